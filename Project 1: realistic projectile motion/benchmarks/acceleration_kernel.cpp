@@ -0,0 +1,119 @@
+/*
+ * acceleration_kernel.cpp
+ *
+ * Microbenchmark for ProjectileParams::acceleration
+ * Compares the cached-coefficient kernel (one sqrt, no divides) with the original
+ * force-based formulation that rebuilt π r², ½ρCdA and the forces on every call
+ * and divided by the mass at the end.
+ *
+ * Hardware counters (IPC, cache and branch misses) are printed per kernel
+ * when perf_event_open is available.
+ *
+ * Build and run: make bench
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "Processing.h"
+#include "Projectile.h"
+#include "perf_counters.h"
+
+using Clock = std::chrono::steady_clock;
+
+// The original calculateAcceleration, kept here as the reference
+static Vector3D forceBasedAcceleration(const ProjectileParams& p, const Vector3D& velocity,
+                                       const Vector3D& wind) {
+    Vector3D gravityForce(0, 0, -p.getMass() * ProjectileParams::GRAVITY);
+    Vector3D relativeVelocity = velocity - wind;
+    double speed = relativeVelocity.magnitude();
+
+    Vector3D dragForce(0, 0, 0);
+    if (speed > 0) {
+        double crossSectionalArea = M_PI * p.getRadius() * p.getRadius();
+        double dragMagnitude = 0.5 * p.getAirDensity() * speed * speed *
+                               p.getDragCoefficient() * crossSectionalArea;
+        dragForce = relativeVelocity.normalize() * -1.0 * dragMagnitude;
+    }
+
+    const Vector3D& spin = p.getSpin();
+    Vector3D magnusCross(spin.y * relativeVelocity.z - spin.z * relativeVelocity.y,
+                         spin.z * relativeVelocity.x - spin.x * relativeVelocity.z,
+                         spin.x * relativeVelocity.y - spin.y * relativeVelocity.x);
+    Vector3D magnusForce = magnusCross * p.getS();
+
+    return (gravityForce + dragForce + magnusForce) / p.getMass();
+}
+
+template <typename Kernel>
+static double nanosecondsPerCall(const char* name, const std::vector<Vector3D>& velocities,
+                                 int repeats, Kernel kernel, Vector3D& sink) {
+    PerfScope scope(name);
+    auto start = Clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (const Vector3D& v : velocities) {
+            Vector3D a = kernel(v);
+            sink = sink + a;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(repeats) * velocities.size());
+}
+
+int main(int argc, char** argv) {
+    int repeats = argc > 1 ? std::atoi(argv[1]) : 200;
+    PerfProfile::enable();
+
+    ProjectileParams params =
+        valadationWithMagnusEffect().getParams();  // ping pong ball with spin
+    Vector3D wind(1.0, -2.0, 0.5);
+
+    std::vector<Vector3D> velocities;
+    for (int i = 0; i < 10000; ++i) {
+        velocities.emplace_back(15.0 - i * 1e-3, 5.0 + i * 2e-4, 15.0 - i * 3e-3);
+    }
+
+    // Both kernels must agree before their speed means anything
+    double worst = 0.0;
+    for (const Vector3D& v : velocities) {
+        Vector3D a = params.acceleration(v, wind);
+        Vector3D b = forceBasedAcceleration(params, v, wind);
+        worst = std::max(worst, (a - b).magnitude() / b.magnitude());
+    }
+
+    Vector3D sink;
+    auto forceBased = [&](const Vector3D& v) { return forceBasedAcceleration(params, v, wind); };
+    auto cachedKernel = [&](const Vector3D& v) { return params.acceleration(v, wind); };
+    double reference =
+        nanosecondsPerCall("force-based (old)", velocities, repeats, forceBased, sink);
+    double cached =
+        nanosecondsPerCall("cached coefficients", velocities, repeats, cachedKernel, sink);
+
+    std::cout << "acceleration() over " << velocities.size() << " velocities x " << repeats
+              << std::endl;
+    std::cout << std::setw(22) << "force-based (old)" << std::setw(10) << std::fixed
+              << std::setprecision(2) << reference << " ns/call" << std::endl;
+    std::cout << std::setw(22) << "cached coefficients" << std::setw(10) << cached
+              << " ns/call" << std::endl;
+    std::cout << "speedup " << reference / cached << "x, max relative difference "
+              << std::scientific << std::setprecision(1) << worst << std::endl;
+
+    // Whole flights: four acceleration calls per RK4 step
+    auto start = Clock::now();
+    size_t steps = 0;
+    for (int r = 0; r < 20; ++r) {
+        ProjectileState state = valadationWithMagnusEffect().getState();
+        steps += rk4Simulation(params, state, 0.0001, wind, 60.0).getPoints().size();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "rk4Simulation: " << std::fixed << std::setprecision(1)
+              << steps / seconds / 1e6 << " M steps/s" << std::endl;
+
+    std::cout << std::endl;
+    PerfProfile::print(std::cout);
+
+    return sink.x == 12345.0 ? 1 : 0;  // keep the results alive
+}
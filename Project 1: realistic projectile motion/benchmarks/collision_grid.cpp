@@ -0,0 +1,118 @@
+/*
+ * collision_grid.cpp
+ *
+ * Broadphase benchmark for CollisionGrid
+ * Spheres are scattered in a box that grows with N (constant density, so the number of
+ * contacts per sphere stays fixed) with random velocities. The grid (build + search) is
+ * timed against the all-pairs O(N²) test, and both must report the same contacts.
+ *
+ * Build and run: make bench
+ * Run:           ./bin/collision_grid [maxN] [threads] [bruteMax]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "Collisions.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// All pairs, in the same order as findContacts
+static std::vector<Contact> bruteForce(const std::vector<ProjectileState>& states,
+                                       const std::vector<double>& radii, double dt) {
+    std::vector<Contact> contacts;
+    for (uint32_t i = 0; i < states.size(); ++i) {
+        for (uint32_t j = i + 1; j < states.size(); ++j) {
+            double t = sphereTimeOfImpact(states[i].position, states[i].velocity, radii[i],
+                                          states[j].position, states[j].velocity, radii[j], dt);
+            if (t >= 0.0) {
+                contacts.push_back(Contact{i, j, t});
+            }
+        }
+    }
+    std::sort(contacts.begin(), contacts.end(), [](const Contact& l, const Contact& r) {
+        return std::tie(l.time, l.a, l.b) < std::tie(r.time, r.a, r.b);
+    });
+    return contacts;
+}
+
+int main(int argc, char** argv) {
+    size_t maxN = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 100000;
+    ThreadPoolOptions options;
+    options.threads = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 0;
+    size_t bruteMax = argc > 3 ? static_cast<size_t>(std::atoll(argv[3])) : 20000;
+    ThreadPool pool(options);
+
+    const double radius = 0.02;   // Ping pong ball
+    const double spacing = 0.2;   // Mean distance between neighbours (m)
+    const double dt = 0.001;
+    const double speed = 30.0;    // Per component (m/s)
+
+    std::cout << "Collision broadphase on " << pool.size() << " thread(s)" << std::endl;
+    std::cout << std::setw(9) << "N" << std::setw(10) << "contacts" << std::setw(12)
+              << "candidates" << std::setw(12) << "grid(ms)" << std::setw(12) << "brute(ms)"
+              << std::setw(10) << "speedup" << std::setw(8) << "match" << std::endl;
+
+    for (size_t n : {1000, 5000, 20000, 100000}) {
+        if (n > maxN) {
+            break;
+        }
+        double side = spacing * std::cbrt(static_cast<double>(n));
+        std::mt19937 random(17);
+        std::uniform_real_distribution<double> place(0.0, side);
+        std::uniform_real_distribution<double> move(-speed, speed);
+        std::vector<ProjectileState> states(n);
+        std::vector<double> radii(n, radius);
+        for (ProjectileState& state : states) {
+            state.position = Vector4D(place(random), place(random), place(random), 0);
+            state.velocity = Vector3D(move(random), move(random), move(random));
+        }
+
+        CollisionGrid grid;
+        grid.build(states, radii, dt, pool);  // Warm-up: sizes the arrays
+        const int repeats = 5;
+        std::vector<Contact> contacts;
+        auto start = Clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            grid.build(states, radii, dt, pool);
+            contacts = grid.findContacts(states, radii, dt, pool);
+        }
+        double gridSeconds = secondsSince(start) / repeats;
+
+        std::cout << std::setw(9) << n << std::setw(10) << contacts.size() << std::setw(12)
+                  << grid.candidatePairs() << std::setw(12) << std::fixed << std::setprecision(3)
+                  << 1e3 * gridSeconds;
+        if (n <= bruteMax) {
+            start = Clock::now();
+            std::vector<Contact> expected = bruteForce(states, radii, dt);
+            double bruteSeconds = secondsSince(start);
+            bool match = expected.size() == contacts.size();
+            for (size_t k = 0; match && k < expected.size(); ++k) {
+                match = expected[k].a == contacts[k].a && expected[k].b == contacts[k].b &&
+                        expected[k].time == contacts[k].time;
+            }
+            std::cout << std::setw(12) << 1e3 * bruteSeconds << std::setw(10)
+                      << std::setprecision(1) << bruteSeconds / gridSeconds << std::setw(8)
+                      << (match ? "yes" : "NO");
+            if (!match) {
+                std::cout << std::defaultfloat << std::endl;
+                return 1;
+            }
+        } else {
+            std::cout << std::setw(12) << "-" << std::setw(10) << "-" << std::setw(8) << "-";
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
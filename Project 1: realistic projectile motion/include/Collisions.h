@@ -0,0 +1,106 @@
+/*
+ * Collisions.h
+ *
+ * Collisions within a cloud of projectiles (debris, shot patterns)
+ * Broadphase: uniform grid hashed into a fixed table, rebuilt every step by a parallel
+ * counting sort. Narrowphase: exact time of impact of two spheres moving in straight lines.
+ */
+
+#ifndef COLLISIONS_H
+#define COLLISIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Projectile.h"
+#include "thread_pool.h"
+
+// Earliest time in [0, maxTime] at which two spheres moving with constant velocities
+// touch, or -1 if they do not. Spheres that already overlap and are closing give 0.
+double sphereTimeOfImpact(const Vector3D& positionA, const Vector3D& velocityA, double radiusA,
+                          const Vector3D& positionB, const Vector3D& velocityB, double radiusB,
+                          double maxTime);
+
+// Two spheres that touch during a step
+struct Contact {
+    uint32_t a;   // Lower index
+    uint32_t b;   // Higher index
+    double time;  // Time of impact from the start of the step (s)
+};
+
+// Uniform grid over the boxes the spheres sweep during one step
+class CollisionGrid {
+   private:
+    double cellSize = 0.0;              // Largest swept box, so touching boxes are in
+                                        // neighbouring cells
+    std::vector<double> boxes;          // Swept box of each sphere: min xyz, max xyz
+    std::vector<int64_t> cells;         // Integer cell coordinates of each box centre
+    std::vector<uint32_t> bucketStart;  // Counting-sort offsets, one past the end at [size]
+    std::vector<uint32_t> sorted;       // Sphere indices grouped by bucket
+    mutable size_t candidates = 0;
+
+    size_t bucketOf(int64_t x, int64_t y, int64_t z) const;
+
+   public:
+    // Bin every sphere (position and velocity from states) by the centre of its swept box
+    void build(const std::vector<ProjectileState>& states, const std::vector<double>& radii,
+               double dt, ThreadPool& pool);
+
+    // Pairs from neighbouring cells whose swept boxes overlap and that touch within dt,
+    // sorted by time of impact. Uses the states and radii given to build().
+    std::vector<Contact> findContacts(const std::vector<ProjectileState>& states,
+                                      const std::vector<double>& radii, double dt,
+                                      ThreadPool& pool) const;
+
+    size_t candidatePairs() const {  // Box-overlapping pairs tested by the last findContacts
+        return candidates;
+    }
+    double getCellSize() const {
+        return cellSize;
+    }
+};
+
+// Many projectiles flying at once and bouncing off each other
+class ProjectileCloud {
+   private:
+    std::vector<ProjectileParams> params;
+    std::vector<ProjectileState> states;
+    std::vector<double> radii;
+    std::vector<size_t> hits;  // Collisions of each projectile so far
+    CollisionGrid grid;
+    double restitution;
+
+   public:
+    explicit ProjectileCloud(double restitution = 0.9);
+
+    void add(const Projectile& projectile);
+
+    // Replace the states and collision counts of the projectiles already added
+    // (resuming a checkpointed cloud). Returns false, changing nothing, if the sizes differ
+    bool restore(const std::vector<ProjectileState>& savedStates,
+                 const std::vector<size_t>& savedHits);
+
+    // Advance every airborne projectile by dt and return the number of collisions.
+    // Projectiles that collide move in a straight line to the contact, exchange an
+    // impulse along the line of centres and finish the step with the new velocity
+    // (first order over that step); every other projectile takes a normal RK4 step.
+    // A projectile takes part in at most one collision per step; landed ones are inert.
+    size_t step(double dt, const Vector3D& wind, ThreadPool& pool);
+
+    bool allGrounded() const;
+    size_t size() const {
+        return states.size();
+    }
+    const std::vector<ProjectileState>& getStates() const {
+        return states;
+    }
+    const std::vector<size_t>& getHits() const {
+        return hits;
+    }
+    const CollisionGrid& getGrid() const {
+        return grid;
+    }
+};
+
+#endif  // COLLISIONS_H
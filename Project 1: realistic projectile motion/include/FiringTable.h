@@ -0,0 +1,104 @@
+/*
+ * FiringTable.h
+ *
+ * Precomputed impact results over a grid of launch conditions
+ * Built in parallel on the shared ThreadPool, stored as a compact binary file,
+ * and queried by multilinear interpolation instead of a full flight
+ */
+
+#ifndef FIRING_TABLE_H
+#define FIRING_TABLE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Projectile.h"
+#include "thread_pool.h"
+
+// Launch conditions a table axis can vary
+enum class TableParameter {
+    Speed,      // Launch speed (m/s)
+    Elevation,  // Elevation angle above the horizontal (degrees), aimed along +x
+    WindX,      // Wind along +x (m/s); negative is a head wind
+    Backspin    // Spin about -y (rad/s); positive lifts a ball flying along +x
+};
+
+const char* tableParameterName(TableParameter parameter);
+
+// One grid axis: count evenly spaced values from min to max
+struct TableAxis {
+    TableParameter parameter;
+    double min;
+    double max;
+    size_t count;
+
+    double value(size_t i) const {
+        return count > 1 ? min + (max - min) * static_cast<double>(i) / (count - 1) : min;
+    }
+};
+
+// Impact result of one launch
+struct FiringSolution {
+    double flightTime;  // Time from launch to impact (s)
+    double range;       // Horizontal distance from the launch point (m)
+    double impactX;     // Impact position (m)
+    double impactY;
+};
+
+// Interpolation error of a table measured against direct simulation
+struct FiringTableError {
+    size_t samples = 0;
+    double maxRangeError = 0.0;  // Largest |table - simulation| (m)
+    double meanRangeError = 0.0;
+    double maxTimeError = 0.0;  // Largest flight time error (s)
+    double meanTimeError = 0.0;
+    double lookupMicroseconds = 0.0;      // Mean time per table lookup
+    double simulationMicroseconds = 0.0;  // Mean time per rk4Flight
+};
+
+class FiringTable {
+   private:
+    ProjectileParams params;  // Projectile the table was built for
+    ProjectileState launch;   // Launch point (and defaults for parameters without an axis)
+    double timeStep;
+    double maxTime;
+    std::vector<TableAxis> axes;
+    std::vector<size_t> strides;        // Node index step along each axis
+    std::vector<FiringSolution> nodes;  // Grid values, last axis fastest
+
+    void computeStrides();
+    void checkPoint(const std::vector<double>& point) const;  // One value per axis
+
+   public:
+    FiringTable();
+
+    // Simulate every grid node on the pool. Throws std::invalid_argument for an axis
+    // without values or one that repeats a parameter.
+    static FiringTable build(const Projectile& base, const std::vector<TableAxis>& axes,
+                             double timeStep, double maxTime, ThreadPool& pool);
+
+    // Binary file: header, projectile, axes, then the node values as raw doubles
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    // Interpolated result at point (one value per axis, in axis order); values
+    // outside an axis are clamped to its ends. Throws std::invalid_argument if
+    // point does not have one value per axis.
+    FiringSolution lookup(const std::vector<double>& point) const;
+
+    // Direct simulation at the same point, for comparison
+    FiringSolution simulate(const std::vector<double>& point) const;
+
+    // Compare lookup with simulate at samples random points inside the grid
+    FiringTableError measureError(size_t samples, ThreadPool& pool, unsigned seed = 1) const;
+
+    const std::vector<TableAxis>& getAxes() const {
+        return axes;
+    }
+    size_t size() const {  // Number of grid nodes
+        return nodes.size();
+    }
+};
+
+#endif  // FIRING_TABLE_H
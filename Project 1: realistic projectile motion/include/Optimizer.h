@@ -0,0 +1,63 @@
+/*
+ * Optimizer.h
+ *
+ * Maximum-range launch search with drag, wind and spin
+ * Brent's method (parabolic steps with golden-section fallback) on the elevation angle,
+ * Nelder-Mead on elevation and backspin together. Every evaluation is a summary-only
+ * rk4Flight, and many configurations are optimized in parallel on the shared ThreadPool.
+ */
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Projectile.h"
+#include "thread_pool.h"
+
+// One projectile/wind configuration to optimize. The launch is aimed along +x.
+struct LaunchSearchCase {
+    std::shared_ptr<const ProjectileParams> params;  // Physical properties (read-only)
+    Vector4D launch;                                 // Launch position and time
+    double speed;                                    // Launch speed (m/s)
+    Vector3D wind;                                   // Wind velocity (m/s)
+};
+
+struct SearchSettings {
+    double timeStep = 0.001;
+    double maxTime = 60.0;
+    double angleMin = 0.0;  // Elevation search interval (degrees)
+    double angleMax = 90.0;
+    double spinMin = 0.0;  // Backspin search interval (rad/s), angle+spin search only
+    double spinMax = 0.0;
+    double angleTolerance = 1e-3;  // Stop when the optimum is bracketed this tightly (degrees)
+    size_t maxEvaluations = 200;   // Flights per case
+};
+
+// Best launch of a case and how sensitive the range is around it
+struct LaunchOptimum {
+    double elevation;   // Optimal elevation (degrees)
+    double backspin;    // Optimal backspin about -y (rad/s); the params spin if not searched
+    double range;       // Range at the optimum (m)
+    double flightTime;  // Flight time at the optimum (s)
+    double angleCurvature;   // d²R/dθ² at the optimum (m/deg²); R(θ ± 1°) ≈ R + curvature / 2
+    double windSensitivity;  // dR/dWx (m per m/s of tail wind)
+    double spinSensitivity;  // dR/dω (m per rad/s of backspin)
+    size_t evaluations;      // Flights spent by the search (sensitivities not included)
+};
+
+// Maximum-range elevation for the projectile's own spin (Brent's method)
+LaunchOptimum optimizeAngle(const LaunchSearchCase& search, const SearchSettings& settings);
+
+// Maximum-range elevation and backspin within [spinMin, spinMax] (Nelder-Mead)
+LaunchOptimum optimizeAngleAndSpin(const LaunchSearchCase& search,
+                                   const SearchSettings& settings);
+
+// Optimize every case on the pool; results are in the same order as cases
+std::vector<LaunchOptimum> optimizeLaunches(const std::vector<LaunchSearchCase>& cases,
+                                            const SearchSettings& settings, bool searchSpin,
+                                            ThreadPool& pool);
+
+#endif  // OPTIMIZER_H
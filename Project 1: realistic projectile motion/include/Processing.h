@@ -11,12 +11,46 @@
 
 #include "Projectile.h"
 
+// One RK4 step of state with no ground handling
+void rk4Step(const ProjectileParams& params, ProjectileState& state, double timeStep,
+             const Vector3D& wind);
+
+// Point where the step from previous (above ground) to next (below) crosses z = 0
+Vector4D groundCrossing(const Vector4D& previous, const Vector4D& next);
+
+// Integrate from state until the projectile lands or maxTime is reached. params is only
+// read, so concurrent simulations can share one parameter block; state ends at the last point.
+// If landing is given it receives the same impact point as rk4Flight: the ground crossing
+// interpolated to z = 0 (the trajectory itself ends at the last point above ground), or the
+// final state at maxTime.
+Trajectory rk4Simulation(const ProjectileParams& params, ProjectileState& state, double timeStep,
+                         const Vector3D& wind, double maxTime, Vector4D* landing = nullptr);
+
+// Result of a flight integrated without keeping its trajectory
+struct FlightSummary {
+    Vector4D impact;  // Landing point and time, interpolated to z = 0 (or the state at maxTime)
+    double range;     // Horizontal distance from the launch point (m)
+    size_t steps;     // RK4 steps taken
+    bool landed;      // False if maxTime was reached in the air
+};
+
+// Summary-only flight: same steps as rk4Simulation but no allocation, so it is cheap
+// enough for optimizers and tables that only need the impact point
+FlightSummary rk4Flight(const ProjectileParams& params, const ProjectileState& start,
+                        double timeStep, const Vector3D& wind, double maxTime);
+
+// Same, moving proj along the trajectory
 Trajectory rk4Simulation(Projectile& proj, double timeStep, const Vector3D& wind, double maxTime);
 
 void addInfoToStream(std::stringstream& info_stream, const Projectile& proj);
 
 void addInfoToStream2(std::stringstream& info_stream, const Trajectory& trajectory);
 
+// Simulates every launch of a CSV table (see tableSweep in Sweep.h for the columns) on
+// `threads` workers (0 = all CPUs) and writes one summary row per launch to
+// Output/batchN.csv. Returns false after printing the problem if the table is unusable.
+bool runLaunchTable(const std::string& path, size_t threads);
+
 class Run {
    public:
     Vector4D initialPos;
@@ -27,7 +61,9 @@ class Run {
     double maxTime;
     char choice;
 
-    Run();
+    // resume: continue an interrupted sweep (option 4) or cloud (option 7) from its
+    // checkpoint in Output/
+    explicit Run(bool resume = false);
 };
 
 #endif  // PROCESSING_H
\ No newline at end of file
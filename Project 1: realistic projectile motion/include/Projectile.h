@@ -9,11 +9,15 @@
 #define PROJECTILE_H
 
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+class AsyncWriter;  // Shared workspace async CSV writer (../include/async_writer.h)
+
 // Class representing a 3D vector
 class Vector3D {
    public:
@@ -37,7 +41,13 @@ class Vector3D {
 };
 
 // Class representing a 4D vector (extends Vector3D)
-class Vector4D : public Vector3D {
+//
+// x, y, z and t fill one 32-byte aligned block, so the whole vector is one 256-bit
+// register and each operator below is a single AVX instruction (make NATIVE=1; plain
+// SSE2 builds use two). The spatial operators keep t from the left operand: they work
+// on all four lanes and put t back into the last one (one blend). advance() adds all
+// four lanes, so a step in space and time is a single add.
+class alignas(32) Vector4D : public Vector3D {
    public:
     double t;  // t = time coordinate
 
@@ -46,41 +56,150 @@ class Vector4D : public Vector3D {
     Vector4D(double x_, double y_, double z_, double t_)
         : Vector3D(x_, y_, z_), t(t_) {}  // Parameterized constructor
 
-    // Vector operations (4D)
-    Vector4D operator+(const Vector4D& other) const;  // Vector addition
-    Vector4D operator-(const Vector4D& other) const;  // Vector subtraction
-    Vector4D operator*(double scalar) const;          // Scalar multiplication
-    Vector4D operator/(double scalar) const;          // Scalar division
+    // Vector operations (spatial, t is kept)
+    Vector4D operator+(const Vector4D& other) const {  // Vector addition
+        Lanes a, b;
+        load(a, *this);
+        load(b, other);
+        return storeWithTime(a + b, t);
+    }
+    Vector4D operator-(const Vector4D& other) const {  // Vector subtraction
+        Lanes a, b;
+        load(a, *this);
+        load(b, other);
+        return storeWithTime(a - b, t);
+    }
+    Vector4D operator*(double scalar) const {  // Scalar multiplication
+        Lanes a;
+        load(a, *this);
+        return storeWithTime(a * scalar, t);
+    }
+    Vector4D operator/(double scalar) const {  // Scalar division
+        Lanes a;
+        load(a, *this);
+        return storeWithTime(a / scalar, t);
+    }
+
+    // Vector operations (all four lanes)
+    Vector4D advance(const Vector4D& delta) const {  // (x + dx, y + dy, z + dz, t + dt)
+        Lanes a, b;
+        load(a, *this);
+        load(b, delta);
+        Lanes sum = a + b;
+        return Vector4D(sum[0], sum[1], sum[2], sum[3]);
+    }
 
     // Utility functions
     double spacetimeMagnitude() const;       // Calculate the 4D spacetime interval
     Vector4D normalize() const;              // Normalize the spatial components
     void print() const;                      // Print the vector components
     void CSVPrint(std::ostream& out) const;  // Write the vector to a CSV file
-};
 
-// Class representing a projectile with realistic physics
-class Projectile {
    private:
-    Vector4D position;  // Position (x, y, z, t) - (m, m, m, s)
-    Vector3D velocity;  // Velocity (vx, vy, vz) - (m/s, m/s, m/s)
-    Vector3D spin;      // Spin vector (wx, wy, wz) - (rad/s, rad/s, rad/s)
+    // Lanes are only passed by reference: by value they would depend on -mavx (ABI)
+    typedef double Lanes __attribute__((vector_size(32)));  // x, y, z, t
+
+    static void load(Lanes& v, const Vector4D& from) { std::memcpy(&v, &from, sizeof v); }
+    static Vector4D storeWithTime(const Lanes& v, double time) {
+        return Vector4D(v[0], v[1], v[2], time);
+    }
+};
 
+static_assert(sizeof(Vector4D) == 32 && alignof(Vector4D) == 32,
+              "Vector4D must be exactly one 256-bit register");
+static_assert(std::is_trivially_copyable<Vector4D>::value,
+              "Vector4D is loaded into registers with memcpy");
+
+// Physical properties of a projectile. None of them change during a flight, so
+// one instance can be shared (read-only) by every thread of a sweep.
+//
+// The force law only needs three derived constants (drag k = ρ·Cd·A / 2m, Magnus
+// S/m and g). They are cached and refreshed by the setters, so acceleration()
+// costs one sqrt and no divisions.
+class ProjectileParams {
+   private:
+    Vector3D spin;           // Spin vector (wx, wy, wz) - (rad/s), constant in flight
     double mass;             // Mass (kg)
     double radius;           // Radius (m) - for air resistance
     double dragCoefficient;  // Drag coefficient (dimensionless)
     double airDensity;       // Air density (kg/m³)
-    double S;                // Spin factor (m²/s)
+    double S;                // Spin factor (S/m times the mass)
+
+    // Cached coefficients
+    double dragConstant;    // ρ·Cd·π·r² / (2m) (1/m)
+    double magnusConstant;  // S / m
+    double gravity;         // Downward acceleration (m/s²)
+
+    void updateCoefficients();  // Recompute the cached coefficients
 
+   public:
     // Environmental constants
     static constexpr double GRAVITY = 9.81;  // Gravitational acceleration (m/s²)
 
+    ProjectileParams();  // 1 kg, 10 cm, Cd 0.47, no air, no spin
+    ProjectileParams(Vector3D spin, double mass, double radius, double airDensity,
+                     double SOverM, double dragCoeff);
+
+    // Setters (each one refreshes the cached coefficients)
+    void setMass(double m);
+    void setRadius(double r);
+    void setDragCoefficient(double cd);
+    void setSpin(const Vector3D& spinVec);
+    void setAirDensity(double density);
+    void setS(double SOverM);  // Spin factor per unit mass
+    void setSpinFactor(double spinFactor);  // S itself (getS()), to restore saved values exactly
+
+    // Getters
+    double getMass() const { return mass; }
+    double getRadius() const { return radius; }
+    double getDragCoefficient() const { return dragCoefficient; }
+    const Vector3D& getSpin() const { return spin; }
+    double getAirDensity() const { return airDensity; }
+    double getS() const { return S; }
+    double getDragConstant() const { return dragConstant; }
+    double getMagnusConstant() const { return magnusConstant; }
+
+    // Acceleration of a projectile moving at velocity through the given wind:
+    // a = -k |v_rel| v_rel + (S/m) (ω × v_rel) - g ẑ
+    Vector3D acceleration(const Vector3D& velocity, const Vector3D& wind) const {
+        double rx = velocity.x - wind.x;
+        double ry = velocity.y - wind.y;
+        double rz = velocity.z - wind.z;
+        double drag = -dragConstant * std::sqrt(rx * rx + ry * ry + rz * rz);
+        return Vector3D(drag * rx + magnusConstant * (spin.y * rz - spin.z * ry),
+                        drag * ry + magnusConstant * (spin.z * rx - spin.x * rz),
+                        drag * rz + magnusConstant * (spin.x * ry - spin.y * rx) - gravity);
+    }
+};
+
+// Kinematic state of a projectile: plain data, cheap to copy and pack in arrays
+// (64 bytes, so an array of states puts each one in its own cache line)
+struct ProjectileState {
+    Vector4D position;  // Position (x, y, z, t) - (m, m, m, s), one aligned 4-lane block
+    Vector3D velocity;  // Velocity (vx, vy, vz) - (m/s, m/s, m/s)
+
+    bool isGrounded() const {  // On or below the ground and not rising
+        return position.z <= 0 && velocity.z <= 0;
+    }
+};
+
+static_assert(std::is_trivially_copyable<ProjectileState>::value,
+              "ProjectileState must stay plain data");
+
+// Class representing a projectile with realistic physics
+class Projectile {
+   private:
+    ProjectileParams params;  // Physical properties
+    ProjectileState state;    // Position and velocity
+
    public:
     // Constructors
     Projectile();  // Default constructor
-    Projectile(Vector4D initialPos, Vector3D initialVel, Vector3D initialSpin, double mass,
+    Projectile(const Vector4D& initialPos, Vector3D initialVel, Vector3D initialSpin, double mass,
                double radius, double airDensity, double SOverM,
                double dragCoeff);  // Parameterized constructor
+    Projectile(const ProjectileParams& params,
+               const ProjectileState& state);  // From a parameter block and a state
 
     // Setters
     void setPosition(const Vector4D& pos);  // Set the position
@@ -91,11 +210,12 @@ class Projectile {
     void setSpin(const Vector3D& spinVec);  // Set the spin vector
     void setAirDensity(double density);     // Set the air density
     void setS(double SOverM);               // Set the spin factor
+    void setState(const ProjectileState& s);  // Set position and velocity
 
-    void setAll(Vector4D pos, Vector3D vel, Vector3D spinVec, double m, double r, double density,
-                double SOverM, double dragCoeff);  // Set all properties
+    void setAll(const Vector4D& pos, Vector3D vel, Vector3D spinVec, double m, double r,
+                double density, double SOverM, double dragCoeff);  // Set all properties
 
-    void move(Vector4D pos, Vector3D vel);  // Update position and velocity
+    void move(const Vector4D& pos, Vector3D vel);  // Update position and velocity
 
     // Getters
     Vector4D getPosition() const;       // Get the position
@@ -110,10 +230,12 @@ class Projectile {
     double getS() const;                // Get the spin factor
     double getRadius() const;           // Get the radius
     double getDragCoefficient() const;  // Get the drag coefficient
+    const ProjectileParams& getParams() const;  // Get the physical properties
+    const ProjectileState& getState() const;    // Get position and velocity
 
     // Physics calculations
-    Vector3D calculateAcceleration(const Vector3D& wind = Vector3D(0, 0,
-                                                                   0));  // Calculate acceleration
+    Vector3D calculateAcceleration(
+        const Vector3D& wind = Vector3D(0, 0, 0)) const;  // Calculate acceleration
 
     // Utility
     bool isGrounded() const;  // Check if the projectile is on the ground
@@ -127,21 +249,21 @@ class Projectile {
 
 class Baseball : public Projectile {
    public:
-    Baseball(Vector4D initialPos, Vector3D initialVel, Vector3D initialSpin)
+    Baseball(const Vector4D& initialPos, Vector3D initialVel, Vector3D initialSpin)
         : Projectile(initialPos, initialVel, initialSpin, 0.149, 0.0366, 1.225, 4.1e-4, 0.35) {
     }  // Initialize with typical baseball properties
 };
 
 class pingPongBall : public Projectile {
    public:
-    pingPongBall(Vector4D initialPos, Vector3D initialVel, Vector3D initialSpin)
+    pingPongBall(const Vector4D& initialPos, Vector3D initialVel, Vector3D initialSpin)
         : Projectile(initialPos, initialVel, initialSpin, 0.0027, 0.02, 1.27, 0.04, 0.5) {
     }  // Initialize with typical ping pong ball properties
 };
 
 class perfectProjectile : public Projectile {
    public:
-    perfectProjectile(Vector4D initialPos, Vector3D initialVel, Vector3D initialSpin)
+    perfectProjectile(const Vector4D& initialPos, Vector3D initialVel, Vector3D initialSpin)
         : Projectile(initialPos, initialVel, initialSpin, 1.0, 0.1, 0.0, 0.0, 0.0) {
     }  // No air resistance or spin effects
 };
@@ -159,6 +281,9 @@ class Trajectory {
     void print() const;  // Print the trajectory points
     void CSVPrint(const std::string& filename,
                   const std::string& info) const;  // Write the trajectory to a CSV file
+    void CSVPrint(AsyncWriter& writer, const std::string& filename,
+                  const std::string& info) const;  // Same file, written by an I/O thread
+    std::string CSVString(const std::string& info) const;  // Same file contents as a string
 
     const std::vector<Vector4D>& getPoints() const {
         return points;
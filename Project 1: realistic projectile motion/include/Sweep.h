@@ -0,0 +1,76 @@
+/*
+ * Sweep.h
+ *
+ * Parallel parameter sweeps over many projectile launches
+ * Runs on the shared NUMA-aware ThreadPool from the workspace include/ folder
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Projectile.h"
+#include "bulk_file_writer.h"
+#include "checkpoint.h"
+#include "csv_loader.h"
+#include "run_archive.h"
+#include "thread_pool.h"
+
+// One launch in a sweep. Cases usually share one parameter block; only the
+// launch state differs, so a case is a pointer plus a few doubles.
+struct SweepCase {
+    std::shared_ptr<const ProjectileParams> params;  // Physical properties (read-only)
+    ProjectileState start;                           // Launch position and velocity
+    Vector3D wind;                                   // Wind velocity (m/s)
+};
+
+// Summary of one launch (the full trajectory is not kept). Whether trajectories are saved
+// or not, the impact is the landing interpolated to z = 0, as in rk4Flight.
+struct SweepResult {
+    Vector4D impact;  // Landing position and time (or the state at maxTime)
+    double range;     // Horizontal distance travelled (m)
+    size_t steps;     // Number of trajectory points
+};
+
+// Where runSweep saves full trajectories (both are optional)
+struct SweepOutput {
+    // One CSV per case, trajectoryStem + i + ".csv". Workers format the CSV and hand
+    // it over; the files are created in batches by the writer's background thread.
+    BulkFileWriter* files = nullptr;
+    std::string trajectoryStem;
+    // Every case in one indexed archive with run id i (see sweepArchiveLayout)
+    RunArchiveWriter* archive = nullptr;
+    // Progress for resuming a killed sweep: each finished case is recorded with
+    // sweepCheckpointValues doubles, and cases already done are not simulated again
+    // (their results come back bit for bit from the checkpoint)
+    Checkpoint* checkpoint = nullptr;
+};
+
+// Doubles per case in a sweep checkpoint: impact x, y, z, t, range and steps
+const size_t sweepCheckpointValues = 6;
+
+// Simulate every case on the pool; results are in the same order as cases
+std::vector<SweepResult> runSweep(const std::vector<SweepCase>& cases, double timeStep,
+                                  double maxTime, ThreadPool& pool,
+                                  const SweepOutput& output = SweepOutput());
+
+// Archive layout used by runSweep: parameters Speed, Elevation (degrees) and Spin,
+// summary FlightTime, Range, ImpactX, ImpactY and columns Time, X, Y, Z
+RunArchiveLayout sweepArchiveLayout();
+
+// Cases launching base at the given speed with elevation angles evenly spaced
+// from angleMinDeg to angleMaxDeg (degrees), aimed along +x
+std::vector<SweepCase> angleSweep(const Projectile& base, double speed, double angleMinDeg,
+                                  double angleMaxDeg, size_t count, const Vector3D& wind);
+
+// Cases from a table of launches, one per row (see CsvTable). Columns vx, vy and vz are
+// required; x, y, z, spin_x, spin_y, spin_z, wind_x, wind_y, wind_z, mass, radius,
+// drag_coefficient, air_density and spin_factor are optional and default to base.
+// Consecutive rows with the same physical constants share one parameter block.
+// Returns false (after printing the problem) if a required column is missing.
+bool tableSweep(const CsvTable& table, const Projectile& base, std::vector<SweepCase>& cases);
+
+#endif  // SWEEP_H
@@ -5,11 +5,12 @@
  * Uses 4D vectors (x, y, z, t) to track position and time
  *
  * Build: clang++ -std=c++17 -O2 -I./include main.cpp src/Projectile.cpp src/Processing.cpp -o bin/projectile
- * Run: ./bin/projectile
+ * Run: ./bin/projectile [--resume | --batch launches.csv [threads]]
  * Or press F5 to build and run
  */
 
 #include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -18,11 +19,28 @@
 
 #include "Projectile.h"
 #include "Processing.h"
+#include "alloc_tracker.h"
+#include "perf_counters.h"
+#include "trace.h"
 
 using namespace std;
 
-int main() {
-    Run Run;
+int main(int argc, char** argv) {
+    // NM_TRACE=Output/trace.json: timeline of the run for Perfetto / chrome://tracing
+    Trace::enableFromEnvironment();
+    // NM_PERF=1: IPC, cache and branch misses of the integration kernels at exit
+    PerfProfile::enableFromEnvironment();
+    // NM_ALLOC=1: heap allocations, bytes and peaks per subsystem at exit
+    AllocationTracker::enableFromEnvironment();
+
+    // --batch FILE [THREADS]: simulate every launch of a CSV table, no prompts
+    if (argc > 2 && string(argv[1]) == "--batch") {
+        size_t threads = argc > 3 ? static_cast<size_t>(atoll(argv[3])) : 0;
+        return runLaunchTable(argv[2], threads) ? 0 : 1;
+    }
+    // --resume: pick up a killed sweep or cloud from its checkpoint
+    bool resume = argc > 1 && string(argv[1]) == "--resume";
+    Run Run(resume);
     return 0;
 }
 
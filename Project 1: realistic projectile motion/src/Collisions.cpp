@@ -0,0 +1,283 @@
+/*
+ * Collisions.cpp
+ *
+ * Implementation of the collision grid and the projectile cloud
+ */
+
+#include "Collisions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+#include "Processing.h"
+#include "alloc_tracker.h"
+#include "trace.h"
+
+double sphereTimeOfImpact(const Vector3D& positionA, const Vector3D& velocityA, double radiusA,
+                          const Vector3D& positionB, const Vector3D& velocityB, double radiusB,
+                          double maxTime) {
+    // |d + v t| = R with d and v the relative position and velocity
+    Vector3D d = positionB - positionA;
+    Vector3D v = velocityB - velocityA;
+    double reach = radiusA + radiusB;
+    double c = d.x * d.x + d.y * d.y + d.z * d.z - reach * reach;
+    double b = d.x * v.x + d.y * v.y + d.z * v.z;  // Half the linear coefficient
+    if (c <= 0.0) {
+        return b < 0.0 ? 0.0 : -1.0;  // Overlapping: only a contact if still closing
+    }
+    double a = v.x * v.x + v.y * v.y + v.z * v.z;
+    if (b >= 0.0 || a == 0.0) {
+        return -1.0;  // Moving apart or not moving relative to each other
+    }
+    double discriminant = b * b - a * c;
+    if (discriminant < 0.0) {
+        return -1.0;  // Closest approach is farther than the radii
+    }
+    // Smaller root, written to avoid cancellation: t = c / (-b + sqrt(b² - ac))
+    double t = c / (-b + std::sqrt(discriminant));
+    return t <= maxTime ? t : -1.0;
+}
+
+size_t CollisionGrid::bucketOf(int64_t x, int64_t y, int64_t z) const {
+    uint64_t hash = static_cast<uint64_t>(x) * 73856093u ^ static_cast<uint64_t>(y) * 19349663u ^
+                    static_cast<uint64_t>(z) * 83492791u;
+    return static_cast<size_t>(hash & (bucketStart.size() - 2));  // Table size is a power of two
+}
+
+void CollisionGrid::build(const std::vector<ProjectileState>& states,
+                          const std::vector<double>& radii, double dt, ThreadPool& pool) {
+    size_t n = states.size();
+    boxes.resize(6 * n);
+    cells.resize(3 * n);
+    sorted.resize(n);
+
+    // Swept boxes, and the largest extent along any axis as the cell size
+    std::vector<double> largest(pool.size(), 0.0);
+    pool.parallelFor(n, 0, [&](size_t begin, size_t end, size_t worker) {
+        for (size_t i = begin; i < end; ++i) {
+            const Vector4D& p = states[i].position;
+            const Vector3D& v = states[i].velocity;
+            double r = radii[i];
+            double* box = &boxes[6 * i];
+            box[0] = std::min(p.x, p.x + v.x * dt) - r;
+            box[1] = std::min(p.y, p.y + v.y * dt) - r;
+            box[2] = std::min(p.z, p.z + v.z * dt) - r;
+            box[3] = std::max(p.x, p.x + v.x * dt) + r;
+            box[4] = std::max(p.y, p.y + v.y * dt) + r;
+            box[5] = std::max(p.z, p.z + v.z * dt) + r;
+            largest[worker] = std::max({largest[worker], box[3] - box[0], box[4] - box[1],
+                                        box[5] - box[2]});
+        }
+    });
+    cellSize = *std::max_element(largest.begin(), largest.end());
+    if (cellSize <= 0.0) {
+        cellSize = 1.0;
+    }
+
+    size_t tableSize = 1;
+    while (tableSize < 2 * n) {
+        tableSize *= 2;
+    }
+    bucketStart.assign(tableSize + 1, 0);
+
+    // Counting sort: count per bucket, prefix sum, scatter
+    std::unique_ptr<std::atomic<uint32_t>[]> counts(new std::atomic<uint32_t>[tableSize]);
+    for (size_t b = 0; b < tableSize; ++b) {
+        counts[b].store(0, std::memory_order_relaxed);
+    }
+    std::vector<uint32_t> bucket(n);
+    pool.parallelFor(n, 0, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            const double* box = &boxes[6 * i];
+            int64_t* cell = &cells[3 * i];
+            for (int axis = 0; axis < 3; ++axis) {
+                cell[axis] = static_cast<int64_t>(
+                    std::floor(0.5 * (box[axis] + box[axis + 3]) / cellSize));
+            }
+            bucket[i] = static_cast<uint32_t>(bucketOf(cell[0], cell[1], cell[2]));
+            counts[bucket[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    uint32_t total = 0;
+    for (size_t b = 0; b < tableSize; ++b) {
+        bucketStart[b] = total;
+        total += counts[b].load(std::memory_order_relaxed);
+        counts[b].store(bucketStart[b], std::memory_order_relaxed);  // Becomes the write cursor
+    }
+    bucketStart[tableSize] = total;
+    pool.parallelFor(n, 0, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            sorted[counts[bucket[i]].fetch_add(1, std::memory_order_relaxed)] =
+                static_cast<uint32_t>(i);
+        }
+    });
+}
+
+std::vector<Contact> CollisionGrid::findContacts(const std::vector<ProjectileState>& states,
+                                                 const std::vector<double>& radii, double dt,
+                                                 ThreadPool& pool) const {
+    size_t n = states.size();
+    std::vector<std::vector<Contact>> found(pool.size());
+    std::vector<size_t> tested(pool.size(), 0);
+
+    pool.parallelFor(n, 256, [&](size_t begin, size_t end, size_t worker) {
+        std::vector<Contact>& local = found[worker];
+        size_t visited[27];
+        for (size_t i = begin; i < end; ++i) {
+            const int64_t* cell = &cells[3 * i];
+            const double* boxI = &boxes[6 * i];
+            size_t visitedCount = 0;
+            for (int64_t dx = -1; dx <= 1; ++dx) {
+                for (int64_t dy = -1; dy <= 1; ++dy) {
+                    for (int64_t dz = -1; dz <= 1; ++dz) {
+                        // Distinct cells can share a bucket; scan each bucket once
+                        size_t b = bucketOf(cell[0] + dx, cell[1] + dy, cell[2] + dz);
+                        if (std::find(visited, visited + visitedCount, b) !=
+                            visited + visitedCount) {
+                            continue;
+                        }
+                        visited[visitedCount++] = b;
+
+                        for (uint32_t k = bucketStart[b]; k < bucketStart[b + 1]; ++k) {
+                            uint32_t j = sorted[k];
+                            if (j <= i) {
+                                continue;  // Each pair once, from its lower index
+                            }
+                            const double* boxJ = &boxes[6 * j];
+                            if (boxI[0] > boxJ[3] || boxJ[0] > boxI[3] || boxI[1] > boxJ[4] ||
+                                boxJ[1] > boxI[4] || boxI[2] > boxJ[5] || boxJ[2] > boxI[5]) {
+                                continue;
+                            }
+                            tested[worker]++;
+                            double t = sphereTimeOfImpact(
+                                states[i].position, states[i].velocity, radii[i],
+                                states[j].position, states[j].velocity, radii[j], dt);
+                            if (t >= 0.0) {
+                                local.push_back(Contact{static_cast<uint32_t>(i), j, t});
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    TraceSpan span("merge contacts", "cloud");
+    std::vector<Contact> contacts;
+    candidates = 0;
+    for (size_t w = 0; w < found.size(); ++w) {
+        contacts.insert(contacts.end(), found[w].begin(), found[w].end());
+        candidates += tested[w];
+    }
+    std::sort(contacts.begin(), contacts.end(), [](const Contact& l, const Contact& r) {
+        if (l.time != r.time) {
+            return l.time < r.time;
+        }
+        return l.a != r.a ? l.a < r.a : l.b < r.b;
+    });
+    return contacts;
+}
+
+ProjectileCloud::ProjectileCloud(double restitution) : restitution(restitution) {}
+
+void ProjectileCloud::add(const Projectile& projectile) {
+    params.push_back(projectile.getParams());
+    states.push_back(projectile.getState());
+    radii.push_back(projectile.getRadius());
+    hits.push_back(0);
+}
+
+bool ProjectileCloud::restore(const std::vector<ProjectileState>& savedStates,
+                              const std::vector<size_t>& savedHits) {
+    if (savedStates.size() != states.size() || savedHits.size() != hits.size()) {
+        return false;
+    }
+    states = savedStates;
+    hits = savedHits;
+    return true;
+}
+
+bool ProjectileCloud::allGrounded() const {
+    return std::all_of(states.begin(), states.end(),
+                       [](const ProjectileState& s) { return s.isGrounded(); });
+}
+
+size_t ProjectileCloud::step(double dt, const Vector3D& wind, ThreadPool& pool) {
+    AllocScope memory("projectile cloud");
+    size_t n = states.size();
+    {
+        TraceSpan span("grid build", "cloud");
+        grid.build(states, radii, dt, pool);
+    }
+    std::vector<Contact> contacts;
+    {
+        TraceSpan span("find contacts", "cloud");
+        contacts = grid.findContacts(states, radii, dt, pool);
+    }
+
+    // Earliest contacts first; each projectile collides at most once per step
+    std::vector<char> collided(n, 0);
+    std::vector<ProjectileState> start = states;
+    size_t resolved = 0;
+    for (const Contact& contact : contacts) {
+        uint32_t a = contact.a;
+        uint32_t b = contact.b;
+        if (collided[a] || collided[b] || start[a].isGrounded() || start[b].isGrounded()) {
+            continue;
+        }
+        double t = contact.time;
+        Vector3D va = start[a].velocity;
+        Vector3D vb = start[b].velocity;
+        Vector3D pa = Vector3D(start[a].position.x, start[a].position.y, start[a].position.z) +
+                      va * t;
+        Vector3D pb = Vector3D(start[b].position.x, start[b].position.y, start[b].position.z) +
+                      vb * t;
+        Vector3D normal = (pb - pa).normalize();
+        Vector3D relative = vb - va;
+        double closing = relative.x * normal.x + relative.y * normal.y + relative.z * normal.z;
+        if (closing >= 0.0) {
+            continue;
+        }
+
+        double ma = params[a].getMass();
+        double mb = params[b].getMass();
+        double impulse = -(1.0 + restitution) * closing / (1.0 / ma + 1.0 / mb);
+        Vector3D newA = va - normal * (impulse / ma);
+        Vector3D newB = vb + normal * (impulse / mb);
+
+        // Straight line to the contact, new velocity for the rest of the step,
+        // plus one step of gravity and drag
+        Vector3D endA = pa + newA * (dt - t);
+        Vector3D endB = pb + newB * (dt - t);
+        states[a].position = Vector4D(endA.x, endA.y, endA.z, start[a].position.t + dt);
+        states[b].position = Vector4D(endB.x, endB.y, endB.z, start[b].position.t + dt);
+        states[a].velocity = newA + params[a].acceleration(va, wind) * dt;
+        states[b].velocity = newB + params[b].acceleration(vb, wind) * dt;
+
+        collided[a] = collided[b] = 1;
+        hits[a]++;
+        hits[b]++;
+        resolved++;
+    }
+
+    TraceSpan span("integrate", "cloud");
+    pool.parallelFor(n, 256, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            ProjectileState& state = states[i];
+            if (start[i].isGrounded()) {
+                continue;
+            }
+            if (!collided[i]) {
+                rk4Step(params[i], state, dt, wind);
+            }
+            // Same ground rule as rk4Simulation
+            if (state.position.z < 0) {
+                state.position.z = 0;
+                state.velocity = Vector3D(0, 0, 0);
+            }
+        }
+    });
+    return resolved;
+}
@@ -0,0 +1,367 @@
+/*
+ * FiringTable.cpp
+ *
+ * Implementation of the firing-table builder and interpolated lookup
+ */
+
+#include "FiringTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "Processing.h"
+
+namespace {
+
+const char tableMagic[8] = {'N', 'M', 'F', 'T', 'A', 'B', '0', '1'};
+const size_t maxAxes = 4;  // One per TableParameter
+const size_t fields = sizeof(FiringSolution) / sizeof(double);
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Speed and elevation (degrees) of a velocity in the launch plane
+double launchSpeed(const Vector3D& velocity) {
+    return velocity.magnitude();
+}
+
+double launchElevation(const Vector3D& velocity) {
+    double horizontal = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+    return std::atan2(velocity.z, horizontal) * 180.0 / M_PI;
+}
+
+}  // namespace
+
+const char* tableParameterName(TableParameter parameter) {
+    switch (parameter) {
+        case TableParameter::Speed:
+            return "Speed";
+        case TableParameter::Elevation:
+            return "Elevation";
+        case TableParameter::WindX:
+            return "WindX";
+        case TableParameter::Backspin:
+            return "Backspin";
+    }
+    return "Unknown";
+}
+
+FiringTable::FiringTable() : timeStep(0.001), maxTime(60.0) {}
+
+void FiringTable::computeStrides() {
+    strides.assign(axes.size(), 1);
+    for (size_t d = axes.size(); d-- > 1;) {
+        strides[d - 1] = strides[d] * axes[d].count;
+    }
+}
+
+void FiringTable::checkPoint(const std::vector<double>& point) const {
+    if (point.size() != axes.size()) {
+        throw std::invalid_argument("firing table point has " + std::to_string(point.size()) +
+                                    " values for " + std::to_string(axes.size()) + " axes");
+    }
+}
+
+FiringSolution FiringTable::simulate(const std::vector<double>& point) const {
+    checkPoint(point);
+    double speed = launchSpeed(launch.velocity);
+    double elevation = launchElevation(launch.velocity);
+    Vector3D wind(0, 0, 0);
+    ProjectileParams flightParams = params;
+    for (size_t d = 0; d < axes.size(); ++d) {
+        switch (axes[d].parameter) {
+            case TableParameter::Speed:
+                speed = point[d];
+                break;
+            case TableParameter::Elevation:
+                elevation = point[d];
+                break;
+            case TableParameter::WindX:
+                wind.x = point[d];
+                break;
+            case TableParameter::Backspin:
+                flightParams.setSpin(Vector3D(0, -point[d], 0));
+                break;
+        }
+    }
+
+    double angle = elevation * M_PI / 180.0;
+    ProjectileState state = launch;
+    state.velocity = Vector3D(speed * std::cos(angle), 0, speed * std::sin(angle));
+    FlightSummary flight = rk4Flight(flightParams, state, timeStep, wind, maxTime);
+
+    const Vector4D& impact = flight.impact;
+    return FiringSolution{impact.t - launch.position.t, flight.range, impact.x, impact.y};
+}
+
+FiringTable FiringTable::build(const Projectile& base, const std::vector<TableAxis>& axes,
+                               double timeStep, double maxTime, ThreadPool& pool) {
+    FiringTable table;
+    table.params = base.getParams();
+    table.launch = base.getState();
+    table.timeStep = timeStep;
+    table.maxTime = maxTime;
+    for (const TableAxis& axis : axes) {
+        bool repeated = std::any_of(table.axes.begin(), table.axes.end(), [&](const TableAxis& a) {
+            return a.parameter == axis.parameter;
+        });
+        if (axis.count == 0 || repeated || table.axes.size() == maxAxes) {
+            throw std::invalid_argument(std::string("invalid or repeated firing table axis ") +
+                                        tableParameterName(axis.parameter));
+        }
+        table.axes.push_back(axis);
+    }
+    table.computeStrides();
+
+    size_t total = 1;
+    for (const TableAxis& axis : table.axes) {
+        total *= axis.count;
+    }
+    table.nodes.resize(total);
+
+    // Flight times vary across the grid, so hand out small chunks
+    pool.parallelFor(total, 4, [&](size_t begin, size_t end, size_t) {
+        std::vector<double> point(table.axes.size());
+        for (size_t node = begin; node < end; ++node) {
+            for (size_t d = 0; d < table.axes.size(); ++d) {
+                point[d] = table.axes[d].value(node / table.strides[d] % table.axes[d].count);
+            }
+            table.nodes[node] = table.simulate(point);
+        }
+    });
+    return table;
+}
+
+FiringSolution FiringTable::lookup(const std::vector<double>& point) const {
+    checkPoint(point);
+    // Cell index and fractional position along each axis
+    size_t base = 0;
+    size_t step[maxAxes];
+    double fraction[maxAxes];
+    size_t dims = axes.size();
+    for (size_t d = 0; d < dims; ++d) {
+        const TableAxis& axis = axes[d];
+        double u = 0.0;
+        if (axis.count > 1 && axis.max != axis.min) {
+            u = (point[d] - axis.min) / (axis.max - axis.min) * (axis.count - 1);
+            u = std::min(std::max(u, 0.0), static_cast<double>(axis.count - 1));
+        }
+        size_t cell = std::min(static_cast<size_t>(u), axis.count > 1 ? axis.count - 2 : 0);
+        base += cell * strides[d];
+        fraction[d] = u - cell;
+        step[d] = axis.count > 1 ? strides[d] : 0;
+    }
+
+    // Weighted sum over the 2^dims corners of the cell
+    double result[fields] = {};
+    for (size_t corner = 0; corner < (size_t(1) << dims); ++corner) {
+        double weight = 1.0;
+        size_t node = base;
+        for (size_t d = 0; d < dims; ++d) {
+            if (corner & (size_t(1) << d)) {
+                weight *= fraction[d];
+                node += step[d];
+            } else {
+                weight *= 1.0 - fraction[d];
+            }
+        }
+        if (weight == 0.0) {
+            continue;
+        }
+        const double* values = reinterpret_cast<const double*>(&nodes[node]);
+        for (size_t f = 0; f < fields; ++f) {
+            result[f] += weight * values[f];
+        }
+    }
+    return FiringSolution{result[0], result[1], result[2], result[3]};
+}
+
+FiringTableError FiringTable::measureError(size_t samples, ThreadPool& pool,
+                                           unsigned seed) const {
+    FiringTableError error;
+    if (samples == 0 || nodes.empty()) {
+        return error;
+    }
+
+    std::mt19937 random(seed);
+    std::vector<std::vector<double>> points(samples, std::vector<double>(axes.size()));
+    for (std::vector<double>& point : points) {
+        for (size_t d = 0; d < axes.size(); ++d) {
+            std::uniform_real_distribution<double> value(axes[d].min, axes[d].max);
+            point[d] = value(random);
+        }
+    }
+
+    std::vector<FiringSolution> direct(samples);
+    std::vector<double> seconds(samples);
+    pool.parallelFor(samples, 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            direct[i] = simulate(points[i]);
+            seconds[i] =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    });
+
+    std::vector<FiringSolution> interpolated(samples);
+    const int repeats = 100;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (size_t i = 0; i < samples; ++i) {
+            interpolated[i] = lookup(points[i]);
+        }
+    }
+    double lookupSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    error.samples = samples;
+    double totalSimulation = 0.0;
+    for (size_t i = 0; i < samples; ++i) {
+        double rangeError = std::fabs(interpolated[i].range - direct[i].range);
+        double timeError = std::fabs(interpolated[i].flightTime - direct[i].flightTime);
+        error.maxRangeError = std::max(error.maxRangeError, rangeError);
+        error.maxTimeError = std::max(error.maxTimeError, timeError);
+        error.meanRangeError += rangeError / samples;
+        error.meanTimeError += timeError / samples;
+        totalSimulation += seconds[i];
+    }
+    error.lookupMicroseconds = lookupSeconds * 1e6 / (static_cast<double>(repeats) * samples);
+    error.simulationMicroseconds = totalSimulation * 1e6 / samples;
+    return error;
+}
+
+bool FiringTable::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+    file.write(tableMagic, sizeof(tableMagic));
+    writeValue(file, static_cast<uint32_t>(axes.size()));
+    writeValue(file, static_cast<uint32_t>(fields));
+
+    const Vector3D& spin = params.getSpin();
+    double header[] = {params.getMass(),
+                       params.getRadius(),
+                       params.getDragCoefficient(),
+                       params.getAirDensity(),
+                       params.getS() / params.getMass(),
+                       spin.x,
+                       spin.y,
+                       spin.z,
+                       launch.position.x,
+                       launch.position.y,
+                       launch.position.z,
+                       launch.position.t,
+                       launch.velocity.x,
+                       launch.velocity.y,
+                       launch.velocity.z,
+                       timeStep,
+                       maxTime};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    for (const TableAxis& axis : axes) {
+        writeValue(file, static_cast<uint32_t>(axis.parameter));
+        writeValue(file, static_cast<uint32_t>(0));
+        writeValue(file, static_cast<uint64_t>(axis.count));
+        writeValue(file, axis.min);
+        writeValue(file, axis.max);
+    }
+    file.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(FiringSolution));
+
+    if (!file) {
+        std::cerr << "Error: Could not write file " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool FiringTable::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(tableMagic)];
+    uint32_t axisCount = 0;
+    uint32_t fieldCount = 0;
+    double header[17];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, tableMagic, sizeof(magic)) != 0 ||
+        !readValue(file, axisCount) || !readValue(file, fieldCount) || axisCount > maxAxes ||
+        fieldCount != fields || !file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        std::cerr << "Error: " << filename << " is not a firing table" << std::endl;
+        return false;
+    }
+
+    std::vector<TableAxis> loadedAxes;
+    size_t total = 1;
+    for (uint32_t d = 0; d < axisCount; ++d) {
+        uint32_t parameter = 0;
+        uint32_t padding = 0;
+        uint64_t count = 0;
+        TableAxis axis{};
+        if (!readValue(file, parameter) || !readValue(file, padding) || !readValue(file, count) ||
+            !readValue(file, axis.min) || !readValue(file, axis.max) ||
+            parameter > static_cast<uint32_t>(TableParameter::Backspin) || count == 0 ||
+            count > (size_t(1) << 24)) {
+            std::cerr << "Error: " << filename << " has a corrupt axis" << std::endl;
+            return false;
+        }
+        axis.parameter = static_cast<TableParameter>(parameter);
+        if (std::any_of(loadedAxes.begin(), loadedAxes.end(),
+                        [&](const TableAxis& a) { return a.parameter == axis.parameter; })) {
+            std::cerr << "Error: " << filename << " has a repeated axis" << std::endl;
+            return false;
+        }
+        axis.count = static_cast<size_t>(count);
+        if (total > std::numeric_limits<size_t>::max() / sizeof(FiringSolution) / axis.count) {
+            std::cerr << "Error: " << filename << " has too many nodes" << std::endl;
+            return false;
+        }
+        total *= axis.count;
+        loadedAxes.push_back(axis);
+    }
+
+    // The node count comes from the file: check it against the bytes actually left
+    // before allocating
+    std::streampos nodesStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff left = file.tellg() - nodesStart;
+    file.seekg(nodesStart);
+    if (!file || left < 0 || static_cast<uint64_t>(left) / sizeof(FiringSolution) < total) {
+        std::cerr << "Error: " << filename << " is truncated" << std::endl;
+        return false;
+    }
+    std::vector<FiringSolution> loadedNodes(total);
+    if (!file.read(reinterpret_cast<char*>(loadedNodes.data()), total * sizeof(FiringSolution))) {
+        std::cerr << "Error: " << filename << " is truncated" << std::endl;
+        return false;
+    }
+
+    params = ProjectileParams(Vector3D(header[5], header[6], header[7]), header[0], header[1],
+                              header[3], header[4], header[2]);
+    launch.position = Vector4D(header[8], header[9], header[10], header[11]);
+    launch.velocity = Vector3D(header[12], header[13], header[14]);
+    timeStep = header[15];
+    maxTime = header[16];
+    axes = loadedAxes;
+    nodes = std::move(loadedNodes);
+    computeStrides();
+    return true;
+}
@@ -0,0 +1,279 @@
+/*
+ * Optimizer.cpp
+ *
+ * Implementation of the maximum-range launch search
+ */
+
+#include "Optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "Processing.h"
+
+namespace {
+
+const double goldenSection = 0.3819660112501051;  // (3 - √5) / 2
+
+// Steps for the finite-difference sensitivities
+const double angleStep = 0.5;  // degrees
+const double windStep = 0.5;   // m/s
+const double spinStep = 1.0;   // rad/s
+
+// Copy of params with the -y spin component set to backspin
+ProjectileParams withBackspin(const ProjectileParams& params, double backspin) {
+    ProjectileParams spun = params;
+    const Vector3D& spin = params.getSpin();
+    spun.setSpin(Vector3D(spin.x, -backspin, spin.z));
+    return spun;
+}
+
+FlightSummary fly(const ProjectileParams& params, const LaunchSearchCase& search,
+                  double elevation, const Vector3D& wind, const SearchSettings& settings) {
+    double angle = elevation * M_PI / 180.0;
+    ProjectileState start;
+    start.position = search.launch;
+    start.velocity =
+        Vector3D(search.speed * std::cos(angle), 0, search.speed * std::sin(angle));
+    return rk4Flight(params, start, settings.timeStep, wind, settings.maxTime);
+}
+
+// Brent's method: maximum of range(elevation) on [settings.angleMin, settings.angleMax]
+double brentMaximum(const ProjectileParams& params, const LaunchSearchCase& search,
+                    const SearchSettings& settings, size_t& evaluations) {
+    auto cost = [&](double elevation) {
+        evaluations++;
+        return -fly(params, search, elevation, search.wind, settings).range;
+    };
+
+    double a = settings.angleMin;
+    double b = settings.angleMax;
+    double x = a + goldenSection * (b - a);
+    double w = x;
+    double v = x;
+    double fx = cost(x);
+    double fw = fx;
+    double fv = fx;
+    double d = 0.0;
+    double e = 0.0;
+
+    while (evaluations < settings.maxEvaluations) {
+        double middle = 0.5 * (a + b);
+        double tol1 = 1e-10 * std::fabs(x) + settings.angleTolerance / 3.0;
+        double tol2 = 2.0 * tol1;
+        if (std::fabs(x - middle) <= tol2 - 0.5 * (b - a)) {
+            break;
+        }
+
+        bool golden = true;
+        if (std::fabs(e) > tol1) {
+            // Parabola through x, w and v
+            double r = (x - w) * (fx - fv);
+            double q = (x - v) * (fx - fw);
+            double p = (x - v) * q - (x - w) * r;
+            q = 2.0 * (q - r);
+            if (q > 0.0) {
+                p = -p;
+            }
+            q = std::fabs(q);
+            double previous = e;
+            e = d;
+            if (std::fabs(p) < std::fabs(0.5 * q * previous) && p > q * (a - x) &&
+                p < q * (b - x)) {
+                d = p / q;
+                double u = x + d;
+                if (u - a < tol2 || b - u < tol2) {
+                    d = std::copysign(tol1, middle - x);
+                }
+                golden = false;
+            }
+        }
+        if (golden) {
+            e = x >= middle ? a - x : b - x;
+            d = goldenSection * e;
+        }
+
+        double u = std::fabs(d) >= tol1 ? x + d : x + std::copysign(tol1, d);
+        double fu = cost(u);
+        if (fu <= fx) {
+            if (u >= x) {
+                a = x;
+            } else {
+                b = x;
+            }
+            v = w;
+            fv = fw;
+            w = x;
+            fw = fx;
+            x = u;
+            fx = fu;
+        } else {
+            if (u < x) {
+                a = u;
+            } else {
+                b = u;
+            }
+            if (fu <= fw || w == x) {
+                v = w;
+                fv = fw;
+                w = u;
+                fw = fu;
+            } else if (fu <= fv || v == x || v == w) {
+                v = u;
+                fv = fu;
+            }
+        }
+    }
+    return x;
+}
+
+// Range, flight time and sensitivities at (elevation, backspin)
+LaunchOptimum describe(const ProjectileParams& params, const LaunchSearchCase& search,
+                       const SearchSettings& settings, double elevation, double backspin,
+                       size_t evaluations) {
+    FlightSummary best = fly(params, search, elevation, search.wind, settings);
+
+    double above = fly(params, search, elevation + angleStep, search.wind, settings).range;
+    double below = fly(params, search, elevation - angleStep, search.wind, settings).range;
+
+    Vector3D tailWind = search.wind;
+    Vector3D headWind = search.wind;
+    tailWind.x += windStep;
+    headWind.x -= windStep;
+    double tail = fly(params, search, elevation, tailWind, settings).range;
+    double head = fly(params, search, elevation, headWind, settings).range;
+
+    double moreSpin =
+        fly(withBackspin(params, backspin + spinStep), search, elevation, search.wind, settings)
+            .range;
+    double lessSpin =
+        fly(withBackspin(params, backspin - spinStep), search, elevation, search.wind, settings)
+            .range;
+
+    LaunchOptimum optimum;
+    optimum.elevation = elevation;
+    optimum.backspin = backspin;
+    optimum.range = best.range;
+    optimum.flightTime = best.impact.t - search.launch.t;
+    optimum.angleCurvature = (above - 2.0 * best.range + below) / (angleStep * angleStep);
+    optimum.windSensitivity = (tail - head) / (2.0 * windStep);
+    optimum.spinSensitivity = (moreSpin - lessSpin) / (2.0 * spinStep);
+    optimum.evaluations = evaluations + 1;
+    return optimum;
+}
+
+}  // namespace
+
+LaunchOptimum optimizeAngle(const LaunchSearchCase& search, const SearchSettings& settings) {
+    size_t evaluations = 0;
+    double elevation = brentMaximum(*search.params, search, settings, evaluations);
+    double spinY = search.params->getSpin().y;
+    return describe(*search.params, search, settings, elevation, spinY == 0.0 ? 0.0 : -spinY,
+                    evaluations);
+}
+
+LaunchOptimum optimizeAngleAndSpin(const LaunchSearchCase& search,
+                                   const SearchSettings& settings) {
+    double angleSpan = settings.angleMax - settings.angleMin;
+    double spinSpan = settings.spinMax - settings.spinMin;
+    if (spinSpan <= 0.0) {
+        LaunchSearchCase fixed = search;
+        fixed.params = std::make_shared<const ProjectileParams>(
+            withBackspin(*search.params, settings.spinMin));
+        return optimizeAngle(fixed, settings);
+    }
+
+    // Simplex in unit coordinates (elevation and backspin scaled to [0, 1])
+    typedef std::array<double, 2> Point;
+    size_t evaluations = 0;
+    auto cost = [&](Point& p) {
+        p[0] = std::min(std::max(p[0], 0.0), 1.0);
+        p[1] = std::min(std::max(p[1], 0.0), 1.0);
+        evaluations++;
+        ProjectileParams params =
+            withBackspin(*search.params, settings.spinMin + p[1] * spinSpan);
+        return -fly(params, search, settings.angleMin + p[0] * angleSpan, search.wind, settings)
+                    .range;
+    };
+    auto combine = [](const Point& from, const Point& to, double t) {
+        return Point{from[0] + t * (to[0] - from[0]), from[1] + t * (to[1] - from[1])};
+    };
+
+    std::array<Point, 3> simplex = {Point{0.45, 0.5}, Point{0.6, 0.5}, Point{0.45, 0.65}};
+    std::array<double, 3> values;
+    for (size_t i = 0; i < 3; ++i) {
+        values[i] = cost(simplex[i]);
+    }
+
+    double tolerance = settings.angleTolerance / angleSpan;
+    while (evaluations < settings.maxEvaluations) {
+        // Order best (0) to worst (2)
+        for (size_t i = 1; i < 3; ++i) {
+            for (size_t j = i; j > 0 && values[j] < values[j - 1]; --j) {
+                std::swap(values[j], values[j - 1]);
+                std::swap(simplex[j], simplex[j - 1]);
+            }
+        }
+        double size = 0.0;
+        for (size_t i = 1; i < 3; ++i) {
+            size = std::max(size, std::max(std::fabs(simplex[i][0] - simplex[0][0]),
+                                           std::fabs(simplex[i][1] - simplex[0][1])));
+        }
+        if (size < tolerance) {
+            break;
+        }
+
+        Point centroid = combine(simplex[0], simplex[1], 0.5);
+        Point reflected = combine(simplex[2], centroid, 2.0);
+        double reflectedValue = cost(reflected);
+        if (reflectedValue < values[0]) {
+            Point expanded = combine(simplex[2], centroid, 3.0);
+            double expandedValue = cost(expanded);
+            if (expandedValue < reflectedValue) {
+                simplex[2] = expanded;
+                values[2] = expandedValue;
+            } else {
+                simplex[2] = reflected;
+                values[2] = reflectedValue;
+            }
+        } else if (reflectedValue < values[1]) {
+            simplex[2] = reflected;
+            values[2] = reflectedValue;
+        } else {
+            // Contract towards the better of the worst and reflected points
+            bool outside = reflectedValue < values[2];
+            Point contracted = outside ? combine(centroid, reflected, 0.5)
+                                       : combine(centroid, simplex[2], 0.5);
+            double contractedValue = cost(contracted);
+            if (contractedValue < std::min(reflectedValue, values[2])) {
+                simplex[2] = contracted;
+                values[2] = contractedValue;
+            } else {
+                // Shrink towards the best point
+                for (size_t i = 1; i < 3; ++i) {
+                    simplex[i] = combine(simplex[0], simplex[i], 0.5);
+                    values[i] = cost(simplex[i]);
+                }
+            }
+        }
+    }
+
+    size_t best = std::min_element(values.begin(), values.end()) - values.begin();
+    double backspin = settings.spinMin + simplex[best][1] * spinSpan;
+    return describe(withBackspin(*search.params, backspin), search, settings,
+                    settings.angleMin + simplex[best][0] * angleSpan, backspin, evaluations);
+}
+
+std::vector<LaunchOptimum> optimizeLaunches(const std::vector<LaunchSearchCase>& cases,
+                                            const SearchSettings& settings, bool searchSpin,
+                                            ThreadPool& pool) {
+    std::vector<LaunchOptimum> results(cases.size());
+    pool.parallelFor(cases.size(), 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = searchSpin ? optimizeAngleAndSpin(cases[i], settings)
+                                    : optimizeAngle(cases[i], settings);
+        }
+    });
+    return results;
+}
@@ -6,10 +6,23 @@
 
 #include "Processing.h"
 
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <sstream>
+
+#include "alloc_tracker.h"
+#include "Collisions.h"
+#include "FiringTable.h"
+#include "Optimizer.h"
+#include "perf_counters.h"
+#include "plugin_loader.h"
+#include "run_state.h"
+#include "Sweep.h"
 #ifndef _WIN32
 #include <unistd.h>
 #endif
@@ -24,64 +37,123 @@ using namespace std;
 // Overall, RK4 is very accurate for smooth, continuous forces but may struggle with abrupt changes unless time steps are sufficiently small.
 
 
-// Standalone RK4 integration function
+// RK4 step for any force law acceleration(velocity); used with the built-in law and with
+// plugin force laws
+template <typename Acceleration>
+static void rk4StepWith(const Acceleration& acceleration, ProjectileState& state,
+                        double timeStep) {
+    // Save current state
+    Vector4D pos0 = state.position;
+    Vector3D vel0 = state.velocity;
 
-Trajectory rk4Simulation(Projectile& proj, double timeStep, const Vector3D& wind, double maxTime) {
+    // k1: acceleration and velocity at current state
+    Vector3D k1_a = acceleration(vel0);
+    Vector3D k1_v = k1_a * timeStep;
+    Vector3D k1_x = vel0 * timeStep;
+
+    // k2: acceleration at midpoint using k1
+    Vector3D vel_mid1 = vel0 + k1_v * 0.5;
+    Vector3D k2_a = acceleration(vel_mid1);
+    Vector3D k2_v = k2_a * timeStep;
+    Vector3D k2_x = vel_mid1 * timeStep;
+
+    // k3: acceleration at midpoint using k2
+    Vector3D vel_mid2 = vel0 + k2_v * 0.5;
+    Vector3D k3_a = acceleration(vel_mid2);
+    Vector3D k3_v = k3_a * timeStep;
+    Vector3D k3_x = vel_mid2 * timeStep;
+
+    // k4: acceleration at endpoint using k3
+    Vector3D vel_end = vel0 + k3_v;
+    Vector3D k4_a = acceleration(vel_end);
+    Vector3D k4_v = k4_a * timeStep;
+    Vector3D k4_x = vel_end * timeStep;
+
+    // Weighted average of slopes
+    Vector3D new_vel = vel0 + (k1_v + k2_v * 2.0 + k3_v * 2.0 + k4_v) / 6.0;
+    Vector3D delta_r = (k1_x + k2_x * 2.0 + k3_x * 2.0 + k4_x) / 6.0;
+
+    // Update position and time in one four-lane add
+    state.position = pos0.advance(Vector4D(delta_r.x, delta_r.y, delta_r.z, timeStep));
+    state.velocity = new_vel;
+}
+
+// Shared by the trajectory, summary and cloud paths so all produce the same flight
+void rk4Step(const ProjectileParams& params, ProjectileState& state, double timeStep,
+             const Vector3D& wind) {
+    rk4StepWith([&](const Vector3D& velocity) { return params.acceleration(velocity, wind); },
+                state, timeStep);
+}
+
+Vector4D groundCrossing(const Vector4D& previous, const Vector4D& next) {
+    // Linear interpolation within the step, time included (the Vector4D operators would
+    // keep the time of the earlier point)
+    double fraction = previous.z / (previous.z - next.z);
+    return Vector4D(previous.x + (next.x - previous.x) * fraction,
+                    previous.y + (next.y - previous.y) * fraction, 0,
+                    previous.t + (next.t - previous.t) * fraction);
+}
+
+// Standalone RK4 integration function
+Trajectory rk4Simulation(const ProjectileParams& params, ProjectileState& state, double timeStep,
+                         const Vector3D& wind, double maxTime, Vector4D* landing) {
+    PerfScope scope("projectile RK4 (acceleration)");
     Trajectory trajectory;
-    trajectory.addPoint(proj.getPosition());
-
-    while (!proj.isGrounded() && proj.getTime() < maxTime) {
-        // Save current state
-        Vector4D pos0 = proj.getPosition();
-        Vector3D vel0 = proj.getVelocity();
-
-        // k1: acceleration and velocity at current state
-        Vector3D k1_a = proj.calculateAcceleration(wind);
-        Vector3D k1_v = k1_a * timeStep;
-        Vector3D k1_x = vel0 * timeStep;
-
-        // k2: acceleration at midpoint using k1
-        Vector3D vel_mid1 = vel0 + k1_v * 0.5;
-        proj.setVelocity(vel_mid1);
-        Vector3D k2_a = proj.calculateAcceleration(wind);
-        Vector3D k2_v = k2_a * timeStep;
-        Vector3D k2_x = vel_mid1 * timeStep;
-
-        // k3: acceleration at midpoint using k2
-        Vector3D vel_mid2 = vel0 + k2_v * 0.5;
-        proj.setVelocity(vel_mid2);
-        Vector3D k3_a = proj.calculateAcceleration(wind);
-        Vector3D k3_v = k3_a * timeStep;
-        Vector3D k3_x = vel_mid2 * timeStep;
-
-        // k4: acceleration at endpoint using k3
-        Vector3D vel_end = vel0 + k3_v;
-        proj.setVelocity(vel_end);
-        Vector3D k4_a = proj.calculateAcceleration(wind);
-        Vector3D k4_v = k4_a * timeStep;
-        Vector3D k4_x = vel_end * timeStep;
-
-        // Weighted average of slopes
-        Vector3D new_vel = vel0 + (k1_v + k2_v * 2.0 + k3_v * 2.0 + k4_v) / 6.0;
-        Vector3D delta_r = (k1_x + k2_x * 2.0 + k3_x * 2.0 + k4_x) / 6.0;
-
-        // Update position with time
-        Vector4D new_pos(pos0.x + delta_r.x, pos0.y + delta_r.y, pos0.z + delta_r.z,
-                         pos0.t + timeStep);
-
-        proj.move(new_pos, new_vel);
+    trajectory.addPoint(state.position);
+
+    while (!state.isGrounded() && state.position.t < maxTime) {
+        Vector4D previous = state.position;
+        rk4Step(params, state, timeStep, wind);
 
         // Ground collision check
-        if (new_pos.z < 0) {
-            new_pos.z = 0;
-            Vector3D stopped_vel(0, 0, 0);
-            proj.move(new_pos, stopped_vel);
-            break;
+        if (state.position.z < 0) {
+            if (landing != nullptr) {
+                *landing = groundCrossing(previous, state.position);
+            }
+            state.position.z = 0;
+            state.velocity = Vector3D(0, 0, 0);
+            return trajectory;
         }
 
-        trajectory.addPoint(proj.getPosition());
+        trajectory.addPoint(state.position);
+    }
+
+    if (landing != nullptr) {
+        *landing = state.position;
+    }
+    return trajectory;
+}
+
+FlightSummary rk4Flight(const ProjectileParams& params, const ProjectileState& start,
+                        double timeStep, const Vector3D& wind, double maxTime) {
+    PerfScope scope("projectile RK4 (acceleration)");
+    FlightSummary summary{start.position, 0.0, 0, false};
+    ProjectileState state = start;
+
+    while (!state.isGrounded() && state.position.t < maxTime) {
+        Vector4D previous = state.position;
+        rk4Step(params, state, timeStep, wind);
+        summary.steps++;
+
+        if (state.position.z < 0) {
+            state.position = groundCrossing(previous, state.position);
+            summary.landed = true;
+            break;
+        }
     }
 
+    summary.impact = state.position;
+    double dx = summary.impact.x - start.position.x;
+    double dy = summary.impact.y - start.position.y;
+    summary.range = std::sqrt(dx * dx + dy * dy);
+    return summary;
+}
+
+Trajectory rk4Simulation(Projectile& proj, double timeStep, const Vector3D& wind, double maxTime) {
+    AllocScope memory("trajectory");
+    ProjectileState state = proj.getState();
+    Trajectory trajectory = rk4Simulation(proj.getParams(), state, timeStep, wind, maxTime);
+    proj.setState(state);
     return trajectory;
 }
 
@@ -105,7 +177,821 @@ void addInfoToStream2(std::stringstream& info_stream, const Trajectory& trajecto
                 << std::endl;
 }
 
-Run::Run() {
+// Returns dir + stem + N + extension for the first N >= 1 that does not exist yet
+static string nextOutputFile(const string& dir, const string& stem,
+                             const string& extension = ".csv") {
+    int fileIndex = 1;
+    string filename = dir + stem + to_string(fileIndex) + extension;
+    while (ifstream(filename)) {
+        fileIndex++;
+        filename = dir + stem + to_string(fileIndex) + extension;
+    }
+    return filename;
+}
+
+// Directory for output files (./Output/ under the working directory)
+static string outputDirectory() {
+    char buffer[FILENAME_MAX];
+    getcwd(buffer, FILENAME_MAX);
+    return std::string(buffer) + "/Output/";
+}
+
+// Long sweeps and clouds record their progress in Output/<mode>.checkpoint, rewritten
+// atomically every NM_CHECKPOINT_SECONDS seconds (default 30). ./bin/main --resume
+// continues a killed run from it; the output matches an uninterrupted run.
+static double checkpointInterval() {
+    const char* env = std::getenv("NM_CHECKPOINT_SECONDS");
+    double seconds = env ? std::atof(env) : 0.0;
+    return seconds > 0.0 ? seconds : 30.0;
+}
+
+// Loads the checkpoint when resuming; false if it belongs to a run with other inputs
+static bool resumeCheckpoint(Checkpoint& checkpoint, bool resume) {
+    if (!resume) {
+        return true;
+    }
+    try {
+        if (!checkpoint.resume()) {
+            cout << "No checkpoint at " << checkpoint.path() << ", starting from scratch" << endl;
+        }
+        return true;
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl
+                  << "Enter the same inputs as the interrupted run, or run without --resume"
+                  << std::endl;
+        return false;
+    }
+}
+
+// Asks for one of the presets, launched from (0, 0, 1) without spin. presetType is the
+// menu choice, part of the checkpoint fingerprint of the resumable modes.
+static Projectile chooseProjectile(int& presetType) {
+    std::cout << "Choose projectile:" << std::endl;
+    std::cout << "1. Ping Pong Ball" << std::endl;
+    std::cout << "2. Baseball" << std::endl;
+    std::cin >> presetType;
+
+    Vector4D launch(0, 0, 1, 0);
+    Vector3D noSpin(0, 0, 0);
+    return presetType == 2 ? Projectile(Baseball(launch, Vector3D(), noSpin))
+                           : Projectile(pingPongBall(launch, Vector3D(), noSpin));
+}
+
+static Projectile chooseProjectile() {
+    int presetType;
+    return chooseProjectile(presetType);
+}
+
+// Asks for the worker count of the thread pool (0 = all CPUs)
+static size_t chooseThreads() {
+    std::cout << "Enter number of threads (0 = all CPUs): ";
+    size_t threads;
+    std::cin >> threads;
+    return threads;
+}
+
+// Interactive launch-angle sweep: many simulations in parallel, summary only
+static void runAngleSweep(bool resume) {
+    std::cout << "Sweep mode selected." << std::endl;
+    int presetType;
+    Projectile base = chooseProjectile(presetType);
+
+    double speed, angleMin, angleMax;
+    size_t count;
+    std::cout << "Enter launch speed (m/s): ";
+    std::cin >> speed;
+    std::cout << "Enter first and last elevation angle (degrees): ";
+    std::cin >> angleMin >> angleMax;
+    std::cout << "Enter number of angles: ";
+    std::cin >> count;
+    size_t threads = chooseThreads();
+    std::cout << "Save every trajectory as well as the summary?" << std::endl;
+    std::cout << "(n = no, y = one CSV per angle, a = single indexed archive): ";
+    char saveAll;
+    std::cin >> saveAll;
+
+    double timeStep = 0.001;
+    double maxTime = 60.0;
+    Vector3D wind(0, 0, 0);
+
+    ThreadPoolOptions options;
+    options.threads = threads;
+    ThreadPool pool(options);
+    std::vector<SweepCase> cases = angleSweep(base, speed, angleMin, angleMax, count, wind);
+
+    // Summary-only sweeps can be resumed; the trajectory files and archives of the
+    // other modes are written as the sweep runs and are not checkpointed
+    bool summaryOnly = saveAll != 'y' && saveAll != 'Y' && saveAll != 'a' && saveAll != 'A';
+    double inputs[] = {static_cast<double>(presetType), speed, angleMin, angleMax,
+                       static_cast<double>(count), timeStep, maxTime};
+    Checkpoint checkpoint(outputDirectory() + "sweep.checkpoint",
+                          checkpointHash(inputs, sizeof(inputs)), count, sweepCheckpointValues,
+                          checkpointInterval());
+    if (summaryOnly && !resumeCheckpoint(checkpoint, resume)) {
+        return;
+    }
+    if (!summaryOnly && resume) {
+        cout << "Only summary sweeps are checkpointed: running from scratch" << endl;
+    }
+
+    // A resumed sweep writes the summary file the interrupted one would have written
+    string filename = checkpoint.label().empty() ? nextOutputFile(outputDirectory(), "sweep")
+                                                 : checkpoint.label();
+    checkpoint.setLabel(filename);
+    if (checkpoint.doneCount() > 0) {
+        cout << "Resuming: " << checkpoint.doneCount() << " of " << count
+             << " angles already done" << endl;
+    }
+    std::vector<SweepResult> results;
+    string stem = filename.substr(0, filename.size() - 4);
+    if (saveAll == 'y' || saveAll == 'Y') {
+        // Trajectories go to sweepN_0.csv, sweepN_1.csv, ... in batches (io_uring if available)
+        BulkFileWriter files;
+        SweepOutput output;
+        output.files = &files;
+        output.trajectoryStem = stem + "_";
+        results = runSweep(cases, timeStep, maxTime, pool, output);
+        size_t failures = files.flush();
+        cout << files.filesWritten() << " trajectories saved to: " << output.trajectoryStem
+             << "*.csv (" << BulkFileWriter::backendName(files.backend()) << ")" << endl;
+        if (failures > 0) {
+            cerr << failures << " trajectory files could not be written" << endl;
+        }
+    } else if (saveAll == 'a' || saveAll == 'A') {
+        // All trajectories in sweepN.nmra, indexed by case number and launch parameters
+        try {
+            RunArchiveWriter archive(stem + ".nmra", sweepArchiveLayout());
+            SweepOutput output;
+            output.archive = &archive;
+            results = runSweep(cases, timeStep, maxTime, pool, output);
+            archive.close();
+            cout << archive.runs() << " trajectories saved to: " << stem << ".nmra" << endl;
+        } catch (const std::exception& error) {
+            std::cerr << "Error: " << error.what() << std::endl;
+            return;
+        }
+    } else {
+        SweepOutput output;
+        output.checkpoint = &checkpoint;
+        results = runSweep(cases, timeStep, maxTime, pool, output);
+    }
+    ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return;
+    }
+    file << "#Projectile Motion Angle Sweep" << std::endl
+         << "#Launch Speed (m/s): " << speed << std::endl
+         << "#Threads: " << pool.size() << " on " << pool.nodeCount() << " NUMA node(s)"
+         << std::endl;
+    file << "Angle,FlightTime,Range,X,Y" << std::endl;
+    size_t best = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        double fraction = count > 1 ? static_cast<double>(i) / (count - 1) : 0.0;
+        file << angleMin + fraction * (angleMax - angleMin) << "," << results[i].impact.t << ","
+             << results[i].range << "," << results[i].impact.x << "," << results[i].impact.y
+             << std::endl;
+        if (results[i].range > results[best].range) {
+            best = i;
+        }
+    }
+    file.close();
+    if (summaryOnly) {
+        checkpoint.discard();  // Complete: nothing left to resume
+    }
+    cout << "Sweep data saved to: " << filename << endl;
+    if (!results.empty()) {
+        double fraction = count > 1 ? static_cast<double>(best) / (count - 1) : 0.0;
+        cout << "Longest range " << results[best].range << " m at "
+             << angleMin + fraction * (angleMax - angleMin) << " degrees" << endl;
+    }
+}
+
+bool runLaunchTable(const string& path, size_t threads) {
+    ThreadPoolOptions options;
+    options.threads = threads;
+    ThreadPool pool(options);
+
+    auto start = std::chrono::steady_clock::now();
+    CsvTable table;
+    try {
+        table = CsvTable::load(path, &pool);
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return false;
+    }
+    double loadSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Columns the table leaves out come from the baseball preset, launched from (0, 0, 1)
+    Projectile base(Baseball(Vector4D(0, 0, 1, 0), Vector3D(), Vector3D(0, 0, 0)));
+    std::vector<SweepCase> cases;
+    if (!tableSweep(table, base, cases)) {
+        return false;
+    }
+    cout << table.rows() << " launches loaded from " << path << " in " << loadSeconds << " s"
+         << endl;
+
+    double timeStep = 0.001;
+    double maxTime = 60.0;
+    std::vector<SweepResult> results = runSweep(cases, timeStep, maxTime, pool);
+
+    string filename = nextOutputFile(outputDirectory(), "batch");
+    ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+    file << "#Projectile Launch Batch" << std::endl
+         << "#Launch Table: " << path << std::endl
+         << "#Threads: " << pool.size() << " on " << pool.nodeCount() << " NUMA node(s)"
+         << std::endl;
+    file << "Row,FlightTime,Range,X,Y" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        file << i << "," << results[i].impact.t - cases[i].start.position.t << ","
+             << results[i].range << "," << results[i].impact.x << "," << results[i].impact.y
+             << std::endl;
+    }
+    file.close();
+    cout << "Batch results saved to: " << filename << endl;
+    return true;
+}
+
+// Interactive firing table: build over speed, elevation and wind, then answer queries
+static void runFiringTable() {
+    std::cout << "Firing table mode selected." << std::endl;
+    Projectile base = chooseProjectile();
+
+    TableAxis speed{TableParameter::Speed, 0, 0, 0};
+    TableAxis elevation{TableParameter::Elevation, 0, 0, 0};
+    TableAxis wind{TableParameter::WindX, 0, 0, 0};
+    std::cout << "Enter first and last launch speed (m/s) and number of speeds: ";
+    std::cin >> speed.min >> speed.max >> speed.count;
+    std::cout << "Enter first and last elevation angle (degrees) and number of angles: ";
+    std::cin >> elevation.min >> elevation.max >> elevation.count;
+    std::cout << "Enter first and last wind along x (m/s) and number of winds: ";
+    std::cin >> wind.min >> wind.max >> wind.count;
+    size_t threads = chooseThreads();
+
+    ThreadPoolOptions options;
+    options.threads = threads;
+    ThreadPool pool(options);
+    FiringTable table;
+    try {
+        table = FiringTable::build(base, {speed, elevation, wind}, 0.001, 60.0, pool);
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return;
+    }
+
+    string filename = nextOutputFile(outputDirectory(), "firingtable", ".bin");
+    if (table.save(filename)) {
+        cout << table.size() << " launches saved to: " << filename << endl;
+    }
+
+    FiringTableError error = table.measureError(200, pool);
+    cout << "Interpolation error over " << error.samples << " random launches:" << endl
+         << "  Range:       max " << error.maxRangeError << " m, mean " << error.meanRangeError
+         << " m" << endl
+         << "  Flight time: max " << error.maxTimeError << " s, mean " << error.meanTimeError
+         << " s" << endl
+         << "  Lookup " << error.lookupMicroseconds << " us vs simulation "
+         << error.simulationMicroseconds << " us" << endl;
+
+    // One value per axis of the table, in its axis order
+    const std::vector<TableAxis>& axes = table.getAxes();
+    string prompt = "Enter";
+    for (size_t d = 0; d < axes.size(); ++d) {
+        prompt += d == 0 ? " " : d + 1 < axes.size() ? ", " : " and ";
+        prompt += tableParameterName(axes[d].parameter);
+    }
+    prompt += " to look up (non-number to quit): ";
+    std::vector<double> point(axes.size());
+    while (true) {
+        std::cout << prompt;
+        bool read = true;
+        for (double& value : point) {
+            read = read && static_cast<bool>(std::cin >> value);
+        }
+        if (!read) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            break;
+        }
+        FiringSolution solution = table.lookup(point);
+        cout << "Range " << solution.range << " m, flight time " << solution.flightTime
+             << " s, impact (" << solution.impactX << ", " << solution.impactY << ")" << endl;
+    }
+}
+
+// Interactive optimum search: maximum-range launch for every speed and wind in a grid
+static void runLaunchOptimizer() {
+    std::cout << "Optimizer mode selected." << std::endl;
+    Projectile base = chooseProjectile();
+
+    double speedMin, speedMax, windMin, windMax;
+    size_t speedCount, windCount;
+    std::cout << "Enter first and last launch speed (m/s) and number of speeds: ";
+    std::cin >> speedMin >> speedMax >> speedCount;
+    std::cout << "Enter first and last wind along x (m/s) and number of winds: ";
+    std::cin >> windMin >> windMax >> windCount;
+    SearchSettings settings;
+    std::cout << "Search backspin as well? (y/n): ";
+    char searchSpin;
+    std::cin >> searchSpin;
+    bool withSpin = searchSpin == 'y' || searchSpin == 'Y';
+    if (withSpin) {
+        std::cout << "Enter lowest and highest backspin (rad/s): ";
+        std::cin >> settings.spinMin >> settings.spinMax;
+    }
+    size_t threads = chooseThreads();
+
+    auto params = std::make_shared<const ProjectileParams>(base.getParams());
+    Vector4D launch = base.getPosition();
+    std::vector<LaunchSearchCase> cases;
+    for (size_t i = 0; i < speedCount; ++i) {
+        double speed = speedCount > 1 ? speedMin + (speedMax - speedMin) * i / (speedCount - 1)
+                                      : speedMin;
+        for (size_t j = 0; j < windCount; ++j) {
+            double wind =
+                windCount > 1 ? windMin + (windMax - windMin) * j / (windCount - 1) : windMin;
+            cases.push_back(LaunchSearchCase{params, launch, speed, Vector3D(wind, 0, 0)});
+        }
+    }
+
+    ThreadPoolOptions options;
+    options.threads = threads;
+    ThreadPool pool(options);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<LaunchOptimum> optima = optimizeLaunches(cases, settings, withSpin, pool);
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    string filename = nextOutputFile(outputDirectory(), "optimum");
+    ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return;
+    }
+    file << "#Projectile Motion Maximum-Range Search" << std::endl
+         << "#Threads: " << pool.size() << " on " << pool.nodeCount() << " NUMA node(s)"
+         << std::endl;
+    file << "Speed,WindX,Elevation,Backspin,Range,FlightTime,AngleCurvature,WindSensitivity,"
+            "SpinSensitivity,Evaluations"
+         << std::endl;
+    size_t evaluations = 0;
+    for (size_t i = 0; i < optima.size(); ++i) {
+        const LaunchOptimum& best = optima[i];
+        file << cases[i].speed << "," << cases[i].wind.x << "," << best.elevation << ","
+             << best.backspin << "," << best.range << "," << best.flightTime << ","
+             << best.angleCurvature << "," << best.windSensitivity << ","
+             << best.spinSensitivity << "," << best.evaluations << std::endl;
+        evaluations += best.evaluations;
+    }
+    file.close();
+    cout << optima.size() << " configurations optimized in " << seconds << " s ("
+         << evaluations << " flights)" << endl;
+    cout << "Optima saved to: " << filename << endl;
+    if (!optima.empty()) {
+        const LaunchOptimum& first = optima.front();
+        cout << "First case: " << first.range << " m at " << first.elevation << " degrees, "
+             << first.backspin << " rad/s backspin (range changes by "
+             << 0.5 * first.angleCurvature << " m at +/-1 degree)" << endl;
+    }
+}
+
+static void runProjectileCloud(bool resume) {
+    std::cout << "Cloud mode selected." << std::endl;
+    int presetType;
+    Projectile base = chooseProjectile(presetType);
+
+    size_t count;
+    double speed, spread;
+    std::cout << "Enter number of projectiles: ";
+    std::cin >> count;
+    std::cout << "Enter launch speed (m/s) and spread of the cone around 45 degrees (deg): ";
+    std::cin >> speed >> spread;
+    size_t threads = chooseThreads();
+
+    // Launch from a small ball around the launch point, denser for more projectiles
+    const double pi = std::acos(-1.0);
+    double radius = base.getRadius();
+    double clusterRadius = 4.0 * radius * std::cbrt(static_cast<double>(count));
+    std::mt19937 random(2026);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    Vector4D launch = base.getPosition();
+    ProjectileCloud cloud;
+    for (size_t i = 0; i < count; ++i) {
+        Vector3D offset;
+        do {
+            offset = Vector3D(unit(random), unit(random), unit(random));
+        } while (offset.magnitude() > 1.0);
+        double elevation = (45.0 + 0.5 * spread * unit(random)) * pi / 180.0;
+        double heading = 0.5 * spread * unit(random) * pi / 180.0;
+        ProjectileState state;
+        state.position = Vector4D(offset.x * clusterRadius, offset.y * clusterRadius,
+                                  launch.z + clusterRadius + offset.z * clusterRadius, 0);
+        state.velocity = Vector3D(speed * std::cos(elevation) * std::cos(heading),
+                                  speed * std::cos(elevation) * std::sin(heading),
+                                  speed * std::sin(elevation));
+        cloud.add(Projectile(base.getParams(), state));
+    }
+
+    ThreadPoolOptions options;
+    options.threads = threads;
+    ThreadPool pool(options);
+    const double timeStep = 0.001;
+    const double maxTime = 60.0;
+    size_t collisions = 0, steps = 0, candidates = 0;
+
+    // The cloud moves in lock step, so its checkpoint is the whole ensemble: the step
+    // counters, then time, position, velocity and collision count of every projectile
+    const size_t perProjectile = 8;
+    double inputs[] = {static_cast<double>(presetType), static_cast<double>(count), speed,
+                       spread, timeStep, maxTime};
+    Checkpoint checkpoint(outputDirectory() + "cloud.checkpoint",
+                          checkpointHash(inputs, sizeof(inputs)), 0, 0, checkpointInterval());
+    if (!resumeCheckpoint(checkpoint, resume)) {
+        return;
+    }
+    std::vector<double>& saved = checkpoint.state();
+    if (saved.size() == 3 + perProjectile * count) {
+        steps = static_cast<size_t>(saved[0]);
+        collisions = static_cast<size_t>(saved[1]);
+        candidates = static_cast<size_t>(saved[2]);
+        std::vector<ProjectileState> states(count);
+        std::vector<size_t> hits(count);
+        for (size_t i = 0; i < count; ++i) {
+            const double* v = &saved[3 + perProjectile * i];
+            states[i].position = Vector4D(v[1], v[2], v[3], v[0]);
+            states[i].velocity = Vector3D(v[4], v[5], v[6]);
+            hits[i] = static_cast<size_t>(v[7]);
+        }
+        cloud.restore(states, hits);
+        cout << "Resuming at t = " << steps * timeStep << " s" << endl;
+    }
+
+    bool reportedError = false;
+    auto start = std::chrono::steady_clock::now();
+    while (!cloud.allGrounded() && steps * timeStep < maxTime) {
+        collisions += cloud.step(timeStep, Vector3D(0, 0, 0), pool);
+        candidates += cloud.getGrid().candidatePairs();
+        steps++;
+        if (!checkpoint.due()) {
+            continue;
+        }
+        saved = {static_cast<double>(steps), static_cast<double>(collisions),
+                 static_cast<double>(candidates)};
+        for (size_t i = 0; i < count; ++i) {
+            const ProjectileState& state = cloud.getStates()[i];
+            saved.insert(saved.end(),
+                         {state.position.t, state.position.x, state.position.y,
+                          state.position.z, state.velocity.x, state.velocity.y,
+                          state.velocity.z, static_cast<double>(cloud.getHits()[i])});
+        }
+        try {
+            checkpoint.save();
+        } catch (const std::exception& error) {
+            if (!reportedError) {
+                std::cerr << "Warning: " << error.what() << " (checkpointing continues)"
+                          << std::endl;
+                reportedError = true;
+            }
+        }
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    string filename = nextOutputFile(outputDirectory(), "cloud");
+    ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return;
+    }
+    file << "#Projectile Cloud Simulation" << std::endl
+         << "#Projectiles: " << count << ", steps: " << steps << ", collisions: " << collisions
+         << std::endl;
+    file << "Index,FlightTime,X,Y,Collisions" << std::endl;
+    const std::vector<ProjectileState>& states = cloud.getStates();
+    for (size_t i = 0; i < states.size(); ++i) {
+        file << i << "," << states[i].position.t << "," << states[i].position.x << ","
+             << states[i].position.y << "," << cloud.getHits()[i] << std::endl;
+    }
+    file.close();
+    checkpoint.discard();
+    cout << count << " projectiles, " << steps << " steps in " << seconds << " s ("
+         << pool.size() << " thread(s))" << endl;
+    cout << collisions << " collisions from " << candidates << " candidate pairs" << endl;
+    cout << "Landing points saved to: " << filename << endl;
+}
+
+// ==================== Saved flights (continue / branch) ====================
+
+// Trajectory runs keep their exact final state and a snapshot every snapshotEvery steps
+// in trajectoryN.state, so a flight that hit maxTime can be continued and any flight can
+// be branched at an earlier time without integrating from launch again
+static const uint64_t snapshotEvery = 1000;
+
+static std::vector<double> stateValues(const ProjectileState& state) {
+    return {state.position.t, state.position.x, state.position.y, state.position.z,
+            state.velocity.x, state.velocity.y, state.velocity.z};
+}
+
+static ProjectileState stateFromValues(const std::vector<double>& values) {
+    ProjectileState state;
+    state.position = Vector4D(values.at(1), values.at(2), values.at(3), values.at(0));
+    state.velocity = Vector3D(values.at(4), values.at(5), values.at(6));
+    return state;
+}
+
+static void describeFlight(RunState& saved, const ProjectileParams& params,
+                           const Vector3D& wind, double timeStep, double maxTime) {
+    const Vector3D& spin = params.getSpin();
+    saved.model = "projectile";
+    saved.parameters = {{"mass", params.getMass()},
+                        {"radius", params.getRadius()},
+                        {"drag_coefficient", params.getDragCoefficient()},
+                        {"air_density", params.getAirDensity()},
+                        {"spin_factor", params.getS()},
+                        {"spin_x", spin.x},
+                        {"spin_y", spin.y},
+                        {"spin_z", spin.z},
+                        {"wind_x", wind.x},
+                        {"wind_y", wind.y},
+                        {"wind_z", wind.z}};
+    saved.names = {"Time", "X", "Y", "Z", "VX", "VY", "VZ"};
+    saved.timeStep = timeStep;
+    saved.endTime = maxTime;
+}
+
+// Rebuilt with the setters so the cached coefficients come out bit for bit the same
+static ProjectileParams paramsFromRun(const RunState& saved) {
+    ProjectileParams params;
+    params.setMass(saved.parameter("mass"));
+    params.setRadius(saved.parameter("radius"));
+    params.setDragCoefficient(saved.parameter("drag_coefficient"));
+    params.setAirDensity(saved.parameter("air_density"));
+    params.setSpinFactor(saved.parameter("spin_factor"));
+    params.setSpin(Vector3D(saved.parameter("spin_x"), saved.parameter("spin_y"),
+                            saved.parameter("spin_z")));
+    return params;
+}
+
+static Vector3D windFromRun(const RunState& saved) {
+    return Vector3D(saved.parameter("wind_x"), saved.parameter("wind_y"),
+                    saved.parameter("wind_z"));
+}
+
+// The rk4Simulation loop, also counting steps and taking snapshots in saved
+static void flyRecorded(const ProjectileParams& params, ProjectileState& state,
+                        const Vector3D& wind, double maxTime, Trajectory& trajectory,
+                        RunState& saved) {
+    while (!state.isGrounded() && state.position.t < maxTime) {
+        rk4Step(params, state, saved.timeStep, wind);
+        saved.steps++;
+
+        if (state.position.z < 0) {
+            state.position.z = 0;
+            state.velocity = Vector3D(0, 0, 0);
+            break;
+        }
+
+        trajectory.addPoint(state.position);
+        saved.snapshot(saved.steps, stateValues(state), snapshotEvery);
+    }
+    saved.state = stateValues(state);
+    saved.endTime = maxTime;
+}
+
+// Same flight as rk4Simulation(proj, ...), with everything needed to continue it in saved
+static Trajectory simulateRecorded(Projectile& proj, double timeStep, const Vector3D& wind,
+                                   double maxTime, RunState& saved) {
+    ProjectileState state = proj.getState();
+    describeFlight(saved, proj.getParams(), wind, timeStep, maxTime);
+    saved.steps = 0;
+    saved.snapshots = {RunState::Snapshot{0, stateValues(state)}};
+
+    Trajectory trajectory;
+    trajectory.addPoint(state.position);
+    flyRecorded(proj.getParams(), state, wind, maxTime, trajectory, saved);
+    proj.setState(state);
+    return trajectory;
+}
+
+// trajectoryN.csv -> trajectoryN.state
+static string statePathFor(const string& csv) {
+    return csv.substr(0, csv.find_last_of('.')) + ".state";
+}
+
+static bool saveFlight(RunState& saved, const string& csv) {
+    saved.output = csv;
+    try {
+        saved.save(statePathFor(csv));
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Continues a saved flight to a later maxTime (appending to its CSV), or starts a new
+// flight from its state at an earlier time with a different wind
+static void runSavedFlight() {
+    std::cout << "Enter the trajectory number to continue or branch: ";
+    int number;
+    std::cin >> number;
+    string csv = outputDirectory() + "trajectory" + to_string(number) + ".csv";
+    RunState saved;
+    try {
+        saved = RunState::load(statePathFor(csv));
+        if (saved.model != "projectile" || saved.state.size() != 7) {
+            throw std::runtime_error(statePathFor(csv) + " is not a projectile run");
+        }
+        paramsFromRun(saved);
+        windFromRun(saved);
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return;
+    }
+    const ProjectileParams params = paramsFromRun(saved);
+    ProjectileState state = stateFromValues(saved.state);
+    std::cout << "Saved flight ends at t = " << state.position.t << " s, z = " << state.position.z
+              << " m after " << saved.steps << " steps" << std::endl;
+    std::cout << "1. Continue to a later maximum time" << std::endl;
+    std::cout << "2. Branch from an earlier time with a new wind" << std::endl;
+    int choice;
+    std::cin >> choice;
+
+    if (choice == 1) {
+        if (state.isGrounded()) {
+            std::cout << "The projectile has already landed; nothing to continue." << std::endl;
+            return;
+        }
+        std::cout << "Enter the new maximum simulation time (in seconds): ";
+        double maxTime;
+        std::cin >> maxTime;
+        Trajectory extension;
+        flyRecorded(params, state, windFromRun(saved), maxTime, extension, saved);
+
+        // Rewrite the CSV: the #Final lines now describe the new end point, and the new
+        // rows, formatted like Trajectory::CSVString, follow the existing ones
+        std::stringstream finalInfo;
+        if (!extension.getPoints().empty()) {
+            addInfoToStream2(finalInfo, extension);
+        }
+        std::stringstream text;
+        {
+            ifstream in(csv);
+            if (!in.is_open()) {
+                std::cerr << "Error: Could not open file " << csv << std::endl;
+                return;
+            }
+            string line;
+            while (std::getline(in, line)) {
+                if (line.rfind("#Final Position (m): ", 0) == 0 && finalInfo.tellp() > 0) {
+                    continue;
+                }
+                if (line.rfind("#Final Time (s): ", 0) == 0 && finalInfo.tellp() > 0) {
+                    text << finalInfo.str();
+                    continue;
+                }
+                text << line << '\n';
+            }
+        }
+        for (const Vector4D& point : extension.getPoints()) {
+            text << point.t << "," << point.x << "," << point.y << "," << point.z << '\n';
+        }
+        ofstream file(csv);
+        file << text.str();
+        file.close();
+        if (!file || !saveFlight(saved, csv)) {
+            std::cerr << "Error: Could not update " << csv << std::endl;
+            return;
+        }
+        cout << extension.getPoints().size() << " points appended to " << csv
+             << "; now ends at t = " << state.position.t << " s" << endl;
+        return;
+    }
+    if (choice != 2) {
+        std::cout << "Invalid choice. Exiting." << std::endl;
+        return;
+    }
+
+    double branchTime, wx, wy, wz, maxTime;
+    std::cout << "Enter the branch time (in seconds): ";
+    std::cin >> branchTime;
+    std::cout << "Enter the new wind velocity (wx wy wz in meters per second): ";
+    std::cin >> wx >> wy >> wz;
+    std::cout << "Enter the maximum simulation time (in seconds): ";
+    std::cin >> maxTime;
+
+    // Replay from the last snapshot before the branch time with the original wind
+    const RunState::Snapshot* snap = saved.snapshotBefore(branchTime);
+    if (!snap || branchTime > state.position.t) {
+        std::cerr << "Error: the saved flight does not reach t = " << branchTime << " s"
+                  << std::endl;
+        return;
+    }
+    RunState branch = saved;
+    branch.steps = snap->step;
+    state = stateFromValues(snap->state);
+    Vector3D oldWind = windFromRun(saved);
+    while (!state.isGrounded() && state.position.t < branchTime) {
+        rk4Step(params, state, saved.timeStep, oldWind);
+        branch.steps++;
+    }
+    if (state.position.z < 0) {
+        std::cerr << "Error: the projectile lands before t = " << branchTime << " s" << std::endl;
+        return;
+    }
+
+    Vector3D wind(wx, wy, wz);
+    describeFlight(branch, params, wind, saved.timeStep, maxTime);
+    branch.snapshots = {RunState::Snapshot{branch.steps, stateValues(state)}};
+    Trajectory trajectory;
+    trajectory.addPoint(state.position);
+    flyRecorded(params, state, wind, maxTime, trajectory, branch);
+
+    std::stringstream info_stream;
+    info_stream << "#Projectile Motion Simulation Data" << std::endl
+                << "#Branch of trajectory" << number << " at t = " << trajectory.getPoints()[0].t
+                << " s, wind (" << wx << ", " << wy << ", " << wz << ") m/s" << std::endl;
+    addInfoToStream2(info_stream, trajectory);
+    string filename = nextOutputFile(outputDirectory(), "trajectory");
+    trajectory.CSVPrint(filename, info_stream.str());
+    if (saveFlight(branch, filename)) {
+        cout << "Branch saved to: " << filename << endl;
+    }
+}
+
+// Flight under a force law from a native plugin (../include/model_plugin.h); fills
+// trajectory and info like the built-in modes. Returns false if nothing was simulated.
+static bool runPluginFlight(const PluginRegistry& registry, Trajectory& trajectory,
+                            std::stringstream& info_stream) {
+    std::vector<const PluginModel*> laws;
+    for (const PluginModel& model : registry.models()) {
+        if (model.kind() == NM_MODEL_ACCELERATION) {
+            laws.push_back(&model);
+        }
+    }
+    if (laws.empty()) {
+        std::cerr << "Error: no force-law plugins found. Build them with 'make plugins' in the "
+                     "workspace root or set NM_PLUGIN_PATH."
+                  << std::endl;
+        return false;
+    }
+    std::cout << "Choose force law:" << std::endl;
+    for (size_t i = 0; i < laws.size(); ++i) {
+        std::cout << i + 1 << ". " << laws[i]->name() << " - " << laws[i]->description()
+                  << std::endl;
+    }
+    size_t choice;
+    std::cin >> choice;
+    if (choice < 1 || choice > laws.size()) {
+        std::cout << "Invalid choice. Exiting." << std::endl;
+        return false;
+    }
+    const PluginModel& law = *laws[choice - 1];
+
+    double x, y, z, vx, vy, vz, wx, wy, wz, timeStep, maxTime;
+    std::cout << "Enter initial position (x y z in meters): ";
+    std::cin >> x >> y >> z;
+    std::cout << "Enter initial velocity (vx vy vz in meters per second): ";
+    std::cin >> vx >> vy >> vz;
+    std::cout << "Enter wind velocity (wx wy wz in meters per second): ";
+    std::cin >> wx >> wy >> wz;
+    std::cout << "Enter time step and maximum simulation time (in seconds): ";
+    std::cin >> timeStep >> maxTime;
+
+    info_stream << "#Plugin Force Law: " << law.name() << " (" << law.path() << ")" << std::endl;
+    for (size_t i = 0; i < law.parameters().size(); ++i) {
+        info_stream << "#" << law.parameterNames()[i] << ": " << law.parameters()[i] << std::endl;
+    }
+
+    // Same steps and ground rule as rk4Simulation, with the plugin supplying the acceleration
+    ProjectileState state;
+    state.position = Vector4D(x, y, z, 0);
+    state.velocity = Vector3D(vx, vy, vz);
+    auto acceleration = [&](const Vector3D& velocity) {
+        double in[6] = {velocity.x, velocity.y, velocity.z, wx, wy, wz}, a[3];
+        law.evaluate(state.position.t, in, a);
+        return Vector3D(a[0], a[1], a[2]);
+    };
+    trajectory.addPoint(state.position);
+    while (!state.isGrounded() && state.position.t < maxTime) {
+        rk4StepWith(acceleration, state, timeStep);
+        if (state.position.z < 0) {
+            state.position.z = 0;
+            state.velocity = Vector3D(0, 0, 0);
+            break;
+        }
+        trajectory.addPoint(state.position);
+    }
+    addInfoToStream2(info_stream, trajectory);
+    return true;
+}
+
+Run::Run(bool resume) {
     std::cout << "Realistic Projectile Motion Simulation" << std::endl;
     std::cout << "======================================" << std::endl;
     std::cout << "Note: All units are in SI (meters, seconds, m/s, etc.)" << std::endl << std::endl;
@@ -114,11 +1000,29 @@ Run::Run() {
     std::cout << "1. Run the program to validate the model" << std::endl;
     std::cout << "2. Run a custom simulation" << std::endl;
     std::cout << "3. Run a preset simulation" << std::endl;
+    std::cout << "4. Run a launch-angle sweep" << std::endl;
+    std::cout << "5. Build a firing table" << std::endl;
+    std::cout << "6. Find the maximum-range launch" << std::endl;
+    std::cout << "7. Simulate a cloud of colliding projectiles" << std::endl;
+
+    // Force-law plugins are found once at startup: $NM_PLUGIN_PATH, then the workspace's
+    // bin/plugins (built by make plugins in the workspace root)
+    PluginRegistry plugins;
+    for (const std::string& dir : PluginRegistry::searchPath("../bin/plugins")) {
+        plugins.discover(dir);
+    }
+    for (const std::string& problem : plugins.errors()) {
+        std::cerr << "Warning: " << problem << std::endl;
+    }
+    std::cout << "8. Fly with a plugin force law (" << plugins.models().size()
+              << " plugin model(s) found)" << std::endl;
+    std::cout << "9. Continue or branch a saved trajectory" << std::endl;
 
     int mode;
     std::cin >> mode;
 
     Trajectory trajectory;
+    RunState saved;  // Filled by the built-in force-law modes, written next to the CSV
 
     std::stringstream info_stream;
     info_stream << "#Projectile Motion Simulation Data" << std::endl;
@@ -142,7 +1046,7 @@ Run::Run() {
                     info_stream << "#Validation Type: Without Air Resistance" << std::endl;
                     addInfoToStream(info_stream, valadation);
 
-                    trajectory = rk4Simulation(valadation, timeStep, wind, maxTime);
+                    trajectory = simulateRecorded(valadation, timeStep, wind, maxTime, saved);
 
                     addInfoToStream2(info_stream, trajectory);
                     break;
@@ -152,7 +1056,7 @@ Run::Run() {
                     info_stream << "#Validation Type: With Air Resistance" << std::endl;
                     addInfoToStream(info_stream, valadation);
 
-                    trajectory = rk4Simulation(valadation, timeStep, wind, maxTime);
+                    trajectory = simulateRecorded(valadation, timeStep, wind, maxTime, saved);
 
                     addInfoToStream2(info_stream, trajectory);
                     break;
@@ -162,7 +1066,7 @@ Run::Run() {
                     info_stream << "#Validation Type: With Magnus Effect" << std::endl;
                     addInfoToStream(info_stream, valadation);
 
-                    trajectory = rk4Simulation(valadation, timeStep, wind, maxTime);
+                    trajectory = simulateRecorded(valadation, timeStep, wind, maxTime, saved);
 
                     addInfoToStream2(info_stream, trajectory);
                     break;
@@ -172,7 +1076,7 @@ Run::Run() {
                     info_stream << "#Validation Type: With Magnus Effect" << std::endl;
                     addInfoToStream(info_stream, valadation);
 
-                    trajectory = rk4Simulation(valadation, timeStep, wind, maxTime);
+                    trajectory = simulateRecorded(valadation, timeStep, wind, maxTime, saved);
 
                     addInfoToStream2(info_stream, trajectory);
 
@@ -246,7 +1150,7 @@ Run::Run() {
             info_stream << "#Custom Simulation" << std::endl;
             addInfoToStream(info_stream, customProj);
 
-            trajectory = rk4Simulation(customProj, timeStep, wind, maxTime);
+            trajectory = simulateRecorded(customProj, timeStep, wind, maxTime, saved);
 
             addInfoToStream2(info_stream, trajectory);
             break;
@@ -268,7 +1172,7 @@ Run::Run() {
                     info_stream << "#Preset: Ping Pong Ball" << std::endl;
                     addInfoToStream(info_stream, pingPong);
 
-                    trajectory = rk4Simulation(pingPong, timeStep, wind, maxTime);
+                    trajectory = simulateRecorded(pingPong, timeStep, wind, maxTime, saved);
 
                     addInfoToStream2(info_stream, trajectory);
                     break;
@@ -279,7 +1183,7 @@ Run::Run() {
                     info_stream << "#Preset: Baseball" << std::endl;
                     addInfoToStream(info_stream, baseball);
 
-                    trajectory = rk4Simulation(baseball, timeStep, wind, maxTime);
+                    trajectory = simulateRecorded(baseball, timeStep, wind, maxTime, saved);
 
                     addInfoToStream2(info_stream, trajectory);
                     break;
@@ -287,24 +1191,44 @@ Run::Run() {
             }
             break;
         }
+        case 4: {
+            runAngleSweep(resume);
+            return;
+        }
+        case 5: {
+            runFiringTable();
+            return;
+        }
+        case 6: {
+            runLaunchOptimizer();
+            return;
+        }
+        case 7: {
+            runProjectileCloud(resume);
+            return;
+        }
+        case 8: {
+            std::cout << "Plugin force law mode selected." << std::endl;
+            if (!runPluginFlight(plugins, trajectory, info_stream)) {
+                return;
+            }
+            break;
+        }
+        case 9: {
+            runSavedFlight();
+            return;
+        }
     }
 
-    // get the current directory
-    char buffer[FILENAME_MAX];
-    std::string dir;
-    getcwd(buffer, FILENAME_MAX);
-    dir = std::string(buffer) + "/Output/";
-    string filename = dir + "trajectory" + to_string(1) + ".csv";
-
-    // Iterate through filenames to avoid overwriting existing files
-    while (ifstream(filename)) {
-        static int fileIndex = 2;
-        filename = dir + "trajectory" + to_string(fileIndex) + ".csv";
-        fileIndex++;
-    }
+    // Pick the first unused trajectoryN.csv to avoid overwriting existing files
+    std::string dir = outputDirectory();
+    string filename = nextOutputFile(dir, "trajectory");
 
     trajectory.CSVPrint(filename, info_stream.str());
     cout << "Trajectory data saved to: " << filename << endl;
+    if (!saved.model.empty() && saveFlight(saved, filename)) {
+        cout << "Final state saved to: " << statePathFor(filename) << " (menu option 9)" << endl;
+    }
 
     // Extract trajectory number from filename for plotting script
     size_t trajPos = filename.find("trajectory");
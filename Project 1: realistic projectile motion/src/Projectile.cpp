@@ -9,6 +9,9 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+
+#include "async_writer.h"
 using namespace std;
 
 // ==================== Vector3D Implementation ====================
@@ -59,25 +62,7 @@ void Vector3D::CSVPrint(std::ostream& out) const {
 }
 
 // ==================== Vector4D Implementation ====================
-// Overload the addition operator for Vector4D
-Vector4D Vector4D::operator+(const Vector4D& other) const {
-    return Vector4D(x + other.x, y + other.y, z + other.z, t);
-}
-
-// Overload the subtraction operator for Vector4D
-Vector4D Vector4D::operator-(const Vector4D& other) const {
-    return Vector4D(x - other.x, y - other.y, z - other.z, t);
-}
-
-// Overload the multiplication operator for scalar multiplication
-Vector4D Vector4D::operator*(double scalar) const {
-    return Vector4D(x * scalar, y * scalar, z * scalar, t);
-}
-
-// Overload the division operator for scalar division
-Vector4D Vector4D::operator/(double scalar) const {
-    return Vector4D(x / scalar, y / scalar, z / scalar, t);
-}
+// The arithmetic operators are inline in Projectile.h
 
 // Calculate the spacetime magnitude (Minkowski interval)
 double Vector4D::spacetimeMagnitude() const {
@@ -103,184 +88,209 @@ void Vector4D::CSVPrint(std::ostream& out) const {
     out << x << "," << y << "," << z << "," << t;
 }
 
-// ==================== Projectile Implementation ====================
+// ==================== ProjectileParams Implementation ====================
 
-// Default constructor for Projectile
-Projectile::Projectile()
-    : position(0, 0, 0, 0), velocity(0, 0, 0), mass(1.0), radius(0.1), dragCoefficient(0.47) {}
+ProjectileParams::ProjectileParams()
+    : spin(0, 0, 0),
+      mass(1.0),
+      radius(0.1),
+      dragCoefficient(0.47),
+      airDensity(0.0),
+      S(0.0) {
+    updateCoefficients();
+}
 
-// Parameterized constructor for Projectile
-Projectile::Projectile(Vector4D initialPos, Vector3D initialVel, Vector3D initialSpin, double m,
-                       double r, double airDensity, double SOverM, double dragCoeff)
-    : position(initialPos),
-      velocity(initialVel),
-      spin(initialSpin),
+ProjectileParams::ProjectileParams(Vector3D spinVec, double m, double r, double density,
+                                   double SOverM, double dragCoeff)
+    : spin(spinVec),
       mass(m),
       radius(r),
       dragCoefficient(dragCoeff),
-      airDensity(airDensity),
-      S(SOverM * m) {}
+      airDensity(density),
+      S(SOverM * m) {
+    updateCoefficients();
+}
+
+// The only place the force law divides: F_drag = 0.5 * ρ * v² * Cd * A and
+// F_magnus = S * (ω x v) both become accelerations once divided by the mass
+void ProjectileParams::updateCoefficients() {
+    double crossSectionalArea = M_PI * radius * radius;
+    dragConstant = 0.5 * airDensity * dragCoefficient * crossSectionalArea / mass;
+    magnusConstant = S / mass;
+    gravity = GRAVITY;
+}
+
+void ProjectileParams::setMass(double m) {
+    mass = m;
+    updateCoefficients();
+}
+
+void ProjectileParams::setRadius(double r) {
+    radius = r;
+    updateCoefficients();
+}
+
+void ProjectileParams::setDragCoefficient(double cd) {
+    dragCoefficient = cd;
+    updateCoefficients();
+}
+
+void ProjectileParams::setSpin(const Vector3D& spinVec) {
+    spin = spinVec;
+}
+
+void ProjectileParams::setAirDensity(double density) {
+    airDensity = density;
+    updateCoefficients();
+}
+
+void ProjectileParams::setS(double SOverM) {
+    S = SOverM * mass;
+    updateCoefficients();
+}
+
+void ProjectileParams::setSpinFactor(double spinFactor) {
+    S = spinFactor;
+    updateCoefficients();
+}
+
+// ==================== Projectile Implementation ====================
+
+// Default constructor for Projectile
+Projectile::Projectile() : params(), state() {}
+
+// Parameterized constructor for Projectile
+Projectile::Projectile(const Vector4D& initialPos, Vector3D initialVel, Vector3D initialSpin,
+                       double m, double r, double airDensity, double SOverM, double dragCoeff) {
+    setAll(initialPos, initialVel, initialSpin, m, r, airDensity, SOverM, dragCoeff);
+}
+
+Projectile::Projectile(const ProjectileParams& params_, const ProjectileState& state_)
+    : params(params_), state(state_) {}
 
 // Setters for Projectile properties
 void Projectile::setPosition(const Vector4D& pos) {
-    position = pos;
+    state.position = pos;
 }
 
 void Projectile::setVelocity(const Vector3D& vel) {
-    velocity = vel;
+    state.velocity = vel;
 }
 
 void Projectile::setMass(double m) {
-    mass = m;
+    params.setMass(m);
 }
 
 void Projectile::setRadius(double r) {
-    radius = r;
+    params.setRadius(r);
 }
 
 void Projectile::setDragCoefficient(double cd) {
-    dragCoefficient = cd;
+    params.setDragCoefficient(cd);
 }
 
 void Projectile::setSpin(const Vector3D& spinVec) {
-    spin = spinVec;
+    params.setSpin(spinVec);
 }
 
 void Projectile::setAirDensity(double density) {
-    airDensity = density;
+    params.setAirDensity(density);
 }
 
 void Projectile::setS(double SOverM) {
-    S = SOverM * mass;
+    params.setS(SOverM);
+}
+
+void Projectile::setState(const ProjectileState& s) {
+    state = s;
 }
 
 // Set all properties of the Projectile
 
-void Projectile::setAll(Vector4D pos, Vector3D vel, Vector3D spinVec, double m, double r,
+void Projectile::setAll(const Vector4D& pos, Vector3D vel, Vector3D spinVec, double m, double r,
                         double density, double SOverM, double dragCoeff) {
-    position = pos;
-    velocity = vel;
-    spin = spinVec;
-    mass = m;
-    radius = r;
-    airDensity = density;
-    S = SOverM * m;
-    dragCoefficient = dragCoeff;
+    state.position = pos;
+    state.velocity = vel;
+    params = ProjectileParams(spinVec, m, r, density, SOverM, dragCoeff);
 }
 
 // Getters
 Vector4D Projectile::getPosition() const {
-    return position;
+    return state.position;
 }
 
 Vector3D Projectile::getVelocity() const {
-    return velocity;
+    return state.velocity;
 }
 
 double Projectile::getTime() const {
-    return position.t;
+    return state.position.t;
 }
 
 double Projectile::getMass() const {
-    return mass;
+    return params.getMass();
 }
 
 double Projectile::getSpeed() const {
-    return velocity.magnitude();
+    return state.velocity.magnitude();
 }
 
 double Projectile::getHeight() const {
-    return position.z;
+    return state.position.z;
 }
 
 double Projectile::getRadius() const {
-    return radius;
+    return params.getRadius();
 }
 
 double Projectile::getRange() const {
-    return std::sqrt(position.x * position.x + position.y * position.y);
+    return std::sqrt(state.position.x * state.position.x + state.position.y * state.position.y);
 }
 
 Vector3D Projectile::getSpin() const {
-    return spin;
+    return params.getSpin();
 }
 
 double Projectile::getAirDensity() const {
-    return airDensity;
+    return params.getAirDensity();
 }
 
 double Projectile::getDragCoefficient() const {
-    return dragCoefficient;
+    return params.getDragCoefficient();
 }
 
 double Projectile::getS() const {
-    return S;
+    return params.getS();
 }
 
-// Physics calculations
-//  Calculate acceleration including gravity and air resistance
-Vector3D Projectile::calculateAcceleration(const Vector3D& wind) {
-    // Gravity (downward in Z direction, no time component)
-    Vector3D gravityForce(0, 0, -mass * GRAVITY);
-
-    Vector3D relativeVelocity = velocity - wind;
-
-    // Air resistance (drag)
-    double speed = relativeVelocity.magnitude();  // Spatial magnitude only
-
-    Vector3D dragForce(0, 0, 0);
-    if (speed > 0) {
-        // F_drag = 0.5 * ρ * v² * Cd * A
-        double crossSectionalArea = M_PI * radius * radius;
-        double dragMagnitude =
-            0.5 * airDensity * speed * speed * dragCoefficient * crossSectionalArea;
-
-        // Drag opposes velocity (spatial components only)
-        Vector3D dragDirection = relativeVelocity.normalize() * -1.0;
-        dragForce = dragDirection * dragMagnitude;
-    } else {
-        dragForce = Vector3D(0, 0, 0);
-    }
-
-    // Magnus force
-    Vector3D magnusForce(0, 0, 0);
-    // F_magnus = S * (ω x v) / m
-    Vector3D magnusCross = Vector3D(spin.y * relativeVelocity.z - spin.z * relativeVelocity.y,
-                                    spin.z * relativeVelocity.x - spin.x * relativeVelocity.z,
-                                    spin.x * relativeVelocity.y - spin.y * relativeVelocity.x);
-
-    magnusForce = magnusCross * S;
+const ProjectileParams& Projectile::getParams() const {
+    return params;
+}
 
-    // cout << spin.x << " " << spin.y << " " << spin.z << " Spin " << endl;
-    // cout << velocity.x << " " << velocity.y << " " << velocity.z << " Velocity " << endl;
-    // cout << relativeVelocity.x << " " << relativeVelocity.y << " " << relativeVelocity.z
-    //      << " Rel Vel " << endl;
-    // cout << magnusForce.x << " " << magnusForce.y << " " << magnusForce.z << " Magnus Force "
-    //      << endl;
-    // cout << gravityForce.x << " " << gravityForce.y << " " << gravityForce.z << " Gravity Force "
-    //      << endl;
-    // cout << dragForce.x << " " << dragForce.y << " " << dragForce.z << " Drag Force " << endl;
+const ProjectileState& Projectile::getState() const {
+    return state;
+}
 
-    // F = ma  =>  a = F/m
-    Vector3D totalForce = gravityForce + dragForce + magnusForce;
-    return totalForce / mass;
+// Physics calculations
+Vector3D Projectile::calculateAcceleration(const Vector3D& wind) const {
+    return params.acceleration(state.velocity, wind);
 }
 
-void Projectile::move(Vector4D pos, Vector3D vel) {
-    position = pos;
-    velocity = vel;
+void Projectile::move(const Vector4D& pos, Vector3D vel) {
+    state.position = pos;
+    state.velocity = vel;
 }
 
 // Utility
 bool Projectile::isGrounded() const {
-    return position.z <= 0 && velocity.z <= 0;
+    return state.isGrounded();
 }
 
 void Projectile::print() const {
     std::cout << "Position: ";
-    position.print();
+    state.position.print();
     std::cout << " | Velocity: ";
-    velocity.print();
+    state.velocity.print();
     std::cout << " | Speed: " << getSpeed() << " m/s" << std::endl;
 }
 //
@@ -298,13 +308,29 @@ void Trajectory::CSVPrint(const std::string& filename, const std::string& info)
         std::cerr << "Error: Could not open file " << filename << std::endl;
         return;
     }
-    file << info << std::endl;
-    file << "Time,X,Y,Z" << std::endl;
+    file << CSVString(info);
+    file.close();
+}
+
+std::string Trajectory::CSVString(const std::string& info) const {
+    std::ostringstream text;
+    text << info << '\n';
+    text << "Time,X,Y,Z" << '\n';
     for (const auto& point : points) {
-        file << point.t << "," << point.x << "," << point.y << "," << point.z << std::endl;
+        text << point.t << "," << point.x << "," << point.y << "," << point.z << '\n';
     }
+    return text.str();
+}
 
-    file.close();
+// Hand the points to the writer; formatting and disk I/O happen on its I/O threads
+void Trajectory::CSVPrint(AsyncWriter& writer, const std::string& filename,
+                          const std::string& info) const {
+    std::shared_ptr<AsyncWriter::Stream> stream =
+        writer.open(filename, info + "\nTime,X,Y,Z\n", 4);
+    for (const auto& point : points) {
+        stream->append({point.t, point.x, point.y, point.z});
+    }
+    stream->close();
 }
 
 // Standalone RK4 integration function
@@ -0,0 +1,175 @@
+/*
+ * Sweep.cpp
+ *
+ * Implementation of parallel projectile sweeps
+ */
+
+#include "Sweep.h"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include "Processing.h"
+#include "alloc_tracker.h"
+#include "trace.h"
+
+std::vector<SweepResult> runSweep(const std::vector<SweepCase>& cases, double timeStep,
+                                  double maxTime, ThreadPool& pool, const SweepOutput& output) {
+    std::vector<SweepResult> results(cases.size());
+    auto record = [&output](size_t i, const SweepResult& result) {
+        if (output.checkpoint != nullptr) {
+            const Vector4D& impact = result.impact;
+            double values[sweepCheckpointValues] = {impact.x, impact.y, impact.z, impact.t,
+                                                    result.range,
+                                                    static_cast<double>(result.steps)};
+            output.checkpoint->complete(i, values);
+        }
+    };
+
+    // One chunk per launch: flight times differ a lot between cases, so small
+    // tasks keep the workers balanced
+    pool.parallelFor(cases.size(), 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            if (output.checkpoint != nullptr && output.checkpoint->isDone(i)) {
+                const double* done = output.checkpoint->values(i);
+                results[i] = SweepResult{Vector4D(done[0], done[1], done[2], done[3]), done[4],
+                                         static_cast<size_t>(done[5])};
+                continue;
+            }
+            TraceSpan span("flight", "sweep", static_cast<int64_t>(i));
+            AllocScope memory("sweep flights");
+            const SweepCase& launch = cases[i];
+            if (output.files == nullptr && output.archive == nullptr) {
+                // Nothing to save: no path is stored, nothing is allocated
+                FlightSummary flight =
+                    rk4Flight(*launch.params, launch.start, timeStep, launch.wind, maxTime);
+                // The step below ground is not a trajectory point
+                size_t points = flight.steps + (flight.landed ? 0 : 1);
+                results[i] = SweepResult{flight.impact, flight.range, points};
+                record(i, results[i]);
+                continue;
+            }
+            ProjectileState state = launch.start;  // Only the state is per case
+            Vector4D start = state.position;
+            Vector4D impact;  // Same landing as rk4Flight, not the last saved point
+            Trajectory trajectory =
+                rk4Simulation(*launch.params, state, timeStep, launch.wind, maxTime, &impact);
+
+            if (output.files != nullptr) {
+                std::stringstream info_stream;
+                info_stream << "#Projectile Motion Simulation Data" << std::endl
+                            << "#Sweep Case: " << i << std::endl;
+                addInfoToStream(info_stream, Projectile(*launch.params, launch.start));
+                addInfoToStream2(info_stream, trajectory);
+                output.files->add(output.trajectoryStem + std::to_string(i) + ".csv",
+                                  trajectory.CSVString(info_stream.str()));
+            }
+
+            double dx = impact.x - start.x;
+            double dy = impact.y - start.y;
+            results[i] = SweepResult{impact, std::sqrt(dx * dx + dy * dy),
+                                     trajectory.getPoints().size()};
+
+            if (output.archive != nullptr) {
+                const Vector3D& velocity = launch.start.velocity;
+                double horizontal = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+                double parameters[3] = {velocity.magnitude(),
+                                        std::atan2(velocity.z, horizontal) * 180.0 / M_PI,
+                                        launch.params->getSpin().magnitude()};
+                double summary[4] = {impact.t - start.t, results[i].range, impact.x, impact.y};
+                std::vector<double> rows;
+                rows.reserve(4 * trajectory.getPoints().size());
+                for (const Vector4D& point : trajectory.getPoints()) {
+                    rows.insert(rows.end(), {point.t, point.x, point.y, point.z});
+                }
+                output.archive->append(i, parameters, summary, rows.data(),
+                                       trajectory.getPoints().size());
+            }
+            record(i, results[i]);
+        }
+    });
+    return results;
+}
+
+RunArchiveLayout sweepArchiveLayout() {
+    return RunArchiveLayout{{"Speed", "Elevation", "Spin"},
+                            {"FlightTime", "Range", "ImpactX", "ImpactY"},
+                            {"Time", "X", "Y", "Z"}};
+}
+
+std::vector<SweepCase> angleSweep(const Projectile& base, double speed, double angleMinDeg,
+                                  double angleMaxDeg, size_t count, const Vector3D& wind) {
+    auto params = std::make_shared<const ProjectileParams>(base.getParams());
+    std::vector<SweepCase> cases;
+    cases.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        double fraction = count > 1 ? static_cast<double>(i) / (count - 1) : 0.0;
+        double angle = (angleMinDeg + fraction * (angleMaxDeg - angleMinDeg)) * M_PI / 180.0;
+
+        ProjectileState start = base.getState();
+        start.velocity = Vector3D(speed * std::cos(angle), 0, speed * std::sin(angle));
+        cases.push_back(SweepCase{params, start, wind});
+    }
+    return cases;
+}
+
+bool tableSweep(const CsvTable& table, const Projectile& base, std::vector<SweepCase>& cases) {
+    for (const char* name : {"vx", "vy", "vz"}) {
+        if (!table.has(name)) {
+            std::cerr << "Error: launch table has no '" << name << "' column" << std::endl;
+            return false;
+        }
+    }
+    const ProjectileParams& defaults = base.getParams();
+    const Vector4D& origin = base.getState().position;
+    const Vector3D& spin = defaults.getSpin();
+
+    // Whole columns up front: the loop below only indexes contiguous arrays
+    const std::vector<double>& vx = table.column("vx");
+    const std::vector<double>& vy = table.column("vy");
+    const std::vector<double>& vz = table.column("vz");
+    std::vector<double> x = table.column("x", origin.x);
+    std::vector<double> y = table.column("y", origin.y);
+    std::vector<double> z = table.column("z", origin.z);
+    std::vector<double> windX = table.column("wind_x", 0.0);
+    std::vector<double> windY = table.column("wind_y", 0.0);
+    std::vector<double> windZ = table.column("wind_z", 0.0);
+    const size_t constants = 8;
+    std::vector<double> physical[constants] = {
+        table.column("mass", defaults.getMass()),
+        table.column("radius", defaults.getRadius()),
+        table.column("drag_coefficient", defaults.getDragCoefficient()),
+        table.column("air_density", defaults.getAirDensity()),
+        table.column("spin_factor", defaults.getS()),
+        table.column("spin_x", spin.x),
+        table.column("spin_y", spin.y),
+        table.column("spin_z", spin.z),
+    };
+
+    cases.clear();
+    cases.reserve(table.rows());
+    std::shared_ptr<const ProjectileParams> params;
+    for (size_t i = 0; i < table.rows(); ++i) {
+        bool same = params != nullptr;
+        for (size_t c = 0; same && c < constants; ++c) {
+            same = physical[c][i] == physical[c][i - 1];
+        }
+        if (!same) {
+            // Same setter order as a restored flight, so cached coefficients match exactly
+            ProjectileParams row = defaults;
+            row.setMass(physical[0][i]);
+            row.setRadius(physical[1][i]);
+            row.setDragCoefficient(physical[2][i]);
+            row.setAirDensity(physical[3][i]);
+            row.setSpinFactor(physical[4][i]);
+            row.setSpin(Vector3D(physical[5][i], physical[6][i], physical[7][i]));
+            params = std::make_shared<const ProjectileParams>(row);
+        }
+        ProjectileState start;
+        start.position = Vector4D(x[i], y[i], z[i], origin.t);
+        start.velocity = Vector3D(vx[i], vy[i], vz[i]);
+        cases.push_back(SweepCase{params, start, Vector3D(windX[i], windY[i], windZ[i])});
+    }
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "oscillator.h"
+
+class ThreadPool;
+
+// Events of one pendulum detected online, step by step, without storing the path.
+// Angles are unwrapped (they keep growing through full turns, see
+// OscillatorState::unwrappedAngle). A crossing inside a step is located on the cubic
+// Hermite interpolant of the two end states (angle and angular velocity at both ends),
+// which is as accurate as the RK4 step itself.
+//   - Bottom crossings: the angle passing 2πk with positive angular velocity. Their
+//     spacing is the period of an oscillation (or of a rotation).
+//   - Wraps: the angle passing (2k + 1)π, over the top. Counted +1 forward and -1
+//     backward, so turns() is the net number of full revolutions.
+class PendulumEvents {
+   public:
+    // Checks the step from before to after for crossings
+    void observe(double time0, double angle0, double velocity0, double time1, double angle1,
+                 double velocity1);
+
+    void observe(const OscillatorState& before, const OscillatorState& after) {
+        observe(before.time, before.unwrappedAngle(), before.angularVelocity, after.time,
+                after.unwrappedAngle(), after.angularVelocity);
+    }
+
+    // Forgets every event so far (e.g. after a transient)
+    void reset() { *this = PendulumEvents(); }
+
+    uint64_t bottomCrossings() const { return crossings; }
+    double firstBottomCrossing() const { return firstCrossing; }
+    double lastBottomCrossing() const { return lastCrossing; }
+
+    // Mean spacing of the bottom crossings; NaN with fewer than two
+    double period() const;
+
+    int64_t turns() const { return netTurns; }
+    uint64_t wraps() const { return totalWraps; }
+    double lastWrap() const { return lastWrapTime; }
+
+   private:
+    uint64_t crossings = 0;
+    double firstCrossing = 0.0;
+    double lastCrossing = 0.0;
+    int64_t netTurns = 0;
+    uint64_t totalWraps = 0;
+    double lastWrapTime = 0.0;
+};
+
+// Free (undamped, undriven) period at one amplitude
+struct PeriodMeasurement {
+    double amplitude;  // Release angle (rad), released at rest
+    double period;     // Measured from interpolated bottom crossings (s); NaN if none
+    double exact;      // 2π √(L/g) / AGM(1, cos(A/2)) (s)
+};
+
+// Rotation number of one driven run: net revolutions per drive period after a transient
+struct RotationMeasurement {
+    double rotationNumber;
+    int64_t turns;      // Net revolutions over the measured periods
+    uint64_t wraps;     // Passes over the top in either direction
+    double meanPeriod;  // Mean spacing of forward bottom crossings (s); NaN if < 2
+};
+
+// Exact free period of a pendulum of length params.length released at rest from
+// amplitude (|amplitude| < π), from the arithmetic-geometric mean
+double exactFreePeriod(const OscillatorParams& params, double amplitude);
+
+// Free period for every amplitude (damping and drive switched off), measured over
+// `crossings` full periods each. Runs in parallel, one amplitude per task.
+std::vector<PeriodMeasurement> periodVsAmplitude(const OscillatorParams& params,
+                                                 const std::vector<double>& amplitudes,
+                                                 double timeStep, size_t crossings,
+                                                 ThreadPool& pool);
+
+// Rotation number of every parameter set, from the same initial state. The time step
+// divides the drive period exactly (stepsPerPeriod steps), so the transient and the
+// measured window end on step boundaries. Runs in parallel, one parameter set per task.
+// Throws std::invalid_argument if a drive frequency is not positive.
+std::vector<RotationMeasurement> rotationNumbers(const std::vector<OscillatorParams>& cases,
+                                                 const OscillatorState& initial,
+                                                 size_t stepsPerPeriod, size_t transientPeriods,
+                                                 size_t periods, ThreadPool& pool);
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "oscillator.h"
+
+class ThreadPool;
+
+// Density of visits to the (angle, angular velocity, drive phase) cells of the phase
+// space, accumulated sample by sample so runs of any length fit in a fixed grid.
+// Angles are the wrapped ones in (-π, π]; the drive phase is in [0, 2π). With one phase
+// bin it is the 2D (angle, angular velocity) histogram. Counts are 64-bit, so a single
+// grid holds well over 10^10 samples.
+class AttractorHistogram {
+   public:
+    AttractorHistogram(size_t angleBins, size_t velocityBins, size_t phaseBins,
+                       double velocityMin, double velocityMax);
+
+    void add(double angle, double angularVelocity, size_t phaseBin) {
+        double v = (angularVelocity - velocityMin) * velocityScale;
+        if (!(v >= 0.0 && v < static_cast<double>(velocityBins))) {
+            outside++;
+            return;
+        }
+        size_t a = static_cast<size_t>((angle + M_PI) * angleScale);
+        a = a < angleBins ? a : angleBins - 1;  // angle == π lands in the last bin
+        counts[(phaseBin * velocityBins + static_cast<size_t>(v)) * angleBins + a]++;
+        inside++;
+    }
+
+    // Adds other's counts; throws std::invalid_argument if the grids differ
+    void merge(const AttractorHistogram& other);
+
+    size_t angleBinCount() const { return angleBins; }
+    size_t velocityBinCount() const { return velocityBins; }
+    size_t phaseBinCount() const { return phaseBins; }
+    double velocityMinimum() const { return velocityMin; }
+    double velocityMaximum() const { return velocityMax; }
+    uint64_t samples() const { return inside; }
+    uint64_t samplesOutside() const { return outside; }  // Angular velocity out of range
+
+    // Count of one cell
+    uint64_t count(size_t angleBin, size_t velocityBin, size_t phaseBin) const {
+        return counts[(phaseBin * velocityBins + velocityBin) * angleBins + angleBin];
+    }
+
+    // (angle, angular velocity) counts summed over the drive phase, velocity-major
+    std::vector<uint64_t> projection() const;
+
+    // Writes the counts as a NumPy .npy array of uint64 with shape (phase, velocity, angle),
+    // readable with numpy.load. Throws std::runtime_error if the file cannot be written.
+    void writeNpy(const std::string& path) const;
+
+    // Writes the 2D projection as a 16-bit binary PGM image on a log scale, angle to the
+    // right and angular velocity up. Throws std::runtime_error on failure.
+    void writePgm(const std::string& path) const;
+
+   private:
+    size_t angleBins, velocityBins, phaseBins;
+    double velocityMin, velocityMax;
+    double angleScale, velocityScale;  // Bins per radian and per rad/s
+    std::vector<uint64_t> counts;
+    uint64_t inside = 0;
+    uint64_t outside = 0;
+};
+
+// Runs every initial state (at time 0, drive phase 0) for transientPeriods + periods drive
+// periods of stepsPerPeriod RK4 steps, so the phase of every step is exact, and adds each
+// step after the transient to a histogram with the grid of shape. Runs go in parallel into
+// one histogram per worker, merged at the end. Throws std::invalid_argument if the drive
+// frequency is not positive.
+AttractorHistogram accumulateAttractor(const OscillatorParams& params,
+                                       const std::vector<OscillatorState>& initial,
+                                       size_t stepsPerPeriod, size_t transientPeriods,
+                                       size_t periods, const AttractorHistogram& shape,
+                                       ThreadPool& pool);
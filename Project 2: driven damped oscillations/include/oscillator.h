@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <type_traits>
 #include <vector>  // Include the vector header
 
 #include "processing.h"
@@ -20,24 +22,57 @@
 // A driving force of 1.20 N.
 // A driving frequency of 2/3 rad/s.
 
+// Physical parameters of the driven pendulum. They do not change during a run,
+// so one instance can be shared (read-only) by any number of threads.
+struct OscillatorParams {
+    double mass;                // Mass (kg)
+    double length;              // Pendulum length (m)
+    double dampingCoefficient;  // Damping coefficient (kg/s)
+    double drivingForce;        // Driving force amplitude (N)
+    double drivingFrequency;    // Driving frequency (rad/s)
+
+    static constexpr double gravity = 9.81;  // (m/s²)
+
+    // Angular acceleration (equation of motion)
+    double angularAcceleration(double time, double angle, double angularVelocity) const;
+};
+
+// State of one pendulum: plain data, so many runs pack densely into arrays.
+// rk4Step keeps angle in (-π, π] and counts the whole turns taken out of it, so
+// sin(angle) stays precise however often the pendulum goes over the top.
+struct OscillatorState {
+    double time;             // Time (s)
+    double angle;            // Angle from the vertical, wrapped into (-π, π] (rad)
+    double angularVelocity;  // Angular velocity (rad/s)
+    int64_t turns = 0;       // Net turns over the top (positive with increasing angle)
+
+    // Total angle travelled: angle + 2π turns (rad)
+    double unwrappedAngle() const { return angle + 2.0 * M_PI * static_cast<double>(turns); }
+};
+
+static_assert(std::is_trivially_copyable<OscillatorState>::value,
+              "OscillatorState must stay plain data");
+
+// Move whole turns from angle into turns so that angle is in (-π, π]. Non-finite angles
+// are left as they are.
+void wrapAngle(OscillatorState& state);
+
+// Advance state by one RK4 step (same arithmetic as rk4Simulation in processing.h),
+// then wrap the angle back into (-π, π]
+OscillatorState rk4Step(const OscillatorParams& params, const OscillatorState& state,
+                        double timeStep);
+
 class oscillator {
    public:
-    double mass;
-    double length;
-    double dampingCoefficient;
-    double angle;
-    double angularVelocity;
-    double drivingForce;
-    double drivingFrequency;
-    double time;
-    std::vector<double> state;
-    std::vector<double> derivatives;
+    OscillatorParams params;  // Physical parameters
+    OscillatorState initial;  // Initial state (time 0)
 
     oscillator(double mass_, double length_, double dampingCoefficient_, double initialAngle_,
                double initialAngularVelocity_, double drivingForce_, double drivingFrequency_);
 
+    // Derivatives of the {time, angle, angularVelocity} vector for rk4Simulation
     void computeDerivatives(const std::vector<double>& state, std::vector<double>& derivatives,
-                            double time);
+                            double time) const;
 
     std::vector<double> getState() const;
 
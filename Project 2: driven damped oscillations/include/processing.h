@@ -10,4 +10,11 @@ typedef std::vector<double> state_type;
 // RK4 simulation function
 std::vector<state_type> rk4Simulation(
     state_type& state, std::function<void(const state_type&, state_type&, double)> derivatives,
-    std::function<bool(const state_type&)> stopCondition, double timeStep);
\ No newline at end of file
+    std::function<bool(const state_type&)> stopCondition, double timeStep);
+
+// RK4 simulation that passes every state (including the initial one) to observer
+// instead of storing the path
+void rk4Simulation(state_type& state,
+                   std::function<void(const state_type&, state_type&, double)> derivatives,
+                   std::function<bool(const state_type&)> stopCondition, double timeStep,
+                   std::function<void(const state_type&)> observer);
\ No newline at end of file
@@ -1,55 +1,612 @@
-#include <iostream>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
 #include <vector>
 
-
+#include "alloc_tracker.h"
+#include "analysis.h"
+#include "attractor.h"
+#include "async_writer.h"
+#include "expression.h"
 #include "oscillator.h"
-#include "processing.h"
+#include "perf_counters.h"
+#include "plugin_loader.h"
+#include "run_state.h"
+#include "thread_pool.h"
+#include "trace.h"
 
-int main() {
-    std::cout << "Driven Damped Oscillator Simulation" << std::endl;
+// Integrates dy/dt = derivatives(t, y) from initial with the generic rk4Simulation and
+// streams {time, y...} rows to path. Returns false if the file could not be written.
+template <typename Derivatives>
+static bool integrateToCsv(const std::string& path, const std::vector<std::string>& names,
+                           const std::vector<double>& initial, Derivatives derivatives,
+                           double timeStep, double endTime, size_t& steps) {
+    std::string header = "Time";
+    for (const std::string& name : names) {
+        header += "," + name;
+    }
+    AsyncWriter writer;
+    std::shared_ptr<AsyncWriter::Stream> out =
+        writer.open(path, header + "\n", initial.size() + 1);
+
+    // State vector for rk4Simulation: {time, model states...}
+    state_type state = {0.0};
+    state.insert(state.end(), initial.begin(), initial.end());
+    steps = 0;
+    TraceSpan span("integrate", "ode");
+    PerfScope scope("ODE model derivative (RK4)");
+    AllocScope memory("integration");
+    rk4Simulation(
+        state,
+        [&derivatives](const state_type& s, state_type& d, double) {
+            d[0] = 1.0;
+            derivatives(s[0], s.data() + 1, d.data() + 1);
+        },
+        [endTime](const state_type& s) { return s[0] < endTime; }, timeStep,
+        [&](const state_type& s) {
+            out->append(s.data());
+            steps++;
+        });
+    out->close();
+    out->wait();
+    return out->ok();
+}
+
+// Integrates a model read from a file (see models/pendulum.ode) instead of the built-in
+// pendulum. The derivatives run as compiled bytecode, so no rebuild is needed.
+static int runModel(const std::string& path, double timeStep, double endTime) {
+    OdeModel model;
+    try {
+        model = OdeModel::load(path);
+    } catch (const ExpressionError& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return 1;
+    }
 
+    size_t steps = 0;
+    bool ok = integrateToCsv(
+        "Output/model_output.csv", model.stateNames(), model.initialState(),
+        [&model](double t, const double* y, double* dy) { model.derivatives(t, y, dy); },
+        timeStep, endTime, steps);
+
+    std::cout << "Model " << path << ": " << model.dimension() << " state variable(s), "
+              << model.program().code().size() << " bytecode instructions" << std::endl;
+    std::cout << "Simulation complete. Total steps: " << steps << std::endl;
+    if (!ok) {
+        std::cerr << "Error: Unable to open output file." << std::endl;
+        return 1;
+    }
+    std::cout << "Results written to Output/model_output.csv" << std::endl;
+    return 0;
+}
+
+// Integrates an ODE model from a native plugin (see ../include/model_plugin.h). Plugins are
+// discovered at startup in $NM_PLUGIN_PATH and ../bin/plugins; overrides are name=value.
+static int runPlugin(const std::string& name, const std::vector<std::string>& overrides,
+                     double timeStep, double endTime) {
+    PluginRegistry registry;
+    for (const std::string& dir : PluginRegistry::searchPath("../bin/plugins")) {
+        registry.discover(dir);
+    }
+    for (const std::string& problem : registry.errors()) {
+        std::cerr << "Warning: " << problem << std::endl;
+    }
+
+    const PluginModel* found = registry.find(name, NM_MODEL_ODE);
+    if (!found) {
+        std::cerr << "Error: no ODE plugin named '" << name << "'. Available:";
+        for (const PluginModel& model : registry.models()) {
+            if (model.kind() == NM_MODEL_ODE) {
+                std::cerr << " " << model.name();
+            }
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+    PluginModel model = *found;
+    try {
+        for (const std::string& assignment : overrides) {
+            size_t equals = assignment.find('=');
+            if (equals == std::string::npos) {
+                throw PluginError("expected name=value, got '" + assignment + "'");
+            }
+            model.setParameter(assignment.substr(0, equals),
+                               std::stod(assignment.substr(equals + 1)));
+        }
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return 1;
+    }
+
+    size_t steps = 0;
+    bool ok = integrateToCsv(
+        "Output/plugin_output.csv", model.stateNames(), model.initialState(),
+        [&model](double t, const double* y, double* dy) { model.evaluate(t, y, dy); },
+        timeStep, endTime, steps);
+
+    std::cout << "Plugin model " << model.name() << " (" << model.path() << "): "
+              << model.description() << std::endl;
+    for (size_t i = 0; i < model.parameters().size(); ++i) {
+        std::cout << "  " << model.parameterNames()[i] << " = " << model.parameters()[i]
+                  << std::endl;
+    }
+    std::cout << "Simulation complete. Total steps: " << steps << std::endl;
+    if (!ok) {
+        std::cerr << "Error: Unable to open output file." << std::endl;
+        return 1;
+    }
+    std::cout << "Results written to Output/plugin_output.csv" << std::endl;
+    return 0;
+}
+
+// ==================== Analysis modes ====================
+
+// Free period of the test pendulum at count amplitudes spread over (0, π), measured from
+// interpolated zero crossings and compared with the exact period. Only the crossings are
+// kept, not the paths. Writes Output/period_amplitude.csv.
+static int runPeriodSweep(size_t count, size_t threads) {
+    if (count == 0) {
+        std::cerr << "Error: --period needs a positive number of amplitudes." << std::endl;
+        return 1;
+    }
+    const double timeStep = 0.01;
+    const size_t crossings = 10;  // Periods measured per amplitude
     testOscillator osc;
+    std::vector<double> amplitudes;
+    for (size_t i = 0; i < count; ++i) {
+        amplitudes.push_back(M_PI * (i + 1.0) / (count + 1.0));
+    }
 
-    osc.printParameters();
+    ThreadPoolOptions options;
+    options.threads = threads;
+    ThreadPool pool(options);
+    std::vector<PeriodMeasurement> results =
+        periodVsAmplitude(osc.params, amplitudes, timeStep, crossings, pool);
 
-    auto derivFunc = [&osc](const std::vector<double>& state, std::vector<double>& derivatives,
-                            double time) { osc.computeDerivatives(state, derivatives, time); };
+    AsyncWriter writer;
+    std::shared_ptr<AsyncWriter::Stream> out = writer.open(
+        "Output/period_amplitude.csv", "Amplitude,Period,ExactPeriod,PeriodRatio\n", 4);
+    double smallAngle = exactFreePeriod(osc.params, 0.0);
+    double worst = 0.0;
+    for (const PeriodMeasurement& m : results) {
+        out->append({m.amplitude, m.period, m.exact, m.period / smallAngle});
+        worst = std::max(worst, std::fabs(m.period - m.exact) / m.exact);
+    }
+    out->close();
+    out->wait();
+    if (!out->ok()) {
+        std::cerr << "Error: Unable to open output file." << std::endl;
+        return 1;
+    }
 
-    // Stop condition: continue while time < 180.0 seconds
-    auto stopCondition = [](const std::vector<double>& state) {
-        return state[0] < 180.0;  // state[0] is time
-    };
+    std::cout << "Free period vs amplitude: " << count << " amplitudes, " << crossings
+              << " periods each, dt = " << timeStep << " s, " << pool.size() << " thread(s)"
+              << std::endl;
+    std::cout << "Small-angle period: " << smallAngle << " s; largest amplitude "
+              << amplitudes.back() << " rad: " << results.back().period << " s" << std::endl;
+    std::cout << "Largest relative error against the exact period: " << worst << std::endl;
+    std::cout << "Results written to Output/period_amplitude.csv" << std::endl;
+    return 0;
+}
 
-    double timeStep = 0.04;  // Time step for the simulation
+// Rotation number (net turns over the top per drive period) of the test pendulum for
+// count driving forces in [forceMin, forceMax], after a 100-period transient. Only the
+// wrap events are kept. Writes Output/rotation_number.csv.
+static int runRotationSweep(double forceMin, double forceMax, size_t count, size_t periods,
+                            size_t threads) {
+    if (count == 0) {
+        std::cerr << "Error: --rotation needs a positive number of driving forces."
+                  << std::endl;
+        return 1;
+    }
+    const size_t stepsPerPeriod = 200;
+    const size_t transientPeriods = 100;
+    testOscillator osc;
+    std::vector<OscillatorParams> cases(count, osc.params);
+    for (size_t i = 0; i < count; ++i) {
+        double fraction = count > 1 ? static_cast<double>(i) / (count - 1) : 0.0;
+        cases[i].drivingForce = forceMin + fraction * (forceMax - forceMin);
+    }
+
+    ThreadPoolOptions options;
+    options.threads = threads;
+    ThreadPool pool(options);
+    std::vector<RotationMeasurement> results;
+    try {
+        results = rotationNumbers(cases, osc.initial, stepsPerPeriod, transientPeriods, periods,
+                                  pool);
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return 1;
+    }
 
-    std::vector<double> initialState = osc.getState();
-    std::vector<std::vector<double>> path =
-        rk4Simulation(initialState, derivFunc, stopCondition, timeStep);
-
-
-    std::cout << "Simulation complete. Total steps: " << path.size() << std::endl;
-    std::cout << "Initial state: Time = " << path.front()[0]
-              << ", Angle = " << path.front()[1]
-              << ", Angular Velocity = " << path.front()[2] << std::endl;
-    std::cout << "Final state: Time = " << path.back()[0]
-              << ", Angle = " << path.back()[1]
-              << ", Angular Velocity = " << path.back()[2] << std::endl;
-
-    //outpur results to a file in the directory ./Output/oscillator_output.csv
-    std::ofstream outFile("/Users/nelsbuhrley/CPP_Workspace/Project 2: driven damped oscillations/Output/oscillator_output.csv");
-    if (outFile.is_open()) {
-        outFile << "Time,Angle,AngularVelocity\n";
-        for (const auto& state : path) {
-            outFile << state[0] << "," << state[1] << "," << state[2] << "\n";
-        }
-        outFile.close();
-        std::cout << "Results written to Output/oscillator_output.csv" << std::endl;
-    } else {
+    AsyncWriter writer;
+    std::shared_ptr<AsyncWriter::Stream> out = writer.open(
+        "Output/rotation_number.csv", "DrivingForce,RotationNumber,Turns,Wraps,MeanPeriod\n", 5);
+    size_t rotating = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const RotationMeasurement& m = results[i];
+        out->append({cases[i].drivingForce, m.rotationNumber, static_cast<double>(m.turns),
+                     static_cast<double>(m.wraps), m.meanPeriod});
+        rotating += m.wraps > 0 ? 1 : 0;
+    }
+    out->close();
+    out->wait();
+    if (!out->ok()) {
         std::cerr << "Error: Unable to open output file." << std::endl;
+        return 1;
     }
 
+    std::cout << "Rotation numbers: " << count << " driving forces in [" << forceMin << ", "
+              << forceMax << "] N, " << periods << " drive periods after " << transientPeriods
+              << ", " << pool.size() << " thread(s)" << std::endl;
+    std::cout << rotating << " of " << count << " runs go over the top" << std::endl;
+    std::cout << "Results written to Output/rotation_number.csv" << std::endl;
+    return 0;
+}
 
+// Density of the test pendulum's attractor: runs ensembles of nearby starts for many drive
+// periods and bins every step by angle, angular velocity and drive phase, without storing
+// a single row. Writes Output/attractor.npy (counts, shape (phase, velocity, angle)) and
+// Output/attractor.pgm (log-scaled angle / angular velocity image).
+static int runAttractor(size_t runs, size_t periods, size_t threads) {
+    if (runs == 0 || periods == 0) {
+        std::cerr << "Error: --attractor needs a positive number of runs and periods."
+                  << std::endl;
+        return 1;
+    }
+    const size_t stepsPerPeriod = 200;
+    const size_t transientPeriods = 100;
+    testOscillator osc;
+    std::vector<OscillatorState> starts;
+    for (size_t i = 0; i < runs; ++i) {
+        OscillatorState start = osc.initial;
+        start.angle += 1e-3 * static_cast<double>(i);
+        starts.push_back(start);
+    }
+
+    ThreadPoolOptions options;
+    options.threads = threads;
+    ThreadPool pool(options);
+    AttractorHistogram histogram(256, 256, 16, -3.5, 3.5);  // 8 MiB per worker
+    try {
+        histogram = accumulateAttractor(osc.params, starts, stepsPerPeriod, transientPeriods,
+                                        periods, histogram, pool);
+        histogram.writeNpy("Output/attractor.npy");
+        histogram.writePgm("Output/attractor.pgm");
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return 1;
+    }
 
+    std::cout << "Attractor: " << runs << " run(s) x " << periods << " drive periods x "
+              << stepsPerPeriod << " steps, " << pool.size() << " thread(s)" << std::endl;
+    std::cout << histogram.samples() << " samples binned, " << histogram.samplesOutside()
+              << " outside |angular velocity| < 3.5 rad/s" << std::endl;
+    std::cout << "Results written to Output/attractor.npy and Output/attractor.pgm" << std::endl;
     return 0;
 }
+
+// ==================== Saved runs (extend / branch) ====================
+
+// Every run leaves its exact final state next to its CSV, with a snapshot every
+// snapshotEvery steps, so it can be extended or branched without starting from t = 0
+static const uint64_t snapshotEvery = 250;
+
+static std::vector<std::pair<std::string, double>> namedParameters(const OscillatorParams& p) {
+    return {{"mass", p.mass},
+            {"length", p.length},
+            {"damping", p.dampingCoefficient},
+            {"force", p.drivingForce},
+            {"frequency", p.drivingFrequency}};
+}
+
+static OscillatorParams paramsFrom(const RunState& saved) {
+    return OscillatorParams{saved.parameter("mass"), saved.parameter("length"),
+                            saved.parameter("damping"), saved.parameter("force"),
+                            saved.parameter("frequency")};
+}
+
+// State files hold {time, wrapped angle, angular velocity, turns}; files written before
+// the angle was wrapped have no turns and an unwrapped angle, which is equally valid
+static OscillatorState stateFrom(const std::vector<double>& values) {
+    return OscillatorState{values.at(0), values.at(1), values.at(2),
+                           values.size() > 3 ? static_cast<int64_t>(values[3]) : 0};
+}
+
+static std::vector<double> valuesOf(const OscillatorState& state) {
+    return {state.time, state.angle, state.angularVelocity, static_cast<double>(state.turns)};
+}
+
+// CSV header for the wrapped angle (compact, the default) or the unwrapped one (--unwrapped)
+static const std::string wrappedHeader = "Time,Angle,AngularVelocity\n";
+static const std::string unwrappedHeader = "Time,UnwrappedAngle,AngularVelocity\n";
+
+// Whether an existing CSV holds the unwrapped angle, so extensions and branches match it
+static bool holdsUnwrapped(const std::string& csv) {
+    std::ifstream in(csv);
+    std::string header;
+    std::getline(in, header);
+    return header + "\n" == unwrappedHeader;
+}
+
+static void appendRow(AsyncWriter::Stream& out, const OscillatorState& state, bool unwrapped) {
+    out.append({state.time, unwrapped ? state.unwrappedAngle() : state.angle,
+                state.angularVelocity});
+}
+
+// Steps state to endTime exactly like the built-in run, appending each new state to out
+// and counting steps (and snapshots) in saved
+static void advance(const OscillatorParams& params, OscillatorState& state, double endTime,
+                    AsyncWriter::Stream& out, RunState& saved, bool unwrapped) {
+    TraceSpan span("integrate", "oscillator");
+    PerfScope scope("oscillator derivative (RK4)");
+    AllocScope memory("integration");
+    while (state.time < endTime) {
+        state = rk4Step(params, state, saved.timeStep);
+        appendRow(out, state, unwrapped);
+        saved.steps++;
+        saved.snapshot(saved.steps, valuesOf(state), snapshotEvery);
+    }
+    saved.state = valuesOf(state);
+    saved.endTime = endTime;
+}
+
+// Path of the state file saved next to a CSV (Output/x.csv -> Output/x.state)
+static std::string statePathFor(const std::string& csv) {
+    return csv.substr(0, csv.rfind('.')) + ".state";
+}
+
+// Writes the state file and reports the outcome of a run
+static int finishRun(AsyncWriter::Stream& out, const RunState& saved) {
+    out.close();
+    out.wait();
+    if (!out.ok()) {
+        std::cerr << "Error: Unable to open output file." << std::endl;
+        return 1;
+    }
+    try {
+        saved.save(statePathFor(saved.output));
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return 1;
+    }
+    std::cout << "Final state: Time = " << saved.state[0] << ", Angle = " << saved.state[1]
+              << " (" << saved.state[3] << " turns), Angular Velocity = " << saved.state[2]
+              << " (" << saved.steps << " steps)" << std::endl;
+    std::cout << "Results written to " << saved.output << ", state to "
+              << statePathFor(saved.output) << std::endl;
+    return 0;
+}
+
+static bool loadRun(const std::string& path, RunState& saved) {
+    try {
+        saved = RunState::load(path);
+        if (saved.model != "oscillator" || saved.state.size() < 3 || saved.state.size() > 4) {
+            throw std::runtime_error(path + " is not an oscillator run");
+        }
+        paramsFrom(saved);  // Throws if a parameter is missing
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Continues a saved run to a later end time, appending to its CSV. Only the new
+// interval is integrated, and the rows match an uninterrupted run to the last bit.
+static int extendRun(const std::string& statePath, double endTime) {
+    RunState saved;
+    if (!loadRun(statePath, saved)) {
+        return 1;
+    }
+    OscillatorState state = stateFrom(saved.state);
+    if (state.time >= endTime) {
+        std::cout << "The run already reaches t = " << state.time << " s; nothing to do."
+                  << std::endl;
+        return 0;
+    }
+    std::cout << "Extending " << saved.output << " from t = " << state.time << " s to "
+              << endTime << " s" << std::endl;
+    AsyncWriter writer;
+    bool unwrapped = holdsUnwrapped(saved.output);
+    saved.names = {"Time", "Angle", "AngularVelocity", "Turns"};
+    std::shared_ptr<AsyncWriter::Stream> out = writer.open(saved.output, "", 3, true);
+    advance(paramsFrom(saved), state, endTime, *out, saved, unwrapped);
+    return finishRun(*out, saved);
+}
+
+// Starts a new run from a saved run's state at time branchTime, optionally with changed
+// parameters (name=value). The saved snapshot before branchTime is replayed with the
+// original parameters, so the branch point is a state the original run really passed.
+static int branchRun(const std::string& statePath, double branchTime, double endTime,
+                     const std::vector<std::string>& overrides) {
+    RunState saved;
+    if (!loadRun(statePath, saved)) {
+        return 1;
+    }
+    const RunState::Snapshot* snap = saved.snapshotBefore(branchTime);
+    if (!snap || branchTime > saved.state[0]) {
+        std::cerr << "Error: t = " << branchTime << " s is outside the saved run (it ends at "
+                  << saved.state[0] << " s; use --extend to go further)" << std::endl;
+        return 1;
+    }
+
+    const OscillatorParams original = paramsFrom(saved);
+    OscillatorState state = stateFrom(snap->state);
+    uint64_t steps = snap->step;
+    while (state.time < branchTime) {
+        state = rk4Step(original, state, saved.timeStep);
+        steps++;
+    }
+
+    RunState branch = saved;
+    for (const std::string& assignment : overrides) {
+        size_t equals = assignment.find('=');
+        bool known = false;
+        for (auto& entry : branch.parameters) {
+            if (equals != std::string::npos && entry.first == assignment.substr(0, equals)) {
+                char* end = nullptr;
+                entry.second = std::strtod(assignment.c_str() + equals + 1, &end);
+                known = *end == '\0' && end != assignment.c_str() + equals + 1;
+            }
+        }
+        if (!known) {
+            std::cerr << "Error: expected name=value with name one of mass, length, damping, "
+                         "force, frequency; got '"
+                      << assignment << "'" << std::endl;
+            return 1;
+        }
+    }
+    branch.output = "Output/oscillator_branch.csv";
+    branch.steps = steps;
+    branch.snapshots = {RunState::Snapshot{steps, valuesOf(state)}};
+
+    std::cout << "Branching at t = " << state.time << " s (step " << steps << ", replayed "
+              << steps - snap->step << " steps) to " << endTime << " s" << std::endl;
+    AsyncWriter writer;
+    bool unwrapped = holdsUnwrapped(saved.output);
+    branch.names = {"Time", "Angle", "AngularVelocity", "Turns"};
+    std::shared_ptr<AsyncWriter::Stream> out =
+        writer.open(branch.output, unwrapped ? unwrappedHeader : wrappedHeader, 3);
+    appendRow(*out, state, unwrapped);
+    advance(paramsFrom(branch), state, endTime, *out, branch, unwrapped);
+    return finishRun(*out, branch);
+}
+
+// Whole number argument (a count or a thread count): digits only, so "-1" or "abc" is an
+// error rather than a huge or zero count
+static bool parseCount(const char* text, size_t& value) {
+    if (!std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > std::numeric_limits<size_t>::max()) {
+        return false;
+    }
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+// Optional count argv[index], defaultValue if it is not given
+static bool countArg(int argc, char** argv, int index, size_t defaultValue, size_t& value) {
+    value = defaultValue;
+    return argc <= index || parseCount(argv[index], value);
+}
+
+static bool parseNumber(const char* text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text, &end);
+    return end != text && *end == '\0' && std::isfinite(value);
+}
+
+int main(int argc, char** argv) {
+    // NM_TRACE=Output/trace.json: timeline of the run (integration and background writes)
+    Trace::enableFromEnvironment();
+    // NM_PERF=1: IPC, cache and branch misses of the integration at exit
+    PerfProfile::enableFromEnvironment();
+    // NM_ALLOC=1: heap allocations, bytes and peaks per subsystem at exit
+    AllocationTracker::enableFromEnvironment();
+
+    if (argc > 2 && std::string(argv[1]) == "--plugin") {
+        return runPlugin(argv[2], std::vector<std::string>(argv + 3, argv + argc), 0.04, 180.0);
+    }
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--extend" && argc > 2) {
+        return extendRun(argc > 3 ? argv[3] : "Output/oscillator_output.state",
+                         std::atof(argv[2]));
+    }
+    if (mode == "--branch" && argc > 3) {
+        // Remaining arguments: name=value overrides and optionally another state file
+        std::string statePath = "Output/oscillator_output.state";
+        std::vector<std::string> overrides;
+        for (int i = 4; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.find('=') != std::string::npos) {
+                overrides.push_back(arg);
+            } else {
+                statePath = arg;
+            }
+        }
+        return branchRun(statePath, std::atof(argv[2]), std::atof(argv[3]), overrides);
+    }
+    if (mode == "--period") {
+        size_t count, threads;
+        if (!countArg(argc, argv, 2, 60, count) || !countArg(argc, argv, 3, 0, threads)) {
+            std::cerr << "Usage: " << argv[0] << " --period [COUNT] [THREADS]" << std::endl;
+            return 1;
+        }
+        return runPeriodSweep(count, threads);
+    }
+    if (mode == "--rotation") {
+        double forceMin = 0.0, forceMax = 0.0;
+        size_t count, periods, threads;
+        if (argc < 4 || !parseNumber(argv[2], forceMin) || !parseNumber(argv[3], forceMax) ||
+            !countArg(argc, argv, 4, 200, count) || !countArg(argc, argv, 5, 200, periods) ||
+            !countArg(argc, argv, 6, 0, threads)) {
+            std::cerr << "Usage: " << argv[0]
+                      << " --rotation FMIN FMAX [COUNT] [PERIODS] [THREADS]"
+                      << std::endl;
+            return 1;
+        }
+        return runRotationSweep(forceMin, forceMax, count, periods, threads);
+    }
+    if (mode == "--attractor") {
+        size_t runs, periods, threads;
+        if (!countArg(argc, argv, 2, 8, runs) || !countArg(argc, argv, 3, 2000, periods) ||
+            !countArg(argc, argv, 4, 0, threads)) {
+            std::cerr << "Usage: " << argv[0] << " --attractor [RUNS] [PERIODS] [THREADS]"
+                      << std::endl;
+            return 1;
+        }
+        return runAttractor(runs, periods, threads);
+    }
+    // --unwrapped: write the total angle travelled instead of the angle in (-π, π]
+    bool unwrapped = mode == "--unwrapped";
+    if (argc > 1 && !unwrapped) {
+        return runModel(argv[1], 0.04, 180.0);
+    }
+
+    std::cout << "Driven Damped Oscillator Simulation" << std::endl;
+
+    testOscillator osc;
+
+    osc.printParameters();
+
+    double timeStep = 0.04;  // Time step for the simulation
+    double endTime = 180.0;  // Model 180 seconds of motion
+
+    // Rows are handed to an I/O thread as they are computed, so formatting and
+    // disk writes overlap the integration instead of following it
+    AsyncWriter writer;
+    std::shared_ptr<AsyncWriter::Stream> out = writer.open(
+        "Output/oscillator_output.csv", unwrapped ? unwrappedHeader : wrappedHeader, 3);
+
+    // The parameters stay fixed; only the small plain-data state moves
+    const OscillatorParams& params = osc.params;
+    OscillatorState state = osc.initial;
+    RunState saved;
+    saved.model = "oscillator";
+    saved.output = "Output/oscillator_output.csv";
+    saved.parameters = namedParameters(params);
+    saved.names = {"Time", "Angle", "AngularVelocity", "Turns"};
+    saved.timeStep = timeStep;
+    saved.snapshots = {RunState::Snapshot{0, valuesOf(state)}};
+    appendRow(*out, state, unwrapped);
+    advance(params, state, endTime, *out, saved, unwrapped);
+
+    std::cout << "Simulation complete. Total steps: " << saved.steps + 1 << std::endl;
+    std::cout << "Initial state: Time = " << osc.initial.time
+              << ", Angle = " << osc.initial.angle
+              << ", Angular Velocity = " << osc.initial.angularVelocity << std::endl;
+    return finishRun(*out, saved);
+}
@@ -9,9 +9,10 @@ os.chdir(script_dir)
 # Read the CSV file
 data = pd.read_csv('Output/oscillator_output.csv', delimiter=',')
 
-# Extract time and angle columns
+# Extract time and angle columns (Angle is wrapped into (-pi, pi]; runs started
+# with --unwrapped write the total angle as UnwrappedAngle instead)
 time = data['Time']
-angle = data['Angle']
+angle = data['Angle'] if 'Angle' in data else data['UnwrappedAngle']
 
 # Create the plot
 plt.figure(figsize=(12, 6))
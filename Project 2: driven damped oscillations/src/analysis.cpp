@@ -0,0 +1,150 @@
+#include "analysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "thread_pool.h"
+#include "trace.h"
+
+// Position in [0, 1] of the step where the cubic Hermite interpolant of the angle
+// reaches level. The linear guess is refined by Newton's method on the cubic.
+static double crossingFraction(double level, double angle0, double slope0, double angle1,
+                               double slope1) {
+    double s = (level - angle0) / (angle1 - angle0);
+    for (int iteration = 0; iteration < 4; ++iteration) {
+        double s2 = s * s, s3 = s2 * s;
+        double value = (2 * s3 - 3 * s2 + 1) * angle0 + (s3 - 2 * s2 + s) * slope0 +
+                       (-2 * s3 + 3 * s2) * angle1 + (s3 - s2) * slope1;
+        double derivative = (6 * s2 - 6 * s) * angle0 + (3 * s2 - 4 * s + 1) * slope0 +
+                            (-6 * s2 + 6 * s) * angle1 + (3 * s2 - 2 * s) * slope1;
+        if (derivative == 0.0) {
+            break;
+        }
+        s = std::min(1.0, std::max(0.0, s - (value - level) / derivative));
+    }
+    return s;
+}
+
+void PendulumEvents::observe(double time0, double angle0, double velocity0, double time1,
+                             double angle1, double velocity1) {
+    if (angle1 == angle0) {
+        return;
+    }
+    // Levels kπ inside the step: (angle0, angle1] going forward, [angle1, angle0) back
+    bool forward = angle1 > angle0;
+    double first = forward ? std::floor(angle0 / M_PI) + 1.0 : std::ceil(angle1 / M_PI);
+    double last = forward ? std::floor(angle1 / M_PI) : std::ceil(angle0 / M_PI) - 1.0;
+    double dt = time1 - time0;
+
+    for (double k = first; k <= last; k += 1.0) {
+        double s = crossingFraction(k * M_PI, angle0, velocity0 * dt, angle1, velocity1 * dt);
+        double time = time0 + s * dt;
+        if (std::fmod(k, 2.0) == 0.0) {
+            if (forward) {  // Bottom, moving forward: once per oscillation or rotation
+                if (crossings == 0) {
+                    firstCrossing = time;
+                }
+                lastCrossing = time;
+                crossings++;
+            }
+        } else {  // Over the top
+            netTurns += forward ? 1 : -1;
+            totalWraps++;
+            lastWrapTime = time;
+        }
+    }
+}
+
+double PendulumEvents::period() const {
+    if (crossings < 2) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return (lastCrossing - firstCrossing) / static_cast<double>(crossings - 1);
+}
+
+double exactFreePeriod(const OscillatorParams& params, double amplitude) {
+    if (std::fabs(amplitude) >= M_PI) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double a = 1.0, b = std::cos(0.5 * amplitude);
+    while (std::fabs(a - b) > 1e-15 * a) {
+        double mean = 0.5 * (a + b);
+        b = std::sqrt(a * b);
+        a = mean;
+    }
+    return 2.0 * M_PI * std::sqrt(params.length / OscillatorParams::gravity) / a;
+}
+
+std::vector<PeriodMeasurement> periodVsAmplitude(const OscillatorParams& params,
+                                                 const std::vector<double>& amplitudes,
+                                                 double timeStep, size_t crossings,
+                                                 ThreadPool& pool) {
+    OscillatorParams undriven = params;
+    undriven.dampingCoefficient = 0.0;
+    undriven.drivingForce = 0.0;
+
+    std::vector<PeriodMeasurement> results(amplitudes.size());
+    pool.parallelFor(amplitudes.size(), 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            TraceSpan span("amplitude", "analysis", static_cast<int64_t>(i));
+            double amplitude = amplitudes[i];
+            double exact = exactFreePeriod(undriven, amplitude);
+            results[i] = PeriodMeasurement{amplitude, std::numeric_limits<double>::quiet_NaN(),
+                                           exact};
+            if (!std::isfinite(exact) || amplitude == 0.0) {
+                continue;  // Never swings (at rest at the bottom or balanced on top)
+            }
+
+            // Released at rest: the first forward bottom crossing comes within a period
+            double endTime = exact * (crossings + 2.0);
+            OscillatorState state{0.0, amplitude, 0.0};
+            PendulumEvents events;
+            while (events.bottomCrossings() <= crossings && state.time < endTime) {
+                OscillatorState next = rk4Step(undriven, state, timeStep);
+                events.observe(state, next);
+                state = next;
+            }
+            results[i].period = events.period();
+        }
+    });
+    return results;
+}
+
+std::vector<RotationMeasurement> rotationNumbers(const std::vector<OscillatorParams>& cases,
+                                                 const OscillatorState& initial,
+                                                 size_t stepsPerPeriod, size_t transientPeriods,
+                                                 size_t periods, ThreadPool& pool) {
+    for (const OscillatorParams& params : cases) {
+        if (!(params.drivingFrequency > 0.0)) {
+            throw std::invalid_argument("rotation numbers need a positive drive frequency");
+        }
+    }
+    if (stepsPerPeriod == 0 || periods == 0) {
+        throw std::invalid_argument("rotation numbers need at least one step and one period");
+    }
+
+    std::vector<RotationMeasurement> results(cases.size());
+    pool.parallelFor(cases.size(), 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            TraceSpan span("rotation number", "analysis", static_cast<int64_t>(i));
+            const OscillatorParams& params = cases[i];
+            double timeStep = 2.0 * M_PI / params.drivingFrequency / stepsPerPeriod;
+
+            OscillatorState state = initial;
+            for (size_t step = 0; step < transientPeriods * stepsPerPeriod; ++step) {
+                state = rk4Step(params, state, timeStep);
+            }
+            PendulumEvents events;
+            for (size_t step = 0; step < periods * stepsPerPeriod; ++step) {
+                OscillatorState next = rk4Step(params, state, timeStep);
+                events.observe(state, next);
+                state = next;
+            }
+            results[i] = RotationMeasurement{static_cast<double>(events.turns()) / periods,
+                                             events.turns(), events.wraps(), events.period()};
+        }
+    });
+    return results;
+}
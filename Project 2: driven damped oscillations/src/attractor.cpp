@@ -0,0 +1,145 @@
+#include "attractor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+#include "thread_pool.h"
+#include "trace.h"
+
+AttractorHistogram::AttractorHistogram(size_t angleBins, size_t velocityBins, size_t phaseBins,
+                                       double velocityMin, double velocityMax)
+    : angleBins(angleBins),
+      velocityBins(velocityBins),
+      phaseBins(phaseBins),
+      velocityMin(velocityMin),
+      velocityMax(velocityMax) {
+    if (angleBins == 0 || velocityBins == 0 || phaseBins == 0 || !(velocityMax > velocityMin)) {
+        throw std::invalid_argument("attractor histogram needs bins and a velocity range");
+    }
+    angleScale = angleBins / (2.0 * M_PI);
+    velocityScale = velocityBins / (velocityMax - velocityMin);
+    counts.assign(angleBins * velocityBins * phaseBins, 0);
+}
+
+void AttractorHistogram::merge(const AttractorHistogram& other) {
+    if (other.angleBins != angleBins || other.velocityBins != velocityBins ||
+        other.phaseBins != phaseBins || other.velocityMin != velocityMin ||
+        other.velocityMax != velocityMax) {
+        throw std::invalid_argument("cannot merge attractor histograms with different grids");
+    }
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    inside += other.inside;
+    outside += other.outside;
+}
+
+std::vector<uint64_t> AttractorHistogram::projection() const {
+    size_t plane = angleBins * velocityBins;
+    std::vector<uint64_t> sum(counts.begin(), counts.begin() + plane);
+    for (size_t phase = 1; phase < phaseBins; ++phase) {
+        const uint64_t* slice = counts.data() + phase * plane;
+        for (size_t i = 0; i < plane; ++i) {
+            sum[i] += slice[i];
+        }
+    }
+    return sum;
+}
+
+// Writes size bytes to path in one go, throwing on any failure
+static void writeFile(const std::string& path, const std::string& header, const void* data,
+                      size_t size) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    bool ok = file != nullptr && std::fwrite(header.data(), 1, header.size(), file) ==
+                                     header.size();
+    ok = ok && (size == 0 || std::fwrite(data, 1, size, file) == size);
+    if (file != nullptr && std::fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        throw std::runtime_error("cannot write " + path);
+    }
+}
+
+void AttractorHistogram::writeNpy(const std::string& path) const {
+    // Format 1.0: magic, version, header length, then a Python dict literal padded with
+    // spaces to a multiple of 64 bytes and ended by a newline. Data little-endian (x86).
+    std::string dict = "{'descr': '<u8', 'fortran_order': False, 'shape': (" +
+                       std::to_string(phaseBins) + ", " + std::to_string(velocityBins) + ", " +
+                       std::to_string(angleBins) + "), }";
+    size_t total = 10 + dict.size() + 1;
+    dict.append((64 - total % 64) % 64, ' ');
+    dict += '\n';
+    std::string header = "\x93NUMPY\x01";
+    header += '\0';
+    header += static_cast<char>(dict.size() & 0xff);
+    header += static_cast<char>(dict.size() >> 8);
+    header += dict;
+    writeFile(path, header, counts.data(), counts.size() * sizeof(uint64_t));
+}
+
+void AttractorHistogram::writePgm(const std::string& path) const {
+    std::vector<uint64_t> density = projection();
+    uint64_t peak = *std::max_element(density.begin(), density.end());
+    double scale = peak > 0 ? 65535.0 / std::log1p(static_cast<double>(peak)) : 0.0;
+
+    // 16-bit samples are big-endian; the first row is the top (highest velocity)
+    std::vector<unsigned char> pixels(density.size() * 2);
+    for (size_t row = 0; row < velocityBins; ++row) {
+        const uint64_t* line = density.data() + (velocityBins - 1 - row) * angleBins;
+        for (size_t column = 0; column < angleBins; ++column) {
+            auto value = static_cast<unsigned>(
+                std::lround(std::log1p(static_cast<double>(line[column])) * scale));
+            pixels[2 * (row * angleBins + column)] = static_cast<unsigned char>(value >> 8);
+            pixels[2 * (row * angleBins + column) + 1] = static_cast<unsigned char>(value);
+        }
+    }
+    std::string header = "P5\n" + std::to_string(angleBins) + " " +
+                         std::to_string(velocityBins) + "\n65535\n";
+    writeFile(path, header, pixels.data(), pixels.size());
+}
+
+AttractorHistogram accumulateAttractor(const OscillatorParams& params,
+                                       const std::vector<OscillatorState>& initial,
+                                       size_t stepsPerPeriod, size_t transientPeriods,
+                                       size_t periods, const AttractorHistogram& shape,
+                                       ThreadPool& pool) {
+    if (!(params.drivingFrequency > 0.0) || stepsPerPeriod == 0) {
+        throw std::invalid_argument("the attractor needs a positive drive frequency");
+    }
+    double timeStep = 2.0 * M_PI / params.drivingFrequency / stepsPerPeriod;
+    auto emptyLike = [&shape](size_t) {
+        return AttractorHistogram(shape.angleBinCount(), shape.velocityBinCount(),
+                                  shape.phaseBinCount(), shape.velocityMinimum(),
+                                  shape.velocityMaximum());
+    };
+
+    // One grid per worker: no sharing, no atomics, merged once at the end
+    PerWorker<AttractorHistogram> local(pool, emptyLike);
+    pool.parallelFor(initial.size(), 1, [&](size_t begin, size_t end, size_t worker) {
+        AttractorHistogram& histogram = local[worker];
+        size_t phaseBins = histogram.phaseBinCount();
+        for (size_t i = begin; i < end; ++i) {
+            TraceSpan span("attractor run", "analysis", static_cast<int64_t>(i));
+            OscillatorState state = initial[i];
+            for (size_t step = 0; step < transientPeriods * stepsPerPeriod; ++step) {
+                state = rk4Step(params, state, timeStep);
+            }
+            for (size_t period = 0; period < periods; ++period) {
+                for (size_t step = 1; step <= stepsPerPeriod; ++step) {
+                    state = rk4Step(params, state, timeStep);
+                    size_t phase = step == stepsPerPeriod ? 0 : step * phaseBins / stepsPerPeriod;
+                    histogram.add(state.angle, state.angularVelocity, phase);
+                }
+            }
+        }
+    });
+
+    AttractorHistogram total = emptyLike(0);
+    for (size_t worker = 0; worker < local.size(); ++worker) {
+        total.merge(local[worker]);
+    }
+    return total;
+}
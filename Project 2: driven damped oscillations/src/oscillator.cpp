@@ -12,20 +12,71 @@
 // A driving force of 1.20 N.
 // A driving frequency of 2/3 rad/s.
 
+double OscillatorParams::angularAcceleration(double time, double angle,
+                                             double angularVelocity) const {
+    double gravityTerm = -(gravity / length) * sin(angle);
+    double dampingTerm = -(dampingCoefficient / mass) * angularVelocity;
+    double drivingTerm = (drivingForce / mass) * cos(drivingFrequency * time);
+
+    return gravityTerm + dampingTerm + drivingTerm;
+}
+
+void wrapAngle(OscillatorState& state) {
+    if (state.angle > -M_PI && state.angle <= M_PI) {
+        return;
+    }
+    // All whole turns at once, so a large angle (a state saved unwrapped) costs no more
+    // than a small one. Non-finite angles, and angles too large to count turns of, stay.
+    double turns = std::floor((state.angle + M_PI) / (2.0 * M_PI));
+    if (!std::isfinite(turns) || std::fabs(turns) > 4e18) {
+        return;
+    }
+    state.angle -= turns * 2.0 * M_PI;
+    // Rounding can leave the angle just outside (-π, π]
+    if (state.angle > M_PI) {
+        state.angle -= 2.0 * M_PI;
+        turns++;
+    } else if (state.angle <= -M_PI) {
+        state.angle += 2.0 * M_PI;
+        turns--;
+    }
+    state.turns += static_cast<int64_t>(turns);
+}
+
+OscillatorState rk4Step(const OscillatorParams& params, const OscillatorState& state,
+                        double timeStep) {
+    // Each stage: derivative of {time, angle, angularVelocity} is {1, ω, α}
+    double half = 0.5 * timeStep;
+
+    double w1 = state.angularVelocity;
+    double a1 = params.angularAcceleration(state.time, state.angle, w1);
+
+    double w2 = state.angularVelocity + half * a1;
+    double a2 = params.angularAcceleration(state.time + half, state.angle + half * w1, w2);
+
+    double w3 = state.angularVelocity + half * a2;
+    double a3 = params.angularAcceleration(state.time + half, state.angle + half * w2, w3);
+
+    double w4 = state.angularVelocity + timeStep * a3;
+    double a4 = params.angularAcceleration(state.time + timeStep, state.angle + timeStep * w3, w4);
+
+    double sixth = timeStep / 6.0;
+    OscillatorState next{state.time + sixth * 6.0,
+                         state.angle + sixth * (w1 + 2.0 * w2 + 2.0 * w3 + w4),
+                         state.angularVelocity + sixth * (a1 + 2.0 * a2 + 2.0 * a3 + a4),
+                         state.turns};
+    wrapAngle(next);
+    return next;
+}
+
 oscillator::oscillator(double mass_, double length_, double dampingCoefficient_,
                        double initialAngle_, double initialAngularVelocity_, double drivingForce_,
                        double drivingFrequency_)
-    : mass(mass_),
-      length(length_),
-      dampingCoefficient(dampingCoefficient_),
-      angle(initialAngle_),
-      angularVelocity(initialAngularVelocity_),
-      drivingForce(drivingForce_),
-      drivingFrequency(drivingFrequency_),
-      time(0.0) {}
+    : params{mass_, length_, dampingCoefficient_, drivingForce_, drivingFrequency_},
+      initial{0.0, initialAngle_, initialAngularVelocity_} {}
 
 void oscillator::computeDerivatives(const std::vector<double>& state,
-                                    std::vector<double>& derivatives, double timeStep) {
+                                    std::vector<double>& derivatives, double timeStep) const {
     double time = state[0];
     double angle = state[1];
     double angularVelocity = state[2];
@@ -34,24 +85,19 @@ void oscillator::computeDerivatives(const std::vector<double>& state,
     // Derivative of angle is angular velocity
     derivatives[1] = angularVelocity;
     // Derivative of angular velocity (equation of motion)
-    double gravityTerm = -(9.81 / length) * sin(angle);
-    double dampingTerm = -(dampingCoefficient / mass) * angularVelocity;
-    double drivingTerm = (drivingForce / mass) * cos(drivingFrequency * time);
-
-    derivatives[2] = gravityTerm + dampingTerm + drivingTerm;
-};
+    derivatives[2] = params.angularAcceleration(time, angle, angularVelocity);
+}
 
 std::vector<double> oscillator::getState() const {
-    return {time, angle, angularVelocity};
+    return {initial.time, initial.angle, initial.angularVelocity};
 }
 
 void oscillator::printParameters() const {
-    std::cout << "Mass: " << mass << " kg\n"
-              << "Length: " << length << " m\n"
-              << "Damping Coefficient: " << dampingCoefficient << "\n"
-              << "Initial Angle: " << angle << " rad\n"
-              << "Initial Angular Velocity: " << angularVelocity << " rad/s\n"
-              << "Driving Force: " << drivingForce << " N\n"
-              << "Driving Frequency: " << drivingFrequency << " rad/s\n";
+    std::cout << "Mass: " << params.mass << " kg\n"
+              << "Length: " << params.length << " m\n"
+              << "Damping Coefficient: " << params.dampingCoefficient << "\n"
+              << "Initial Angle: " << initial.angle << " rad\n"
+              << "Initial Angular Velocity: " << initial.angularVelocity << " rad/s\n"
+              << "Driving Force: " << params.drivingForce << " N\n"
+              << "Driving Frequency: " << params.drivingFrequency << " rad/s\n";
 }
-
@@ -10,7 +10,16 @@ std::vector<state_type> rk4Simulation(
     state_type& state, std::function<void(const state_type&, state_type&, double)> derivatives,
     std::function<bool(const state_type&)> stopCondition, double timeStep) {
     std::vector<state_type> trajectory;
-    trajectory.push_back(state);
+    rk4Simulation(state, derivatives, stopCondition, timeStep,
+                  [&trajectory](const state_type& s) { trajectory.push_back(s); });
+    return trajectory;
+}
+
+void rk4Simulation(state_type& state,
+                   std::function<void(const state_type&, state_type&, double)> derivatives,
+                   std::function<bool(const state_type&)> stopCondition, double timeStep,
+                   std::function<void(const state_type&)> observer) {
+    observer(state);
 
     state_type k1(state.size());
     state_type k2(state.size());
@@ -45,8 +54,7 @@ std::vector<state_type> rk4Simulation(
             state[i] += (timeStep / 6.0) * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]);
         }
 
-        trajectory.push_back(state);
+        observer(state);
         //std::cout << "Current time: " << state[0] << " seconds\r" << std::endl;
     }
-    return trajectory;
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+/**
+ * @file barnes_hut.cpp
+ * @brief Accuracy versus speed of the Barnes-Hut tree against direct summation
+ *
+ * For each N (Plummer sphere) and opening angle theta the tree is built and
+ * evaluated, and the accelerations of a fixed random sample of particles are
+ * compared with an exact direct sum for those particles. Reported:
+ *  - tree build and force times
+ *  - median, 99th percentile and maximum relative acceleration error
+ *  - speedup over the blocked direct-sum kernel (measured up to directMax,
+ *    extrapolated as N² beyond that)
+ *
+ * Build: make bench   (from the workspace root)
+ * Run:   ./bin/barnes_hut [maxN] [threads] [directMax]   (maxN up to 1000000)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../include/barnes_hut.h"
+#include "../include/particle.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Exact softened acceleration of particle i
+static Vector3D directAcceleration(const ParticleSystem& p, size_t i,
+                                   const GravitySettings& gravity) {
+    double eps2 = gravity.softening * gravity.softening;
+    double sx = 0.0, sy = 0.0, sz = 0.0;
+    for (size_t j = 0; j < p.size(); ++j) {
+        double dx = p.x[j] - p.x[i];
+        double dy = p.y[j] - p.y[i];
+        double dz = p.z[j] - p.z[i];
+        double r2 = dx * dx + dy * dy + dz * dz + eps2;
+        double scale = p.mass[j] / (r2 * std::sqrt(r2));
+        sx += dx * scale;
+        sy += dy * scale;
+        sz += dz * scale;
+    }
+    return Vector3D(sx, sy, sz) * gravity.G;
+}
+
+int main(int argc, char** argv) {
+    size_t maxN = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 100000;
+    ThreadPoolOptions options;
+    options.threads = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 0;
+    size_t directMax = argc > 3 ? static_cast<size_t>(std::atoll(argv[3])) : 20000;
+    ThreadPool pool(options);
+    GravitySettings gravity;
+    const size_t samples = 500;
+
+    std::cout << "Barnes-Hut vs direct summation on " << pool.size() << " thread(s), "
+              << samples << " sampled particles" << std::endl;
+    std::cout << std::setw(8) << "N" << std::setw(7) << "theta" << std::setw(9) << "nodes"
+              << std::setw(10) << "build(s)" << std::setw(10) << "force(s)" << std::setw(11)
+              << "median" << std::setw(11) << "p99" << std::setw(11) << "max" << std::setw(10)
+              << "speedup" << std::endl;
+
+    double directPerPair = 0.0;
+    for (size_t n : {10000, 100000, 1000000}) {
+        if (n > maxN) {
+            break;
+        }
+        ParticleSystem particles = ParticleSystem::plummer(n);
+
+        // Direct-sum cost, measured while affordable
+        if (n <= directMax || directPerPair == 0.0) {
+            ParticleSystem copy = particles;
+            auto start = Clock::now();
+            computeGravityBlocked(copy, gravity, pool);
+            directPerPair = secondsSince(start) / (static_cast<double>(n) * n);
+        }
+        double directSeconds = directPerPair * n * n;
+
+        std::mt19937 random(5);
+        std::uniform_int_distribution<size_t> pick(0, n - 1);
+        std::vector<size_t> sample(samples);
+        std::vector<Vector3D> exact(samples);
+        for (size_t s = 0; s < samples; ++s) {
+            sample[s] = pick(random);
+            exact[s] = directAcceleration(particles, sample[s], gravity);
+        }
+
+        for (double theta : {0.3, 0.5, 0.7, 1.0}) {
+            BarnesHutSettings settings;
+            settings.theta = theta;
+            BarnesHutTree tree(settings);
+            tree.build(particles, pool);  // Warm-up: sizes the node and scratch arrays
+
+            auto start = Clock::now();
+            tree.build(particles, pool);
+            double buildSeconds = secondsSince(start);
+            start = Clock::now();
+            tree.computeForces(particles, gravity, pool);
+            double forceSeconds = secondsSince(start);
+
+            std::vector<double> errors(samples);
+            for (size_t s = 0; s < samples; ++s) {
+                errors[s] = (particles.acceleration(sample[s]) - exact[s]).magnitude() /
+                            exact[s].magnitude();
+            }
+            std::sort(errors.begin(), errors.end());
+
+            std::cout << std::setw(8) << n << std::setw(7) << theta << std::setw(9)
+                      << tree.nodeCount() << std::setw(10) << std::setprecision(3)
+                      << buildSeconds << std::setw(10) << forceSeconds << std::setw(11)
+                      << errors[samples / 2] << std::setw(11) << errors[samples * 99 / 100]
+                      << std::setw(11) << errors.back() << std::setw(10) << std::setprecision(1)
+                      << std::fixed << directSeconds / (buildSeconds + forceSeconds)
+                      << std::defaultfloat << (n > directMax ? "*" : "") << std::endl;
+        }
+    }
+    std::cout << "* direct-sum time extrapolated as N^2" << std::endl;
+    return 0;
+}
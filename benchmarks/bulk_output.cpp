@@ -0,0 +1,128 @@
+/**
+ * @file bulk_output.cpp
+ * @brief Cost of writing thousands of small per-run output files
+ *
+ * Writes the same set of small runs four ways:
+ *  - std::ofstream per file on the calling thread (what CSVPrint does)
+ *  - BulkFileWriter with the POSIX backend (batched on a background thread)
+ *  - BulkFileWriter with io_uring (one submission per phase per batch)
+ *  - one RunArchive container holding every run as a segment
+ *
+ * The io_uring row is skipped when the kernel or a sandbox does not allow it.
+ *
+ * Build: make bench   (from the workspace root)
+ * Run:   ./bin/bulk_output [files] [bytesPerFile] [directory]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../include/bulk_file_writer.h"
+#include "../include/run_archive.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// A CSV body of roughly the requested size
+static std::string makeContents(size_t bytes) {
+    std::string text = "#Benchmark file\nTime,X,Y,Z\n";
+    for (int i = 0; text.size() < bytes; ++i) {
+        text += std::to_string(i * 0.001) + ",1.5,0,0.25\n";
+    }
+    return text;
+}
+
+static void removeFiles(const std::vector<std::string>& names) {
+    for (const std::string& name : names) {
+        unlink(name.c_str());
+    }
+}
+
+static void report(const char* label, size_t files, double seconds, size_t failures) {
+    std::cout << std::setw(12) << label << std::setw(12) << std::fixed << std::setprecision(3)
+              << seconds << std::setw(14) << std::setprecision(0) << (files / seconds);
+    if (failures > 0) {
+        std::cout << "   (" << failures << " failed)";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t files = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 5000;
+    size_t bytes = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 2048;
+    std::string directory = argc > 3 ? argv[3] : "/tmp/bulk_output_bench";
+    if (directory.back() != '/') {
+        directory += '/';
+    }
+    std::string command = "mkdir -p '" + directory + "'";
+    if (std::system(command.c_str()) != 0) {
+        std::cerr << "Error: Could not create " << directory << std::endl;
+        return 1;
+    }
+
+    std::string contents = makeContents(bytes);
+    std::vector<std::string> names(files);
+    for (size_t i = 0; i < files; ++i) {
+        names[i] = directory + "run_" + std::to_string(i) + ".csv";
+    }
+
+    std::cout << files << " files of " << contents.size() << " bytes in " << directory
+              << std::endl;
+    std::cout << std::setw(12) << "method" << std::setw(12) << "time(s)" << std::setw(14)
+              << "files/s" << std::endl;
+
+    auto start = Clock::now();
+    for (const std::string& name : names) {
+        std::ofstream file(name);
+        file << contents;
+    }
+    report("ofstream", files, secondsSince(start), 0);
+    removeFiles(names);
+
+    BulkFileWriter::Backend backends[] = {BulkFileWriter::Backend::Posix,
+                                          BulkFileWriter::Backend::IoUring};
+    for (BulkFileWriter::Backend requested : backends) {
+        start = Clock::now();
+        BulkFileWriter writer(requested);
+        if (writer.backend() != requested) {
+            std::cout << std::setw(12) << BulkFileWriter::backendName(requested)
+                      << "   unavailable on this system" << std::endl;
+            continue;
+        }
+        for (const std::string& name : names) {
+            writer.add(name, contents);
+        }
+        size_t failures = writer.flush();
+        report(BulkFileWriter::backendName(writer.backend()), files, secondsSince(start),
+               failures);
+        removeFiles(names);
+    }
+
+    // Same payload as one segment per run in a single file
+    std::vector<double> rows((contents.size() + 7) / 8);
+    std::memcpy(rows.data(), contents.data(), contents.size());
+    std::string archivePath = directory + "runs.nmra";
+    start = Clock::now();
+    {
+        RunArchiveWriter archive(archivePath, RunArchiveLayout{{"Run"}, {}, {"Data"}});
+        for (size_t i = 0; i < files; ++i) {
+            double run = static_cast<double>(i);
+            archive.append(i, &run, nullptr, rows.data(), rows.size());
+        }
+        archive.close();
+    }
+    report("archive", files, secondsSince(start), 0);
+    unlink(archivePath.c_str());
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file csv_loader.cpp
+ * @brief Loading a large launch CSV with CsvTable against istream extraction
+ *
+ * Writes N rows of launch conditions (position, velocity, spin, wind, mass)
+ * to a temporary file, then reads it back three ways:
+ *  - std::ifstream with operator>> per field, as the interactive prompts do
+ *  - CsvTable::load on the calling thread (mmap + std::from_chars)
+ *  - CsvTable::load with the chunks parsed across the thread pool
+ * and reports rows per second, MB/s and whether all three agree.
+ *
+ * Build: make bench   (from the workspace root)
+ * Run:   ./bin/csv_loader [rows] [threads]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/csv_loader.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+    ThreadPoolOptions options;
+    options.threads = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 0;
+    ThreadPool pool(options);
+
+    const std::vector<std::string> names = {"x",      "y",      "z",      "vx",     "vy",
+                                            "vz",     "spin_x", "spin_y", "spin_z", "wind_x",
+                                            "wind_y", "wind_z", "mass"};
+    const std::string path = "/tmp/nm_csv_loader_bench.csv";
+    std::mt19937 random(5);
+    std::uniform_real_distribution<double> value(-50.0, 50.0);
+    {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            std::cerr << "Cannot write " << path << std::endl;
+            return 1;
+        }
+        for (size_t c = 0; c < names.size(); ++c) {
+            std::fprintf(file, "%s%s", names[c].c_str(), c + 1 < names.size() ? "," : "\n");
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t c = 0; c < names.size(); ++c) {
+                std::fprintf(file, "%.17g%c", value(random), c + 1 < names.size() ? ',' : '\n');
+            }
+        }
+        std::fclose(file);
+    }
+    std::ifstream sizeCheck(path, std::ios::binary | std::ios::ate);
+    double megabytes = static_cast<double>(sizeCheck.tellg()) / (1024.0 * 1024.0);
+
+    // operator>> per field, one column vector each
+    auto start = Clock::now();
+    std::vector<std::vector<double>> streamed(names.size());
+    {
+        std::ifstream in(path);
+        std::string header;
+        std::getline(in, header);
+        double field;
+        char separator;
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t c = 0; c < names.size(); ++c) {
+                in >> field;
+                streamed[c].push_back(field);
+                if (c + 1 < names.size()) {
+                    in >> separator;
+                }
+            }
+        }
+    }
+    double streamSeconds = secondsSince(start);
+
+    start = Clock::now();
+    CsvTable serial = CsvTable::load(path);
+    double serialSeconds = secondsSince(start);
+
+    start = Clock::now();
+    CsvTable parallel = CsvTable::load(path, &pool);
+    double parallelSeconds = secondsSince(start);
+    std::remove(path.c_str());
+
+    bool same = serial.rows() == rows && parallel.rows() == rows;
+    for (size_t c = 0; same && c < names.size(); ++c) {
+        same = serial.column(names[c]) == parallel.column(names[c]) &&
+               serial.column(names[c]) == streamed[c];
+    }
+
+    std::cout << rows << " rows x " << names.size() << " columns (" << std::fixed
+              << std::setprecision(1) << megabytes << " MB), " << pool.size() << " thread(s)"
+              << std::endl;
+    auto report = [&](const char* name, double seconds) {
+        std::cout << std::setw(22) << name << std::setw(10) << std::setprecision(3) << seconds
+                  << " s" << std::setw(10) << std::setprecision(2) << rows / seconds / 1e6
+                  << " Mrows/s" << std::setw(9) << std::setprecision(0) << megabytes / seconds
+                  << " MB/s" << std::setw(8) << std::setprecision(1)
+                  << streamSeconds / seconds << "x" << std::endl;
+    };
+    report("ifstream >>", streamSeconds);
+    report("CsvTable (1 thread)", serialSeconds);
+    report("CsvTable (pool)", parallelSeconds);
+    std::cout << (same ? "All three agree bit for bit" : "MISMATCH between loaders") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file expression.cpp
+ * @brief Cost of runtime-defined derivatives against the same equations in C++
+ *
+ * An ensemble of driven damped pendulums (the Project 2 model) is advanced
+ * with RK4 three ways:
+ *  - native: the equation of motion written in C++
+ *  - bytecode: OdeModel::derivatives, one system at a time
+ *  - batched: OdeModel::derivativesBatch over the whole ensemble per stage
+ * Reported: nanoseconds per derivative evaluation, the overhead relative to
+ * native code, and the largest difference in the final angles.
+ *
+ * Build: make bench   (from the workspace root)
+ * Run:   ./bin/expression [systems] [steps]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "../include/expression.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static const char* model = R"(
+param g = 9.81
+param L = 9.8
+param m = 1.0
+param b = 0.5
+param F = 1.2
+param Omega = 2/3
+state theta = 0.2
+state omega = 0
+theta' = omega
+omega' = -(g / L) * sin(theta) - b / m * omega + F / m * cos(Omega * t)
+)";
+
+static void nativeDerivatives(double t, const double* y, double* dy) {
+    dy[0] = y[1];
+    dy[1] = -(9.81 / 9.8) * std::sin(y[0]) - (0.5 / 1.0) * y[1] +
+            (1.2 / 1.0) * std::cos(2.0 / 3.0 * t);
+}
+
+// RK4 over every system, one at a time; derivative(t, y, dy) for two-variable states
+template <typename Derivative>
+static void stepEach(std::vector<double>& theta, std::vector<double>& omega, double t, double h,
+                     Derivative derivative) {
+    for (size_t i = 0; i < theta.size(); ++i) {
+        double y[2] = {theta[i], omega[i]}, k1[2], k2[2], k3[2], k4[2], s[2];
+        derivative(t, y, k1);
+        s[0] = y[0] + 0.5 * h * k1[0];
+        s[1] = y[1] + 0.5 * h * k1[1];
+        derivative(t + 0.5 * h, s, k2);
+        s[0] = y[0] + 0.5 * h * k2[0];
+        s[1] = y[1] + 0.5 * h * k2[1];
+        derivative(t + 0.5 * h, s, k3);
+        s[0] = y[0] + h * k3[0];
+        s[1] = y[1] + h * k3[1];
+        derivative(t + h, s, k4);
+        theta[i] += h / 6.0 * (k1[0] + 2.0 * k2[0] + 2.0 * k3[0] + k4[0]);
+        omega[i] += h / 6.0 * (k1[1] + 2.0 * k2[1] + 2.0 * k3[1] + k4[1]);
+    }
+}
+
+// The same RK4 step with each stage evaluated for the whole ensemble at once
+struct BatchStepper {
+    const OdeModel& ode;
+    size_t n;
+    std::vector<double> time, sTheta, sOmega;
+    std::vector<double> k[4][2];
+
+    BatchStepper(const OdeModel& model, size_t count)
+        : ode(model), n(count), time(count), sTheta(count), sOmega(count) {
+        for (auto& stage : k) {
+            stage[0].resize(count);
+            stage[1].resize(count);
+        }
+    }
+
+    void stage(double t, const double* theta, const double* omega, std::vector<double>* out) {
+        std::fill(time.begin(), time.end(), t);
+        const double* state[2] = {theta, omega};
+        double* derivative[2] = {out[0].data(), out[1].data()};
+        ode.derivativesBatch(n, time.data(), state, derivative);
+    }
+
+    void step(std::vector<double>& theta, std::vector<double>& omega, double t, double h) {
+        const double factor[3] = {0.5 * h, 0.5 * h, h};
+        stage(t, theta.data(), omega.data(), k[0]);
+        for (int s = 1; s < 4; ++s) {
+            for (size_t i = 0; i < n; ++i) {
+                sTheta[i] = theta[i] + factor[s - 1] * k[s - 1][0][i];
+                sOmega[i] = omega[i] + factor[s - 1] * k[s - 1][1][i];
+            }
+            stage(t + factor[s - 1], sTheta.data(), sOmega.data(), k[s]);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            theta[i] += h / 6.0 * (k[0][0][i] + 2.0 * k[1][0][i] + 2.0 * k[2][0][i] + k[3][0][i]);
+            omega[i] += h / 6.0 * (k[0][1][i] + 2.0 * k[1][1][i] + 2.0 * k[2][1][i] + k[3][1][i]);
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    size_t systems = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 4096;
+    size_t steps = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 200;
+    const double h = 0.04;
+
+    std::istringstream text(model);
+    OdeModel ode = OdeModel::parse(text);
+    std::cout << "Pendulum ensemble: " << systems << " systems x " << steps << " RK4 steps, "
+              << ode.program().code().size() << " instructions, "
+              << ode.program().registerCount() << " registers" << std::endl;
+
+    // Initial angles spread over a range, so every system follows its own path
+    std::vector<double> theta0(systems), omega0(systems, 0.0);
+    for (size_t i = 0; i < systems; ++i) {
+        theta0[i] = 0.2 + 2.0 * static_cast<double>(i) / systems;
+    }
+    double evaluations = 4.0 * systems * steps;
+
+    std::vector<double> nativeTheta = theta0, nativeOmega = omega0;
+    auto start = Clock::now();
+    for (size_t s = 0; s < steps; ++s) {
+        stepEach(nativeTheta, nativeOmega, s * h, h, nativeDerivatives);
+    }
+    double nativeSeconds = secondsSince(start);
+
+    std::vector<double> scalarTheta = theta0, scalarOmega = omega0;
+    start = Clock::now();
+    for (size_t s = 0; s < steps; ++s) {
+        stepEach(scalarTheta, scalarOmega, s * h, h,
+                 [&](double t, const double* y, double* dy) { ode.derivatives(t, y, dy); });
+    }
+    double scalarSeconds = secondsSince(start);
+
+    std::vector<double> batchTheta = theta0, batchOmega = omega0;
+    BatchStepper batch(ode, systems);
+    start = Clock::now();
+    for (size_t s = 0; s < steps; ++s) {
+        batch.step(batchTheta, batchOmega, s * h, h);
+    }
+    double batchSeconds = secondsSince(start);
+
+    auto maxDifference = [&](const std::vector<double>& angles) {
+        double worst = 0.0;
+        for (size_t i = 0; i < systems; ++i) {
+            worst = std::max(worst, std::fabs(angles[i] - nativeTheta[i]));
+        }
+        return worst;
+    };
+
+    std::cout << std::setw(10) << "variant" << std::setw(12) << "ns/eval" << std::setw(11)
+              << "overhead" << std::setw(14) << "max |dtheta|" << std::endl;
+    auto report = [&](const char* name, double seconds, double difference) {
+        std::cout << std::setw(10) << name << std::fixed << std::setprecision(2) << std::setw(12)
+                  << 1e9 * seconds / evaluations << std::setw(10) << seconds / nativeSeconds
+                  << "x" << std::scientific << std::setprecision(1) << std::setw(14)
+                  << difference << std::defaultfloat << std::endl;
+    };
+    report("native", nativeSeconds, 0.0);
+    report("bytecode", scalarSeconds, maxDifference(scalarTheta));
+    report("batched", batchSeconds, maxDifference(batchTheta));
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file nbody.cpp
+ * @brief Direct-sum gravity kernels and leapfrog stepping from 1k to 100k particles
+ *
+ * For each N (Plummer sphere) one force evaluation is timed with:
+ *  - the reference kernel (one target at a time, skipped above referenceMax)
+ *  - the blocked SIMD kernel
+ * and reported as pair interactions per second and GFLOP/s (20 flops per
+ * interaction, the usual convention). The largest relative difference between
+ * the two kernels is printed wherever both ran.
+ *
+ * Finally a 1k-particle cluster is stepped with the leapfrog integrator to show
+ * the relative energy error staying bounded.
+ *
+ * Build: make bench   (from the workspace root; make NATIVE=1 for AVX2/AVX-512)
+ * Run:   ./bin/nbody [maxN] [threads] [referenceMax]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "../include/integrator.h"
+#include "../include/particle.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Seconds per call, repeating fast calls until at least 0.2 s have passed
+template <typename Kernel>
+static double timeKernel(Kernel kernel) {
+    size_t calls = 0;
+    auto start = Clock::now();
+    do {
+        kernel();
+        calls++;
+    } while (secondsSince(start) < 0.2);
+    return secondsSince(start) / calls;
+}
+
+static double maxRelativeDifference(const ParticleSystem& a, const ParticleSystem& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        double difference = (a.acceleration(i) - b.acceleration(i)).magnitude();
+        worst = std::max(worst, difference / a.acceleration(i).magnitude());
+    }
+    return worst;
+}
+
+int main(int argc, char** argv) {
+    size_t maxN = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 100000;
+    ThreadPoolOptions options;
+    options.threads = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 0;
+    size_t referenceMax = argc > 3 ? static_cast<size_t>(std::atoll(argv[3])) : 20000;
+    ThreadPool pool(options);
+    GravitySettings gravity;
+
+    std::cout << "Direct-sum gravity on " << pool.size() << " thread(s)" << std::endl;
+    std::cout << std::setw(8) << "N" << std::setw(14) << "reference(s)" << std::setw(12)
+              << "blocked(s)" << std::setw(14) << "pairs/s" << std::setw(10) << "GFLOP/s"
+              << std::setw(10) << "speedup" << std::setw(12) << "max rel" << std::endl;
+
+    for (size_t n : {1000, 2000, 5000, 10000, 20000, 50000, 100000}) {
+        if (n > maxN) {
+            break;
+        }
+        ParticleSystem blocked = ParticleSystem::plummer(n);
+        double blockedSeconds =
+            timeKernel([&] { computeGravityBlocked(blocked, gravity, pool); });
+        double pairs = static_cast<double>(n) * n / blockedSeconds;
+
+        std::cout << std::setw(8) << n;
+        if (n <= referenceMax) {
+            ParticleSystem reference = blocked;
+            double referenceSeconds =
+                timeKernel([&] { computeGravityDirect(reference, gravity, pool); });
+            std::cout << std::setw(14) << std::setprecision(4) << referenceSeconds;
+            std::cout << std::setw(12) << blockedSeconds << std::setw(14) << std::setprecision(3)
+                      << pairs << std::setw(10) << std::fixed << std::setprecision(2)
+                      << pairs * 20e-9 << std::setw(10) << referenceSeconds / blockedSeconds
+                      << std::defaultfloat << std::setw(12) << std::setprecision(2)
+                      << maxRelativeDifference(reference, blocked) << std::endl;
+        } else {
+            std::cout << std::setw(14) << "-" << std::setw(12) << std::setprecision(4)
+                      << blockedSeconds << std::setw(14) << std::setprecision(3) << pairs
+                      << std::setw(10) << std::fixed << std::setprecision(2) << pairs * 20e-9
+                      << std::defaultfloat << std::endl;
+        }
+    }
+
+    // Energy conservation of the integrator on a small cluster
+    ParticleSystem cluster = ParticleSystem::plummer(1000);
+    LeapfrogIntegrator leapfrog(
+        [&](ParticleSystem& p) { computeGravityBlocked(p, gravity, pool); });
+    double initial = cluster.kineticEnergy() + cluster.potentialEnergy(gravity.G, gravity.softening);
+    std::cout << std::endl << "Leapfrog, N = 1000, dt = 0.001" << std::endl;
+    std::cout << std::setw(8) << "time" << std::setw(16) << "dE/E" << std::endl;
+    auto start = Clock::now();
+    for (int block = 1; block <= 5; ++block) {
+        leapfrog.run(cluster, 0.001, 200);
+        double energy =
+            cluster.kineticEnergy() + cluster.potentialEnergy(gravity.G, gravity.softening);
+        std::cout << std::setw(8) << leapfrog.time() << std::setw(16) << std::setprecision(3)
+                  << (energy - initial) / std::fabs(initial) << std::endl;
+    }
+    std::cout << leapfrog.steps() << " steps in " << secondsSince(start) << " s" << std::endl;
+    return 0;
+}
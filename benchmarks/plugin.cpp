@@ -0,0 +1,117 @@
+/**
+ * @file plugin.cpp
+ * @brief Cost of derivatives loaded from a plugin against the same equations compiled in
+ *
+ * The derivatives of an ensemble of Duffing oscillators are evaluated three
+ * ways:
+ *  - native: the equation of motion written in C++ in this file
+ *  - plugin: PluginModel::evaluate, one indirect call per system
+ *  - batched: PluginModel::evaluateBatch, one call for the whole ensemble
+ * Reported: nanoseconds per derivative evaluation, the overhead relative to
+ * native code, and the largest difference from it.
+ *
+ * Build: make bench   (from the workspace root; also builds bin/plugins/duffing.so)
+ * Run:   ./bin/plugin [systems] [rounds]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "../include/plugin_loader.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The plugin's default parameters, written out
+static void nativeDerivatives(double t, const double* y, double* dy) {
+    dy[0] = y[1];
+    dy[1] = 0.5 * std::cos(1.2 * t) - 0.3 * y[1] - (-1.0) * y[0] - 1.0 * y[0] * y[0] * y[0];
+}
+
+int main(int argc, char** argv) {
+    size_t systems = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 4096;
+    size_t rounds = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 400;
+
+    PluginRegistry registry;
+    try {
+        registry.load("bin/plugins/duffing.so");
+    } catch (const PluginError& error) {
+        std::cerr << "Error: " << error.what() << " (run from the workspace root after make)"
+                  << std::endl;
+        return 1;
+    }
+    const PluginModel& model = *registry.find("duffing", NM_MODEL_ODE);
+    std::cout << "Duffing ensemble: " << systems << " systems x " << rounds << " rounds"
+              << std::endl;
+
+    std::vector<double> t(systems), x(systems), v(systems);
+    for (size_t i = 0; i < systems; ++i) {
+        t[i] = 0.01 * static_cast<double>(i);
+        x[i] = -1.5 + 3.0 * static_cast<double>(i) / systems;
+        v[i] = 0.5 - static_cast<double>(i) / systems;
+    }
+    std::vector<double> nativeDx(systems), nativeDv(systems);
+    std::vector<double> pluginDx(systems), pluginDv(systems);
+    std::vector<double> batchDx(systems), batchDv(systems);
+    double evaluations = static_cast<double>(systems) * rounds;
+
+    // Each kernel writes its results so the work cannot be optimized away
+    auto start = Clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < systems; ++i) {
+            double y[2] = {x[i], v[i]}, dy[2];
+            nativeDerivatives(t[i], y, dy);
+            nativeDx[i] = dy[0];
+            nativeDv[i] = dy[1];
+        }
+    }
+    double nativeSeconds = secondsSince(start);
+
+    start = Clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < systems; ++i) {
+            double y[2] = {x[i], v[i]}, dy[2];
+            model.evaluate(t[i], y, dy);
+            pluginDx[i] = dy[0];
+            pluginDv[i] = dy[1];
+        }
+    }
+    double pluginSeconds = secondsSince(start);
+
+    const double* state[2] = {x.data(), v.data()};
+    double* derivative[2] = {batchDx.data(), batchDv.data()};
+    start = Clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        model.evaluateBatch(systems, t.data(), state, derivative);
+    }
+    double batchSeconds = secondsSince(start);
+
+    auto maxDifference = [&](const std::vector<double>& dv) {
+        double worst = 0.0;
+        for (size_t i = 0; i < systems; ++i) {
+            worst = std::max(worst, std::fabs(dv[i] - nativeDv[i]));
+        }
+        return worst;
+    };
+
+    std::cout << std::setw(10) << "variant" << std::setw(12) << "ns/eval" << std::setw(11)
+              << "overhead" << std::setw(14) << "max |ddv|" << std::endl;
+    auto report = [&](const char* name, double seconds, double difference) {
+        std::cout << std::setw(10) << name << std::fixed << std::setprecision(2) << std::setw(12)
+                  << 1e9 * seconds / evaluations << std::setw(10) << seconds / nativeSeconds
+                  << "x" << std::scientific << std::setprecision(1) << std::setw(14)
+                  << difference << std::defaultfloat << std::endl;
+    };
+    report("native", nativeSeconds, 0.0);
+    report("plugin", pluginSeconds, maxDifference(pluginDv));
+    report("batched", batchSeconds, maxDifference(batchDv));
+    return 0;
+}
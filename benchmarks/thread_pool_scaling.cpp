@@ -0,0 +1,152 @@
+/**
+ * @file thread_pool_scaling.cpp
+ * @brief Scaling of the NUMA-aware ThreadPool across threads and sockets
+ *
+ * Two workloads:
+ *  - Collatz range scan (compute bound, per-worker accumulators)
+ *  - Triad a = b + s*c (memory bound), once with arrays initialised by the
+ *    main thread (all pages on one node) and once with parallel first-touch
+ *    initialisation using the same partition as the triad.
+ *
+ * On a multi-socket machine the first-touch triad keeps scaling after the
+ * first socket is full, while the main-thread variant flattens out.
+ *
+ * Build: make bench   (from the workspace root)
+ * Run:   ./bin/thread_pool_scaling [collatzLimit] [arrayMiB]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "../collatz_project/collatz.h"
+#include "../include/perf_counters.h"
+#include "../include/thread_pool.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Thread counts 1, 2, 4, ... up to and including max
+static std::vector<size_t> threadCounts(size_t max) {
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < max; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max);
+    return counts;
+}
+
+static double collatzScan(ThreadPool& pool, long long limit, long long& longest) {
+    PerWorker<long long> best(pool, [](size_t) { return 0LL; });
+    auto start = Clock::now();
+    pool.parallelFor(static_cast<size_t>(limit - 1), 4096, [&](size_t b, size_t e, size_t w) {
+        PerfScope scope("collatz loop");
+        long long& local = best[w];
+        for (size_t i = b; i < e; ++i) {
+            long long length = collatzLength(static_cast<long long>(i) + 1);
+            if (length > local) {
+                local = length;
+            }
+        }
+    });
+    double seconds = secondsSince(start);
+    longest = 0;
+    for (size_t w = 0; w < best.size(); ++w) {
+        longest = std::max(longest, best[w]);
+    }
+    return seconds;
+}
+
+static double triad(ThreadPool& pool, size_t n, bool firstTouch) {
+    std::unique_ptr<double[]> a(new double[n]);
+    std::unique_ptr<double[]> b(new double[n]);
+    std::unique_ptr<double[]> c(new double[n]);
+    auto init = [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            a[i] = 0.0;
+            b[i] = 1.0;
+            c[i] = 2.0;
+        }
+    };
+    if (firstTouch) {
+        pool.parallelFor(n, 0, init);
+    } else {
+        init(0, n, 0);
+    }
+
+    const int repeats = 5;
+    auto start = Clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        pool.parallelFor(n, 0, [&](size_t begin, size_t end, size_t) {
+            PerfScope scope("triad");
+            for (size_t i = begin; i < end; ++i) {
+                a[i] = b[i] + 3.0 * c[i];
+            }
+        });
+    }
+    double seconds = secondsSince(start);
+    return repeats * 3.0 * n * sizeof(double) / seconds / 1e9;  // GB/s
+}
+
+int main(int argc, char** argv) {
+    long long collatzLimit = argc > 1 ? std::atoll(argv[1]) : 2000000;
+    size_t arrayMiB = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 64;
+    size_t arrayLength = arrayMiB * 1024 * 1024 / sizeof(double);
+
+    // Counters show why the scaling differs: the Collatz loop is compute
+    // bound, the triad waits on memory
+    PerfProfile::enable();
+
+    CpuTopology topology = CpuTopology::detect();
+    size_t cpuCount = 0;
+    std::cout << "NUMA nodes: " << topology.nodeCount() << std::endl;
+    for (size_t node = 0; node < topology.nodeCount(); ++node) {
+        std::cout << "  node " << node << ": " << topology.nodeCpus[node].size() << " CPUs"
+                  << std::endl;
+        cpuCount += topology.nodeCpus[node].size();
+    }
+    std::cout << std::endl;
+
+    std::cout << "Collatz scan 1.." << collatzLimit << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(8) << "nodes" << std::setw(12) << "time(s)"
+              << std::setw(12) << "Mnum/s" << std::setw(10) << "speedup" << std::endl;
+    double baseline = 0.0;
+    for (size_t threads : threadCounts(cpuCount)) {
+        ThreadPoolOptions options;
+        options.threads = threads;
+        ThreadPool pool(options);
+        long long longest = 0;
+        double seconds = collatzScan(pool, collatzLimit, longest);
+        if (baseline == 0.0) {
+            baseline = seconds;
+        }
+        std::cout << std::setw(8) << threads << std::setw(8) << pool.nodeCount() << std::setw(12)
+                  << std::fixed << std::setprecision(3) << seconds << std::setw(12)
+                  << (collatzLimit / seconds / 1e6) << std::setw(10) << (baseline / seconds)
+                  << "   (longest " << longest << ")" << std::endl;
+    }
+    std::cout << std::endl;
+
+    std::cout << "Triad a = b + s*c, 3 x " << arrayMiB << " MiB (GB/s)" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(8) << "nodes" << std::setw(14)
+              << "main-touch" << std::setw(14) << "first-touch" << std::endl;
+    for (size_t threads : threadCounts(cpuCount)) {
+        ThreadPoolOptions options;
+        options.threads = threads;
+        ThreadPool pool(options);
+        double mainTouch = triad(pool, arrayLength, false);
+        double firstTouch = triad(pool, arrayLength, true);
+        std::cout << std::setw(8) << threads << std::setw(8) << pool.nodeCount() << std::setw(14)
+                  << std::setprecision(2) << mainTouch << std::setw(14) << firstTouch
+                  << std::endl;
+    }
+    std::cout << std::endl;
+    PerfProfile::print(std::cout);
+    return 0;
+}
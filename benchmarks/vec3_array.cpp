@@ -0,0 +1,118 @@
+/**
+ * @file vec3_array.cpp
+ * @brief Bulk Vec3Array operations against per-object Vector3D loops
+ *
+ * For N vectors each operation is timed three ways:
+ *  - a loop over std::vector<Vector3D> using the Vector3D member functions
+ *  - the Vec3Array bulk operation on the calling thread
+ *  - the same operation split across the thread pool
+ * and reported in nanoseconds per vector. The AoS↔SoA conversions are timed
+ * as well, since batched engines pay for them at their edges.
+ *
+ * Build: make bench   (from the workspace root; make NATIVE=1 for AVX2/AVX-512)
+ * Run:   ./bin/vec3_array [N] [threads]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/vec3_array.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Seconds per call, repeating fast calls until at least 0.2 s have passed
+template <typename Kernel>
+static double timeKernel(Kernel kernel) {
+    size_t calls = 0;
+    auto start = Clock::now();
+    do {
+        kernel();
+        calls++;
+    } while (secondsSince(start) < 0.2);
+    return secondsSince(start) / calls;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+    ThreadPoolOptions options;
+    options.threads = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 0;
+    ThreadPool pool(options);
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> component(-1.0, 1.0);
+    std::vector<Vector3D> aosA(n), aosB(n), aosOut(n);
+    std::vector<double> aosScalar(n);
+    for (size_t i = 0; i < n; ++i) {
+        aosA[i] = Vector3D(component(random), component(random), component(random));
+        aosB[i] = Vector3D(component(random), component(random), component(random));
+    }
+    Vec3Array a = Vec3Array::fromAoS(aosA);
+    Vec3Array b = Vec3Array::fromAoS(aosB);
+    Vec3Array out(n);
+    AlignedVector scalar(n);
+
+    std::cout << n << " vectors, " << pool.size() << " thread(s), ns per vector" << std::endl;
+    std::cout << std::setw(12) << "operation" << std::setw(12) << "Vector3D" << std::setw(12)
+              << "Vec3Array" << std::setw(12) << "threaded" << std::setw(10) << "speedup"
+              << std::endl;
+    auto report = [&](const std::string& name, double aos, double soa, double threaded) {
+        double scale = 1e9 / n;
+        std::cout << std::setw(12) << name << std::fixed << std::setprecision(3) << std::setw(12)
+                  << aos * scale << std::setw(12) << soa * scale << std::setw(12)
+                  << threaded * scale << std::setprecision(1) << std::setw(10) << aos / threaded
+                  << std::defaultfloat << std::endl;
+    };
+
+    const double h = 1e-9;  // Keeps repeated axpy calls from overflowing
+    report("axpy",
+           timeKernel([&] {
+               for (size_t i = 0; i < n; ++i) {
+                   aosB[i] = aosB[i] + aosA[i] * h;
+               }
+           }),
+           timeKernel([&] { axpy(h, a, b); }), timeKernel([&] { axpy(h, a, b, &pool); }));
+    report("dot",
+           timeKernel([&] {
+               for (size_t i = 0; i < n; ++i) {
+                   aosScalar[i] = aosA[i].dot(aosB[i]);
+               }
+           }),
+           timeKernel([&] { dot(a, b, scalar); }), timeKernel([&] { dot(a, b, scalar, &pool); }));
+    report("cross",
+           timeKernel([&] {
+               for (size_t i = 0; i < n; ++i) {
+                   aosOut[i] = aosA[i].cross(aosB[i]);
+               }
+           }),
+           timeKernel([&] { cross(a, b, out); }), timeKernel([&] { cross(a, b, out, &pool); }));
+    report("norm",
+           timeKernel([&] {
+               for (size_t i = 0; i < n; ++i) {
+                   aosScalar[i] = aosA[i].magnitude();
+               }
+           }),
+           timeKernel([&] { norm(a, scalar); }), timeKernel([&] { norm(a, scalar, &pool); }));
+    report("normalize",
+           timeKernel([&] {
+               for (size_t i = 0; i < n; ++i) {
+                   aosA[i] = aosA[i].normalized();
+               }
+           }),
+           timeKernel([&] { normalize(a); }), timeKernel([&] { normalize(a, &pool); }));
+
+    double toSoA = timeKernel([&] { a = Vec3Array::fromAoS(aosA); });
+    double toAoS = timeKernel([&] { aosOut = a.toAoS(); });
+    std::cout << "fromAoS " << std::fixed << std::setprecision(3) << 1e9 * toSoA / n
+              << " ns, toAoS " << 1e9 * toAoS / n << " ns per vector" << std::defaultfloat
+              << std::endl;
+    return 0;
+}
@@ -1,25 +1,9 @@
 #include <iostream>
 #include <limits>
 
-using namespace std;
-
-long long collatzSequence(long long n, long long& maxNum) {
-    maxNum = n;
+#include "collatz.h"
 
-    while (n != 1) {
-        if (n > maxNum) {
-            maxNum = n;
-        }
-
-        if (n % 2 == 0) {
-            n = n / 2;
-        } else {
-            n = 3 * n + 1;
-        }
-    }
-
-    return maxNum;
-}
+using namespace std;
 
 int main() {
     long long current = 1;
@@ -31,17 +15,7 @@ int main() {
 
     while (true) {
         cout << "Starting number: " << current << endl;
-        long long count = 0;
-        long long temp = current;
-        while (temp != 1) {
-            count++;
-            if (temp % 2 == 0) {
-                temp = temp / 2;
-            } else {
-                temp = 3 * temp + 1;
-            }
-        }
-        count++;  // count the final 1
+        long long count = collatzLength(current);
         cout << "Sequence length: " << count << endl;
 
         maxInSequence = collatzSequence(current, maxInSequence);
@@ -0,0 +1,76 @@
+/*
+ * collatz.h
+ *
+ * Shared 3n+1 kernels used by the Collatz programs and the embedding library.
+ * Header-only so the single-file programs in this folder still build with F5.
+ */
+
+#ifndef COLLATZ_H
+#define COLLATZ_H
+
+#include <limits>
+
+// Largest value reached by the sequence starting at n (n itself included).
+// The result is also stored in maxNum, matching the original programs.
+inline long long collatzSequence(long long n, long long& maxNum) {
+    maxNum = n;
+
+    while (n != 1) {
+        if (n > maxNum) {
+            maxNum = n;
+        }
+
+        if (n % 2 == 0) {
+            n = n / 2;
+        } else {
+            n = 3 * n + 1;
+        }
+    }
+
+    return maxNum;
+}
+
+// Number of values in the sequence starting at n, counting n and the final 1
+inline long long collatzLength(long long n) {
+    long long count = 1;
+    while (n != 1) {
+        count++;
+        if (n % 2 == 0) {
+            n = n / 2;
+        } else {
+            n = 3 * n + 1;
+        }
+    }
+    return count;
+}
+
+// Overflow-checked kernel: steps to reach 1 and the peak value.
+// Returns false (leaving steps/peak untouched) if n is 0 or 3n+1 would overflow.
+inline bool collatzChecked(unsigned long long n, unsigned long long& steps,
+                           unsigned long long& peak) {
+    if (n == 0) {
+        return false;
+    }
+    const unsigned long long limit = (std::numeric_limits<unsigned long long>::max() - 1) / 3;
+    unsigned long long count = 0;
+    unsigned long long maxNum = n;
+    while (n != 1) {
+        if (n % 2 == 0) {
+            n = n / 2;
+        } else {
+            if (n > limit) {
+                return false;
+            }
+            n = 3 * n + 1;
+        }
+        if (n > maxNum) {
+            maxNum = n;
+        }
+        count++;
+    }
+    steps = count;
+    peak = maxNum;
+    return true;
+}
+
+#endif  // COLLATZ_H
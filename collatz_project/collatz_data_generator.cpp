@@ -11,25 +11,9 @@
 #include <iostream>
 #include <limits>
 
-using namespace std;
-
-long long collatzSequence(long long n, long long& maxNum) {
-    maxNum = n;
+#include "collatz.h"
 
-    while (n != 1) {
-        if (n > maxNum) {
-            maxNum = n;
-        }
-
-        if (n % 2 == 0) {
-            n = n / 2;
-        } else {
-            n = 3 * n + 1;
-        }
-    }
-
-    return maxNum;
-}
+using namespace std;
 
 int main() {
     int numPoints;
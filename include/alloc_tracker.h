@@ -0,0 +1,108 @@
+/**
+ * @file alloc_tracker.h
+ * @brief Opt-in heap allocation counts, bytes and high-water marks per subsystem
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Heap use of one subsystem (or of the whole program)
+ */
+struct AllocationStats {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;      ///< Total requested by all allocations
+    int64_t liveBytes = 0;   ///< Allocated and not yet freed
+    int64_t peakBytes = 0;   ///< High-water mark of liveBytes
+};
+
+/**
+ * @class AllocationTracker
+ * @brief Counts operator new / delete while enabled, attributed by AllocScope
+ *
+ * The replacement global operator new and delete live in
+ * src/alloc_hooks.cpp; a program links that file to make counting possible
+ * (the projects and the root binaries do, libnumerical does not, so a host
+ * process keeps its own allocator). Until enable() the hooks cost one atomic
+ * load per call.
+ *
+ * Each allocation is charged to the subsystem of the innermost AllocScope on
+ * the allocating thread ("other" outside any scope), and its free is charged
+ * to the same subsystem whichever thread frees it, so per-subsystem live bytes
+ * and peaks are exact. Memory allocated before enable() is not counted.
+ *
+ * Example usage:
+ * @code
+ * AllocationTracker::enable();
+ * {
+ *     AllocScope scope("path storage");
+ *     std::vector<std::vector<double>> path = ...;  // Counted under "path storage"
+ * }
+ * AllocationTracker::print(std::cout);
+ * @endcode
+ */
+class AllocationTracker {
+   public:
+    static void enable();
+
+    /**
+     * @brief enable() and print to std::cout at exit, if NM_ALLOC is set and not "0"
+     */
+    static bool enableFromEnvironment();
+
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Per-subsystem totals, "other" first, then in order of first scope
+     */
+    static std::vector<std::pair<std::string, AllocationStats>> subsystems();
+
+    /**
+     * @brief Whole-program totals (peakBytes is the peak of the sum, not a sum of peaks)
+     */
+    static AllocationStats total();
+
+    /**
+     * @brief Table of subsystems plus the total and the process peak resident set
+     */
+    static void print(std::ostream& out);
+
+    // Called by the operator new / delete hooks
+    static void recordAllocation(void* pointer, size_t bytes);
+    static void recordFree(void* pointer);
+
+   private:
+    static std::atomic<bool> active;
+};
+
+/**
+ * @class AllocScope
+ * @brief Charges the calling thread's allocations to a subsystem while in scope
+ *
+ * Scopes nest; the innermost wins. The name must outlive the program (a
+ * string literal). When tracking is off a scope costs one atomic load.
+ */
+class AllocScope {
+   public:
+    explicit AllocScope(const char* subsystem);
+    ~AllocScope();
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+   private:
+    int previous = -1;  ///< Subsystem to restore, -1 if the scope is inactive
+};
+
+#endif  // ALLOC_TRACKER_H
@@ -0,0 +1,176 @@
+/**
+ * @file async_writer.h
+ * @brief Double-buffered CSV output written by dedicated I/O threads
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class AsyncWriter
+ * @brief Moves CSV formatting, compression and file writes off the compute threads
+ *
+ * A compute thread opens a Stream and appends raw rows of doubles. Each
+ * stream owns two row buffers: while one is being filled the other is
+ * formatted and written by an I/O thread. The compute thread only waits if it
+ * fills a buffer before the I/O thread has finished with the previous one.
+ *
+ * Example usage:
+ * @code
+ * AsyncWriter writer;
+ * auto out = writer.open("Output/run.csv", "Time,Angle\n", 2);
+ * for (...) out->append({t, angle});
+ * out->close();
+ * writer.flush();
+ * @endcode
+ */
+class AsyncWriter {
+   public:
+    /**
+     * @class Stream
+     * @brief One output file fed by a single producer thread
+     */
+    class Stream : public std::enable_shared_from_this<Stream> {
+       public:
+        ~Stream();
+
+        /**
+         * @brief Appends one row (columns() values)
+         */
+        void append(const double* row);
+
+        /**
+         * @brief Appends one row given as a list of exactly columns() values
+         */
+        void append(std::initializer_list<double> row) { append(row.begin()); }
+
+        /**
+         * @brief Hands the last buffer to the I/O threads; the file is closed after it
+         */
+        void close();
+
+        /**
+         * @brief Blocks until everything appended so far is on disk (or failed)
+         */
+        void wait();
+
+        /**
+         * @brief False if the file could not be opened or written
+         */
+        bool ok() const { return !failed.load(); }
+
+        size_t columns() const { return columnCount; }
+        const std::string& filename() const { return path; }
+
+       private:
+        friend class AsyncWriter;
+
+        struct Buffer {
+            std::vector<double> values;
+            bool inFlight = false;
+        };
+
+        Stream(AsyncWriter& owner, std::string filename, std::string preamble, size_t columns,
+               size_t bufferRows, bool append);
+        void submitActive(bool last);
+        void writeBuffer(int index, bool last);
+        void finished(int index);
+
+        AsyncWriter& writer;
+        std::string path;
+        std::string preamble;  ///< Written before the first row
+        size_t columnCount;
+        size_t capacity;  ///< Values per buffer
+        bool appending;   ///< Open the file for appending
+
+        Buffer buffers[2];
+        int active = 0;
+        bool closed = false;
+        std::mutex mutex;
+        std::condition_variable returned;
+
+        // Touched only by the I/O thread that owns the in-flight buffer
+        void* file = nullptr;
+        std::string text;
+        std::atomic<bool> failed{false};
+    };
+
+    /**
+     * @brief Starts the I/O threads
+     * @param ioThreads Number of I/O threads
+     * @param bufferRows Rows per stream buffer
+     * @param precision Significant digits per value (0 = shortest round-trip form)
+     */
+    explicit AsyncWriter(size_t ioThreads = 1, size_t bufferRows = 8192, int precision = 6);
+
+    /**
+     * @brief Closes open streams, flushes and joins the I/O threads
+     *
+     * Streams must not be used after their writer is destroyed.
+     */
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    /**
+     * @brief Opens an output stream (the file itself is created by an I/O thread)
+     * @param filename Output path; a name ending in ".gz" is gzip-compressed when
+     *                 built with USE_ZLIB
+     * @param preamble Text written before the rows (comment lines, CSV header)
+     * @param columns Values per row
+     * @param append Add to the end of an existing file instead of truncating it (used to
+     *               extend a run; gzip output gets a second member, which gzip reads as one)
+     */
+    std::shared_ptr<Stream> open(const std::string& filename, const std::string& preamble,
+                                 size_t columns, bool append = false);
+
+    /**
+     * @brief Blocks until every buffer handed over so far has been written
+     */
+    void flush();
+
+    /**
+     * @brief True if gzip output is available in this build
+     */
+    static bool compressionAvailable();
+
+   private:
+    struct Job {
+        std::shared_ptr<Stream> stream;
+        int buffer;
+        bool last;
+    };
+
+    void enqueue(Job job);
+    void ioLoop();
+
+    size_t bufferRows;
+    int precision;
+
+    std::vector<std::thread> ioThreads;
+    std::mutex queueMutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable idle;
+    std::deque<Job> jobs;
+    size_t busy = 0;
+    bool stopping = false;
+
+    std::mutex streamsMutex;
+    std::vector<std::weak_ptr<Stream>> streams;  ///< For closing leftovers on destruction
+};
+
+#endif  // ASYNC_WRITER_H
@@ -0,0 +1,106 @@
+/**
+ * @file barnes_hut.h
+ * @brief Barnes-Hut octree for O(N log N) gravitational accelerations
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef BARNES_HUT_H
+#define BARNES_HUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "particle.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Accuracy and granularity of the tree
+ */
+struct BarnesHutSettings {
+    /// Opening angle: a cell of side s at distance d acts as one mass if s/d < theta
+    double theta = 0.5;
+    size_t leafSize = 8;  ///< Cells with at most this many particles are not split
+};
+
+/**
+ * @class BarnesHutTree
+ * @brief Octree over a particle system, rebuilt every step
+ *
+ * build() computes a 63-bit Morton key per particle (in parallel), sorts the
+ * particles by key and copies positions and masses into that order, so every
+ * cell is a contiguous range and nearby particles are nearby in memory. The
+ * 64 cells two levels below the root are then built as independent tasks and
+ * spliced under the top levels.
+ *
+ * Nodes live in one array in depth-first order: the first child of a node
+ * is the next element and each node stores the index just past its subtree.
+ * A force walk is therefore a single forward scan with no stack. The node
+ * and scratch arrays keep their capacity between builds, so steady-state
+ * rebuilds do not allocate.
+ *
+ * Example usage:
+ * @code
+ * BarnesHutTree tree;
+ * LeapfrogIntegrator leapfrog([&](ParticleSystem& p) { tree.computeGravity(p, gravity, pool); });
+ * @endcode
+ */
+class BarnesHutTree {
+   public:
+    explicit BarnesHutTree(BarnesHutSettings settings = BarnesHutSettings());
+
+    /**
+     * @brief Builds the tree for the current particle positions
+     */
+    void build(const ParticleSystem& particles, ThreadPool& pool);
+
+    /**
+     * @brief Fills ax/ay/az from the last build() (positions must not have moved)
+     */
+    void computeForces(ParticleSystem& particles, const GravitySettings& gravity,
+                       ThreadPool& pool) const;
+
+    /**
+     * @brief build() followed by computeForces(); usable as a ForceSolver
+     */
+    void computeGravity(ParticleSystem& particles, const GravitySettings& gravity,
+                        ThreadPool& pool);
+
+    const BarnesHutSettings& settings() const { return options; }
+    void setTheta(double theta) { options.theta = theta; }
+
+    size_t nodeCount() const { return nodes.size(); }
+
+   private:
+    struct Node {
+        double x, y, z;  ///< Centre of mass
+        double mass;
+        double size;     ///< Side length of the cell
+        uint32_t next;   ///< Index just past this node's subtree
+        uint32_t begin;  ///< First particle (sorted order)
+        uint32_t end;    ///< One past the last particle
+        uint32_t leaf;   ///< Non-zero if the particles are summed directly
+    };
+
+    void sortByKey(ThreadPool& pool);
+    void buildRange(std::vector<Node>& out, uint32_t begin, uint32_t end, unsigned depth) const;
+    void splice(unsigned depth, uint32_t prefix);
+    void finish(std::vector<Node>& out, size_t index) const;
+
+    BarnesHutSettings options;
+    double rootSize = 0.0;
+
+    // Particles in Morton order
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;  ///< order[i] = original index of sorted particle i
+    std::vector<double> x, y, z, mass;
+
+    std::vector<Node> nodes;
+    std::vector<std::vector<Node>> subtrees;  ///< One per cell at the split depth
+    std::vector<uint32_t> cellStart;          ///< First sorted particle of each split cell
+    std::vector<std::pair<uint64_t, uint32_t>> sortScratch;
+};
+
+#endif  // BARNES_HUT_H
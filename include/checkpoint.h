@@ -0,0 +1,135 @@
+/**
+ * @file checkpoint.h
+ * @brief Periodic, atomically written progress files for long sweeps and ensembles
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 64-bit FNV-1a hash of raw bytes, chained through seed
+ *
+ * Used to fingerprint the inputs of a run (parameters, step size, case
+ * list) so a checkpoint is only resumed by the run that wrote it.
+ */
+uint64_t checkpointHash(const void* data, size_t bytes, uint64_t seed = 14695981039346656037ULL);
+
+/**
+ * @class Checkpoint
+ * @brief Progress of a run over many independent items (sweep cases, table nodes)
+ *
+ * Each item stores a fixed number of result doubles when it completes. A
+ * free-form state vector holds whatever else the run needs to continue:
+ * partial aggregates, or the in-flight states of an ensemble advanced in
+ * lock step. Results are kept bit for bit, so a resumed run that skips the
+ * completed items produces exactly the output of an uninterrupted one.
+ *
+ * The file is rewritten at most once per interval, from whichever thread
+ * completes an item after the interval has passed, through
+ * writeFileAtomically() (temporary file, fsync, rename): a killed process
+ * leaves either the previous checkpoint or the new one, never a torn file.
+ *
+ * Example usage:
+ * @code
+ * Checkpoint checkpoint("Output/sweep.checkpoint", fingerprint, cases.size(), 4);
+ * if (resume) checkpoint.resume();
+ * pool.parallelFor(cases.size(), 1, [&](size_t begin, size_t end, size_t) {
+ *     for (size_t i = begin; i < end; ++i) {
+ *         if (checkpoint.isDone(i)) continue;
+ *         double result[4] = ...;
+ *         checkpoint.complete(i, result);   // Thread safe
+ *     }
+ * });
+ * checkpoint.discard();                      // Finished: no checkpoint needed
+ * @endcode
+ */
+class Checkpoint {
+   public:
+    /**
+     * @param path Checkpoint file
+     * @param fingerprint Hash of the run's inputs (see checkpointHash)
+     * @param items Number of items in the run
+     * @param valuesPerItem Result doubles stored per completed item
+     * @param intervalSeconds Minimum time between automatic writes
+     */
+    Checkpoint(std::string path, uint64_t fingerprint, size_t items, size_t valuesPerItem,
+               double intervalSeconds = 30.0);
+
+    /**
+     * @brief Loads the checkpoint file if there is one
+     * @return False if there is no file (the run starts from scratch)
+     * @throws std::runtime_error if the file is unreadable or belongs to another run
+     */
+    bool resume();
+
+    bool isDone(size_t item) const { return done[item] != 0; }
+    const double* values(size_t item) const { return results.data() + item * perItem; }
+    size_t doneCount() const;
+    size_t size() const { return done.size(); }
+
+    /**
+     * @brief Records an item's results; writes the file if the interval has passed
+     *
+     * Safe to call from several threads. Write errors are reported once on std::cerr
+     * and do not stop the run.
+     */
+    void complete(size_t item, const double* values);
+
+    /**
+     * @brief Free-form state saved with the checkpoint (aggregates, ensemble states)
+     *
+     * Not locked: change it only while no other thread calls complete().
+     */
+    std::vector<double>& state() { return extra; }
+
+    /**
+     * @brief Text saved with the checkpoint (e.g. the output file name to reuse)
+     */
+    void setLabel(const std::string& text) { tag = text; }
+    const std::string& label() const { return tag; }
+
+    /**
+     * @brief True once the interval has passed since the last write
+     */
+    bool due() const;
+
+    /**
+     * @brief Writes the checkpoint now
+     * @throws std::runtime_error if it cannot be written
+     */
+    void save();
+
+    /**
+     * @brief Removes the file (call after the run's output is complete)
+     */
+    void discard();
+
+    const std::string& path() const { return file; }
+
+   private:
+    std::string serialize() const;
+
+    std::string file;
+    uint64_t fingerprint;
+    size_t perItem;
+    std::vector<char> done;
+    std::vector<double> results;
+    std::vector<double> extra;
+    std::string tag;
+
+    std::chrono::steady_clock::duration interval;
+    std::chrono::steady_clock::time_point lastWrite;
+    mutable std::mutex mutex;
+    bool reportedError = false;
+};
+
+#endif  // CHECKPOINT_H
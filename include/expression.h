@@ -0,0 +1,280 @@
+/**
+ * @file expression.h
+ * @brief Runtime expressions compiled to register bytecode, and ODE models built from them
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Syntax or name error in an expression or model file
+ */
+class ExpressionError : public std::runtime_error {
+   public:
+    explicit ExpressionError(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * @brief Operations of the bytecode (binary ones read a and b, unary ones a)
+ */
+enum class OpCode : uint8_t {
+    Move,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Neg,
+    Pow,
+    Atan2,
+    Min,
+    Max,
+    Sin,
+    Cos,
+    Tan,
+    Asin,
+    Acos,
+    Atan,
+    Sinh,
+    Cosh,
+    Tanh,
+    Exp,
+    Log,
+    Sqrt,
+    Abs,
+    Floor
+};
+
+/**
+ * @brief One bytecode instruction: registers[dst] = op(registers[a], registers[b])
+ */
+struct Instruction {
+    OpCode op;
+    uint32_t dst, a, b;
+};
+
+/**
+ * @class ExpressionProgram
+ * @brief Compiled form of one or more expressions over the same inputs
+ *
+ * Registers are laid out as [inputs | constants | temporaries]. Every
+ * instruction writes a temporary, so constants are loaded once and inputs are
+ * never overwritten. Several outputs share one program, and common named
+ * subexpressions (ExpressionCompiler::define) are computed once.
+ *
+ * evaluate() runs the program once. evaluateBatch() runs it over many
+ * independent input sets (an ensemble) in blocks of lanes: the switch on the
+ * opcode is paid once per block instead of once per value, and arithmetic
+ * instructions become SIMD loops.
+ */
+class ExpressionProgram {
+   public:
+    /**
+     * @brief outputs[k] = expression k at the given inputs
+     */
+    void evaluate(const double* inputs, double* outputs) const;
+
+    /**
+     * @brief Evaluates count input sets given as one array per input (structure of arrays)
+     * @param inputs inputCount() pointers to count values each
+     * @param outputs outputCount() pointers to count values each
+     */
+    void evaluateBatch(size_t count, const double* const* inputs, double* const* outputs) const;
+
+    size_t inputCount() const { return inputs; }
+    size_t outputCount() const { return outputRegisters.size(); }
+    size_t registerCount() const { return registers; }
+    const std::vector<Instruction>& code() const { return instructions; }
+
+    /**
+     * @brief One instruction per line, for debugging
+     */
+    std::string disassemble() const;
+
+   private:
+    friend class ExpressionCompiler;
+
+    size_t inputs = 0;
+    size_t registers = 0;
+    std::vector<double> constants;  ///< Values of registers [inputs, inputs + constants.size())
+    std::vector<Instruction> instructions;
+    std::vector<uint32_t> outputRegisters;
+};
+
+/**
+ * @class ExpressionCompiler
+ * @brief Parses expressions and emits bytecode with constant folding
+ *
+ * Grammar: numbers, names, + - * / ^ (right associative, binds tighter than
+ * unary minus), parentheses, and the functions sin cos tan asin acos atan
+ * sinh cosh tanh exp log sqrt abs floor (one argument) and pow atan2 min max
+ * (two). pi and e are predefined. Any operation whose operands are all
+ * constants is computed at compile time, so parameters cost nothing at run
+ * time.
+ *
+ * Example usage:
+ * @code
+ * ExpressionCompiler compiler({"t", "theta", "omega"});
+ * compiler.defineConstant("g", 9.81);
+ * compiler.addOutput("omega");
+ * compiler.addOutput("-g / 9.8 * sin(theta) - 0.5 * omega + 1.2 * cos(2/3 * t)");
+ * ExpressionProgram program = compiler.finish();
+ * @endcode
+ */
+class ExpressionCompiler {
+   public:
+    /**
+     * @brief Starts a program whose inputs have the given names (in this order)
+     */
+    explicit ExpressionCompiler(std::vector<std::string> inputNames);
+
+    /**
+     * @brief Makes name a compile-time constant in later expressions
+     */
+    void defineConstant(const std::string& name, double value);
+
+    /**
+     * @brief Makes name stand for the value of expression in later expressions
+     *
+     * The expression is compiled once; every use reads the same register.
+     * @throws ExpressionError on a syntax error or unknown name
+     */
+    void define(const std::string& name, const std::string& expression);
+
+    /**
+     * @brief Compiles expression as the next output
+     * @throws ExpressionError on a syntax error or unknown name
+     */
+    void addOutput(const std::string& expression);
+
+    /**
+     * @brief The program built so far (the compiler can keep going afterwards)
+     */
+    ExpressionProgram finish() const;
+
+    /**
+     * @brief Value of an expression over constants only (e.g. a parameter)
+     * @throws ExpressionError if it is not constant
+     */
+    double evaluateConstant(const std::string& expression);
+
+   private:
+    /// Compile-time value: a known constant or a register (input, constant or temporary)
+    struct Operand {
+        bool constant;
+        double value;
+        uint32_t reg;
+    };
+
+    Operand parse(const std::string& expression);
+    Operand parseSum();
+    Operand parseProduct();
+    Operand parseUnary();
+    Operand parsePower();
+    Operand parsePrimary();
+    Operand call(const std::string& name, const std::vector<Operand>& args);
+    Operand emit(OpCode op, const Operand& a, const Operand& b);
+    uint32_t registerOf(const Operand& operand);
+    void release(const Operand& operand);
+    void skipSpace();
+    [[noreturn]] void fail(const std::string& message) const;
+
+    size_t inputCount;
+    std::map<std::string, Operand> names;  ///< Inputs, constants and defined names
+    std::vector<double> constants;
+    std::vector<Instruction> instructions;
+    std::vector<uint32_t> outputs;
+    std::vector<uint32_t> freeTemporaries;
+    std::vector<bool> pinned;  ///< Temporaries holding outputs or defined names
+    uint32_t temporaries = 0;
+
+    const std::string* text = nullptr;  ///< Expression being parsed
+    size_t position = 0;
+};
+
+/**
+ * @class OdeModel
+ * @brief System of ODEs dy/dt = f(t, y) read from a small text format
+ *
+ * One statement per line ('#' starts a comment):
+ * @code
+ * param g = 9.81             # constant, may use earlier params
+ * state theta = 0.2          # state variable and its initial value
+ * state omega = 0
+ * let drive = 1.2 * cos(2/3 * t)    # named intermediate (may use t and states)
+ * theta' = omega             # one derivative per state
+ * omega' = -g / 9.8 * sin(theta) - 0.5 * omega + drive
+ * @endcode
+ * All derivatives compile into one program with inputs (t, states...).
+ * Parameters are folded into the bytecode; setParameter() recompiles.
+ */
+class OdeModel {
+   public:
+    /**
+     * @brief Parses a model
+     * @throws ExpressionError (message starts with the line number)
+     */
+    static OdeModel parse(std::istream& in);
+
+    /**
+     * @brief Parses the model in a file
+     * @throws ExpressionError if it cannot be read or parsed
+     */
+    static OdeModel load(const std::string& path);
+
+    const std::vector<std::string>& stateNames() const { return states; }
+    const std::vector<double>& initialState() const { return initial; }
+    size_t dimension() const { return states.size(); }
+
+    double parameter(const std::string& name) const;
+
+    /**
+     * @brief Changes a parameter and recompiles (initial values are recomputed too)
+     * @throws ExpressionError if there is no such parameter
+     */
+    void setParameter(const std::string& name, double value);
+
+    /**
+     * @brief out[k] = d(state k)/dt at time t
+     */
+    void derivatives(double t, const double* state, double* out) const;
+
+    /**
+     * @brief derivatives() for count independent systems
+     * @param t count times
+     * @param state dimension() pointers to count values each
+     * @param out dimension() pointers to count values each
+     */
+    void derivativesBatch(size_t count, const double* t, const double* const* state,
+                          double* const* out) const;
+
+    const ExpressionProgram& program() const { return compiled; }
+
+   private:
+    struct Statement {
+        enum Kind { Param, State, Let, Derivative } kind;
+        std::string name;
+        std::string expression;
+        size_t line;
+    };
+
+    void compile();
+
+    std::vector<Statement> statements;
+    std::vector<std::pair<std::string, double>> overrides;  ///< From setParameter
+    std::vector<std::string> states;
+    std::vector<double> initial;
+    std::vector<std::pair<std::string, double>> parameters;
+    ExpressionProgram compiled;
+};
+
+#endif  // EXPRESSION_H
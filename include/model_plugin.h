@@ -0,0 +1,131 @@
+/**
+ * @file model_plugin.h
+ * @brief C interface for native model plugins loaded by the simulators at run time
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ *
+ * A plugin is a shared object (`.so`) compiled outside the workspace that
+ * supplies derivative or force functions. The simulators find plugins at
+ * startup (see plugin_loader.h), so a custom oscillator or drag law runs at
+ * native speed without forking src/oscillator.cpp or src/Projectile.cpp.
+ *
+ * Conventions:
+ * - The header is plain C so plugins can be written in C, C++ or anything
+ *   that can export a C symbol. No C++ exception may cross it.
+ * - A plugin exports one function, NM_PLUGIN_ENTRY_SYMBOL, returning a static
+ *   table of ::nm_model descriptors. The host passes its ABI version and the
+ *   plugin returns NULL if it cannot serve that version.
+ * - Every descriptor starts with its own ABI version and struct size, so the
+ *   host can reject plugins built against another layout before touching
+ *   anything else.
+ * - Functions must be thread safe: the host may evaluate one model from
+ *   several threads at once, each with its own parameter array.
+ *
+ * Minimal plugin:
+ * @code
+ * #include "model_plugin.h"
+ *
+ * static void decay(const double* p, double t, const double* y, double* dy) {
+ *     (void)t;
+ *     dy[0] = -p[0] * y[0];
+ * }
+ * static const char* const names[] = {"k"};
+ * static const double defaults[] = {0.5};
+ * static const nm_model models[] = {{NM_PLUGIN_ABI_VERSION, sizeof(nm_model), NM_MODEL_ODE,
+ *     "decay", "dy/dt = -k y", 1, 1, names, defaults, NULL, NULL, decay, NULL}};
+ *
+ * NM_PLUGIN_EXPORT const nm_model* nm_plugin_models(uint32_t host_abi, size_t* count) {
+ *     if (host_abi != NM_PLUGIN_ABI_VERSION) return NULL;
+ *     *count = 1;
+ *     return models;
+ * }
+ * @endcode
+ * Build: `gcc -std=c99 -O2 -fPIC -shared -I<workspace>/include decay.c -o decay.so`
+ */
+
+#ifndef MODEL_PLUGIN_H
+#define MODEL_PLUGIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Marks the entry point so it stays visible under -fvisibility=hidden */
+#if defined(__GNUC__)
+#define NM_PLUGIN_EXPORT __attribute__((visibility("default")))
+#else
+#define NM_PLUGIN_EXPORT
+#endif
+
+/** Bumped whenever ::nm_model or a function signature changes incompatibly */
+#define NM_PLUGIN_ABI_VERSION 1
+
+/** Name of the function every plugin exports (see ::nm_plugin_entry) */
+#define NM_PLUGIN_ENTRY_SYMBOL "nm_plugin_models"
+
+/**
+ * @brief What a model computes, which fixes the meaning of its inputs and outputs
+ */
+typedef enum nm_model_kind {
+    /** dy/dt = f(t, y): `state_size` inputs y, `state_size` outputs dy/dt (Project 2) */
+    NM_MODEL_ODE = 1,
+    /** a = f(t, v, wind): inputs (vx, vy, vz, wind x, wind y, wind z), outputs (ax, ay, az)
+     *  in m/s^2, gravity included (Project 1) */
+    NM_MODEL_ACCELERATION = 2
+} nm_model_kind;
+
+/**
+ * @brief Evaluates the model once
+ * @param parameters `parameter_count` values, initially `default_parameters`
+ * @param t Time (s)
+ * @param state `state_size` input values
+ * @param out `output_size` results
+ */
+typedef void (*nm_model_evaluate_fn)(const double* parameters, double t, const double* state,
+                                     double* out);
+
+/**
+ * @brief Evaluates the model for `count` independent inputs (structure of arrays)
+ * @param t `count` times
+ * @param state `state_size` pointers to `count` values each
+ * @param out `output_size` pointers to `count` values each
+ */
+typedef void (*nm_model_evaluate_batch_fn)(const double* parameters, size_t count,
+                                           const double* t, const double* const* state,
+                                           double* const* out);
+
+/**
+ * @brief Static description of one model in a plugin
+ */
+typedef struct nm_model {
+    uint32_t abi_version;                ///< NM_PLUGIN_ABI_VERSION the plugin was built with
+    uint32_t struct_size;                ///< sizeof(nm_model) in the plugin
+    uint32_t kind;                       ///< ::nm_model_kind
+    const char* name;                    ///< Unique name used to select the model
+    const char* description;             ///< One line for listings (may be NULL)
+    uint32_t state_size;                 ///< Inputs per evaluation (6 for acceleration models)
+    uint32_t parameter_count;            ///< Length of the two arrays below
+    const char* const* parameter_names;  ///< Parameter names (may be NULL if count is 0)
+    const double* default_parameters;    ///< Parameter values used unless the host overrides them
+    const char* const* state_names;      ///< ODE state names for output headers (may be NULL)
+    const double* initial_state;         ///< ODE initial values (may be NULL: all zero)
+    nm_model_evaluate_fn evaluate;       ///< Required
+    nm_model_evaluate_batch_fn evaluate_batch;  ///< Optional; the host loops over evaluate if NULL
+} nm_model;
+
+/**
+ * @brief Signature of NM_PLUGIN_ENTRY_SYMBOL
+ * @param host_abi_version NM_PLUGIN_ABI_VERSION of the loading program
+ * @param count Receives the number of descriptors
+ * @return Array of `*count` descriptors valid until the plugin is unloaded, or NULL
+ */
+typedef const nm_model* (*nm_plugin_entry_fn)(uint32_t host_abi_version, size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODEL_PLUGIN_H
@@ -0,0 +1,105 @@
+/**
+ * @file particle.h
+ * @brief Particle system in structure-of-arrays layout with direct-sum gravity
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef PARTICLE_H
+#define PARTICLE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "thread_pool.h"
+#include "vec3_array.h"
+#include "vector3d.h"
+
+/**
+ * @class ParticleSystem
+ * @brief Positions, velocities, accelerations and masses of N point masses
+ *
+ * Each component lives in its own contiguous, 64-byte aligned array (x[], y[],
+ * z[], ...), so force kernels stream through memory and vectorize across
+ * particles.
+ * Vector3D is used at the edges (adding, reading and summarising particles).
+ */
+class ParticleSystem {
+   public:
+    AlignedVector x, y, z;     ///< Positions
+    AlignedVector vx, vy, vz;  ///< Velocities
+    AlignedVector ax, ay, az;  ///< Accelerations from the last force evaluation
+    AlignedVector mass;        ///< Masses
+
+    ParticleSystem() = default;
+
+    /**
+     * @brief Reserves room for count particles
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Appends a particle (zero acceleration until the next force evaluation)
+     * @return Index of the new particle
+     */
+    size_t add(const Vector3D& position, const Vector3D& velocity, double m);
+
+    size_t size() const { return mass.size(); }
+
+    Vector3D position(size_t i) const { return Vector3D(x[i], y[i], z[i]); }
+    Vector3D velocity(size_t i) const { return Vector3D(vx[i], vy[i], vz[i]); }
+    Vector3D acceleration(size_t i) const { return Vector3D(ax[i], ay[i], az[i]); }
+
+    double totalMass() const;
+    Vector3D centerOfMass() const;
+    Vector3D momentum() const;
+    double kineticEnergy() const;
+
+    /**
+     * @brief Softened gravitational potential energy (direct O(N²) sum)
+     */
+    double potentialEnergy(double G, double softening) const;
+
+    /**
+     * @brief Plummer sphere in virial equilibrium
+     *
+     * Total mass 1, scale radius 1 (G = 1 units), centre of mass at rest at
+     * the origin. The same seed always gives the same particles.
+     */
+    static ParticleSystem plummer(size_t count, unsigned seed = 1);
+};
+
+/**
+ * @brief Parameters of the gravitational force
+ *
+ * Accelerations are a_i = G Σ_j m_j (r_j - r_i) / (|r_j - r_i|² + ε²)^(3/2).
+ * ε > 0 removes the singularity of close encounters and makes the self term
+ * vanish, so the kernels need no i == j branch.
+ */
+struct GravitySettings {
+    double G = 1.0;           ///< Gravitational constant (1 in N-body units)
+    double softening = 1e-2;  ///< Plummer softening length ε (must be > 0)
+};
+
+/**
+ * @brief Reference kernel: one particle at a time over every other particle
+ *
+ * Fills ax/ay/az. Kept simple on purpose; computeGravityBlocked must agree
+ * with it to rounding.
+ */
+void computeGravityDirect(ParticleSystem& particles, const GravitySettings& settings,
+                          ThreadPool& pool);
+
+/**
+ * @brief Blocked, vectorized direct-sum kernel
+ *
+ * Targets are processed in blocks of consecutive particles and sources in
+ * tiles that stay in L1 cache. The innermost loop runs over a fixed number
+ * of target lanes with independent accumulators, so the compiler turns it
+ * into SIMD arithmetic without reassociating any sum. Target blocks are
+ * spread over the pool.
+ */
+void computeGravityBlocked(ParticleSystem& particles, const GravitySettings& settings,
+                           ThreadPool& pool);
+
+#endif  // PARTICLE_H
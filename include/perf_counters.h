@@ -0,0 +1,160 @@
+/**
+ * @file perf_counters.h
+ * @brief Hardware performance counters (perf_event_open) around named kernels
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Hardware events counted by PerfCounters
+ */
+enum PerfEvent : size_t {
+    PerfCycles,
+    PerfInstructions,
+    PerfCacheReferences,
+    PerfCacheMisses,  ///< Last-level cache misses
+    PerfBranches,
+    PerfBranchMisses,
+    PerfEventCount
+};
+
+/**
+ * @brief Counter totals of one kernel (or one read of the counters)
+ *
+ * Counts are scaled by time enabled / time running, so they stay
+ * meaningful when the kernel multiplexes the hardware counters.
+ * Ratios of events that were not measured are NaN.
+ */
+struct PerfSample {
+    double counts[PerfEventCount] = {};
+    bool measured[PerfEventCount] = {};
+    double seconds = 0.0;  ///< Wall time inside the kernel
+    uint64_t calls = 0;
+
+    PerfSample& operator+=(const PerfSample& other);
+
+    double ipc() const;                 ///< Instructions per cycle
+    double cacheMissRate() const;       ///< Cache misses per cache reference
+    double cacheMissesPerKilo() const;  ///< Cache misses per 1000 instructions (MPKI)
+    double branchMissRate() const;      ///< Mispredicted branches per branch
+};
+
+/**
+ * @class PerfCounters
+ * @brief The calling thread's cycles, instructions, cache and branch counters
+ *
+ * Opened as one perf_event_open group (user space only), so a read() is a
+ * single system call returning every event over the same interval. Events
+ * the CPU or kernel does not offer are left out; if none can be opened (no
+ * PMU in a VM, perf_event_paranoid too strict, seccomp) available() is false
+ * and error() says why. Nothing throws: callers fall back to wall time.
+ */
+class PerfCounters {
+   public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return leader >= 0; }
+    const std::string& error() const { return problem; }
+
+    /**
+     * @brief Running totals since construction (all zero if unavailable)
+     */
+    PerfSample read() const;
+
+   private:
+    int leader = -1;
+    std::vector<std::pair<PerfEvent, int>> members;  ///< Open events in group order
+    std::string problem;
+};
+
+/**
+ * @class PerfProfile
+ * @brief Per-kernel counter totals collected by PerfScope from any thread
+ *
+ * Off unless enabled. The programs enable it from the environment
+ * (NM_PERF=1) and print the table at exit: calls, time, IPC, cache misses
+ * per reference and per 1000 instructions, branch miss rate, and a rough
+ * verdict (memory bound at 5 or more cache misses per 1000 instructions,
+ * compute bound otherwise).
+ *
+ * Example usage:
+ * @code
+ * PerfProfile::enable();
+ * {
+ *     PerfScope scope("collatz loop");  // Counts this thread until the scope ends
+ *     ...
+ * }
+ * PerfProfile::print(std::cout);
+ * @endcode
+ */
+class PerfProfile {
+   public:
+    static void enable();
+
+    /**
+     * @brief enable() and print to std::cout at exit, if NM_PERF is set and not "0"
+     */
+    static bool enableFromEnvironment();
+
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Adds one measured interval to a kernel's totals (thread safe)
+     */
+    static void add(const char* kernel, const PerfSample& sample);
+
+    /**
+     * @brief Totals per kernel, in order of first use
+     */
+    static std::vector<std::pair<std::string, PerfSample>> kernels();
+
+    /**
+     * @brief Why counters are unavailable on this machine (empty if they work)
+     */
+    static std::string unavailableReason();
+
+    static void print(std::ostream& out);
+    static void reset();
+
+   private:
+    static std::atomic<bool> active;
+};
+
+/**
+ * @class PerfScope
+ * @brief Counts the calling thread while in scope and adds it to a kernel
+ *
+ * Each thread opens its counters once, on its first scope. Put scopes
+ * around loops that run for microseconds or more: reading the counters is
+ * a system call. When profiling is off a scope costs one atomic load.
+ */
+class PerfScope {
+   public:
+    explicit PerfScope(const char* kernel);
+    ~PerfScope();
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+   private:
+    const char* kernel;
+    bool on;
+    PerfSample start;
+};
+
+#endif  // PERF_COUNTERS_H
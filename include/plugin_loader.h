@@ -0,0 +1,150 @@
+/**
+ * @file plugin_loader.h
+ * @brief Loads native model plugins (model_plugin.h) from shared objects with dlopen
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef PLUGIN_LOADER_H
+#define PLUGIN_LOADER_H
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "model_plugin.h"
+
+/**
+ * @brief A plugin could not be loaded, or a model was used incorrectly
+ */
+class PluginError : public std::runtime_error {
+   public:
+    explicit PluginError(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * @class PluginModel
+ * @brief One model from a loaded plugin, with its own copy of the parameters
+ *
+ * Copies share the library handle, which stays loaded until the last model
+ * taken from it is destroyed. evaluate() and evaluateBatch() only read the
+ * model, so one instance may be used from several threads.
+ */
+class PluginModel {
+   public:
+    const std::string& name() const { return modelName; }
+    const std::string& description() const { return modelDescription; }
+    const std::string& path() const { return libraryPath; }  ///< Shared object it came from
+    nm_model_kind kind() const { return static_cast<nm_model_kind>(model->kind); }
+
+    size_t stateSize() const { return model->state_size; }
+    size_t outputSize() const { return kind() == NM_MODEL_ODE ? model->state_size : 3; }
+
+    /**
+     * @brief ODE state names ("y0", "y1", ... when the plugin gives none)
+     */
+    std::vector<std::string> stateNames() const;
+
+    /**
+     * @brief ODE initial values (zeros when the plugin gives none)
+     */
+    std::vector<double> initialState() const;
+
+    const std::vector<std::string>& parameterNames() const { return names; }
+    const std::vector<double>& parameters() const { return values; }
+
+    /**
+     * @brief Overrides a parameter for this instance only
+     * @throws PluginError if there is no such parameter
+     */
+    void setParameter(const std::string& name, double value);
+
+    /**
+     * @brief out[k] = output k for stateSize() inputs at time t
+     */
+    void evaluate(double t, const double* state, double* out) const {
+        model->evaluate(values.data(), t, state, out);
+    }
+
+    /**
+     * @brief evaluate() for count inputs given as stateSize() arrays (structure of arrays)
+     *
+     * Calls the plugin's batched entry point, or evaluate() lane by lane when it has none.
+     */
+    void evaluateBatch(size_t count, const double* t, const double* const* state,
+                       double* const* out) const;
+
+    bool hasBatch() const { return model->evaluate_batch != nullptr; }
+
+   private:
+    friend class PluginRegistry;
+
+    PluginModel(std::shared_ptr<void> library, const nm_model* model, std::string path);
+
+    std::shared_ptr<void> handle;  ///< dlopen handle, closed with the last reference
+    const nm_model* model;         ///< Descriptor inside the loaded library
+    std::string modelName;
+    std::string modelDescription;
+    std::string libraryPath;
+    std::vector<std::string> names;
+    std::vector<double> values;
+};
+
+/**
+ * @class PluginRegistry
+ * @brief Set of models found in plugin libraries
+ *
+ * Example usage:
+ * @code
+ * PluginRegistry registry;
+ * for (const std::string& dir : PluginRegistry::searchPath("../bin/plugins")) {
+ *     registry.discover(dir);
+ * }
+ * if (const PluginModel* duffing = registry.find("duffing", NM_MODEL_ODE)) {
+ *     PluginModel model = *duffing;   // Private parameter copy
+ *     model.setParameter("beta", 2.0);
+ * }
+ * @endcode
+ */
+class PluginRegistry {
+   public:
+    /**
+     * @brief Loads one shared object and adds its models
+     * @return Number of models added
+     * @throws PluginError if it cannot be opened, has no entry point, was built for
+     *         another ABI version, or declares a malformed or duplicate model
+     */
+    size_t load(const std::string& path);
+
+    /**
+     * @brief Loads every *.so in a directory (in name order)
+     *
+     * A missing directory is not an error. Libraries that fail to load are
+     * skipped and their messages kept in errors(), so one broken plugin does
+     * not stop the program from starting.
+     * @return Number of models added
+     */
+    size_t discover(const std::string& directory);
+
+    /**
+     * @brief Directories listed in NM_PLUGIN_PATH (colon separated), then defaultDirectory
+     */
+    static std::vector<std::string> searchPath(const std::string& defaultDirectory);
+
+    const std::vector<PluginModel>& models() const { return loaded; }
+
+    /**
+     * @brief Model with this name and kind, or nullptr
+     */
+    const PluginModel* find(const std::string& name, nm_model_kind kind) const;
+
+    const std::vector<std::string>& errors() const { return problems; }
+
+   private:
+    std::vector<PluginModel> loaded;
+    std::vector<std::string> problems;
+};
+
+#endif  // PLUGIN_LOADER_H
@@ -0,0 +1,189 @@
+/**
+ * @file run_archive.h
+ * @brief Single-file container for many simulation runs with an indexed footer
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef RUN_ARCHIVE_H
+#define RUN_ARCHIVE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Names of the per-run values stored in an archive
+ *
+ * Every run has the same number of input parameters (e.g. launch angle),
+ * summary values (e.g. range) and data columns (e.g. Time, X, Y, Z).
+ */
+struct RunArchiveLayout {
+    std::vector<std::string> parameters;  ///< Inputs that runs can be queried by
+    std::vector<std::string> summary;     ///< Scalar results of each run
+    std::vector<std::string> columns;     ///< Columns of each run's data rows
+};
+
+/**
+ * @class RunArchiveWriter
+ * @brief Appends runs to an archive file from any number of threads
+ *
+ * File layout (native byte order, every block 8-byte aligned):
+ *  - header: magic, counts and the layout names
+ *  - one segment per run: run id, row count, rows of doubles
+ *  - footer index written by close(): one record per run (id, offset, rows,
+ *    parameters, summary) sorted by id, then a trailer locating the index
+ *
+ * append() reserves its segment with an atomic add on the end offset and
+ * writes it with pwrite, so concurrent writers never share a lock. Index
+ * records go onto a lock-free list until close().
+ *
+ * Example usage:
+ * @code
+ * RunArchiveWriter archive("Output/sweep.nmra", {{"Angle"}, {"Range"}, {"Time", "X", "Z"}});
+ * archive.append(id, &angle, &range, rows.data(), rows.size() / 3);  // from any thread
+ * archive.close();
+ * @endcode
+ */
+class RunArchiveWriter {
+   public:
+    /**
+     * @brief Creates (or truncates) the archive and writes its header
+     * @throws std::runtime_error if the file cannot be created
+     */
+    RunArchiveWriter(const std::string& filename, RunArchiveLayout layout);
+
+    /**
+     * @brief Closes the archive if close() was not called (errors go to std::cerr)
+     */
+    ~RunArchiveWriter();
+
+    RunArchiveWriter(const RunArchiveWriter&) = delete;
+    RunArchiveWriter& operator=(const RunArchiveWriter&) = delete;
+
+    /**
+     * @brief Adds one run; safe to call concurrently
+     * @param runId Identifier used for lookups (should be unique)
+     * @param parameters layout().parameters.size() values
+     * @param summary layout().summary.size() values
+     * @param rows rowCount * layout().columns.size() values, row-major
+     * @param rowCount Number of data rows
+     * @return False if the segment could not be written
+     */
+    bool append(uint64_t runId, const double* parameters, const double* summary,
+                const double* rows, size_t rowCount);
+
+    /**
+     * @brief Writes the footer index and closes the file
+     *
+     * No append() may run concurrently with or after close().
+     * @throws std::runtime_error if the footer cannot be written
+     */
+    void close();
+
+    /**
+     * @brief False if any append() failed
+     */
+    bool ok() const { return !failed.load(); }
+
+    const RunArchiveLayout& layout() const { return names; }
+    size_t runs() const { return count.load(); }
+
+   private:
+    struct Entry {
+        uint64_t id;
+        uint64_t offset;
+        uint64_t rows;
+        std::vector<double> values;  ///< Parameters followed by summary
+        Entry* next;
+    };
+
+    bool writeAt(const void* data, size_t size, uint64_t offset);
+
+    std::string path;
+    RunArchiveLayout names;
+    int fd = -1;
+    std::atomic<uint64_t> end{0};  ///< Next free byte
+    std::atomic<Entry*> head{nullptr};
+    std::atomic<size_t> count{0};
+    std::atomic<bool> failed{false};
+};
+
+/**
+ * @class RunArchiveReader
+ * @brief Memory-mapped random access to a closed archive
+ *
+ * Runs are returned as views into the mapping; they stay valid for the
+ * lifetime of the reader. All const member functions are thread-safe.
+ */
+class RunArchiveReader {
+   public:
+    /**
+     * @brief View of one stored run
+     */
+    struct Run {
+        uint64_t id = 0;
+        const double* parameters = nullptr;  ///< layout().parameters.size() values
+        const double* summary = nullptr;     ///< layout().summary.size() values
+        const double* data = nullptr;        ///< rows * columns values, row-major
+        size_t rows = 0;
+        size_t columns = 0;
+
+        double at(size_t row, size_t column) const { return data[row * columns + column]; }
+    };
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Maps the archive and validates its header and index
+     * @throws std::runtime_error if the file is missing, truncated or not closed
+     */
+    explicit RunArchiveReader(const std::string& filename);
+    ~RunArchiveReader();
+
+    RunArchiveReader(const RunArchiveReader&) = delete;
+    RunArchiveReader& operator=(const RunArchiveReader&) = delete;
+
+    const RunArchiveLayout& layout() const { return names; }
+
+    /**
+     * @brief Number of runs
+     */
+    size_t size() const { return runCount; }
+
+    /**
+     * @brief Run at a position in id order (0 <= index < size())
+     */
+    Run run(size_t index) const;
+
+    /**
+     * @brief Looks up a run by id (binary search on the index)
+     * @return False if no run has that id
+     */
+    bool find(uint64_t runId, Run& out) const;
+
+    /**
+     * @brief Runs whose parameter lies in [min, max], in increasing parameter order
+     */
+    std::vector<Run> select(size_t parameter, double min, double max) const;
+
+    /**
+     * @brief Position of a parameter name in layout().parameters, or npos
+     */
+    size_t parameterIndex(const std::string& name) const;
+
+   private:
+    const unsigned char* record(size_t position) const;
+
+    RunArchiveLayout names;
+    const unsigned char* base = nullptr;
+    size_t length = 0;
+    const unsigned char* index = nullptr;
+    size_t runCount = 0;
+    size_t recordSize = 0;
+    std::vector<std::vector<uint32_t>> byParameter;  ///< Run positions sorted by each parameter
+};
+
+#endif  // RUN_ARCHIVE_H
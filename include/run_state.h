@@ -0,0 +1,101 @@
+/**
+ * @file run_state.h
+ * @brief Exact integrator state saved next to a run's output, for extending or branching it
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef RUN_STATE_H
+#define RUN_STATE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Replaces path with contents atomically: temporary file, fsync, then rename
+ * @throws std::runtime_error if it cannot be written (the old file is left intact)
+ */
+void writeFileAtomically(const std::string& path, const std::string& contents);
+
+/**
+ * @class RunState
+ * @brief Everything needed to continue a finished run as if it had never stopped
+ *
+ * Holds the model's parameters (to refuse continuing under a different
+ * model), the final state vector, the step size and step count, the RNG
+ * state if the run used one, and snapshots of the state every few steps.
+ * Continuing from the final state with the same step size reproduces an
+ * uninterrupted longer run bit for bit; a snapshot lets a run be branched
+ * from an earlier time after replaying at most one snapshot interval.
+ *
+ * The file is text with doubles in hexadecimal floating point, so values
+ * round-trip exactly, and it is replaced atomically (written to a temporary
+ * name, then renamed) so a crash never leaves a truncated state behind.
+ *
+ * Example usage:
+ * @code
+ * RunState saved;
+ * saved.model = "oscillator";
+ * saved.output = "Output/oscillator_output.csv";
+ * saved.names = {"Time", "Angle", "AngularVelocity"};
+ * saved.state = {t, angle, omega};
+ * saved.timeStep = 0.04;
+ * saved.steps = steps;
+ * saved.save("Output/oscillator_output.state");
+ * @endcode
+ */
+class RunState {
+   public:
+    /// State vector at a given step
+    struct Snapshot {
+        uint64_t step;
+        std::vector<double> state;
+    };
+
+    std::string model;                                       ///< Which simulation wrote it
+    std::string output;                                      ///< Data file the run wrote
+    std::vector<std::pair<std::string, double>> parameters;  ///< Named model parameters
+    std::vector<std::string> names;                          ///< One per state value
+    std::vector<double> state;                               ///< Final state (time first)
+    double timeStep = 0.0;                                   ///< Integrator step size
+    double endTime = 0.0;                                    ///< Time the run was asked to reach
+    uint64_t steps = 0;                                      ///< Steps taken from the start
+    std::string rng;                                         ///< RNG engine text (or empty)
+    std::vector<Snapshot> snapshots;                         ///< In step order
+
+    /**
+     * @brief Records a snapshot if step is a multiple of every (and every > 0)
+     */
+    void snapshot(uint64_t step, const std::vector<double>& values, uint64_t every) {
+        if (every > 0 && step % every == 0) {
+            snapshots.push_back(Snapshot{step, values});
+        }
+    }
+
+    /**
+     * @brief Latest snapshot whose time (first value) is at most time, or nullptr
+     */
+    const Snapshot* snapshotBefore(double time) const;
+
+    /**
+     * @brief Value of a named parameter
+     * @throws std::invalid_argument if it is missing
+     */
+    double parameter(const std::string& name) const;
+
+    /**
+     * @brief Writes the state atomically
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Reads a state written by save()
+     * @throws std::runtime_error if the file is missing or malformed
+     */
+    static RunState load(const std::string& path);
+};
+
+#endif  // RUN_STATE_H
@@ -0,0 +1,201 @@
+/**
+ * @file thread_pool.h
+ * @brief NUMA-aware thread pool with CPU pinning for the batch runners
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief CPUs grouped by NUMA node
+ *
+ * Read from /sys/devices/system/node on Linux and restricted to the CPUs the
+ * process is allowed to run on. Other systems report a single node.
+ */
+struct CpuTopology {
+    std::vector<std::vector<int>> nodeCpus;  ///< CPU ids of each node
+
+    /**
+     * @brief Detects the topology of the current machine
+     */
+    static CpuTopology detect();
+
+    /**
+     * @brief Node owning a CPU, or 0 if unknown
+     */
+    int nodeOf(int cpu) const;
+
+    size_t nodeCount() const { return nodeCpus.size(); }
+};
+
+/**
+ * @brief Parses a Linux cpulist string such as "0-3,8,10-11"
+ * @return CPU ids in the order given (empty on malformed input)
+ */
+std::vector<int> parseCpuList(const std::string& list);
+
+/**
+ * @brief Construction options for ThreadPool
+ */
+struct ThreadPoolOptions {
+    size_t threads = 0;      ///< Worker count (0 = one per allowed CPU)
+    bool pinThreads = true;  ///< Pin each worker to a single CPU
+    std::vector<int> cpus;   ///< CPUs to use in order (empty = round-robin over the nodes)
+};
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of pinned workers with one task queue per NUMA node
+ *
+ * Workers are spread over the chosen CPUs and serve the queue of their own
+ * node first, stealing from other nodes only when it is empty. parallelFor
+ * hands each node a fixed contiguous slice of the index range, so running the
+ * initialisation and the computation with the same range keeps each node
+ * working on pages it touched first (Linux first-touch placement).
+ */
+class ThreadPool {
+   public:
+    /**
+     * @brief Starts the workers
+     * @param options Thread count and affinity settings
+     */
+    explicit ThreadPool(const ThreadPoolOptions& options = ThreadPoolOptions());
+
+    /**
+     * @brief Finishes queued work and joins the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+    size_t nodeCount() const { return nodeWorkers.size(); }
+
+    /**
+     * @brief Node index (0..nodeCount()-1) of a worker
+     */
+    size_t workerNode(size_t worker) const { return workerInfo[worker].node; }
+
+    /**
+     * @brief CPU a worker is pinned to (-1 if not pinned)
+     */
+    int workerCpu(size_t worker) const { return workerInfo[worker].cpu; }
+
+    /**
+     * @brief Queues a task
+     * @param task Work to run (must not throw; use parallelFor for throwing work)
+     * @param node Preferred node, or -1 to distribute round-robin
+     */
+    void submit(std::function<void()> task, int node = -1);
+
+    /**
+     * @brief Blocks until every submitted task has finished
+     */
+    void wait();
+
+    /**
+     * @brief Runs body(begin, end, worker) over [0, count) in chunks and waits
+     *
+     * The range is cut into one contiguous slice per node, proportional to the
+     * node's worker count; chunks of a slice are queued on that node.
+     *
+     * @param count Number of indices
+     * @param chunk Indices per task (0 = choose automatically)
+     * @param body Callback receiving a half-open range and the worker index
+     */
+    void parallelFor(size_t count, size_t chunk,
+                     const std::function<void(size_t, size_t, size_t)>& body);
+
+    /**
+     * @brief Runs fn(worker) exactly once on every worker thread and waits
+     *
+     * Used to allocate per-thread buffers from the thread that will use them.
+     */
+    void forEachWorker(const std::function<void(size_t)>& fn);
+
+    /**
+     * @brief Index of the calling worker, or npos when called from outside the pool
+     */
+    static size_t currentWorker();
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+   private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        size_t size = 0;  ///< Mirror of tasks.size(), guarded by sleepMutex
+    };
+
+    struct WorkerInfo {
+        size_t node;
+        int cpu;
+    };
+
+    void workerLoop(size_t index);
+    bool tryPop(size_t index, std::function<void()>& task);
+    void push(TaskQueue& queue, std::function<void()> task);
+
+    std::vector<std::thread> workers;
+    std::vector<WorkerInfo> workerInfo;
+    std::vector<std::vector<size_t>> nodeWorkers;       ///< Worker indices per node
+    std::vector<std::unique_ptr<TaskQueue>> nodeQueues;  ///< Shared queue per node
+    std::vector<std::unique_ptr<TaskQueue>> ownQueues;   ///< Private queue per worker
+
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<size_t> pending{0};  ///< Tasks submitted but not finished
+    std::atomic<size_t> nextNode{0};
+    bool stopping = false;
+};
+
+/**
+ * @class PerWorker
+ * @brief One T per pool worker, constructed on that worker (first touch)
+ *
+ * Each element is built inside forEachWorker, so its heap storage is
+ * allocated and first written by the thread that will use it and lands on
+ * that thread's NUMA node.
+ */
+template <typename T>
+class PerWorker {
+   public:
+    /**
+     * @brief Builds one value per worker
+     * @param pool Pool whose workers own the values
+     * @param make Factory called on each worker, given the worker index
+     */
+    template <typename Factory>
+    PerWorker(ThreadPool& pool, Factory make) : values(pool.size()) {
+        pool.forEachWorker([&](size_t worker) { values[worker].reset(new T(make(worker))); });
+    }
+
+    T& operator[](size_t worker) { return *values[worker]; }
+    const T& operator[](size_t worker) const { return *values[worker]; }
+    size_t size() const { return values.size(); }
+
+    /**
+     * @brief Value of the calling worker (must be called from inside the pool)
+     */
+    T& local() { return *values[ThreadPool::currentWorker()]; }
+
+   private:
+    std::vector<std::unique_ptr<T>> values;
+};
+
+#endif  // THREAD_POOL_H
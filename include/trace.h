@@ -0,0 +1,113 @@
+/**
+ * @file trace.h
+ * @brief Optional timeline recording of parallel runs in Chrome trace-event JSON
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class Trace
+ * @brief Process-wide trace recorder (off unless enabled)
+ *
+ * Every thread records its spans into its own buffer, created the first
+ * time the thread records anything; appending takes no lock and no atomic
+ * read-modify-write, so tracing a sweep does not serialize its workers.
+ * When tracing is off a span costs one relaxed atomic load.
+ *
+ * flush() writes all buffers as Chrome trace-event JSON ("X" complete
+ * events, one timeline row per thread, named with nameThread()). Open the
+ * file in https://ui.perfetto.dev, chrome://tracing or any local viewer
+ * that reads the format. flush() must run while no thread is recording,
+ * e.g. at exit, after the pools and writers have been joined.
+ *
+ * The programs enable it from the environment: NM_TRACE=Output/trace.json
+ * records the run and writes the file at exit.
+ *
+ * Example usage:
+ * @code
+ * Trace::enableFromEnvironment();          // Start of main
+ * {
+ *     TraceSpan span("flight", "sweep", i);  // Recorded when it goes out of scope
+ *     ...
+ * }
+ * @endcode
+ */
+class Trace {
+   public:
+    /**
+     * @brief Starts recording; flush() will write to path
+     */
+    static void enable(const std::string& path);
+
+    /**
+     * @brief Calls enable($NM_TRACE) and flushes at exit, if NM_TRACE is set
+     * @return True if tracing was enabled
+     */
+    static bool enableFromEnvironment();
+
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Names the calling thread's row in the timeline (no-op when disabled)
+     */
+    static void nameThread(const std::string& name);
+
+    /**
+     * @brief Nanoseconds since enable()
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Adds a finished span to the calling thread's buffer
+     * @param name,category String literals (stored as pointers)
+     * @param id Shown as the span's argument (e.g. case index), or -1 for none
+     */
+    static void record(const char* name, const char* category, uint64_t start, uint64_t end,
+                       int64_t id = -1);
+
+    /**
+     * @brief Stops recording and writes the JSON file
+     * @return Number of spans written
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static size_t flush();
+
+   private:
+    static std::atomic<bool> active;
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records the lifetime of a scope as one span (when tracing is on)
+ */
+class TraceSpan {
+   public:
+    TraceSpan(const char* name, const char* category, int64_t id = -1)
+        : name(name), category(category), id(id), on(Trace::enabled()),
+          start(on ? Trace::now() : 0) {}
+    ~TraceSpan() {
+        if (on) {
+            Trace::record(name, category, start, Trace::now(), id);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+   private:
+    const char* name;
+    const char* category;
+    int64_t id;
+    bool on;
+    uint64_t start;
+};
+
+#endif  // TRACE_H
@@ -0,0 +1,135 @@
+/**
+ * @file vec3_array.h
+ * @brief Structure-of-arrays container of 3D vectors with bulk operations
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ */
+
+#ifndef VEC3_ARRAY_H
+#define VEC3_ARRAY_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "thread_pool.h"
+#include "vector3d.h"
+
+/**
+ * @brief std::allocator replacement returning Alignment-byte aligned blocks
+ *
+ * 64 bytes is a cache line and the width of an AVX-512 register, so every
+ * array starts on a full SIMD lane boundary.
+ */
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        // aligned_alloc needs a size that is a multiple of the alignment
+        size_t bytes = (count * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void* block = std::aligned_alloc(Alignment, bytes == 0 ? Alignment : bytes);
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(block);
+    }
+    void deallocate(T* block, size_t) { std::free(block); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+/// Contiguous, 64-byte aligned array of doubles
+using AlignedVector = std::vector<double, AlignedAllocator<double>>;
+
+/**
+ * @class Vec3Array
+ * @brief N vectors stored as three aligned component arrays x[], y[], z[]
+ *
+ * The layout the particle and batched projectile engines compute on: a loop
+ * over i touches three unit-stride streams, so the compiler processes 4
+ * (AVX2) or 8 (AVX-512) vectors per instruction. Vector3D is used only to
+ * move single elements and whole arrays in and out (toAoS / fromAoS).
+ *
+ * The bulk operations below are free functions. They take an optional
+ * ThreadPool; large arrays are then split into chunks across the workers
+ * (small ones always run on the calling thread, where threading would cost
+ * more than the loop). Mismatched sizes throw std::invalid_argument.
+ *
+ * Example usage:
+ * @code
+ * Vec3Array position = Vec3Array::fromAoS(points), velocity(points.size());
+ * axpy(dt, velocity, position, &pool);   // position += dt * velocity
+ * AlignedVector speed;
+ * norm(velocity, speed, &pool);
+ * @endcode
+ */
+class Vec3Array {
+   public:
+    AlignedVector x, y, z;  ///< Components
+
+    Vec3Array() = default;
+
+    /**
+     * @brief count zero vectors
+     */
+    explicit Vec3Array(size_t count);
+
+    size_t size() const { return x.size(); }
+    void resize(size_t count);
+    void reserve(size_t count);
+
+    Vector3D get(size_t i) const { return Vector3D(x[i], y[i], z[i]); }
+    void set(size_t i, const Vector3D& v);
+    void push_back(const Vector3D& v);
+
+    /**
+     * @brief Converts an array of structures to this layout
+     */
+    static Vec3Array fromAoS(const std::vector<Vector3D>& vectors);
+
+    /**
+     * @brief Converts back to an array of structures
+     */
+    std::vector<Vector3D> toAoS() const;
+};
+
+/**
+ * @brief y[i] += a * x[i]
+ */
+void axpy(double a, const Vec3Array& x, Vec3Array& y, ThreadPool* pool = nullptr);
+
+/**
+ * @brief out[i] = a[i] · b[i] (out is resized)
+ */
+void dot(const Vec3Array& a, const Vec3Array& b, AlignedVector& out, ThreadPool* pool = nullptr);
+
+/**
+ * @brief out[i] = a[i] × b[i] (out is resized; it may not alias a or b)
+ */
+void cross(const Vec3Array& a, const Vec3Array& b, Vec3Array& out, ThreadPool* pool = nullptr);
+
+/**
+ * @brief out[i] = |v[i]| (out is resized)
+ */
+void norm(const Vec3Array& v, AlignedVector& out, ThreadPool* pool = nullptr);
+
+/**
+ * @brief v[i] = v[i] / |v[i]| in place; zero vectors stay zero, as in Vector3D::normalized
+ */
+void normalize(Vec3Array& v, ThreadPool* pool = nullptr);
+
+#endif  // VEC3_ARRAY_H
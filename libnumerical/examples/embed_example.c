@@ -0,0 +1,65 @@
+/*
+ * embed_example.c
+ *
+ * Calls the solvers through the C API, the way another service would.
+ * Build: make example   (from libnumerical/)
+ * Run:   LD_LIBRARY_PATH=bin ./bin/embed_example
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "numerical_api.h"
+
+int main(void) {
+    if (nm_api_version() != NM_API_VERSION) {
+        fprintf(stderr, "Header/library version mismatch\n");
+        return 1;
+    }
+
+    // Ping pong ball with the "final submission" launch conditions
+    nm_projectile_params params = {
+        {0.0, 0.0, 0.0, 5.0}, {4.0, 4.0, 10.0}, {-50.0, -100.0, 100.0}, 0.0027, 0.02, 1.27, 0.04,
+        0.5};
+    nm_projectile* proj = NULL;
+    nm_status status = nm_projectile_create(&params, &proj);
+    if (status != NM_OK) {
+        fprintf(stderr, "nm_projectile_create: %s\n", nm_status_string(status));
+        return 1;
+    }
+
+    nm_vec3 wind = {0.0, 0.0, 0.0};
+    size_t count = 0;
+    // First call with no buffer to learn the trajectory length
+    nm_projectile_simulate(proj, 0.001, wind, 10.0, NULL, 0, &count);
+    nm_point* points = malloc(count * sizeof(nm_point));
+    status = nm_projectile_simulate(proj, 0.001, wind, 10.0, points, count, &count);
+    if (status == NM_OK) {
+        nm_point last = points[count - 1];
+        printf("Projectile: %zu samples, lands at t = %.3f s (%.3f, %.3f)\n", count, last.t,
+               last.x, last.y);
+    }
+    free(points);
+    nm_projectile_destroy(proj);
+
+    nm_oscillator_params oscParams = {1.0, 9.8, 0.5, 0.2, 0.0, 1.2, 2.0 / 3.0};
+    nm_oscillator* osc = NULL;
+    if (nm_oscillator_create(&oscParams, &osc) == NM_OK) {
+        nm_oscillator_simulate(osc, 0.04, 180.0, NULL, 0, &count);
+        nm_oscillator_sample* samples = malloc(count * sizeof(nm_oscillator_sample));
+        if (nm_oscillator_simulate(osc, 0.04, 180.0, samples, count, &count) == NM_OK) {
+            printf("Oscillator: %zu samples, final angle %.5f rad\n", count,
+                   samples[count - 1].angle);
+        }
+        free(samples);
+        nm_oscillator_destroy(osc);
+    }
+
+    uint64_t steps = 0;
+    uint64_t peak = 0;
+    if (nm_collatz(27, &steps, &peak) == NM_OK) {
+        printf("Collatz(27): %llu steps, peak %llu\n", (unsigned long long)steps,
+               (unsigned long long)peak);
+    }
+    return 0;
+}
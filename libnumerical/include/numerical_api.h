@@ -0,0 +1,185 @@
+/**
+ * @file numerical_api.h
+ * @brief Stable C interface to the projectile, oscillator and Collatz engines
+ * @author CPP_Workspace
+ * @date 2026-10-18
+ *
+ * Lets other programs run the solvers in-process through libnumerical.so
+ * instead of spawning the project binaries and parsing their CSV output.
+ *
+ * Conventions:
+ * - Models are opaque handles created by `*_create` and released by `*_destroy`.
+ * - Every call returns an ::nm_status; no C++ exception crosses this boundary.
+ * - Result arrays are owned by the caller. A simulate call writes at most
+ *   `capacity` entries and always reports the full length in `*count`, so
+ *   passing `capacity = 0` (and `NULL`) queries the required size.
+ * - Handles are never modified by a simulation, so one handle may be used
+ *   from several threads at once.
+ */
+
+#ifndef NUMERICAL_API_H
+#define NUMERICAL_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Marks the symbols exported from libnumerical.so (everything else is hidden) */
+#if defined(__GNUC__)
+#define NM_EXPORT __attribute__((visibility("default")))
+#else
+#define NM_EXPORT
+#endif
+
+/** Bumped whenever a struct layout or function signature changes */
+#define NM_API_VERSION 1
+
+/**
+ * @brief Result codes returned by every entry point
+ */
+typedef enum nm_status {
+    NM_OK = 0,                    ///< Success
+    NM_ERR_INVALID_ARGUMENT = 1,  ///< Null handle/pointer or non-physical parameter
+    NM_ERR_BUFFER_TOO_SMALL = 2,  ///< Output truncated; `*count` holds the size needed
+    NM_ERR_OUT_OF_MEMORY = 3,     ///< Allocation failed inside the library
+    NM_ERR_OVERFLOW = 4,          ///< Integer result does not fit (Collatz)
+    NM_ERR_INTERNAL = 5           ///< Any other failure inside the engine
+} nm_status;
+
+/**
+ * @brief Version of the library actually loaded (compare with NM_API_VERSION)
+ */
+NM_EXPORT int nm_api_version(void);
+
+/**
+ * @brief Human readable description of a status code (static storage)
+ */
+NM_EXPORT const char* nm_status_string(nm_status status);
+
+// ==================== Projectile ====================
+
+/** Spatial vector (m, m/s or rad/s depending on use) */
+typedef struct nm_vec3 {
+    double x, y, z;
+} nm_vec3;
+
+/** One trajectory sample */
+typedef struct nm_point {
+    double t;        ///< Time (s)
+    double x, y, z;  ///< Position (m)
+} nm_point;
+
+/** Physical description of a projectile and its launch state */
+typedef struct nm_projectile_params {
+    nm_point position;        ///< Initial position and time
+    nm_vec3 velocity;         ///< Initial velocity (m/s)
+    nm_vec3 spin;             ///< Spin vector (rad/s)
+    double mass;              ///< Mass (kg), must be > 0
+    double radius;            ///< Radius (m), must be >= 0
+    double air_density;       ///< Air density (kg/m^3)
+    double s_over_m;          ///< Magnus spin factor S/m (1/s)
+    double drag_coefficient;  ///< Drag coefficient (dimensionless)
+} nm_projectile_params;
+
+typedef struct nm_projectile nm_projectile;  ///< Opaque projectile handle
+
+/**
+ * @brief Creates a projectile from its parameters
+ * @param params Parameters (copied)
+ * @param out Receives the new handle
+ */
+NM_EXPORT nm_status nm_projectile_create(const nm_projectile_params* params,
+                                         nm_projectile** out);
+
+/**
+ * @brief Releases a handle (NULL is ignored)
+ */
+NM_EXPORT void nm_projectile_destroy(nm_projectile* proj);
+
+/**
+ * @brief Integrates the flight with RK4 until landing or max_time
+ * @param proj Projectile handle (not modified)
+ * @param time_step Integration step (s), must be > 0
+ * @param wind Wind velocity (m/s)
+ * @param max_time Time limit (s)
+ * @param points Caller buffer for the trajectory, may be NULL if capacity is 0
+ * @param capacity Number of entries available in points
+ * @param count Receives the total number of trajectory samples
+ * @return NM_OK, or NM_ERR_BUFFER_TOO_SMALL when only capacity samples were written
+ */
+NM_EXPORT nm_status nm_projectile_simulate(const nm_projectile* proj, double time_step,
+                                           nm_vec3 wind, double max_time, nm_point* points,
+                                           size_t capacity, size_t* count);
+
+/**
+ * @brief Integrates the flight and returns only the final sample (no buffer needed)
+ */
+NM_EXPORT nm_status nm_projectile_impact(const nm_projectile* proj, double time_step,
+                                         nm_vec3 wind, double max_time, nm_point* impact);
+
+// ==================== Driven damped oscillator ====================
+
+/** Pendulum parameters and initial state */
+typedef struct nm_oscillator_params {
+    double mass;                      ///< Mass (kg), must be > 0
+    double length;                    ///< Pendulum length (m), must be > 0
+    double damping_coefficient;       ///< Damping coefficient
+    double initial_angle;             ///< Initial angle (rad)
+    double initial_angular_velocity;  ///< Initial angular velocity (rad/s)
+    double driving_force;             ///< Driving force amplitude (N)
+    double driving_frequency;         ///< Driving frequency (rad/s)
+} nm_oscillator_params;
+
+/** One oscillator sample */
+typedef struct nm_oscillator_sample {
+    double t;                 ///< Time (s)
+    double angle;             ///< Angle (rad)
+    double angular_velocity;  ///< Angular velocity (rad/s)
+} nm_oscillator_sample;
+
+typedef struct nm_oscillator nm_oscillator;  ///< Opaque oscillator handle
+
+/**
+ * @brief Creates an oscillator from its parameters
+ */
+NM_EXPORT nm_status nm_oscillator_create(const nm_oscillator_params* params,
+                                         nm_oscillator** out);
+
+/**
+ * @brief Releases a handle (NULL is ignored)
+ */
+NM_EXPORT void nm_oscillator_destroy(nm_oscillator* osc);
+
+/**
+ * @brief Integrates from t = 0 to duration with RK4
+ * @param samples Caller buffer, may be NULL if capacity is 0
+ * @param count Receives the total number of samples (including t = 0)
+ */
+NM_EXPORT nm_status nm_oscillator_simulate(const nm_oscillator* osc, double time_step,
+                                           double duration, nm_oscillator_sample* samples,
+                                           size_t capacity, size_t* count);
+
+// ==================== Collatz ====================
+
+/**
+ * @brief Steps to reach 1 and the largest value of the sequence starting at n
+ * @return NM_ERR_INVALID_ARGUMENT for n = 0, NM_ERR_OVERFLOW if 3n+1 exceeds 64 bits
+ */
+NM_EXPORT nm_status nm_collatz(uint64_t n, uint64_t* steps, uint64_t* peak);
+
+/**
+ * @brief Runs nm_collatz for first, first+1, ..., first+count-1
+ * @param steps Caller array of count entries (may be NULL)
+ * @param peaks Caller array of count entries (may be NULL)
+ */
+NM_EXPORT nm_status nm_collatz_range(uint64_t first, size_t count, uint64_t* steps,
+                                     uint64_t* peaks);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // NUMERICAL_API_H
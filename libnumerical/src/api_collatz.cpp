@@ -0,0 +1,40 @@
+/**
+ * @file api_collatz.cpp
+ * @brief C API wrapper around the shared Collatz kernel
+ */
+
+#include "api_internal.h"
+#include "collatz.h"
+
+extern "C" nm_status nm_collatz(uint64_t n, uint64_t* steps, uint64_t* peak) {
+    if (n == 0) {
+        return NM_ERR_INVALID_ARGUMENT;
+    }
+    unsigned long long s = 0;
+    unsigned long long p = 0;
+    if (!collatzChecked(n, s, p)) {
+        return NM_ERR_OVERFLOW;
+    }
+    if (steps != nullptr) {
+        *steps = s;
+    }
+    if (peak != nullptr) {
+        *peak = p;
+    }
+    return NM_OK;
+}
+
+extern "C" nm_status nm_collatz_range(uint64_t first, size_t count, uint64_t* steps,
+                                      uint64_t* peaks) {
+    if (first == 0 || first + count < first) {
+        return NM_ERR_INVALID_ARGUMENT;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        nm_status status = nm_collatz(first + i, steps ? steps + i : nullptr,
+                                      peaks ? peaks + i : nullptr);
+        if (status != NM_OK) {
+            return status;
+        }
+    }
+    return NM_OK;
+}
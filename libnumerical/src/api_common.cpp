@@ -0,0 +1,28 @@
+/**
+ * @file api_common.cpp
+ * @brief Version and status reporting for the C API
+ */
+
+#include "numerical_api.h"
+
+extern "C" int nm_api_version(void) {
+    return NM_API_VERSION;
+}
+
+extern "C" const char* nm_status_string(nm_status status) {
+    switch (status) {
+        case NM_OK:
+            return "ok";
+        case NM_ERR_INVALID_ARGUMENT:
+            return "invalid argument";
+        case NM_ERR_BUFFER_TOO_SMALL:
+            return "output buffer too small";
+        case NM_ERR_OUT_OF_MEMORY:
+            return "out of memory";
+        case NM_ERR_OVERFLOW:
+            return "integer overflow";
+        case NM_ERR_INTERNAL:
+            return "internal error";
+    }
+    return "unknown status";
+}
@@ -0,0 +1,49 @@
+/**
+ * @file api_internal.h
+ * @brief Helpers shared by the C API translation units (not installed)
+ */
+
+#ifndef API_INTERNAL_H
+#define API_INTERNAL_H
+
+#include <cstddef>
+#include <new>
+
+#include "numerical_api.h"
+
+/**
+ * @brief Runs body and converts any escaping exception to a status code
+ *
+ * Every extern "C" entry point goes through this so exceptions never unwind
+ * into C callers.
+ */
+template <typename Body>
+nm_status guarded(Body&& body) noexcept {
+    try {
+        return body();
+    } catch (const std::bad_alloc&) {
+        return NM_ERR_OUT_OF_MEMORY;
+    } catch (...) {
+        return NM_ERR_INTERNAL;
+    }
+}
+
+/**
+ * @brief Copies a result sequence into a caller buffer using the size-query convention
+ * @param convert Maps one source element to the output type
+ */
+template <typename Source, typename Out, typename Convert>
+nm_status copyOut(const Source& source, Out* out, std::size_t capacity, std::size_t* count,
+                  Convert convert) {
+    *count = source.size();
+    std::size_t written = source.size() < capacity ? source.size() : capacity;
+    if (written > 0 && out == nullptr) {
+        return NM_ERR_INVALID_ARGUMENT;
+    }
+    for (std::size_t i = 0; i < written; ++i) {
+        out[i] = convert(source[i]);
+    }
+    return written == source.size() ? NM_OK : NM_ERR_BUFFER_TOO_SMALL;
+}
+
+#endif  // API_INTERNAL_H
@@ -0,0 +1,58 @@
+/**
+ * @file api_oscillator.cpp
+ * @brief C API wrapper around Project 2 (OscillatorParams + rk4Step)
+ */
+
+#include <cmath>
+
+#include "api_internal.h"
+#include "oscillator.h"
+
+struct nm_oscillator {
+    OscillatorParams params;  ///< Shared read-only by concurrent simulations
+    OscillatorState initial;  ///< Copied for every simulation
+};
+
+namespace {
+
+nm_oscillator_sample toSample(const OscillatorState& state) {
+    return nm_oscillator_sample{state.time, state.unwrappedAngle(), state.angularVelocity};
+}
+
+}  // namespace
+
+extern "C" nm_status nm_oscillator_create(const nm_oscillator_params* params,
+                                          nm_oscillator** out) {
+    if (params == nullptr || out == nullptr || !(params->mass > 0) || !(params->length > 0)) {
+        return NM_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        oscillator model(params->mass, params->length, params->damping_coefficient,
+                         params->initial_angle, params->initial_angular_velocity,
+                         params->driving_force, params->driving_frequency);
+        *out = new nm_oscillator{model.params, model.initial};
+        return NM_OK;
+    });
+}
+
+extern "C" void nm_oscillator_destroy(nm_oscillator* osc) {
+    delete osc;
+}
+
+extern "C" nm_status nm_oscillator_simulate(const nm_oscillator* osc, double time_step,
+                                            double duration, nm_oscillator_sample* samples,
+                                            size_t capacity, size_t* count) {
+    if (osc == nullptr || count == nullptr || !std::isfinite(time_step) || !(time_step > 0) ||
+        !std::isfinite(duration)) {
+        return NM_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        OscillatorState state = osc->initial;
+        std::vector<OscillatorState> path{state};
+        while (state.time < duration) {
+            state = rk4Step(osc->params, state, time_step);
+            path.push_back(state);
+        }
+        return copyOut(path, samples, capacity, count, toSample);
+    });
+}
@@ -0,0 +1,78 @@
+/**
+ * @file api_projectile.cpp
+ * @brief C API wrapper around Project 1 (Projectile + rk4Simulation)
+ */
+
+#include <cmath>
+
+#include "Processing.h"
+#include "Projectile.h"
+#include "api_internal.h"
+
+struct nm_projectile {
+    ProjectileParams params;  ///< Shared read-only by concurrent simulations
+    ProjectileState launch;   ///< Copied for every simulation
+};
+
+namespace {
+
+Vector3D toVector(nm_vec3 v) {
+    return Vector3D(v.x, v.y, v.z);
+}
+
+nm_point toPoint(const Vector4D& p) {
+    return nm_point{p.t, p.x, p.y, p.z};
+}
+
+bool validStep(double timeStep, double maxTime) {
+    return std::isfinite(timeStep) && timeStep > 0 && std::isfinite(maxTime);
+}
+
+}  // namespace
+
+extern "C" nm_status nm_projectile_create(const nm_projectile_params* params,
+                                          nm_projectile** out) {
+    if (params == nullptr || out == nullptr || !(params->mass > 0) || !(params->radius >= 0)) {
+        return NM_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        const nm_point& p = params->position;
+        Projectile proj(Vector4D(p.x, p.y, p.z, p.t), toVector(params->velocity),
+                        toVector(params->spin), params->mass, params->radius,
+                        params->air_density, params->s_over_m, params->drag_coefficient);
+        *out = new nm_projectile{proj.getParams(), proj.getState()};
+        return NM_OK;
+    });
+}
+
+extern "C" void nm_projectile_destroy(nm_projectile* proj) {
+    delete proj;
+}
+
+extern "C" nm_status nm_projectile_simulate(const nm_projectile* proj, double time_step,
+                                            nm_vec3 wind, double max_time, nm_point* points,
+                                            size_t capacity, size_t* count) {
+    if (proj == nullptr || count == nullptr || !validStep(time_step, max_time)) {
+        return NM_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        ProjectileState flight = proj->launch;
+        Trajectory trajectory =
+            rk4Simulation(proj->params, flight, time_step, toVector(wind), max_time);
+        return copyOut(trajectory.getPoints(), points, capacity, count, toPoint);
+    });
+}
+
+extern "C" nm_status nm_projectile_impact(const nm_projectile* proj, double time_step,
+                                          nm_vec3 wind, double max_time, nm_point* impact) {
+    if (proj == nullptr || impact == nullptr || !validStep(time_step, max_time)) {
+        return NM_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        ProjectileState flight = proj->launch;
+        Trajectory trajectory =
+            rk4Simulation(proj->params, flight, time_step, toVector(wind), max_time);
+        *impact = toPoint(trajectory.getFinalPoint());
+        return NM_OK;
+    });
+}
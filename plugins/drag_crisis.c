@@ -0,0 +1,66 @@
+/*
+ * drag_crisis.c
+ *
+ * Example acceleration plugin for Project 1: quadratic drag whose coefficient
+ * drops from cd_low to cd_high around a critical Reynolds number (the "drag
+ * crisis" of a rough ball), instead of the constant Cd in src/Projectile.cpp.
+ * No Magnus force; gravity is included.
+ *
+ * Build: make plugins   (from the workspace root, writes bin/plugins/drag_crisis.so)
+ * Run:   option 8 of Project 1's menu
+ */
+
+#include <math.h>
+
+#include "model_plugin.h"
+
+enum { MASS, RADIUS, AIR_DENSITY, VISCOSITY, CD_LOW, CD_HIGH, RE_CRITICAL, RE_WIDTH, GRAVITY };
+
+/* Acceleration for velocity relative to the air (rx, ry, rz) */
+static void accelerate(const double* p, double rx, double ry, double rz, double* a) {
+    double speed = sqrt(rx * rx + ry * ry + rz * rz);
+    double reynolds = 2.0 * p[RADIUS] * speed / p[VISCOSITY];
+    double blend = 1.0 / (1.0 + exp((reynolds - p[RE_CRITICAL]) / p[RE_WIDTH]));
+    double cd = p[CD_HIGH] + (p[CD_LOW] - p[CD_HIGH]) * blend;
+    double area = 3.14159265358979323846 * p[RADIUS] * p[RADIUS];
+    double k = 0.5 * p[AIR_DENSITY] * area * cd * speed / p[MASS];
+    a[0] = -k * rx;
+    a[1] = -k * ry;
+    a[2] = -k * rz - p[GRAVITY];
+}
+
+static void dragCrisis(const double* p, double t, const double* in, double* out) {
+    (void)t;
+    accelerate(p, in[0] - in[3], in[1] - in[4], in[2] - in[5], out);
+}
+
+static void dragCrisisBatch(const double* p, size_t count, const double* t,
+                            const double* const* in, double* const* out) {
+    (void)t;
+    for (size_t i = 0; i < count; ++i) {
+        double a[3];
+        accelerate(p, in[0][i] - in[3][i], in[1][i] - in[4][i], in[2][i] - in[5][i], a);
+        out[0][i] = a[0];
+        out[1][i] = a[1];
+        out[2][i] = a[2];
+    }
+}
+
+static const char* const parameterNames[] = {
+    "mass", "radius", "air_density", "viscosity", "cd_low", "cd_high", "re_critical", "re_width",
+    "gravity"};
+/* A baseball in sea-level air */
+static const double defaults[] = {0.145, 0.0366, 1.225, 1.5e-5, 0.5, 0.2, 2.0e5, 2.0e4, 9.81};
+
+static const nm_model models[] = {
+    {NM_PLUGIN_ABI_VERSION, sizeof(nm_model), NM_MODEL_ACCELERATION, "drag_crisis",
+     "Quadratic drag with a Reynolds-number dependent drag coefficient", 6, 9, parameterNames,
+     defaults, NULL, NULL, dragCrisis, dragCrisisBatch}};
+
+NM_PLUGIN_EXPORT const nm_model* nm_plugin_models(uint32_t host_abi_version, size_t* count) {
+    if (host_abi_version != NM_PLUGIN_ABI_VERSION) {
+        return NULL;
+    }
+    *count = sizeof(models) / sizeof(models[0]);
+    return models;
+}
@@ -0,0 +1,55 @@
+/*
+ * duffing.c
+ *
+ * Example ODE plugin: the driven Duffing oscillator
+ *   x'' + delta x' + alpha x + beta x^3 = gamma cos(omega t)
+ * With alpha < 0 it is a double-well potential and the motion becomes chaotic
+ * for moderate forcing, a variant of Project 2's pendulum that needs no change
+ * to the project itself.
+ *
+ * Build: make plugins   (from the workspace root, writes bin/plugins/duffing.so)
+ * Run:   ./bin/main --plugin duffing   (from Project 2)
+ */
+
+#include <math.h>
+
+#include "model_plugin.h"
+
+enum { DELTA, ALPHA, BETA, GAMMA, OMEGA };
+
+static void duffing(const double* p, double t, const double* y, double* dy) {
+    double x = y[0], v = y[1];
+    dy[0] = v;
+    dy[1] = p[GAMMA] * cos(p[OMEGA] * t) - p[DELTA] * v - p[ALPHA] * x - p[BETA] * x * x * x;
+}
+
+static void duffingBatch(const double* p, size_t count, const double* t,
+                         const double* const* y, double* const* dy) {
+    const double* x = y[0];
+    const double* v = y[1];
+    double* dx = dy[0];
+    double* dv = dy[1];
+    for (size_t i = 0; i < count; ++i) {
+        dx[i] = v[i];
+        dv[i] = p[GAMMA] * cos(p[OMEGA] * t[i]) - p[DELTA] * v[i] - p[ALPHA] * x[i] -
+                p[BETA] * x[i] * x[i] * x[i];
+    }
+}
+
+static const char* const parameterNames[] = {"delta", "alpha", "beta", "gamma", "omega"};
+static const double defaults[] = {0.3, -1.0, 1.0, 0.5, 1.2};
+static const char* const stateNames[] = {"x", "v"};
+static const double initial[] = {1.0, 0.0};
+
+static const nm_model models[] = {
+    {NM_PLUGIN_ABI_VERSION, sizeof(nm_model), NM_MODEL_ODE, "duffing",
+     "Driven Duffing oscillator x'' + delta x' + alpha x + beta x^3 = gamma cos(omega t)", 2, 5,
+     parameterNames, defaults, stateNames, initial, duffing, duffingBatch}};
+
+NM_PLUGIN_EXPORT const nm_model* nm_plugin_models(uint32_t host_abi_version, size_t* count) {
+    if (host_abi_version != NM_PLUGIN_ABI_VERSION) {
+        return NULL;
+    }
+    *count = sizeof(models) / sizeof(models[0]);
+    return models;
+}
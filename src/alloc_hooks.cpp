@@ -0,0 +1,115 @@
+/**
+ * @file alloc_hooks.cpp
+ * @brief Replacement global operator new / delete feeding AllocationTracker
+ *
+ * Linked into the programs only (not libnumerical): a shared library that
+ * replaced operator new would take over its host process's allocator.
+ */
+
+#include "../include/alloc_tracker.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        void* block = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            block = std::malloc(size);
+        } else if (posix_memalign(&block, alignment, size) != 0) {
+            block = nullptr;
+        }
+        if (block != nullptr) {
+            if (AllocationTracker::enabled()) {
+                AllocationTracker::recordAllocation(block, size);
+            }
+            return block;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void release(void* block) {
+    if (block == nullptr) {
+        return;
+    }
+    if (AllocationTracker::enabled()) {
+        AllocationTracker::recordFree(block);
+    }
+    std::free(block);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    return allocate(size, 0);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size, 0);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size, 0);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* block) noexcept {
+    release(block);
+}
+
+void operator delete[](void* block) noexcept {
+    release(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    release(block);
+}
+
+void operator delete[](void* block, std::size_t) noexcept {
+    release(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    release(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept {
+    release(block);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept {
+    release(block);
+}
+
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept {
+    release(block);
+}
@@ -0,0 +1,247 @@
+/**
+ * @file alloc_tracker.cpp
+ * @brief Implementation of the per-subsystem allocation statistics
+ */
+
+#include "../include/alloc_tracker.h"
+
+#include <sys/resource.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+std::atomic<bool> AllocationTracker::active{false};
+
+namespace {
+
+const int maxSubsystems = 64;
+
+// Static, trivially destructible: usable by frees that run after other
+// statics have been destroyed
+struct Counters {
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> frees;
+    std::atomic<uint64_t> bytes;
+    std::atomic<int64_t> live;
+    std::atomic<int64_t> peak;
+};
+
+Counters counters[maxSubsystems];
+Counters everything;
+
+std::mutex namesMutex;
+const char* names[maxSubsystems] = {"other"};
+int subsystemCount = 1;
+
+thread_local int currentSubsystem = 0;
+
+// The ownership table must not allocate through operator new (it is called
+// from it), so its nodes come straight from malloc
+template <typename T>
+struct MallocAllocator {
+    using value_type = T;
+    MallocAllocator() = default;
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        void* block = std::malloc(n * sizeof(T));
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(block);
+    }
+    void deallocate(T* block, size_t) { std::free(block); }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>&) const { return false; }
+};
+
+struct Owner {
+    int subsystem;
+    size_t bytes;
+};
+
+using OwnerMap = std::unordered_map<void*, Owner, std::hash<void*>, std::equal_to<void*>,
+                                    MallocAllocator<std::pair<void* const, Owner>>>;
+
+// Sharded by address so threads allocating at once rarely share a lock
+struct Shard {
+    std::mutex mutex;
+    OwnerMap owners;
+};
+
+const size_t shardBits = 6;
+
+Shard& shardOf(void* pointer) {
+    // Never destroyed: frees keep arriving during static destruction
+    static Shard* shards = [] {
+        Shard* block = static_cast<Shard*>(std::malloc(sizeof(Shard) << shardBits));
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        for (size_t i = 0; i < (size_t(1) << shardBits); ++i) {
+            new (block + i) Shard();
+        }
+        return block;
+    }();
+    uint64_t hash = (reinterpret_cast<uintptr_t>(pointer) >> 4) * 0x9E3779B97F4A7C15ull;
+    return shards[hash >> (64 - shardBits)];
+}
+
+void add(Counters& c, size_t bytes) {
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    int64_t live = c.live.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) +
+                   static_cast<int64_t>(bytes);
+    int64_t peak = c.peak.load(std::memory_order_relaxed);
+    while (live > peak && !c.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void remove(Counters& c, size_t bytes) {
+    c.frees.fetch_add(1, std::memory_order_relaxed);
+    c.live.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+AllocationStats statsOf(const Counters& c) {
+    AllocationStats stats;
+    stats.allocations = c.allocations.load(std::memory_order_relaxed);
+    stats.frees = c.frees.load(std::memory_order_relaxed);
+    stats.bytes = c.bytes.load(std::memory_order_relaxed);
+    stats.liveBytes = c.live.load(std::memory_order_relaxed);
+    stats.peakBytes = c.peak.load(std::memory_order_relaxed);
+    return stats;
+}
+
+int subsystemIndex(const char* name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    for (int i = 0; i < subsystemCount; ++i) {
+        if (std::strcmp(names[i], name) == 0) {
+            return i;
+        }
+    }
+    if (subsystemCount == maxSubsystems) {
+        return 0;  // Out of slots: charged to "other"
+    }
+    names[subsystemCount] = name;
+    return subsystemCount++;
+}
+
+void printAtExit() {
+    AllocationTracker::print(std::cout);
+}
+
+}  // namespace
+
+// ==================== AllocationTracker ====================
+
+void AllocationTracker::enable() {
+    shardOf(nullptr);  // Build the table before the first tracked allocation
+    active.store(true, std::memory_order_relaxed);
+}
+
+bool AllocationTracker::enableFromEnvironment() {
+    const char* value = std::getenv("NM_ALLOC");
+    if (value == nullptr || *value == '\0' || std::strcmp(value, "0") == 0) {
+        return false;
+    }
+    enable();
+    std::atexit(printAtExit);
+    return true;
+}
+
+void AllocationTracker::recordAllocation(void* pointer, size_t bytes) {
+    int subsystem = currentSubsystem;
+    Shard& shard = shardOf(pointer);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.owners[pointer] = Owner{subsystem, bytes};
+    }
+    add(counters[subsystem], bytes);
+    add(everything, bytes);
+}
+
+void AllocationTracker::recordFree(void* pointer) {
+    Shard& shard = shardOf(pointer);
+    Owner owner;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.owners.find(pointer);
+        if (found == shard.owners.end()) {
+            return;  // Allocated before tracking started
+        }
+        owner = found->second;
+        shard.owners.erase(found);
+    }
+    remove(counters[owner.subsystem], owner.bytes);
+    remove(everything, owner.bytes);
+}
+
+std::vector<std::pair<std::string, AllocationStats>> AllocationTracker::subsystems() {
+    std::vector<std::pair<const char*, int>> known;
+    {
+        std::lock_guard<std::mutex> lock(namesMutex);
+        for (int i = 0; i < subsystemCount; ++i) {
+            known.emplace_back(names[i], i);
+        }
+    }
+    std::vector<std::pair<std::string, AllocationStats>> result;
+    for (const auto& entry : known) {
+        result.emplace_back(entry.first, statsOf(counters[entry.second]));
+    }
+    return result;
+}
+
+AllocationStats AllocationTracker::total() {
+    return statsOf(everything);
+}
+
+void AllocationTracker::print(std::ostream& out) {
+    const double mib = 1.0 / (1024.0 * 1024.0);
+    auto row = [&](const std::string& name, const AllocationStats& s) {
+        out << std::left << std::setw(26) << name.substr(0, 25) << std::right << std::setw(12)
+            << s.allocations << std::setw(12) << s.frees << std::fixed << std::setprecision(2)
+            << std::setw(12) << s.bytes * mib << std::setw(11) << s.liveBytes * mib
+            << std::setw(11) << s.peakBytes * mib << std::defaultfloat << std::endl;
+    };
+
+    out << "Heap allocations by subsystem (MiB)" << std::endl;
+    out << std::left << std::setw(26) << "subsystem" << std::right << std::setw(12) << "allocs"
+        << std::setw(12) << "frees" << std::setw(12) << "total" << std::setw(11) << "live"
+        << std::setw(11) << "peak" << std::endl;
+    for (const auto& entry : subsystems()) {
+        if (entry.second.allocations > 0) {
+            row(entry.first, entry.second);
+        }
+    }
+    row("all", total());
+
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        out << "Peak resident set: " << std::fixed << std::setprecision(1)
+            << usage.ru_maxrss / 1024.0 << " MiB" << std::defaultfloat << std::endl;
+    }
+}
+
+// ==================== AllocScope ====================
+
+AllocScope::AllocScope(const char* subsystem) {
+    if (AllocationTracker::enabled()) {
+        previous = currentSubsystem;
+        currentSubsystem = subsystemIndex(subsystem);
+    }
+}
+
+AllocScope::~AllocScope() {
+    if (previous >= 0) {
+        currentSubsystem = previous;
+    }
+}
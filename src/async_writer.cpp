@@ -0,0 +1,278 @@
+/**
+ * @file async_writer.cpp
+ * @brief Implementation of AsyncWriter and AsyncWriter::Stream
+ */
+
+#include "../include/async_writer.h"
+
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+
+#include "../include/alloc_tracker.h"
+#include "../include/trace.h"
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+#ifdef USE_ZLIB
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+#endif
+
+// Appends value in the same style as std::ostream with the given precision
+void appendNumber(std::string& text, double value, int precision) {
+    char digits[64];
+    std::to_chars_result result =
+        precision > 0 ? std::to_chars(digits, digits + sizeof(digits), value,
+                                      std::chars_format::general, precision)
+                      : std::to_chars(digits, digits + sizeof(digits), value);
+    text.append(digits, result.ptr);
+}
+
+}  // namespace
+
+// ==================== Stream ====================
+
+AsyncWriter::Stream::Stream(AsyncWriter& owner, std::string filename, std::string preamble,
+                            size_t columns, size_t bufferRows, bool append)
+    : writer(owner),
+      path(std::move(filename)),
+      preamble(std::move(preamble)),
+      columnCount(columns),
+      capacity(columns * bufferRows),
+      appending(append) {
+    buffers[0].values.reserve(capacity);
+    buffers[1].values.reserve(capacity);
+}
+
+AsyncWriter::Stream::~Stream() {
+    // No job holds a reference any more, so nothing is in flight: write what
+    // is left on this thread rather than dropping it
+    if (!closed) {
+        writeBuffer(active, true);
+    }
+}
+
+void AsyncWriter::Stream::append(const double* row) {
+    std::vector<double>& values = buffers[active].values;
+    values.insert(values.end(), row, row + columnCount);
+    if (values.size() >= capacity) {
+        submitActive(false);
+    }
+}
+
+void AsyncWriter::Stream::submitActive(bool last) {
+    int index;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // Double buffering: the other buffer must be back before we switch to it
+        int other = 1 - active;
+        returned.wait(lock, [&] { return !buffers[other].inFlight; });
+        index = active;
+        buffers[index].inFlight = true;
+        active = other;
+    }
+    writer.enqueue(Job{shared_from_this(), index, last});
+}
+
+void AsyncWriter::Stream::close() {
+    if (closed) {
+        return;
+    }
+    closed = true;
+    submitActive(true);
+}
+
+void AsyncWriter::Stream::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    returned.wait(lock, [&] { return !buffers[0].inFlight && !buffers[1].inFlight; });
+}
+
+void AsyncWriter::Stream::writeBuffer(int index, bool last) {
+    std::vector<double>& values = buffers[index].values;
+
+    // Format first, then open lazily so a failed open still releases the buffer
+    text.clear();
+    if (file == nullptr && !failed) {
+        text += preamble;
+    }
+    for (size_t i = 0; i < values.size(); i += columnCount) {
+        for (size_t c = 0; c < columnCount; ++c) {
+            if (c > 0) {
+                text += ',';
+            }
+            appendNumber(text, values[i + c], writer.precision);
+        }
+        text += '\n';
+    }
+    values.clear();
+
+    if (failed) {
+        return;
+    }
+#ifdef USE_ZLIB
+    bool compress = endsWith(path, ".gz");
+#endif
+    if (file == nullptr) {
+#ifdef USE_ZLIB
+        file = compress ? static_cast<void*>(gzopen(path.c_str(), appending ? "ab" : "wb"))
+                        : static_cast<void*>(std::fopen(path.c_str(), appending ? "a" : "w"));
+#else
+        file = std::fopen(path.c_str(), appending ? "a" : "w");
+#endif
+        if (file == nullptr) {
+            std::cerr << "Error: Could not open file " << path << std::endl;
+            failed = true;
+            return;
+        }
+    }
+
+    bool written;
+#ifdef USE_ZLIB
+    if (compress) {
+        written = text.empty() || gzwrite(static_cast<gzFile>(file), text.data(),
+                                          static_cast<unsigned>(text.size())) > 0;
+    } else
+#endif
+    {
+        written = std::fwrite(text.data(), 1, text.size(), static_cast<std::FILE*>(file)) ==
+                  text.size();
+    }
+    if (!written) {
+        std::cerr << "Error: Could not write file " << path << std::endl;
+        failed = true;
+    }
+
+    if (last) {
+#ifdef USE_ZLIB
+        if (compress) {
+            gzclose(static_cast<gzFile>(file));
+        } else
+#endif
+        {
+            std::fclose(static_cast<std::FILE*>(file));
+        }
+        file = nullptr;
+        std::string().swap(text);
+    }
+}
+
+void AsyncWriter::Stream::finished(int index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffers[index].inFlight = false;
+    returned.notify_all();
+}
+
+// ==================== AsyncWriter ====================
+
+AsyncWriter::AsyncWriter(size_t ioThreadCount, size_t rows, int digits)
+    : bufferRows(rows > 0 ? rows : 1), precision(digits) {
+    if (ioThreadCount == 0) {
+        ioThreadCount = 1;
+    }
+    for (size_t i = 0; i < ioThreadCount; ++i) {
+        ioThreads.emplace_back(&AsyncWriter::ioLoop, this);
+    }
+}
+
+AsyncWriter::~AsyncWriter() {
+    std::vector<std::shared_ptr<Stream>> open;
+    {
+        std::lock_guard<std::mutex> lock(streamsMutex);
+        for (std::weak_ptr<Stream>& weak : streams) {
+            if (std::shared_ptr<Stream> stream = weak.lock()) {
+                open.push_back(stream);
+            }
+        }
+    }
+    for (std::shared_ptr<Stream>& stream : open) {
+        stream->close();
+    }
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (std::thread& thread : ioThreads) {
+        thread.join();
+    }
+}
+
+bool AsyncWriter::compressionAvailable() {
+#ifdef USE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<AsyncWriter::Stream> AsyncWriter::open(const std::string& filename,
+                                                       const std::string& preamble,
+                                                       size_t columns, bool append) {
+    std::shared_ptr<Stream> stream(
+        new Stream(*this, filename, preamble, columns > 0 ? columns : 1, bufferRows, append));
+    std::lock_guard<std::mutex> lock(streamsMutex);
+    // Forget streams that have already been released
+    size_t kept = 0;
+    for (size_t i = 0; i < streams.size(); ++i) {
+        if (!streams[i].expired()) {
+            streams[kept++] = streams[i];
+        }
+    }
+    streams.resize(kept);
+    streams.push_back(stream);
+    return stream;
+}
+
+void AsyncWriter::enqueue(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+void AsyncWriter::flush() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    idle.wait(lock, [this] { return jobs.empty() && busy == 0; });
+}
+
+void AsyncWriter::ioLoop() {
+    Trace::nameThread("async writer");
+    AllocScope memory("async writer");
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            busy++;
+        }
+
+        {
+            TraceSpan span("write", "io");
+            job.stream->writeBuffer(job.buffer, job.last);
+        }
+        job.stream->finished(job.buffer);
+        job.stream.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            busy--;
+            if (jobs.empty() && busy == 0) {
+                idle.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,317 @@
+/**
+ * @file barnes_hut.cpp
+ * @brief Implementation of the Barnes-Hut octree
+ */
+
+#include "../include/barnes_hut.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const unsigned keyBits = 21;     // Bits per axis in a Morton key
+const unsigned maxDepth = 21;    // Cells at this depth are always leaves
+const unsigned splitDepth = 2;   // Subtrees from this depth down are built in parallel
+const uint32_t splitCells = 64;  // 8^splitDepth
+
+// Spreads the low 21 bits of v so that there are two zero bits between each
+uint64_t spreadBits(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+
+// Shift of the octant digit (0-7) that selects the children of a node at depth
+unsigned digitShift(unsigned depth) {
+    return 3 * (maxDepth - 1 - depth);
+}
+
+}  // namespace
+
+BarnesHutTree::BarnesHutTree(BarnesHutSettings settings)
+    : options(settings), subtrees(splitCells), cellStart(splitCells + 1) {}
+
+void BarnesHutTree::sortByKey(ThreadPool& pool) {
+    size_t n = keys.size();
+    sortScratch.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        sortScratch[i] = {keys[i], static_cast<uint32_t>(i)};
+    }
+
+    // Sort one run per worker, then merge neighbouring runs pairwise
+    size_t runs = std::max<size_t>(1, std::min(pool.size(), n / 4096));
+    size_t runLength = (n + runs - 1) / std::max<size_t>(runs, 1);
+    pool.parallelFor(runs, 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t r = begin; r < end; ++r) {
+            auto first = sortScratch.begin() + std::min(n, r * runLength);
+            auto last = sortScratch.begin() + std::min(n, (r + 1) * runLength);
+            std::sort(first, last);
+        }
+    });
+    for (size_t width = runLength; width < n; width *= 2) {
+        size_t pairs = (n + 2 * width - 1) / (2 * width);
+        pool.parallelFor(pairs, 1, [&](size_t begin, size_t end, size_t) {
+            for (size_t p = begin; p < end; ++p) {
+                auto first = sortScratch.begin() + p * 2 * width;
+                auto middle = sortScratch.begin() + std::min(n, p * 2 * width + width);
+                auto last = sortScratch.begin() + std::min(n, (p + 1) * 2 * width);
+                std::inplace_merge(first, middle, last);
+            }
+        });
+    }
+}
+
+void BarnesHutTree::build(const ParticleSystem& particles, ThreadPool& pool) {
+    size_t n = particles.size();
+    keys.resize(n);
+    order.resize(n);
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    mass.resize(n);
+    nodes.clear();
+    if (n == 0) {
+        return;
+    }
+
+    // Bounding cube (per-worker partial boxes)
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<std::array<double, 6>> boxes(pool.size(), {inf, inf, inf, -inf, -inf, -inf});
+    pool.parallelFor(n, 0, [&](size_t begin, size_t end, size_t worker) {
+        std::array<double, 6>& box = boxes[worker];
+        for (size_t i = begin; i < end; ++i) {
+            box[0] = std::min(box[0], particles.x[i]);
+            box[1] = std::min(box[1], particles.y[i]);
+            box[2] = std::min(box[2], particles.z[i]);
+            box[3] = std::max(box[3], particles.x[i]);
+            box[4] = std::max(box[4], particles.y[i]);
+            box[5] = std::max(box[5], particles.z[i]);
+        }
+    });
+    std::array<double, 6> bounds = boxes[0];
+    for (const std::array<double, 6>& box : boxes) {
+        for (int d = 0; d < 3; ++d) {
+            bounds[d] = std::min(bounds[d], box[d]);
+            bounds[d + 3] = std::max(bounds[d + 3], box[d + 3]);
+        }
+    }
+    rootSize = std::max({bounds[3] - bounds[0], bounds[4] - bounds[1], bounds[5] - bounds[2]});
+    rootSize = rootSize > 0.0 ? rootSize * (1.0 + 1e-12) : 1.0;
+
+    // Morton keys
+    double scale = static_cast<double>(1u << keyBits) / rootSize;
+    auto quantize = [&](double coordinate, double origin) {
+        const uint64_t maxCell = (1u << keyBits) - 1;
+        return std::min(maxCell, static_cast<uint64_t>((coordinate - origin) * scale));
+    };
+    pool.parallelFor(n, 0, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            keys[i] = spreadBits(quantize(particles.x[i], bounds[0])) << 2 |
+                      spreadBits(quantize(particles.y[i], bounds[1])) << 1 |
+                      spreadBits(quantize(particles.z[i], bounds[2]));
+        }
+    });
+
+    // Sorted copies of the particles
+    sortByKey(pool);
+    pool.parallelFor(n, 0, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t source = sortScratch[i].second;
+            keys[i] = sortScratch[i].first;
+            order[i] = source;
+            x[i] = particles.x[source];
+            y[i] = particles.y[source];
+            z[i] = particles.z[source];
+            mass[i] = particles.mass[source];
+        }
+    });
+
+    if (n <= splitCells * options.leafSize) {
+        buildRange(nodes, 0, static_cast<uint32_t>(n), 0);
+        return;
+    }
+
+    // Subtrees of the 64 cells at the split depth in parallel, then the top levels
+    unsigned prefixShift = digitShift(splitDepth - 1);
+    for (uint32_t cell = 0; cell < splitCells; ++cell) {
+        uint64_t first = static_cast<uint64_t>(cell) << prefixShift;
+        cellStart[cell] = static_cast<uint32_t>(
+            std::lower_bound(keys.begin(), keys.end(), first) - keys.begin());
+    }
+    cellStart[splitCells] = static_cast<uint32_t>(n);
+    pool.parallelFor(splitCells, 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t cell = begin; cell < end; ++cell) {
+            subtrees[cell].clear();
+            if (cellStart[cell] < cellStart[cell + 1]) {
+                buildRange(subtrees[cell], cellStart[cell], cellStart[cell + 1], splitDepth);
+            }
+        }
+    });
+    splice(0, 0);
+}
+
+void BarnesHutTree::buildRange(std::vector<Node>& out, uint32_t begin, uint32_t end,
+                               unsigned depth) const {
+    size_t index = out.size();
+    Node node{};
+    node.size = std::ldexp(rootSize, -static_cast<int>(depth));
+    node.begin = begin;
+    node.end = end;
+    out.push_back(node);
+
+    if (end - begin <= options.leafSize || depth == maxDepth) {
+        Node& leaf = out[index];
+        leaf.leaf = 1;
+        for (uint32_t i = begin; i < end; ++i) {
+            leaf.mass += mass[i];
+            leaf.x += mass[i] * x[i];
+            leaf.y += mass[i] * y[i];
+            leaf.z += mass[i] * z[i];
+        }
+        if (leaf.mass > 0.0) {
+            leaf.x /= leaf.mass;
+            leaf.y /= leaf.mass;
+            leaf.z /= leaf.mass;
+        } else {
+            leaf.x = x[begin];
+            leaf.y = y[begin];
+            leaf.z = z[begin];
+        }
+        leaf.next = static_cast<uint32_t>(out.size());
+        return;
+    }
+
+    // Children: runs of equal octant digit (keys in the range share every higher digit)
+    unsigned shift = digitShift(depth);
+    uint64_t below = (uint64_t(1) << shift) - 1;
+    uint32_t start = begin;
+    while (start < end) {
+        uint64_t last = keys[start] | below;
+        uint32_t stop = static_cast<uint32_t>(
+            std::upper_bound(keys.begin() + start, keys.begin() + end, last) - keys.begin());
+        buildRange(out, start, stop, depth + 1);
+        start = stop;
+    }
+    finish(out, index);
+}
+
+void BarnesHutTree::splice(unsigned depth, uint32_t prefix) {
+    // Particles of this cell: split cells prefix * 8^(splitDepth - depth) onwards
+    uint32_t cellsPerNode = 1u << (3 * (splitDepth - depth));
+    uint32_t begin = cellStart[prefix * cellsPerNode];
+    uint32_t end = cellStart[(prefix + 1) * cellsPerNode];
+    if (begin == end) {
+        return;
+    }
+
+    if (depth == splitDepth) {
+        const std::vector<Node>& part = subtrees[prefix];
+        uint32_t offset = static_cast<uint32_t>(nodes.size());
+        for (Node node : part) {
+            node.next += offset;
+            nodes.push_back(node);
+        }
+        return;
+    }
+
+    size_t index = nodes.size();
+    Node node{};
+    node.size = std::ldexp(rootSize, -static_cast<int>(depth));
+    node.begin = begin;
+    node.end = end;
+    nodes.push_back(node);
+    for (uint32_t digit = 0; digit < 8; ++digit) {
+        splice(depth + 1, prefix * 8 + digit);
+    }
+    finish(nodes, index);
+}
+
+void BarnesHutTree::finish(std::vector<Node>& out, size_t index) const {
+    double total = 0.0, sx = 0.0, sy = 0.0, sz = 0.0;
+    for (size_t child = index + 1; child < out.size(); child = out[child].next) {
+        const Node& c = out[child];
+        total += c.mass;
+        sx += c.mass * c.x;
+        sy += c.mass * c.y;
+        sz += c.mass * c.z;
+    }
+    Node& node = out[index];
+    node.mass = total;
+    if (total > 0.0) {
+        node.x = sx / total;
+        node.y = sy / total;
+        node.z = sz / total;
+    } else {
+        node.x = x[node.begin];
+        node.y = y[node.begin];
+        node.z = z[node.begin];
+    }
+    node.next = static_cast<uint32_t>(out.size());
+}
+
+void BarnesHutTree::computeForces(ParticleSystem& particles, const GravitySettings& gravity,
+                                  ThreadPool& pool) const {
+    size_t n = x.size();
+    double eps2 = gravity.softening * gravity.softening;
+    double theta2 = options.theta * options.theta;
+    const Node* tree = nodes.data();
+    uint32_t count = static_cast<uint32_t>(nodes.size());
+
+    // Consecutive targets are close in space, so they walk nearly the same nodes
+    pool.parallelFor(n, 256, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            double xi = x[i], yi = y[i], zi = z[i];
+            double sx = 0.0, sy = 0.0, sz = 0.0;
+            uint32_t current = 0;
+            while (current < count) {
+                const Node& node = tree[current];
+                double dx = node.x - xi;
+                double dy = node.y - yi;
+                double dz = node.z - zi;
+                double d2 = dx * dx + dy * dy + dz * dz;
+                if (node.size * node.size < theta2 * d2) {
+                    // Far enough: the whole cell acts as a point mass
+                    double r2 = d2 + eps2;
+                    double inv = 1.0 / std::sqrt(r2);
+                    double scale = node.mass * inv * inv * inv;
+                    sx += dx * scale;
+                    sy += dy * scale;
+                    sz += dz * scale;
+                    current = node.next;
+                } else if (node.leaf) {
+                    for (uint32_t j = node.begin; j < node.end; ++j) {
+                        double px = x[j] - xi;
+                        double py = y[j] - yi;
+                        double pz = z[j] - zi;
+                        double r2 = px * px + py * py + pz * pz + eps2;
+                        double inv = 1.0 / std::sqrt(r2);
+                        double scale = mass[j] * inv * inv * inv;
+                        sx += px * scale;
+                        sy += py * scale;
+                        sz += pz * scale;
+                    }
+                    current = node.next;
+                } else {
+                    current++;  // Open the cell: its first child follows it
+                }
+            }
+            uint32_t target = order[i];
+            particles.ax[target] = gravity.G * sx;
+            particles.ay[target] = gravity.G * sy;
+            particles.az[target] = gravity.G * sz;
+        }
+    });
+}
+
+void BarnesHutTree::computeGravity(ParticleSystem& particles, const GravitySettings& gravity,
+                                   ThreadPool& pool) {
+    build(particles, pool);
+    computeForces(particles, gravity, pool);
+}
@@ -0,0 +1,475 @@
+/**
+ * @file bulk_file_writer.cpp
+ * @brief Implementation of BulkFileWriter
+ */
+
+#include "../include/bulk_file_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/alloc_tracker.h"
+#include "../include/trace.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define BULK_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+// ==================== io_uring ring ====================
+
+#ifdef BULK_HAVE_IO_URING
+
+// Minimal raw-syscall io_uring (no liburing dependency): one submission queue,
+// one completion queue, synchronous submit-and-wait of whole phases
+class BulkFileWriter::Ring {
+   public:
+    static std::unique_ptr<Ring> create(unsigned entries) {
+        std::unique_ptr<Ring> ring(new Ring);
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring->fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring->fd < 0) {
+            return nullptr;
+        }
+        ring->entries = params.sq_entries;
+
+        ring->sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        ring->cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            ring->sqSize = ring->cqSize = std::max(ring->sqSize, ring->cqSize);
+        }
+
+        ring->sqMap = mmap(nullptr, ring->sqSize, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+        if (ring->sqMap == MAP_FAILED) {
+            ring->sqMap = nullptr;
+            return nullptr;
+        }
+        if (single) {
+            ring->cqMap = ring->sqMap;
+        } else {
+            ring->cqMap = mmap(nullptr, ring->cqSize, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+            if (ring->cqMap == MAP_FAILED) {
+                ring->cqMap = nullptr;
+                return nullptr;
+            }
+        }
+        ring->sqeSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, ring->sqeSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return nullptr;
+        }
+        ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(ring->sqMap);
+        char* cq = static_cast<char*>(ring->cqMap);
+        ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        ring->sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        ring->cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return ring;
+    }
+
+    ~Ring() {
+        if (sqes != nullptr) {
+            munmap(sqes, sqeSize);
+        }
+        if (cqMap != nullptr && cqMap != sqMap) {
+            munmap(cqMap, cqSize);
+        }
+        if (sqMap != nullptr) {
+            munmap(sqMap, sqSize);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    unsigned capacity() const { return entries; }
+
+    // Next submission entry, zeroed; at most capacity() per submitAndWait
+    io_uring_sqe* next(uint64_t userData) {
+        unsigned tail = *sqTail + queued;
+        unsigned index = tail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->user_data = userData;
+        sqArray[index] = index;
+        queued++;
+        return sqe;
+    }
+
+    // Submits the queued entries and calls done(userData, result) for each completion.
+    // If io_uring_enter fails, the requests already submitted are waited for (still
+    // reported to done) before returning false; busy() tells whether that failed too.
+    bool submitAndWait(const std::function<void(uint64_t, int)>& done) {
+        unsigned count = queued;
+        __atomic_store_n(sqTail, *sqTail + count, __ATOMIC_RELEASE);
+        queued = 0;
+
+        unsigned submitted = 0;
+        unsigned completed = 0;
+        while (completed < count) {
+            int ret = static_cast<int>(syscall(__NR_io_uring_enter, fd, count - submitted, 1,
+                                               IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                inFlight = submitted - completed;
+                drain(done);
+                return false;
+            }
+            submitted += static_cast<unsigned>(ret);
+            completed += reap(done);
+        }
+        return true;
+    }
+
+    // Requests of a failed submitAndWait that never completed: the kernel may still read
+    // their buffers, so the ring must outlive them
+    bool busy() const { return inFlight > 0; }
+
+    // Keeps a batch whose requests may still be in flight for as long as the ring
+    void keep(std::vector<File> batch) { kept.push_back(std::move(batch)); }
+
+   private:
+    Ring() = default;
+
+    // Calls done for every completion posted so far and returns how many there were
+    unsigned reap(const std::function<void(uint64_t, int)>& done) {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        unsigned reaped = 0;
+        for (; head != tail; ++head, ++reaped) {
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            done(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        return reaped;
+    }
+
+    // Waits for the inFlight requests without submitting anything more (entries never
+    // submitted stay in the abandoned submission queue). Gives up after repeated errors.
+    void drain(const std::function<void(uint64_t, int)>& done) {
+        int failures = 0;
+        while (inFlight > 0 && failures < 100) {
+            int ret = static_cast<int>(
+                syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (ret < 0 && errno != EINTR) {
+                failures++;
+                usleep(1000);
+            }
+            inFlight -= std::min(inFlight, reap(done));
+        }
+    }
+
+    int fd = -1;
+    unsigned entries = 0;
+    unsigned queued = 0;
+    size_t sqSize = 0, cqSize = 0, sqeSize = 0;
+    void* sqMap = nullptr;
+    void* cqMap = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned inFlight = 0;
+    std::vector<std::vector<File>> kept;
+};
+
+#else
+
+class BulkFileWriter::Ring {};
+
+#endif  // BULK_HAVE_IO_URING
+
+// ==================== BulkFileWriter ====================
+
+BulkFileWriter::BulkFileWriter(Backend backend, size_t batchFiles)
+    : active(Backend::Posix), batchSize(batchFiles > 0 ? batchFiles : 1) {
+#ifdef BULK_HAVE_IO_URING
+    if (backend != Backend::Posix) {
+        ring = Ring::create(static_cast<unsigned>(std::min<size_t>(batchSize, 4096)));
+        if (ring) {
+            active = Backend::IoUring;
+            batchSize = ring->capacity();
+        }
+    }
+#else
+    (void)backend;
+#endif
+    filling.reserve(batchSize);
+    thread = std::thread(&BulkFileWriter::writerLoop, this);
+}
+
+BulkFileWriter::~BulkFileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+#ifdef BULK_HAVE_IO_URING
+    if (ring && ring->busy()) {
+        // The kernel may still read the buffers the ring keeps (and tears a closed ring
+        // down asynchronously): leave both to the process rather than free them
+        ring.release();
+    }
+#endif
+}
+
+const char* BulkFileWriter::backendName(Backend backend) {
+    switch (backend) {
+        case Backend::Auto:
+            return "auto";
+        case Backend::IoUring:
+            return "io_uring";
+        case Backend::Posix:
+            return "posix";
+    }
+    return "unknown";
+}
+
+void BulkFileWriter::add(std::string filename, std::string contents) {
+    std::unique_lock<std::mutex> lock(mutex);
+    // A batch never grows past batchSize (it must fit the submission queue).
+    // Double buffering: wait only if the previous full batch is still queued.
+    while (filling.size() >= batchSize) {
+        changed.wait(lock, [this] { return ready.empty() || filling.size() < batchSize; });
+        if (filling.size() >= batchSize) {
+            ready.swap(filling);
+            filling.reserve(batchSize);
+            changed.notify_all();
+        }
+    }
+    filling.push_back(File{std::move(filename), std::move(contents)});
+    if (filling.size() >= batchSize && ready.empty()) {
+        ready.swap(filling);
+        filling.reserve(batchSize);
+        changed.notify_all();
+    }
+}
+
+size_t BulkFileWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    flushRequested = true;
+    changed.notify_all();
+    changed.wait(lock, [this] { return filling.empty() && ready.empty() && !writing; });
+    flushRequested = false;
+    return failed.load();
+}
+
+void BulkFileWriter::writerLoop() {
+    Trace::nameThread("bulk file writer");
+    AllocScope memory("bulk file writer");
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        changed.wait(lock, [this] {
+            return stopping || !ready.empty() || (flushRequested && !filling.empty());
+        });
+        if (ready.empty() && !filling.empty()) {
+            ready.swap(filling);  // flush or shutdown: take the partial batch
+        }
+        if (ready.empty()) {
+            if (stopping) {
+                return;
+            }
+            continue;
+        }
+
+        std::vector<File> batch;
+        batch.swap(ready);
+        writing = true;
+        changed.notify_all();  // producers may hand over the next batch now
+        lock.unlock();
+
+        {
+            TraceSpan span("write batch", "io", static_cast<int64_t>(batch.size()));
+            writeBatch(batch);
+        }
+
+        lock.lock();
+        writing = false;
+        changed.notify_all();
+    }
+}
+
+void BulkFileWriter::writeBatchPosix(std::vector<File>& batch) {
+    for (File& file : batch) {
+        int fd = ::open(file.name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        bool ok = fd >= 0;
+        size_t offset = 0;
+        while (ok && offset < file.contents.size()) {
+            ssize_t n = ::write(fd, file.contents.data() + offset, file.contents.size() - offset);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            ok = n > 0;
+            offset += ok ? static_cast<size_t>(n) : 0;
+        }
+        if (fd >= 0 && ::close(fd) != 0) {
+            ok = false;
+        }
+        if (ok) {
+            written++;
+        } else {
+            failed++;
+            std::cerr << "Error: Could not write file " << file.name << std::endl;
+        }
+    }
+}
+
+void BulkFileWriter::writeBatch(std::vector<File>& batch) {
+#ifdef BULK_HAVE_IO_URING
+    if (active.load() == Backend::IoUring) {
+        size_t n = batch.size();
+        std::vector<int> fds(n, -1);
+        std::vector<int> errors(n, 0);
+        std::vector<size_t> offsets(n, 0);
+        bool ringOk = true;
+
+        // Phase 1: open every file
+        for (size_t i = 0; i < n; ++i) {
+            io_uring_sqe* sqe = ring->next(i);
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = reinterpret_cast<uint64_t>(batch[i].name.c_str());
+            sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+            sqe->len = 0644;
+        }
+        ringOk = ring->submitAndWait([&](uint64_t i, int res) {
+            if (res >= 0) {
+                fds[i] = res;
+            } else {
+                errors[i] = -res;
+            }
+        });
+
+        // Kernels without IORING_OP_OPENAT reject every entry: switch for good
+        bool unsupported = ringOk && n > 0 &&
+                           std::all_of(errors.begin(), errors.end(),
+                                       [](int e) { return e == EINVAL || e == EOPNOTSUPP; });
+        if (!ringOk || unsupported) {
+            for (int fd : fds) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+            active = Backend::Posix;
+            writeBatchPosix(batch);
+            if (ring->busy()) {
+                ring->keep(std::move(batch));  // Opens may still read the names
+            }
+            return;
+        }
+
+        // Phase 2: write, resubmitting the remainder of any short write
+        while (ringOk) {
+            size_t queued = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (fds[i] >= 0 && errors[i] == 0 && offsets[i] < batch[i].contents.size()) {
+                    size_t remaining = batch[i].contents.size() - offsets[i];
+                    io_uring_sqe* sqe = ring->next(i);
+                    sqe->opcode = IORING_OP_WRITE;
+                    sqe->fd = fds[i];
+                    sqe->addr = reinterpret_cast<uint64_t>(batch[i].contents.data() + offsets[i]);
+                    sqe->len = static_cast<unsigned>(std::min<size_t>(remaining, 1u << 30));
+                    sqe->off = offsets[i];
+                    queued++;
+                }
+            }
+            if (queued == 0) {
+                break;
+            }
+            ringOk = ring->submitAndWait([&](uint64_t i, int res) {
+                if (res > 0) {
+                    offsets[i] += static_cast<size_t>(res);
+                } else {
+                    errors[i] = res < 0 ? -res : EIO;
+                }
+            });
+        }
+
+        // Phase 3: close
+        std::vector<char> closed(n, 0);
+        if (ringOk) {
+            for (size_t i = 0; i < n; ++i) {
+                if (fds[i] >= 0) {
+                    io_uring_sqe* sqe = ring->next(i);
+                    sqe->opcode = IORING_OP_CLOSE;
+                    sqe->fd = fds[i];
+                }
+            }
+            ringOk = ring->submitAndWait([&](uint64_t i, int res) {
+                closed[i] = 1;
+                if (res < 0 && errors[i] == 0) {
+                    errors[i] = -res;
+                }
+            });
+        }
+
+        // io_uring_enter failed mid-batch: the ring is abandoned for good. submitAndWait
+        // has waited for the requests already submitted, so fds, offsets and errors are
+        // final unless the ring is still busy. Close what is still open (EBADF: the ring
+        // closed it after all) and rewrite with POSIX calls the files not completely
+        // written. Writes still in flight carry the same bytes at the same offsets, so they
+        // cannot corrupt the rewrite.
+        std::vector<File> unfinished;
+        std::vector<char> rewritten(n, 0);  // Counted by writeBatchPosix instead
+        if (!ringOk) {
+            active = Backend::Posix;
+            for (size_t i = 0; i < n; ++i) {
+                if (fds[i] >= 0 && !closed[i] && ::close(fds[i]) != 0 && errno != EBADF &&
+                    errors[i] == 0) {
+                    errors[i] = errno;
+                }
+                if (errors[i] == 0 && offsets[i] < batch[i].contents.size()) {
+                    unfinished.push_back(batch[i]);  // A copy: batch[i] may still be read
+                    rewritten[i] = 1;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            if (rewritten[i]) {
+                continue;
+            }
+            if (errors[i] == 0) {
+                written++;
+            } else {
+                failed++;
+                std::cerr << "Error: Could not write file " << batch[i].name << " ("
+                          << std::strerror(errors[i]) << ")" << std::endl;
+            }
+        }
+        writeBatchPosix(unfinished);
+        if (ring->busy()) {
+            ring->keep(std::move(batch));  // Moving the vector keeps every buffer in place
+        }
+        return;
+    }
+#endif
+    writeBatchPosix(batch);
+}
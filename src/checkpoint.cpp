@@ -0,0 +1,163 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Implementation of sweep and ensemble checkpoints
+ */
+
+#include "../include/checkpoint.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "../include/run_state.h"
+
+namespace {
+
+const char magic[8] = {'N', 'M', 'C', 'K', 'P', 'T', '0', '1'};
+
+// File layout (native byte order): magic, fingerprint, item count, values per item,
+// extra count, label length, label, one done flag byte per item,
+// results (item count x values per item doubles), extra doubles
+void put(std::string& out, const void* data, size_t bytes) {
+    out.append(static_cast<const char*>(data), bytes);
+}
+
+void put64(std::string& out, uint64_t value) {
+    put(out, &value, sizeof(value));
+}
+
+}  // namespace
+
+uint64_t checkpointHash(const void* data, size_t bytes, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+Checkpoint::Checkpoint(std::string path, uint64_t inputs, size_t items, size_t valuesPerItem,
+                       double intervalSeconds)
+    : file(std::move(path)),
+      fingerprint(inputs),
+      perItem(valuesPerItem),
+      done(items, 0),
+      results(items * valuesPerItem, 0.0),
+      interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(intervalSeconds))),
+      lastWrite(std::chrono::steady_clock::now()) {}
+
+bool Checkpoint::resume() {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t position = 0;
+    // Checks that count elements of size bytes are left, before anything is allocated
+    auto expect = [&](uint64_t count, size_t size) {
+        if (count > (data.size() - position) / size) {
+            throw std::runtime_error("checkpoint " + file + " is truncated");
+        }
+    };
+    auto take = [&](void* target, size_t bytes) {
+        expect(bytes, 1);
+        std::memcpy(target, data.data() + position, bytes);
+        position += bytes;
+    };
+
+    char header[8];
+    uint64_t hash, items, values, extraCount, labelLength;
+    take(header, sizeof(header));
+    if (std::memcmp(header, magic, sizeof(magic)) != 0) {
+        throw std::runtime_error(file + " is not a checkpoint");
+    }
+    take(&hash, 8);
+    take(&items, 8);
+    take(&values, 8);
+    take(&extraCount, 8);
+    take(&labelLength, 8);
+    if (hash != fingerprint || items != done.size() || values != perItem) {
+        throw std::runtime_error("checkpoint " + file +
+                                 " was written by a run with different inputs");
+    }
+    expect(labelLength, 1);
+    std::string text(labelLength, '\0');
+    take(&text[0], labelLength);
+    std::vector<char> flags(items);
+    take(flags.data(), items);
+    expect(extraCount, sizeof(double));
+    std::vector<double> stored(items * values), state(extraCount);
+    take(stored.data(), stored.size() * sizeof(double));
+    take(state.data(), state.size() * sizeof(double));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    done = std::move(flags);
+    results = std::move(stored);
+    extra = std::move(state);
+    tag = std::move(text);
+    return true;
+}
+
+size_t Checkpoint::doneCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<size_t>(std::count(done.begin(), done.end(), 1));
+}
+
+void Checkpoint::complete(size_t item, const double* values) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::copy(values, values + perItem, results.begin() + item * perItem);
+    done[item] = 1;
+    if (std::chrono::steady_clock::now() - lastWrite < interval) {
+        return;
+    }
+    // Writing under the lock keeps the snapshot consistent; at one write per
+    // interval the other workers rarely notice
+    try {
+        writeFileAtomically(file, serialize());
+    } catch (const std::exception& error) {
+        if (!reportedError) {
+            std::cerr << "Warning: " << error.what() << " (checkpointing continues)" << std::endl;
+            reportedError = true;
+        }
+    }
+    lastWrite = std::chrono::steady_clock::now();
+}
+
+bool Checkpoint::due() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::chrono::steady_clock::now() - lastWrite >= interval;
+}
+
+void Checkpoint::save() {
+    std::lock_guard<std::mutex> lock(mutex);
+    writeFileAtomically(file, serialize());
+    lastWrite = std::chrono::steady_clock::now();
+}
+
+void Checkpoint::discard() {
+    std::remove(file.c_str());
+}
+
+std::string Checkpoint::serialize() const {
+    std::string out;
+    out.reserve(64 + tag.size() + done.size() + 8 * (results.size() + extra.size()));
+    put(out, magic, sizeof(magic));
+    put64(out, fingerprint);
+    put64(out, done.size());
+    put64(out, perItem);
+    put64(out, extra.size());
+    put64(out, tag.size());
+    put(out, tag.data(), tag.size());
+    put(out, done.data(), done.size());
+    put(out, results.data(), results.size() * sizeof(double));
+    put(out, extra.data(), extra.size() * sizeof(double));
+    return out;
+}
@@ -0,0 +1,253 @@
+/**
+ * @file csv_loader.cpp
+ * @brief Implementation of the parallel CSV loader
+ */
+
+#include "../include/csv_loader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/alloc_tracker.h"
+
+namespace {
+
+// Below this many bytes per chunk a task costs more than the parsing it saves
+const size_t minChunkBytes = 64 * 1024;
+
+const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+const char* lineEnd(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+const char* nextLine(const char* p, const char* end) {
+    const char* eol = lineEnd(p, end);
+    return eol == end ? end : eol + 1;
+}
+
+// Blank and comment lines carry no row
+bool isRow(const char* line, const char* end) {
+    line = skipSpaces(line, end);
+    return line < end && *line != '\n' && *line != '#';
+}
+
+// Byte range of the body holding the rows that start inside it
+struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t rows = 0;       ///< Data rows starting in the chunk
+    size_t lines = 0;      ///< All lines starting in the chunk
+    size_t firstRow = 0;   ///< Index of the chunk's first row in the table
+    size_t firstLine = 0;  ///< File line number of the chunk's first line
+    std::string error;     ///< First problem found, empty if none
+};
+
+// Parses one row into columns[c][row]; returns the problem, or an empty string
+std::string parseRow(const char* p, const char* end, std::vector<std::vector<double>>& columns,
+                     const std::vector<std::string>& names, size_t row) {
+    for (size_t c = 0; c < columns.size(); ++c) {
+        p = skipSpaces(p, end);
+        if (p < end && *p == '+') {
+            ++p;  // from_chars does not accept an explicit plus sign
+        }
+        double value;
+        std::from_chars_result parsed = std::from_chars(p, end, value);
+        if (parsed.ec != std::errc()) {
+            return p == end || *p == ','
+                       ? "missing value for column '" + names[c] + "'"
+                       : "bad number '" + std::string(p, std::find(p, end, ',')) +
+                             "' in column '" + names[c] + "'";
+        }
+        columns[c][row] = value;
+        p = skipSpaces(parsed.ptr, end);
+        if (c + 1 < columns.size()) {
+            if (p == end || *p != ',') {
+                return "expected " + std::to_string(columns.size()) + " fields";
+            }
+            ++p;
+        }
+    }
+    if (p != end) {
+        return "more than " + std::to_string(columns.size()) + " fields";
+    }
+    return std::string();
+}
+
+}  // namespace
+
+CsvTable CsvTable::load(const std::string& path, ThreadPool* pool) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not read " + path);
+    }
+    size_t length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return parse("", 0, pool, path);  // Reports the missing header
+    }
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map " + path);
+    }
+    madvise(mapping, length, MADV_SEQUENTIAL);  // Read ahead aggressively
+
+    try {
+        CsvTable table = parse(static_cast<const char*>(mapping), length, pool, path);
+        munmap(mapping, length);
+        return table;
+    } catch (...) {
+        munmap(mapping, length);
+        throw;
+    }
+}
+
+CsvTable CsvTable::parse(const char* text, size_t length, ThreadPool* pool,
+                         const std::string& source) {
+    AllocScope memory("csv loader");
+    const char* end = text + length;
+    const char* p = text;
+    size_t line = 1;
+    while (p < end && !isRow(p, end)) {
+        p = nextLine(p, end);
+        line++;
+    }
+    if (p == end) {
+        throw std::runtime_error(source + ": no header line");
+    }
+
+    CsvTable table;
+    const char* headerEnd = lineEnd(p, end);
+    while (p <= headerEnd) {
+        const char* comma = std::find(p, headerEnd, ',');
+        const char* first = skipSpaces(p, comma);
+        const char* last = comma;
+        while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) {
+            --last;
+        }
+        std::string name(first, last);
+        if (name.empty()) {
+            throw std::runtime_error(source + ":" + std::to_string(line) +
+                                     ": empty column name");
+        }
+        if (table.has(name)) {
+            throw std::runtime_error(source + ":" + std::to_string(line) +
+                                     ": duplicate column '" + name + "'");
+        }
+        table.columnNames.push_back(name);
+        p = comma + 1;
+    }
+    const char* body = nextLine(headerEnd, end);
+
+    // Equal byte ranges, each moved forward to the start of its next line
+    size_t bytes = static_cast<size_t>(end - body);
+    size_t chunkCount = 1;
+    if (pool != nullptr) {
+        chunkCount = std::max<size_t>(1, std::min(4 * pool->size(), bytes / minChunkBytes));
+    }
+    std::vector<Chunk> chunks(chunkCount);
+    const char* start = body;
+    for (size_t k = 0; k < chunkCount; ++k) {
+        chunks[k].begin = start;
+        const char* split = k + 1 == chunkCount ? end : body + bytes * (k + 1) / chunkCount;
+        if (split < end && split > body && split[-1] != '\n') {
+            split = nextLine(split, end);
+        }
+        start = std::max(split, start);
+        chunks[k].end = start;
+    }
+
+    auto forEachChunk = [&](const std::function<void(Chunk&)>& work) {
+        if (pool == nullptr || chunkCount == 1) {
+            for (Chunk& chunk : chunks) {
+                work(chunk);
+            }
+            return;
+        }
+        pool->parallelFor(chunkCount, 1, [&](size_t first, size_t last, size_t) {
+            for (size_t k = first; k < last; ++k) {
+                work(chunks[k]);
+            }
+        });
+    };
+
+    // Pass 1: count, so every chunk knows where its rows go
+    forEachChunk([](Chunk& chunk) {
+        for (const char* q = chunk.begin; q < chunk.end; q = nextLine(q, chunk.end)) {
+            chunk.lines++;
+            if (isRow(q, chunk.end)) {
+                chunk.rows++;
+            }
+        }
+    });
+    size_t rows = 0;
+    line++;  // First body line
+    for (Chunk& chunk : chunks) {
+        chunk.firstRow = rows;
+        chunk.firstLine = line;
+        rows += chunk.rows;
+        line += chunk.lines;
+    }
+    table.rowCount = rows;
+    table.columns.assign(table.columnNames.size(), std::vector<double>(rows));
+
+    // Pass 2: parse straight into the columns (disjoint rows per chunk)
+    forEachChunk([&table](Chunk& chunk) {
+        size_t row = chunk.firstRow;
+        size_t number = chunk.firstLine;
+        for (const char* q = chunk.begin; q < chunk.end; q = nextLine(q, chunk.end), ++number) {
+            if (!isRow(q, chunk.end)) {
+                continue;
+            }
+            std::string problem =
+                parseRow(q, lineEnd(q, chunk.end), table.columns, table.columnNames, row++);
+            if (!problem.empty()) {
+                chunk.error = std::to_string(number) + ": " + problem;
+                return;
+            }
+        }
+    });
+    for (const Chunk& chunk : chunks) {
+        if (!chunk.error.empty()) {
+            throw std::runtime_error(source + ":" + chunk.error);
+        }
+    }
+    return table;
+}
+
+bool CsvTable::has(const std::string& name) const {
+    return std::find(columnNames.begin(), columnNames.end(), name) != columnNames.end();
+}
+
+const std::vector<double>& CsvTable::column(const std::string& name) const {
+    auto found = std::find(columnNames.begin(), columnNames.end(), name);
+    if (found == columnNames.end()) {
+        throw std::invalid_argument("CSV has no column '" + name + "'");
+    }
+    return columns[static_cast<size_t>(found - columnNames.begin())];
+}
+
+std::vector<double> CsvTable::column(const std::string& name, double fallback) const {
+    return has(name) ? column(name) : std::vector<double>(rowCount, fallback);
+}
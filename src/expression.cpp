@@ -0,0 +1,636 @@
+/**
+ * @file expression.cpp
+ * @brief Implementation of the expression compiler, bytecode interpreter and OdeModel
+ */
+
+#include "../include/expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+// Compile-time register ids; finish() relocates them to [inputs | constants | temporaries]
+const uint32_t constantTag = 1u << 30;
+const uint32_t temporaryTag = 1u << 31;
+const uint32_t tagMask = constantTag | temporaryTag;
+
+// Lanes per block in evaluateBatch: registers * lanes doubles stay in L1/L2
+const size_t batchLanes = 64;
+
+struct Function {
+    const char* name;
+    OpCode op;
+    size_t arity;
+};
+
+const Function functions[] = {
+    {"sin", OpCode::Sin, 1},     {"cos", OpCode::Cos, 1},     {"tan", OpCode::Tan, 1},
+    {"asin", OpCode::Asin, 1},   {"acos", OpCode::Acos, 1},   {"atan", OpCode::Atan, 1},
+    {"sinh", OpCode::Sinh, 1},   {"cosh", OpCode::Cosh, 1},   {"tanh", OpCode::Tanh, 1},
+    {"exp", OpCode::Exp, 1},     {"log", OpCode::Log, 1},     {"sqrt", OpCode::Sqrt, 1},
+    {"abs", OpCode::Abs, 1},     {"floor", OpCode::Floor, 1}, {"pow", OpCode::Pow, 2},
+    {"atan2", OpCode::Atan2, 2}, {"min", OpCode::Min, 2},     {"max", OpCode::Max, 2},
+};
+
+const char* opName(OpCode op) {
+    static const char* const opNames[] = {
+        "move", "add", "sub",  "mul",  "div",  "neg",  "pow", "atan2", "min", "max",  "sin",  "cos",
+        "tan",  "asin", "acos", "atan", "sinh", "cosh", "tanh", "exp", "log", "sqrt", "abs", "floor"};
+    return opNames[static_cast<size_t>(op)];
+}
+
+bool isUnary(OpCode op) {
+    return op == OpCode::Move || op == OpCode::Neg || op >= OpCode::Sin;
+}
+
+// The one definition of every operation, used for constant folding and evaluation
+inline double apply(OpCode op, double a, double b) {
+    switch (op) {
+        case OpCode::Move: return a;
+        case OpCode::Add: return a + b;
+        case OpCode::Sub: return a - b;
+        case OpCode::Mul: return a * b;
+        case OpCode::Div: return a / b;
+        case OpCode::Neg: return -a;
+        case OpCode::Pow: return std::pow(a, b);
+        case OpCode::Atan2: return std::atan2(a, b);
+        case OpCode::Min: return std::min(a, b);
+        case OpCode::Max: return std::max(a, b);
+        case OpCode::Sin: return std::sin(a);
+        case OpCode::Cos: return std::cos(a);
+        case OpCode::Tan: return std::tan(a);
+        case OpCode::Asin: return std::asin(a);
+        case OpCode::Acos: return std::acos(a);
+        case OpCode::Atan: return std::atan(a);
+        case OpCode::Sinh: return std::sinh(a);
+        case OpCode::Cosh: return std::cosh(a);
+        case OpCode::Tanh: return std::tanh(a);
+        case OpCode::Exp: return std::exp(a);
+        case OpCode::Log: return std::log(a);
+        case OpCode::Sqrt: return std::sqrt(a);
+        case OpCode::Abs: return std::fabs(a);
+        case OpCode::Floor: return std::floor(a);
+    }
+    return 0.0;
+}
+
+// out[l] = f(x[l], y[l]) over one block; a separate loop per opcode so each vectorizes
+template <typename F>
+inline void lanes(size_t count, double* out, const double* x, const double* y, F f) {
+    for (size_t l = 0; l < count; ++l) {
+        out[l] = f(x[l], y[l]);
+    }
+}
+
+void runBlock(OpCode op, size_t n, double* d, const double* x, const double* y) {
+    switch (op) {
+        case OpCode::Add: lanes(n, d, x, y, [](double a, double b) { return a + b; }); break;
+        case OpCode::Sub: lanes(n, d, x, y, [](double a, double b) { return a - b; }); break;
+        case OpCode::Mul: lanes(n, d, x, y, [](double a, double b) { return a * b; }); break;
+        case OpCode::Div: lanes(n, d, x, y, [](double a, double b) { return a / b; }); break;
+        case OpCode::Neg: lanes(n, d, x, y, [](double a, double) { return -a; }); break;
+        case OpCode::Move: lanes(n, d, x, y, [](double a, double) { return a; }); break;
+        case OpCode::Min:
+            lanes(n, d, x, y, [](double a, double b) { return b < a ? b : a; });
+            break;
+        case OpCode::Max:
+            lanes(n, d, x, y, [](double a, double b) { return a < b ? b : a; });
+            break;
+        case OpCode::Sqrt: lanes(n, d, x, y, [](double a, double) { return std::sqrt(a); }); break;
+        case OpCode::Abs: lanes(n, d, x, y, [](double a, double) { return std::fabs(a); }); break;
+        default:  // Library calls: one at a time
+            for (size_t l = 0; l < n; ++l) {
+                d[l] = apply(op, x[l], y[l]);
+            }
+    }
+}
+
+bool isNameStart(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isNameChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isName(const std::string& name) {
+    return !name.empty() && isNameStart(name[0]) &&
+           std::all_of(name.begin(), name.end(), isNameChar);
+}
+
+std::string trim(const std::string& s) {
+    size_t first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+}
+
+}  // namespace
+
+// ==================== ExpressionProgram ====================
+
+void ExpressionProgram::evaluate(const double* in, double* out) const {
+    double local[64];
+    std::vector<double> heap;
+    double* reg = local;
+    if (registers > 64) {
+        heap.resize(registers);
+        reg = heap.data();
+    }
+    std::memcpy(reg, in, inputs * sizeof(double));
+    std::memcpy(reg + inputs, constants.data(), constants.size() * sizeof(double));
+    for (const Instruction& ins : instructions) {
+        reg[ins.dst] = apply(ins.op, reg[ins.a], reg[ins.b]);
+    }
+    for (size_t k = 0; k < outputRegisters.size(); ++k) {
+        out[k] = reg[outputRegisters[k]];
+    }
+}
+
+void ExpressionProgram::evaluateBatch(size_t count, const double* const* in,
+                                      double* const* out) const {
+    std::vector<double> block(registers * batchLanes);
+    for (size_t c = 0; c < constants.size(); ++c) {
+        std::fill_n(&block[(inputs + c) * batchLanes], batchLanes, constants[c]);
+    }
+    for (size_t first = 0; first < count; first += batchLanes) {
+        size_t n = std::min(batchLanes, count - first);
+        for (size_t i = 0; i < inputs; ++i) {
+            std::memcpy(&block[i * batchLanes], in[i] + first, n * sizeof(double));
+        }
+        for (const Instruction& ins : instructions) {
+            runBlock(ins.op, n, &block[ins.dst * batchLanes], &block[ins.a * batchLanes],
+                     &block[ins.b * batchLanes]);
+        }
+        for (size_t k = 0; k < outputRegisters.size(); ++k) {
+            std::memcpy(out[k] + first, &block[outputRegisters[k] * batchLanes],
+                        n * sizeof(double));
+        }
+    }
+}
+
+std::string ExpressionProgram::disassemble() const {
+    std::ostringstream text;
+    for (size_t c = 0; c < constants.size(); ++c) {
+        text << "r" << inputs + c << " = " << constants[c] << "\n";
+    }
+    for (const Instruction& ins : instructions) {
+        text << "r" << ins.dst << " = " << opName(ins.op) << " r" << ins.a;
+        if (!isUnary(ins.op)) {
+            text << " r" << ins.b;
+        }
+        text << "\n";
+    }
+    for (size_t k = 0; k < outputRegisters.size(); ++k) {
+        text << "out" << k << " = r" << outputRegisters[k] << "\n";
+    }
+    return text.str();
+}
+
+// ==================== ExpressionCompiler ====================
+
+ExpressionCompiler::ExpressionCompiler(std::vector<std::string> inputNames)
+    : inputCount(inputNames.size()) {
+    for (size_t i = 0; i < inputNames.size(); ++i) {
+        if (!isName(inputNames[i]) || !names.emplace(inputNames[i], Operand{false, 0.0,
+                                                     static_cast<uint32_t>(i)}).second) {
+            throw ExpressionError("invalid or repeated input name '" + inputNames[i] + "'");
+        }
+    }
+    names.emplace("pi", Operand{true, M_PI, 0});
+    names.emplace("e", Operand{true, M_E, 0});
+}
+
+void ExpressionCompiler::defineConstant(const std::string& name, double value) {
+    if (!isName(name) || !names.emplace(name, Operand{true, value, 0}).second) {
+        throw ExpressionError("invalid or repeated name '" + name + "'");
+    }
+}
+
+void ExpressionCompiler::define(const std::string& name, const std::string& expression) {
+    if (!isName(name) || names.count(name) != 0) {
+        throw ExpressionError("invalid or repeated name '" + name + "'");
+    }
+    Operand value = parse(expression);
+    if (!value.constant && (value.reg & temporaryTag)) {
+        pinned[value.reg & ~tagMask] = true;
+    }
+    names.emplace(name, value);
+}
+
+void ExpressionCompiler::addOutput(const std::string& expression) {
+    Operand value = parse(expression);
+    uint32_t reg = registerOf(value);
+    if (reg & temporaryTag) {
+        pinned[reg & ~tagMask] = true;
+    }
+    outputs.push_back(reg);
+}
+
+double ExpressionCompiler::evaluateConstant(const std::string& expression) {
+    Operand value = parse(expression);
+    if (!value.constant) {
+        release(value);
+        throw ExpressionError("\"" + expression + "\" is not a constant expression");
+    }
+    return value.value;
+}
+
+ExpressionProgram ExpressionCompiler::finish() const {
+    ExpressionProgram program;
+    program.inputs = inputCount;
+    program.constants = constants;
+    program.registers = inputCount + constants.size() + temporaries;
+    auto relocate = [&](uint32_t id) -> uint32_t {
+        if (id & temporaryTag) {
+            return static_cast<uint32_t>(inputCount + constants.size() + (id & ~tagMask));
+        }
+        if (id & constantTag) {
+            return static_cast<uint32_t>(inputCount + (id & ~tagMask));
+        }
+        return id;
+    };
+    for (Instruction ins : instructions) {
+        ins.dst = relocate(ins.dst);
+        ins.a = relocate(ins.a);
+        ins.b = relocate(ins.b);
+        program.instructions.push_back(ins);
+    }
+    for (uint32_t reg : outputs) {
+        program.outputRegisters.push_back(relocate(reg));
+    }
+    return program;
+}
+
+ExpressionCompiler::Operand ExpressionCompiler::parse(const std::string& expression) {
+    text = &expression;
+    position = 0;
+    Operand result = parseSum();
+    skipSpace();
+    if (position < expression.size()) {
+        fail(std::string("unexpected '") + expression[position] + "'");
+    }
+    return result;
+}
+
+ExpressionCompiler::Operand ExpressionCompiler::parseSum() {
+    Operand left = parseProduct();
+    for (;;) {
+        skipSpace();
+        if (position >= text->size() || ((*text)[position] != '+' && (*text)[position] != '-')) {
+            return left;
+        }
+        OpCode op = (*text)[position++] == '+' ? OpCode::Add : OpCode::Sub;
+        Operand right = parseProduct();
+        left = emit(op, left, right);
+    }
+}
+
+ExpressionCompiler::Operand ExpressionCompiler::parseProduct() {
+    Operand left = parseUnary();
+    for (;;) {
+        skipSpace();
+        if (position >= text->size() || ((*text)[position] != '*' && (*text)[position] != '/')) {
+            return left;
+        }
+        OpCode op = (*text)[position++] == '*' ? OpCode::Mul : OpCode::Div;
+        Operand right = parseUnary();
+        left = emit(op, left, right);
+    }
+}
+
+ExpressionCompiler::Operand ExpressionCompiler::parseUnary() {
+    skipSpace();
+    if (position < text->size() && (*text)[position] == '-') {
+        position++;
+        Operand operand = parseUnary();
+        return emit(OpCode::Neg, operand, operand);
+    }
+    if (position < text->size() && (*text)[position] == '+') {
+        position++;
+        return parseUnary();
+    }
+    return parsePower();
+}
+
+ExpressionCompiler::Operand ExpressionCompiler::parsePower() {
+    Operand base = parsePrimary();
+    skipSpace();
+    if (position < text->size() && (*text)[position] == '^') {
+        position++;
+        Operand exponent = parseUnary();  // Right associative: a^b^c = a^(b^c)
+        return emit(OpCode::Pow, base, exponent);
+    }
+    return base;
+}
+
+ExpressionCompiler::Operand ExpressionCompiler::parsePrimary() {
+    skipSpace();
+    if (position >= text->size()) {
+        fail("unexpected end of expression");
+    }
+    char c = (*text)[position];
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+        const char* start = text->c_str() + position;
+        char* end = nullptr;
+        double value = std::strtod(start, &end);
+        if (end == start) {
+            fail("invalid number");
+        }
+        position += static_cast<size_t>(end - start);
+        return Operand{true, value, 0};
+    }
+    if (isNameStart(c)) {
+        size_t start = position;
+        while (position < text->size() && isNameChar((*text)[position])) {
+            position++;
+        }
+        std::string name = text->substr(start, position - start);
+        skipSpace();
+        if (position < text->size() && (*text)[position] == '(') {
+            position++;
+            std::vector<Operand> args;
+            skipSpace();
+            if (position < text->size() && (*text)[position] == ')') {
+                position++;
+            } else {
+                for (;;) {
+                    args.push_back(parseSum());
+                    skipSpace();
+                    if (position < text->size() && (*text)[position] == ',') {
+                        position++;
+                        continue;
+                    }
+                    if (position < text->size() && (*text)[position] == ')') {
+                        position++;
+                        break;
+                    }
+                    fail("expected ',' or ')'");
+                }
+            }
+            return call(name, args);
+        }
+        auto found = names.find(name);
+        if (found == names.end()) {
+            position = start;
+            fail("unknown name '" + name + "'");
+        }
+        return found->second;
+    }
+    if (c == '(') {
+        position++;
+        Operand inner = parseSum();
+        skipSpace();
+        if (position >= text->size() || (*text)[position] != ')') {
+            fail("expected ')'");
+        }
+        position++;
+        return inner;
+    }
+    fail(std::string("unexpected '") + c + "'");
+}
+
+ExpressionCompiler::Operand ExpressionCompiler::call(const std::string& name,
+                                                     const std::vector<Operand>& args) {
+    for (const Function& function : functions) {
+        if (name == function.name) {
+            if (args.size() != function.arity) {
+                fail(name + " takes " + std::to_string(function.arity) + " argument(s)");
+            }
+            return emit(function.op, args[0], args.size() > 1 ? args[1] : args[0]);
+        }
+    }
+    fail("unknown function '" + name + "'");
+}
+
+ExpressionCompiler::Operand ExpressionCompiler::emit(OpCode op, const Operand& a,
+                                                     const Operand& b) {
+    bool unary = isUnary(op);
+    if (a.constant && (unary || b.constant)) {
+        return Operand{true, apply(op, a.value, b.value), 0};  // Constant folding
+    }
+    const Operand* second = &b;
+    if (op == OpCode::Pow && b.constant && b.value == 2.0) {
+        op = OpCode::Mul;  // x^2 -> x * x
+        second = &a;
+    }
+    uint32_t ra = registerOf(a);
+    uint32_t rb = unary ? ra : registerOf(*second);
+    release(a);
+    if (rb != ra) {
+        release(*second);
+    }
+
+    uint32_t temporary;
+    if (!freeTemporaries.empty()) {
+        temporary = freeTemporaries.back();
+        freeTemporaries.pop_back();
+    } else {
+        temporary = temporaries++;
+        pinned.push_back(false);
+    }
+    instructions.push_back(Instruction{op, temporary | temporaryTag, ra, rb});
+    return Operand{false, 0.0, temporary | temporaryTag};
+}
+
+uint32_t ExpressionCompiler::registerOf(const Operand& operand) {
+    if (!operand.constant) {
+        return operand.reg;
+    }
+    for (size_t c = 0; c < constants.size(); ++c) {
+        if (std::memcmp(&constants[c], &operand.value, sizeof(double)) == 0) {
+            return static_cast<uint32_t>(c) | constantTag;
+        }
+    }
+    constants.push_back(operand.value);
+    return static_cast<uint32_t>(constants.size() - 1) | constantTag;
+}
+
+void ExpressionCompiler::release(const Operand& operand) {
+    if (!operand.constant && (operand.reg & temporaryTag) && !pinned[operand.reg & ~tagMask]) {
+        freeTemporaries.push_back(operand.reg & ~tagMask);
+    }
+}
+
+void ExpressionCompiler::skipSpace() {
+    while (position < text->size() && std::isspace(static_cast<unsigned char>((*text)[position]))) {
+        position++;
+    }
+}
+
+void ExpressionCompiler::fail(const std::string& message) const {
+    throw ExpressionError(message + " at column " + std::to_string(position + 1) + " of \"" +
+                          *text + "\"");
+}
+
+// ==================== OdeModel ====================
+
+OdeModel OdeModel::parse(std::istream& in) {
+    OdeModel model;
+    std::string line;
+    size_t number = 0;
+    while (std::getline(in, line)) {
+        number++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw ExpressionError("line " + std::to_string(number) + ": expected '='");
+        }
+        std::string left = trim(line.substr(0, equals));
+        Statement statement{Statement::Let, "", trim(line.substr(equals + 1)), number};
+        size_t space = left.find_first_of(" \t");
+        std::string keyword = left.substr(0, space);
+        if (space != std::string::npos &&
+            (keyword == "param" || keyword == "state" || keyword == "let")) {
+            statement.kind = keyword == "param"   ? Statement::Param
+                             : keyword == "state" ? Statement::State
+                                                  : Statement::Let;
+            statement.name = trim(left.substr(space));
+        } else if (!left.empty() && left.back() == '\'') {
+            statement.kind = Statement::Derivative;
+            statement.name = trim(left.substr(0, left.size() - 1));
+        } else {
+            throw ExpressionError("line " + std::to_string(number) +
+                                  ": expected param, state, let or name' = expression");
+        }
+        if (!isName(statement.name)) {
+            throw ExpressionError("line " + std::to_string(number) + ": invalid name '" +
+                                  statement.name + "'");
+        }
+        model.statements.push_back(statement);
+    }
+    model.compile();
+    return model;
+}
+
+OdeModel OdeModel::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw ExpressionError("Could not open model file " + path);
+    }
+    try {
+        return parse(file);
+    } catch (const ExpressionError& error) {
+        throw ExpressionError(path + ", " + error.what());
+    }
+}
+
+void OdeModel::compile() {
+    states.clear();
+    for (const Statement& s : statements) {
+        if (s.kind == Statement::State) {
+            states.push_back(s.name);
+        }
+    }
+    if (states.empty()) {
+        throw ExpressionError("model has no state variables");
+    }
+
+    std::vector<std::string> inputs = {"t"};
+    inputs.insert(inputs.end(), states.begin(), states.end());
+    ExpressionCompiler compiler(inputs);
+    initial.assign(states.size(), 0.0);
+    parameters.clear();
+    std::vector<const Statement*> derivative(states.size(), nullptr);
+
+    for (const Statement& s : statements) {
+        try {
+            switch (s.kind) {
+                case Statement::Param: {
+                    double value = compiler.evaluateConstant(s.expression);
+                    for (const auto& o : overrides) {
+                        if (o.first == s.name) {
+                            value = o.second;
+                        }
+                    }
+                    compiler.defineConstant(s.name, value);
+                    parameters.emplace_back(s.name, value);
+                    break;
+                }
+                case Statement::State: {
+                    size_t k = std::find(states.begin(), states.end(), s.name) - states.begin();
+                    initial[k] = compiler.evaluateConstant(s.expression);
+                    break;
+                }
+                case Statement::Let:
+                    compiler.define(s.name, s.expression);
+                    break;
+                case Statement::Derivative: {
+                    auto found = std::find(states.begin(), states.end(), s.name);
+                    if (found == states.end()) {
+                        throw ExpressionError("'" + s.name + "' is not a state variable");
+                    }
+                    const Statement*& slot = derivative[found - states.begin()];
+                    if (slot != nullptr) {
+                        throw ExpressionError("second derivative for '" + s.name + "'");
+                    }
+                    slot = &s;
+                    break;
+                }
+            }
+        } catch (const ExpressionError& error) {
+            throw ExpressionError("line " + std::to_string(s.line) + ": " + error.what());
+        }
+    }
+
+    for (size_t k = 0; k < states.size(); ++k) {
+        if (derivative[k] == nullptr) {
+            throw ExpressionError("no derivative for state '" + states[k] + "'");
+        }
+        try {
+            compiler.addOutput(derivative[k]->expression);
+        } catch (const ExpressionError& error) {
+            throw ExpressionError("line " + std::to_string(derivative[k]->line) + ": " +
+                                  error.what());
+        }
+    }
+    compiled = compiler.finish();
+}
+
+double OdeModel::parameter(const std::string& name) const {
+    for (const auto& p : parameters) {
+        if (p.first == name) {
+            return p.second;
+        }
+    }
+    throw ExpressionError("no parameter '" + name + "'");
+}
+
+void OdeModel::setParameter(const std::string& name, double value) {
+    parameter(name);  // Throws if there is no such parameter
+    overrides.emplace_back(name, value);
+    compile();
+}
+
+void OdeModel::derivatives(double t, const double* state, double* out) const {
+    double local[16];
+    std::vector<double> heap;
+    double* inputs = local;
+    if (states.size() + 1 > 16) {
+        heap.resize(states.size() + 1);
+        inputs = heap.data();
+    }
+    inputs[0] = t;
+    std::memcpy(inputs + 1, state, states.size() * sizeof(double));
+    compiled.evaluate(inputs, out);
+}
+
+void OdeModel::derivativesBatch(size_t count, const double* t, const double* const* state,
+                                double* const* out) const {
+    std::vector<const double*> inputs(states.size() + 1);
+    inputs[0] = t;
+    std::copy(state, state + states.size(), inputs.begin() + 1);
+    compiled.evaluateBatch(count, inputs.data(), out);
+}
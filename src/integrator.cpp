@@ -0,0 +1,65 @@
+/**
+ * @file integrator.cpp
+ * @brief Implementation of LeapfrogIntegrator
+ */
+
+#include "../include/integrator.h"
+
+#include <utility>
+
+namespace {
+
+// v += a * h for every particle
+void kick(ParticleSystem& p, double h) {
+    size_t n = p.size();
+    double* vx = p.vx.data();
+    double* vy = p.vy.data();
+    double* vz = p.vz.data();
+    const double* ax = p.ax.data();
+    const double* ay = p.ay.data();
+    const double* az = p.az.data();
+    for (size_t i = 0; i < n; ++i) {
+        vx[i] += ax[i] * h;
+        vy[i] += ay[i] * h;
+        vz[i] += az[i] * h;
+    }
+}
+
+// x += v * h for every particle
+void drift(ParticleSystem& p, double h) {
+    size_t n = p.size();
+    double* x = p.x.data();
+    double* y = p.y.data();
+    double* z = p.z.data();
+    const double* vx = p.vx.data();
+    const double* vy = p.vy.data();
+    const double* vz = p.vz.data();
+    for (size_t i = 0; i < n; ++i) {
+        x[i] += vx[i] * h;
+        y[i] += vy[i] * h;
+        z[i] += vz[i] * h;
+    }
+}
+
+}  // namespace
+
+LeapfrogIntegrator::LeapfrogIntegrator(ForceSolver forces) : forces(std::move(forces)) {}
+
+void LeapfrogIntegrator::step(ParticleSystem& particles, double dt) {
+    if (!primed) {
+        forces(particles);
+        primed = true;
+    }
+    kick(particles, 0.5 * dt);
+    drift(particles, dt);
+    forces(particles);
+    kick(particles, 0.5 * dt);
+    stepCount++;
+    elapsed += dt;
+}
+
+void LeapfrogIntegrator::run(ParticleSystem& particles, double dt, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        step(particles, dt);
+    }
+}
@@ -0,0 +1,237 @@
+/**
+ * @file particle.cpp
+ * @brief Implementation of ParticleSystem and the direct-sum gravity kernels
+ */
+
+#include "../include/particle.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+const size_t lanes = 8;          // Targets per SIMD group (independent accumulators)
+const size_t targetBlock = 64;   // Targets per parallel task
+const size_t sourceTile = 1024;  // Sources per cache tile (32 KiB of x, y, z, m)
+
+}  // namespace
+
+void ParticleSystem::reserve(size_t count) {
+    for (AlignedVector* array : {&x, &y, &z, &vx, &vy, &vz, &ax, &ay, &az, &mass}) {
+        array->reserve(count);
+    }
+}
+
+size_t ParticleSystem::add(const Vector3D& position, const Vector3D& velocity, double m) {
+    x.push_back(position.getX());
+    y.push_back(position.getY());
+    z.push_back(position.getZ());
+    vx.push_back(velocity.getX());
+    vy.push_back(velocity.getY());
+    vz.push_back(velocity.getZ());
+    ax.push_back(0.0);
+    ay.push_back(0.0);
+    az.push_back(0.0);
+    mass.push_back(m);
+    return mass.size() - 1;
+}
+
+double ParticleSystem::totalMass() const {
+    double total = 0.0;
+    for (double m : mass) {
+        total += m;
+    }
+    return total;
+}
+
+Vector3D ParticleSystem::centerOfMass() const {
+    double sx = 0.0, sy = 0.0, sz = 0.0;
+    for (size_t i = 0; i < size(); ++i) {
+        sx += mass[i] * x[i];
+        sy += mass[i] * y[i];
+        sz += mass[i] * z[i];
+    }
+    double total = totalMass();
+    if (total == 0.0) {
+        return Vector3D(0, 0, 0);
+    }
+    return Vector3D(sx / total, sy / total, sz / total);
+}
+
+Vector3D ParticleSystem::momentum() const {
+    double px = 0.0, py = 0.0, pz = 0.0;
+    for (size_t i = 0; i < size(); ++i) {
+        px += mass[i] * vx[i];
+        py += mass[i] * vy[i];
+        pz += mass[i] * vz[i];
+    }
+    return Vector3D(px, py, pz);
+}
+
+double ParticleSystem::kineticEnergy() const {
+    double energy = 0.0;
+    for (size_t i = 0; i < size(); ++i) {
+        energy += 0.5 * mass[i] * (vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+    }
+    return energy;
+}
+
+double ParticleSystem::potentialEnergy(double G, double softening) const {
+    double eps2 = softening * softening;
+    double energy = 0.0;
+    for (size_t i = 0; i < size(); ++i) {
+        double sum = 0.0;
+        for (size_t j = i + 1; j < size(); ++j) {
+            double dx = x[j] - x[i];
+            double dy = y[j] - y[i];
+            double dz = z[j] - z[i];
+            sum += mass[j] / std::sqrt(dx * dx + dy * dy + dz * dz + eps2);
+        }
+        energy -= G * mass[i] * sum;
+    }
+    return energy;
+}
+
+ParticleSystem ParticleSystem::plummer(size_t count, unsigned seed) {
+    // Aarseth, Henon & Wielen (1974): radius from the cumulative mass profile,
+    // speed by rejection sampling of the distribution function
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    auto isotropic = [&](double length) {
+        double cosTheta = 2.0 * uniform(random) - 1.0;
+        double sinTheta = std::sqrt(1.0 - cosTheta * cosTheta);
+        double phi = 2.0 * M_PI * uniform(random);
+        return Vector3D(length * sinTheta * std::cos(phi), length * sinTheta * std::sin(phi),
+                        length * cosTheta);
+    };
+
+    ParticleSystem particles;
+    particles.reserve(count);
+    double m = count > 0 ? 1.0 / count : 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double r;
+        do {  // Drop the rare far outliers (beyond 10 scale radii)
+            double cumulative = std::max(uniform(random), 1e-12);
+            r = 1.0 / std::sqrt(std::pow(cumulative, -2.0 / 3.0) - 1.0);
+        } while (r > 10.0);
+
+        double q, g;
+        do {
+            q = uniform(random);
+            g = 0.1 * uniform(random);
+        } while (g > q * q * std::pow(1.0 - q * q, 3.5));
+        double speed = q * std::sqrt(2.0) * std::pow(1.0 + r * r, -0.25);
+
+        particles.add(isotropic(r), isotropic(speed), m);
+    }
+
+    // Centre of mass at rest at the origin
+    Vector3D center = particles.centerOfMass();
+    Vector3D drift = count > 0 ? particles.momentum() / particles.totalMass() : Vector3D();
+    for (size_t i = 0; i < count; ++i) {
+        particles.x[i] -= center.getX();
+        particles.y[i] -= center.getY();
+        particles.z[i] -= center.getZ();
+        particles.vx[i] -= drift.getX();
+        particles.vy[i] -= drift.getY();
+        particles.vz[i] -= drift.getZ();
+    }
+    return particles;
+}
+
+void computeGravityDirect(ParticleSystem& particles, const GravitySettings& settings,
+                          ThreadPool& pool) {
+    size_t n = particles.size();
+    double eps2 = settings.softening * settings.softening;
+    const double* x = particles.x.data();
+    const double* y = particles.y.data();
+    const double* z = particles.z.data();
+    const double* m = particles.mass.data();
+
+    pool.parallelFor(n, 0, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            double sx = 0.0, sy = 0.0, sz = 0.0;
+            for (size_t j = 0; j < n; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                double dx = x[j] - x[i];
+                double dy = y[j] - y[i];
+                double dz = z[j] - z[i];
+                double r2 = dx * dx + dy * dy + dz * dz + eps2;
+                double r = std::sqrt(r2);
+                double scale = settings.G * m[j] / (r2 * r);
+                sx += dx * scale;
+                sy += dy * scale;
+                sz += dz * scale;
+            }
+            particles.ax[i] = sx;
+            particles.ay[i] = sy;
+            particles.az[i] = sz;
+        }
+    });
+}
+
+void computeGravityBlocked(ParticleSystem& particles, const GravitySettings& settings,
+                           ThreadPool& pool) {
+    size_t n = particles.size();
+    double eps2 = settings.softening * settings.softening;
+    double G = settings.G;
+    const double* x = particles.x.data();
+    const double* y = particles.y.data();
+    const double* z = particles.z.data();
+    const double* m = particles.mass.data();
+
+    size_t blocks = (n + targetBlock - 1) / targetBlock;
+    pool.parallelFor(blocks, 1, [&](size_t begin, size_t end, size_t) {
+        alignas(64) double tx[targetBlock], ty[targetBlock], tz[targetBlock];
+        alignas(64) double sx[targetBlock], sy[targetBlock], sz[targetBlock];
+
+        for (size_t block = begin; block < end; ++block) {
+            size_t first = block * targetBlock;
+            size_t count = std::min(targetBlock, n - first);
+            // Unused lanes of the last block compute throwaway values at the origin
+            for (size_t k = 0; k < targetBlock; ++k) {
+                tx[k] = k < count ? x[first + k] : 0.0;
+                ty[k] = k < count ? y[first + k] : 0.0;
+                tz[k] = k < count ? z[first + k] : 0.0;
+                sx[k] = sy[k] = sz[k] = 0.0;
+            }
+
+            for (size_t tile = 0; tile < n; tile += sourceTile) {
+                size_t tileEnd = std::min(n, tile + sourceTile);
+                for (size_t group = 0; group < count; group += lanes) {
+                    double* gx = tx + group;
+                    double* gy = ty + group;
+                    double* gz = tz + group;
+                    double* ox = sx + group;
+                    double* oy = sy + group;
+                    double* oz = sz + group;
+                    for (size_t j = tile; j < tileEnd; ++j) {
+                        double xj = x[j], yj = y[j], zj = z[j];
+                        double gm = G * m[j];
+                        // Lanes are independent: one SIMD instruction per line below
+                        for (size_t k = 0; k < lanes; ++k) {
+                            double dx = xj - gx[k];
+                            double dy = yj - gy[k];
+                            double dz = zj - gz[k];
+                            double r2 = dx * dx + dy * dy + dz * dz + eps2;
+                            double inv = 1.0 / std::sqrt(r2);
+                            double scale = gm * inv * inv * inv;
+                            ox[k] += dx * scale;
+                            oy[k] += dy * scale;
+                            oz[k] += dz * scale;
+                        }
+                    }
+                }
+            }
+
+            for (size_t k = 0; k < count; ++k) {
+                particles.ax[first + k] = sx[k];
+                particles.ay[first + k] = sy[k];
+                particles.az[first + k] = sz[k];
+            }
+        }
+    });
+}
@@ -0,0 +1,265 @@
+/**
+ * @file perf_counters.cpp
+ * @brief Implementation of the perf_event_open counters and kernel profile
+ */
+
+#include "../include/perf_counters.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+std::atomic<bool> PerfProfile::active{false};
+
+namespace {
+
+const uint64_t eventConfig[PerfEventCount] = {
+    PERF_COUNT_HW_CPU_CYCLES,       PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES};
+
+int openEvent(PerfEvent event, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = eventConfig[event];
+    attr.disabled = group < 0 ? 1 : 0;  // The leader starts the whole group
+    attr.exclude_kernel = 1;            // Allowed at perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // This thread only, on any CPU
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+double ratio(const PerfSample& sample, PerfEvent top, PerfEvent bottom, double scale = 1.0) {
+    if (!sample.measured[top] || !sample.measured[bottom] || sample.counts[bottom] <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return scale * sample.counts[top] / sample.counts[bottom];
+}
+
+double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+PerfCounters& threadCounters() {
+    thread_local std::unique_ptr<PerfCounters> counters(new PerfCounters());
+    return *counters;
+}
+
+std::mutex profileMutex;
+std::vector<std::pair<std::string, PerfSample>> profile;
+bool probed = false;
+std::string probeProblem;
+
+void printAtExit() {
+    PerfProfile::print(std::cout);
+}
+
+}  // namespace
+
+// ==================== PerfSample ====================
+
+PerfSample& PerfSample::operator+=(const PerfSample& other) {
+    for (size_t e = 0; e < PerfEventCount; ++e) {
+        counts[e] += other.counts[e];
+        measured[e] = measured[e] || other.measured[e];
+    }
+    seconds += other.seconds;
+    calls += other.calls;
+    return *this;
+}
+
+double PerfSample::ipc() const {
+    return ratio(*this, PerfInstructions, PerfCycles);
+}
+
+double PerfSample::cacheMissRate() const {
+    return ratio(*this, PerfCacheMisses, PerfCacheReferences);
+}
+
+double PerfSample::cacheMissesPerKilo() const {
+    return ratio(*this, PerfCacheMisses, PerfInstructions, 1000.0);
+}
+
+double PerfSample::branchMissRate() const {
+    return ratio(*this, PerfBranchMisses, PerfBranches);
+}
+
+// ==================== PerfCounters ====================
+
+PerfCounters::PerfCounters() {
+    leader = openEvent(PerfCycles, -1);
+    if (leader < 0) {
+        problem = std::string("perf_event_open: ") + std::strerror(errno);
+        if (errno == EACCES || errno == EPERM) {
+            problem += " (see /proc/sys/kernel/perf_event_paranoid)";
+        } else if (errno == ENOENT || errno == EOPNOTSUPP) {
+            problem += " (no hardware PMU, e.g. in a virtual machine)";
+        } else if (errno == ENOSYS) {
+            problem += " (not supported by the kernel or blocked by seccomp)";
+        }
+        return;
+    }
+    members.emplace_back(PerfCycles, leader);
+    for (size_t e = PerfCycles + 1; e < PerfEventCount; ++e) {
+        int fd = openEvent(static_cast<PerfEvent>(e), leader);
+        if (fd >= 0) {
+            members.emplace_back(static_cast<PerfEvent>(e), fd);
+        }
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters() {
+    for (const auto& member : members) {
+        ::close(member.second);
+    }
+}
+
+PerfSample PerfCounters::read() const {
+    PerfSample sample;
+    if (leader < 0) {
+        return sample;
+    }
+    // nr, time enabled, time running, one value per member
+    uint64_t data[3 + PerfEventCount];
+    ssize_t bytes = ::read(leader, data, sizeof(data));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[0] != members.size()) {
+        return sample;
+    }
+    double scale = data[2] > 0 ? static_cast<double>(data[1]) / static_cast<double>(data[2])
+                               : 0.0;
+    for (size_t i = 0; i < members.size(); ++i) {
+        sample.counts[members[i].first] = static_cast<double>(data[3 + i]) * scale;
+        sample.measured[members[i].first] = true;
+    }
+    return sample;
+}
+
+// ==================== PerfProfile ====================
+
+void PerfProfile::enable() {
+    active.store(true, std::memory_order_relaxed);
+}
+
+bool PerfProfile::enableFromEnvironment() {
+    const char* value = std::getenv("NM_PERF");
+    if (value == nullptr || *value == '\0' || std::strcmp(value, "0") == 0) {
+        return false;
+    }
+    enable();
+    std::atexit(printAtExit);
+    return true;
+}
+
+void PerfProfile::add(const char* kernel, const PerfSample& sample) {
+    std::lock_guard<std::mutex> lock(profileMutex);
+    for (auto& entry : profile) {
+        if (entry.first == kernel) {
+            entry.second += sample;
+            return;
+        }
+    }
+    profile.emplace_back(kernel, sample);
+}
+
+std::vector<std::pair<std::string, PerfSample>> PerfProfile::kernels() {
+    std::lock_guard<std::mutex> lock(profileMutex);
+    return profile;
+}
+
+std::string PerfProfile::unavailableReason() {
+    // A separate probe: at exit this thread's counters may already be destroyed
+    std::lock_guard<std::mutex> lock(profileMutex);
+    if (!probed) {
+        PerfCounters probe;
+        probeProblem = probe.error();
+        probed = true;
+    }
+    return probeProblem;
+}
+
+void PerfProfile::reset() {
+    std::lock_guard<std::mutex> lock(profileMutex);
+    profile.clear();
+}
+
+void PerfProfile::print(std::ostream& out) {
+    std::vector<std::pair<std::string, PerfSample>> totals = kernels();
+    if (totals.empty()) {
+        return;
+    }
+    std::string reason = unavailableReason();
+    out << "Kernel profile";
+    if (!reason.empty()) {
+        out << " (hardware counters unavailable: " << reason << "; wall time only)";
+    }
+    out << std::endl;
+    out << std::left << std::setw(34) << "kernel" << std::right << std::setw(10) << "calls"
+        << std::setw(11) << "time(s)" << std::setw(11) << "Gcycles" << std::setw(7) << "IPC"
+        << std::setw(10) << "cache%" << std::setw(8) << "MPKI" << std::setw(10) << "branch%"
+        << std::setw(9) << "bound" << std::endl;
+
+    auto field = [&out](double value, int width, int digits) {
+        if (std::isnan(value)) {
+            out << std::setw(width) << "-";
+        } else {
+            out << std::setw(width) << std::fixed << std::setprecision(digits) << value;
+        }
+    };
+    for (const auto& entry : totals) {
+        const PerfSample& s = entry.second;
+        out << std::left << std::setw(34) << entry.first.substr(0, 33) << std::right
+            << std::setw(10) << s.calls;
+        field(s.seconds, 11, 4);
+        field(s.measured[PerfCycles] ? s.counts[PerfCycles] * 1e-9
+                                     : std::numeric_limits<double>::quiet_NaN(),
+              11, 3);
+        field(s.ipc(), 7, 2);
+        field(100.0 * s.cacheMissRate(), 10, 2);
+        field(s.cacheMissesPerKilo(), 8, 2);
+        field(100.0 * s.branchMissRate(), 10, 2);
+        double mpki = s.cacheMissesPerKilo();
+        out << std::setw(9) << (std::isnan(mpki) ? "-" : mpki >= 5.0 ? "memory" : "compute")
+            << std::defaultfloat << std::endl;
+    }
+}
+
+// ==================== PerfScope ====================
+
+PerfScope::PerfScope(const char* kernel) : kernel(kernel), on(PerfProfile::enabled()) {
+    if (on) {
+        start = threadCounters().read();
+        start.seconds = nowSeconds();
+    }
+}
+
+PerfScope::~PerfScope() {
+    if (!on) {
+        return;
+    }
+    PerfSample delta = threadCounters().read();
+    for (size_t e = 0; e < PerfEventCount; ++e) {
+        delta.counts[e] -= start.counts[e];
+    }
+    delta.seconds = nowSeconds() - start.seconds;
+    delta.calls = 1;
+    PerfProfile::add(kernel, delta);
+}
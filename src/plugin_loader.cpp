@@ -0,0 +1,213 @@
+/**
+ * @file plugin_loader.cpp
+ * @brief Implementation of the plugin loader
+ */
+
+#include "../include/plugin_loader.h"
+
+#include <dirent.h>
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+// ==================== PluginModel ====================
+
+PluginModel::PluginModel(std::shared_ptr<void> library, const nm_model* descriptor,
+                         std::string path)
+    : handle(std::move(library)),
+      model(descriptor),
+      modelName(descriptor->name),
+      modelDescription(descriptor->description ? descriptor->description : ""),
+      libraryPath(std::move(path)) {
+    for (uint32_t i = 0; i < model->parameter_count; ++i) {
+        names.emplace_back(model->parameter_names[i]);
+        values.push_back(model->default_parameters[i]);
+    }
+}
+
+std::vector<std::string> PluginModel::stateNames() const {
+    std::vector<std::string> result;
+    for (uint32_t i = 0; i < model->state_size; ++i) {
+        result.push_back(model->state_names ? std::string(model->state_names[i])
+                                            : "y" + std::to_string(i));
+    }
+    return result;
+}
+
+std::vector<double> PluginModel::initialState() const {
+    if (!model->initial_state) {
+        return std::vector<double>(model->state_size, 0.0);
+    }
+    return std::vector<double>(model->initial_state, model->initial_state + model->state_size);
+}
+
+void PluginModel::setParameter(const std::string& name, double value) {
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end()) {
+        throw PluginError("model '" + modelName + "' has no parameter '" + name + "'");
+    }
+    values[it - names.begin()] = value;
+}
+
+void PluginModel::evaluateBatch(size_t count, const double* t, const double* const* state,
+                                double* const* out) const {
+    if (model->evaluate_batch) {
+        model->evaluate_batch(values.data(), count, t, state, out);
+        return;
+    }
+    // Gather one lane at a time; the sizes are small (the state of one system)
+    size_t inputs = stateSize(), outputs = outputSize();
+    std::vector<double> in(inputs), result(outputs);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t k = 0; k < inputs; ++k) {
+            in[k] = state[k][i];
+        }
+        model->evaluate(values.data(), t[i], in.data(), result.data());
+        for (size_t k = 0; k < outputs; ++k) {
+            out[k][i] = result[k];
+        }
+    }
+}
+
+// ==================== PluginRegistry ====================
+
+namespace {
+
+// Rejects descriptors the host cannot use safely; message names the problem
+std::string checkDescriptor(const nm_model& model) {
+    if (model.abi_version != NM_PLUGIN_ABI_VERSION) {
+        return "built for plugin ABI " + std::to_string(model.abi_version) + ", expected " +
+               std::to_string(NM_PLUGIN_ABI_VERSION);
+    }
+    if (model.struct_size < sizeof(nm_model)) {
+        return "descriptor is " + std::to_string(model.struct_size) + " bytes, expected " +
+               std::to_string(sizeof(nm_model));
+    }
+    if (!model.name || !*model.name) {
+        return "model without a name";
+    }
+    if (!model.evaluate) {
+        return "model '" + std::string(model.name) + "' has no evaluate function";
+    }
+    if (model.kind == NM_MODEL_ODE) {
+        if (model.state_size == 0) {
+            return "ODE model '" + std::string(model.name) + "' has no state";
+        }
+    } else if (model.kind == NM_MODEL_ACCELERATION) {
+        if (model.state_size != 6) {
+            return "acceleration model '" + std::string(model.name) +
+                   "' must take 6 inputs (velocity, wind)";
+        }
+    } else {
+        return "model '" + std::string(model.name) + "' has unknown kind " +
+               std::to_string(model.kind);
+    }
+    if (model.parameter_count > 0 && (!model.parameter_names || !model.default_parameters)) {
+        return "model '" + std::string(model.name) +
+               "' declares parameters without names or defaults";
+    }
+    return "";
+}
+
+}  // namespace
+
+size_t PluginRegistry::load(const std::string& path) {
+    // A bare file name would make dlopen search the library path instead of the
+    // working directory. RTLD_LOCAL keeps each plugin's symbols to itself.
+    std::string file = path.find('/') == std::string::npos ? "./" + path : path;
+    void* raw = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!raw) {
+        throw PluginError("cannot load plugin " + path + ": " + dlerror());
+    }
+    std::shared_ptr<void> library(raw, [](void* h) { dlclose(h); });
+
+    auto entry = reinterpret_cast<nm_plugin_entry_fn>(dlsym(raw, NM_PLUGIN_ENTRY_SYMBOL));
+    if (!entry) {
+        throw PluginError("plugin " + path + " does not export " NM_PLUGIN_ENTRY_SYMBOL);
+    }
+    size_t count = 0;
+    const nm_model* descriptors = entry(NM_PLUGIN_ABI_VERSION, &count);
+    if (!descriptors) {
+        throw PluginError("plugin " + path + " does not support plugin ABI " +
+                          std::to_string(NM_PLUGIN_ABI_VERSION));
+    }
+
+    // Validate everything before adding anything, so a bad plugin leaves no partial state
+    std::vector<PluginModel> added;
+    for (size_t i = 0; i < count; ++i) {
+        // checkDescriptor reads the version fields before anything else in the struct
+        std::string problem = checkDescriptor(descriptors[i]);
+        if (!problem.empty()) {
+            throw PluginError("plugin " + path + ": " + problem);
+        }
+        for (const PluginModel& existing : loaded) {
+            if (existing.name() == descriptors[i].name &&
+                existing.model->kind == descriptors[i].kind) {
+                throw PluginError("plugin " + path + ": model '" + existing.name() +
+                                  "' is already provided by " + existing.path());
+            }
+        }
+        added.push_back(PluginModel(library, &descriptors[i], path));
+    }
+    loaded.insert(loaded.end(), added.begin(), added.end());
+    return added.size();
+}
+
+size_t PluginRegistry::discover(const std::string& directory) {
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return 0;
+    }
+    std::vector<std::string> files;
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, ".so") == 0) {
+            files.push_back(name);
+        }
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+
+    size_t added = 0;
+    for (const std::string& file : files) {
+        try {
+            added += load(directory + "/" + file);
+        } catch (const PluginError& error) {
+            problems.push_back(error.what());
+        }
+    }
+    return added;
+}
+
+std::vector<std::string> PluginRegistry::searchPath(const std::string& defaultDirectory) {
+    std::vector<std::string> directories;
+    if (const char* env = std::getenv("NM_PLUGIN_PATH")) {
+        std::string list = env;
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t end = list.find(':', start);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            if (end > start) {
+                directories.push_back(list.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+    }
+    if (!defaultDirectory.empty()) {
+        directories.push_back(defaultDirectory);
+    }
+    return directories;
+}
+
+const PluginModel* PluginRegistry::find(const std::string& name, nm_model_kind kind) const {
+    for (const PluginModel& model : loaded) {
+        if (model.name() == name && model.kind() == kind) {
+            return &model;
+        }
+    }
+    return nullptr;
+}
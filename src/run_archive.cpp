@@ -0,0 +1,368 @@
+/**
+ * @file run_archive.cpp
+ * @brief Implementation of RunArchiveWriter and RunArchiveReader
+ */
+
+#include "../include/run_archive.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "../include/trace.h"
+
+namespace {
+
+const char headerMagic[8] = {'N', 'M', 'R', 'U', 'N', 'A', 'R', '1'};
+const char trailerMagic[8] = {'N', 'M', 'R', 'U', 'N', 'I', 'D', 'X'};
+const uint32_t formatVersion = 1;
+
+// magic, version, parameter/summary/column counts, size of the name table
+const size_t headerSize = 8 + 4 * 4 + 8;
+// index offset, run count, magic
+const size_t trailerSize = 8 + 8 + 8;
+// run id, row count
+const size_t segmentHeaderSize = 16;
+
+size_t padTo8(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+template <typename T>
+void put(std::vector<unsigned char>& out, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T get(const unsigned char* at) {
+    T value;
+    std::memcpy(&value, at, sizeof(T));
+    return value;
+}
+
+std::vector<unsigned char> encodeHeader(const RunArchiveLayout& layout) {
+    std::vector<unsigned char> names;
+    for (const std::vector<std::string>* list : {&layout.parameters, &layout.summary,
+                                                 &layout.columns}) {
+        for (const std::string& name : *list) {
+            put(names, static_cast<uint32_t>(name.size()));
+            names.insert(names.end(), name.begin(), name.end());
+        }
+    }
+    names.resize(padTo8(names.size()), 0);
+
+    std::vector<unsigned char> header(headerMagic, headerMagic + 8);
+    put(header, formatVersion);
+    put(header, static_cast<uint32_t>(layout.parameters.size()));
+    put(header, static_cast<uint32_t>(layout.summary.size()));
+    put(header, static_cast<uint32_t>(layout.columns.size()));
+    put(header, static_cast<uint64_t>(names.size()));
+    header.insert(header.end(), names.begin(), names.end());
+    return header;
+}
+
+}  // namespace
+
+// ==================== RunArchiveWriter ====================
+
+RunArchiveWriter::RunArchiveWriter(const std::string& filename, RunArchiveLayout layout)
+    : path(filename), names(std::move(layout)) {
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Could not create archive " + path + ": " +
+                                 std::strerror(errno));
+    }
+    std::vector<unsigned char> header = encodeHeader(names);
+    if (!writeAt(header.data(), header.size(), 0)) {
+        ::close(fd);
+        fd = -1;
+        throw std::runtime_error("Could not write archive header to " + path);
+    }
+    end.store(header.size());
+}
+
+RunArchiveWriter::~RunArchiveWriter() {
+    try {
+        close();
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << std::endl;
+    }
+    Entry* entry = head.exchange(nullptr);
+    while (entry != nullptr) {
+        Entry* next = entry->next;
+        delete entry;
+        entry = next;
+    }
+}
+
+bool RunArchiveWriter::writeAt(const void* data, size_t size, uint64_t offset) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool RunArchiveWriter::append(uint64_t runId, const double* parameters, const double* summary,
+                              const double* rows, size_t rowCount) {
+    TraceSpan span("archive append", "io", static_cast<int64_t>(runId));
+    size_t dataBytes = rowCount * names.columns.size() * sizeof(double);
+    uint64_t offset = end.fetch_add(segmentHeaderSize + dataBytes, std::memory_order_relaxed);
+
+    uint64_t segmentHeader[2] = {runId, static_cast<uint64_t>(rowCount)};
+    iovec parts[2] = {{segmentHeader, segmentHeaderSize},
+                      {const_cast<double*>(rows), dataBytes}};
+    ssize_t n;
+    do {
+        n = ::pwritev(fd, parts, dataBytes > 0 ? 2 : 1, static_cast<off_t>(offset));
+    } while (n < 0 && errno == EINTR);
+    // Finish a short write piece by piece
+    bool ok = n >= 0;
+    size_t done = ok ? static_cast<size_t>(n) : 0;
+    if (ok && done < segmentHeaderSize) {
+        ok = writeAt(reinterpret_cast<char*>(segmentHeader) + done, segmentHeaderSize - done,
+                     offset + done);
+        done = segmentHeaderSize;
+    }
+    if (ok && done < segmentHeaderSize + dataBytes) {
+        size_t skip = done - segmentHeaderSize;
+        ok = writeAt(reinterpret_cast<const char*>(rows) + skip, dataBytes - skip, offset + done);
+    }
+    if (!ok) {
+        failed = true;
+        std::cerr << "Error: Could not write run " << runId << " to " << path << std::endl;
+        return false;
+    }
+
+    Entry* entry = new Entry{runId, offset, rowCount, {}, nullptr};
+    entry->values.assign(parameters, parameters + names.parameters.size());
+    entry->values.insert(entry->values.end(), summary, summary + names.summary.size());
+
+    // Lock-free push; the list is only read back in close()
+    entry->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(entry->next, entry, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+    count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void RunArchiveWriter::close() {
+    if (fd < 0) {
+        return;
+    }
+    std::vector<Entry*> entries;
+    for (Entry* entry = head.exchange(nullptr, std::memory_order_acquire); entry != nullptr;
+         entry = entry->next) {
+        entries.push_back(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) {
+        return a->id != b->id ? a->id < b->id : a->offset < b->offset;
+    });
+
+    std::vector<unsigned char> footer;
+    footer.reserve(entries.size() * (24 + 8 * (names.parameters.size() + names.summary.size())) +
+                   trailerSize);
+    for (const Entry* entry : entries) {
+        put(footer, entry->id);
+        put(footer, entry->offset);
+        put(footer, entry->rows);
+        for (double value : entry->values) {
+            put(footer, value);
+        }
+    }
+    uint64_t indexOffset = end.load();
+    put(footer, indexOffset);
+    put(footer, static_cast<uint64_t>(entries.size()));
+    footer.insert(footer.end(), trailerMagic, trailerMagic + 8);
+
+    for (Entry* entry : entries) {
+        delete entry;
+    }
+
+    bool ok = writeAt(footer.data(), footer.size(), indexOffset);
+    ok = ::close(fd) == 0 && ok;
+    fd = -1;
+    if (!ok) {
+        throw std::runtime_error("Could not write archive index to " + path);
+    }
+}
+
+// ==================== RunArchiveReader ====================
+
+RunArchiveReader::RunArchiveReader(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open archive " + filename + ": " +
+                                 std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < headerSize + trailerSize) {
+        ::close(fd);
+        throw std::runtime_error(filename + " is not a run archive");
+    }
+    length = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map archive " + filename);
+    }
+    base = static_cast<const unsigned char*>(mapping);
+
+    // Validate everything up front so lookups can trust the offsets
+    auto invalid = [&](const std::string& why) {
+        munmap(const_cast<unsigned char*>(base), length);
+        base = nullptr;
+        return std::runtime_error(filename + ": " + why);
+    };
+    if (std::memcmp(base, headerMagic, 8) != 0 || get<uint32_t>(base + 8) != formatVersion) {
+        throw invalid("not a run archive (or unsupported version)");
+    }
+    const unsigned char* tail = base + length - trailerSize;
+    if (std::memcmp(tail + 16, trailerMagic, 8) != 0) {
+        throw invalid("no index (archive was not closed)");
+    }
+
+    size_t counts[3] = {get<uint32_t>(base + 12), get<uint32_t>(base + 16),
+                        get<uint32_t>(base + 20)};
+    uint64_t namesBytes = get<uint64_t>(base + 24);
+    if (namesBytes > length - headerSize - trailerSize) {
+        throw invalid("corrupt header");
+    }
+    const unsigned char* at = base + headerSize;
+    const unsigned char* namesEnd = at + namesBytes;
+    std::vector<std::string>* lists[3] = {&names.parameters, &names.summary, &names.columns};
+    for (int list = 0; list < 3; ++list) {
+        for (size_t i = 0; i < counts[list]; ++i) {
+            if (namesEnd - at < 4 || namesEnd - at - 4 < get<uint32_t>(at)) {
+                throw invalid("corrupt header");
+            }
+            uint32_t size = get<uint32_t>(at);
+            lists[list]->emplace_back(reinterpret_cast<const char*>(at + 4), size);
+            at += 4 + size;
+        }
+    }
+
+    uint64_t indexOffset = get<uint64_t>(tail);
+    runCount = get<uint64_t>(tail + 8);
+    recordSize = 24 + 8 * (names.parameters.size() + names.summary.size());
+    size_t dataStart = headerSize + namesBytes;
+    if (indexOffset < dataStart || indexOffset % 8 != 0 || indexOffset > length - trailerSize ||
+        (length - trailerSize - indexOffset) / recordSize != runCount ||
+        (length - trailerSize - indexOffset) % recordSize != 0) {
+        throw invalid("corrupt index");
+    }
+    index = base + indexOffset;
+
+    size_t rowBytes = 8 * names.columns.size();
+    for (size_t i = 0; i < runCount; ++i) {
+        const unsigned char* entry = record(i);
+        uint64_t offset = get<uint64_t>(entry + 8);
+        uint64_t rows = get<uint64_t>(entry + 16);
+        if (offset < dataStart || offset % 8 != 0 ||
+            offset + segmentHeaderSize > indexOffset ||
+            (rowBytes > 0 && rows > (indexOffset - offset - segmentHeaderSize) / rowBytes) ||
+            get<uint64_t>(base + offset) != get<uint64_t>(entry)) {
+            throw invalid("corrupt index entry " + std::to_string(i));
+        }
+    }
+
+    // One sorted permutation per parameter for range queries
+    byParameter.resize(names.parameters.size());
+    for (size_t p = 0; p < byParameter.size(); ++p) {
+        std::vector<uint32_t>& order = byParameter[p];
+        order.resize(runCount);
+        for (size_t i = 0; i < runCount; ++i) {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return get<double>(record(a) + 24 + 8 * p) < get<double>(record(b) + 24 + 8 * p);
+        });
+    }
+}
+
+RunArchiveReader::~RunArchiveReader() {
+    if (base != nullptr) {
+        munmap(const_cast<unsigned char*>(base), length);
+    }
+}
+
+const unsigned char* RunArchiveReader::record(size_t position) const {
+    return index + position * recordSize;
+}
+
+RunArchiveReader::Run RunArchiveReader::run(size_t position) const {
+    const unsigned char* entry = record(position);
+    uint64_t offset = get<uint64_t>(entry + 8);
+    Run result;
+    result.id = get<uint64_t>(entry);
+    result.parameters = reinterpret_cast<const double*>(entry + 24);
+    result.summary = result.parameters + names.parameters.size();
+    result.data = reinterpret_cast<const double*>(base + offset + segmentHeaderSize);
+    result.rows = static_cast<size_t>(get<uint64_t>(entry + 16));
+    result.columns = names.columns.size();
+    return result;
+}
+
+bool RunArchiveReader::find(uint64_t runId, Run& out) const {
+    size_t low = 0;
+    size_t high = runCount;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (get<uint64_t>(record(middle)) < runId) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == runCount || get<uint64_t>(record(low)) != runId) {
+        return false;
+    }
+    out = run(low);
+    return true;
+}
+
+std::vector<RunArchiveReader::Run> RunArchiveReader::select(size_t parameter, double min,
+                                                            double max) const {
+    std::vector<Run> result;
+    if (parameter >= byParameter.size()) {
+        return result;
+    }
+    const std::vector<uint32_t>& order = byParameter[parameter];
+    auto value = [&](uint32_t position) {
+        return get<double>(record(position) + 24 + 8 * parameter);
+    };
+    auto first = std::lower_bound(order.begin(), order.end(), min,
+                                  [&](uint32_t position, double bound) {
+                                      return value(position) < bound;
+                                  });
+    for (auto it = first; it != order.end() && value(*it) <= max; ++it) {
+        result.push_back(run(*it));
+    }
+    return result;
+}
+
+size_t RunArchiveReader::parameterIndex(const std::string& name) const {
+    for (size_t i = 0; i < names.parameters.size(); ++i) {
+        if (names.parameters[i] == name) {
+            return i;
+        }
+    }
+    return npos;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file run_state.cpp
+ * @brief Implementation of saved run states
+ */
+
+#include "../include/run_state.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+const char* const magic = "nm-run-state";
+const int formatVersion = 1;
+
+// Hexadecimal floating point: exact, and read back by strtod
+std::string hex(double value) {
+    char text[40];
+    std::snprintf(text, sizeof(text), "%a", value);
+    return text;
+}
+
+double parseDouble(const std::string& word, const std::string& path) {
+    char* end = nullptr;
+    double value = std::strtod(word.c_str(), &end);
+    if (word.empty() || *end != '\0') {
+        throw std::runtime_error(path + ": bad number '" + word + "'");
+    }
+    return value;
+}
+
+void checkName(const std::string& name) {
+    if (name.empty() || name.find_first_of(" \t\n") != std::string::npos) {
+        throw std::invalid_argument("run state name '" + name + "' must be one word");
+    }
+}
+
+}  // namespace
+
+void writeFileAtomically(const std::string& path, const std::string& contents) {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "w");
+    if (!file) {
+        throw std::runtime_error("cannot create " + temporary);
+    }
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = std::fflush(file) == 0 && ok;
+    ok = fsync(fileno(file)) == 0 && ok;  // On disk before the rename makes it visible
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("cannot write " + path);
+    }
+}
+
+const RunState::Snapshot* RunState::snapshotBefore(double time) const {
+    const Snapshot* best = nullptr;
+    for (const Snapshot& snap : snapshots) {
+        if (!snap.state.empty() && snap.state[0] <= time) {
+            best = &snap;
+        }
+    }
+    return best;
+}
+
+double RunState::parameter(const std::string& name) const {
+    for (const auto& entry : parameters) {
+        if (entry.first == name) {
+            return entry.second;
+        }
+    }
+    throw std::invalid_argument("run state has no parameter '" + name + "'");
+}
+
+void RunState::save(const std::string& path) const {
+    checkName(model);
+    std::ostringstream out;
+    out << magic << " " << formatVersion << "\n";
+    out << "model " << model << "\n";
+    if (!output.empty()) {
+        out << "output " << output << "\n";
+    }
+    for (const auto& entry : parameters) {
+        checkName(entry.first);
+        out << "param " << entry.first << " " << hex(entry.second) << "\n";
+    }
+    out << "names";
+    for (const std::string& name : names) {
+        checkName(name);
+        out << " " << name;
+    }
+    out << "\nstate";
+    for (double value : state) {
+        out << " " << hex(value);
+    }
+    out << "\ntime_step " << hex(timeStep) << "\n";
+    out << "end_time " << hex(endTime) << "\n";
+    out << "steps " << steps << "\n";
+    if (!rng.empty()) {
+        out << "rng " << rng << "\n";
+    }
+    for (const Snapshot& snap : snapshots) {
+        out << "snapshot " << snap.step;
+        for (double value : snap.state) {
+            out << " " << hex(value);
+        }
+        out << "\n";
+    }
+    writeFileAtomically(path, out.str());
+}
+
+RunState RunState::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    std::string line, word;
+    int version = 0;
+    if (!std::getline(in, line) || !(std::istringstream(line) >> word >> version) ||
+        word != magic) {
+        throw std::runtime_error(path + " is not a run state file");
+    }
+    if (version != formatVersion) {
+        throw std::runtime_error(path + ": unsupported run state version " +
+                                 std::to_string(version));
+    }
+
+    RunState result;
+    auto readValues = [&path](std::istringstream& fields) {
+        std::vector<double> values;
+        std::string value;
+        while (fields >> value) {
+            values.push_back(parseDouble(value, path));
+        }
+        return values;
+    };
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key)) {
+            continue;
+        }
+        if (key == "model") {
+            fields >> result.model;
+        } else if (key == "output") {
+            std::getline(fields >> std::ws, result.output);
+        } else if (key == "param") {
+            std::string name, value;
+            fields >> name >> value;
+            result.parameters.emplace_back(name, parseDouble(value, path));
+        } else if (key == "names") {
+            while (fields >> word) {
+                result.names.push_back(word);
+            }
+        } else if (key == "state") {
+            result.state = readValues(fields);
+        } else if (key == "time_step") {
+            fields >> word;
+            result.timeStep = parseDouble(word, path);
+        } else if (key == "end_time") {
+            fields >> word;
+            result.endTime = parseDouble(word, path);
+        } else if (key == "steps") {
+            fields >> result.steps;
+        } else if (key == "rng") {
+            std::getline(fields >> std::ws, result.rng);
+        } else if (key == "snapshot") {
+            Snapshot snap;
+            fields >> snap.step;
+            snap.state = readValues(fields);
+            result.snapshots.push_back(std::move(snap));
+        } else {
+            throw std::runtime_error(path + ": unknown entry '" + key + "'");
+        }
+    }
+    if (result.state.empty() || result.state.size() != result.names.size() ||
+        result.timeStep <= 0.0) {
+        throw std::runtime_error(path + ": incomplete run state");
+    }
+    return result;
+}
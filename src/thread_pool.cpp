@@ -0,0 +1,376 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implementation of CpuTopology and ThreadPool
+ */
+
+#include "../include/thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../include/trace.h"
+
+namespace {
+
+thread_local size_t currentWorkerIndex = ThreadPool::npos;
+
+// Completion tracking for one parallelFor / forEachWorker call
+struct TaskGroup {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining = 0;
+    std::exception_ptr error;
+
+    void finish(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (e && !error) {
+            error = e;
+        }
+        if (--remaining == 0) {
+            done.notify_all();
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return remaining == 0; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+// CPUs this process may run on
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned n = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < n; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+void pinCurrentThread(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+}  // namespace
+
+// ==================== CpuTopology ====================
+
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) {
+            continue;
+        }
+        size_t dash = item.find('-');
+        try {
+            if (dash == std::string::npos) {
+                cpus.push_back(std::stoi(item));
+            } else {
+                int first = std::stoi(item.substr(0, dash));
+                int last = std::stoi(item.substr(dash + 1));
+                if (last < first) {
+                    return {};
+                }
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+    std::vector<int> allowed = allowedCpus();
+
+    std::ifstream onlineFile("/sys/devices/system/node/online");
+    std::string online;
+    if (onlineFile && std::getline(onlineFile, online)) {
+        for (int node : parseCpuList(online)) {
+            std::ifstream cpuFile("/sys/devices/system/node/node" + std::to_string(node) +
+                                  "/cpulist");
+            std::string cpuList;
+            if (!cpuFile || !std::getline(cpuFile, cpuList)) {
+                continue;
+            }
+            std::vector<int> cpus;
+            for (int cpu : parseCpuList(cpuList)) {
+                if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty()) {
+                topology.nodeCpus.push_back(cpus);
+            }
+        }
+    }
+
+    if (topology.nodeCpus.empty()) {
+        topology.nodeCpus.push_back(allowed);
+    }
+    return topology;
+}
+
+int CpuTopology::nodeOf(int cpu) const {
+    for (size_t node = 0; node < nodeCpus.size(); ++node) {
+        const std::vector<int>& cpus = nodeCpus[node];
+        if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+            return static_cast<int>(node);
+        }
+    }
+    return 0;
+}
+
+// ==================== ThreadPool ====================
+
+ThreadPool::ThreadPool(const ThreadPoolOptions& options) {
+    CpuTopology topology = CpuTopology::detect();
+
+    // CPU order: explicit list, or spread round-robin over the nodes so that a
+    // partial pool still uses every socket's memory controller
+    std::vector<int> cpus = options.cpus;
+    if (cpus.empty()) {
+        for (size_t i = 0;; ++i) {
+            bool any = false;
+            for (const std::vector<int>& node : topology.nodeCpus) {
+                if (i < node.size()) {
+                    cpus.push_back(node[i]);
+                    any = true;
+                }
+            }
+            if (!any) {
+                break;
+            }
+        }
+    }
+    size_t count = options.threads > 0 ? options.threads : cpus.size();
+
+    // Compact node numbering over the nodes that actually received workers
+    std::vector<int> nodeIndex(topology.nodeCount(), -1);
+    for (size_t i = 0; i < count; ++i) {
+        int cpu = cpus[i % cpus.size()];
+        int node = topology.nodeOf(cpu);
+        if (nodeIndex[node] < 0) {
+            nodeIndex[node] = static_cast<int>(nodeWorkers.size());
+            nodeWorkers.emplace_back();
+            nodeQueues.emplace_back(new TaskQueue);
+        }
+        size_t compact = static_cast<size_t>(nodeIndex[node]);
+        nodeWorkers[compact].push_back(i);
+        workerInfo.push_back(WorkerInfo{compact, options.pinThreads ? cpu : -1});
+        ownQueues.emplace_back(new TaskQueue);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::currentWorker() {
+    return currentWorkerIndex;
+}
+
+void ThreadPool::push(TaskQueue& queue, std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    // Taking the sleep lock orders the update with a worker's predicate check
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    queue.size++;
+}
+
+void ThreadPool::submit(std::function<void()> task, int node) {
+    size_t target = node >= 0 ? static_cast<size_t>(node) % nodeCount()
+                              : nextNode.fetch_add(1) % nodeCount();
+    pending++;
+    push(*nodeQueues[target], std::move(task));
+    // Any worker may steal a shared task, so one wake-up is enough
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    allDone.wait(lock, [this] { return pending.load() == 0; });
+}
+
+bool ThreadPool::tryPop(size_t index, std::function<void()>& task) {
+    auto popFrom = [&task](TaskQueue& queue) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    };
+
+    // Own queue, then own node, then steal from the other nodes
+    if (popFrom(*ownQueues[index])) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ownQueues[index]->size--;
+        return true;
+    }
+    size_t home = workerInfo[index].node;
+    for (size_t i = 0; i < nodeCount(); ++i) {
+        TaskQueue& queue = *nodeQueues[(home + i) % nodeCount()];
+        if (popFrom(queue)) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queue.size--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    if (workerInfo[index].cpu >= 0) {
+        pinCurrentThread(workerInfo[index].cpu);
+    }
+    currentWorkerIndex = index;
+    Trace::nameThread("pool worker " + std::to_string(index) + " (node " +
+                      std::to_string(workerInfo[index].node) + ")");
+
+    std::function<void()> task;
+    for (;;) {
+        if (tryPop(index, task)) {
+            {
+                TraceSpan span("task", "pool");
+                task();
+            }
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        auto hasWork = [this, index] {
+            if (ownQueues[index]->size > 0) {
+                return true;
+            }
+            for (const std::unique_ptr<TaskQueue>& queue : nodeQueues) {
+                if (queue->size > 0) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        if (stopping && !hasWork()) {
+            return;
+        }
+        workAvailable.wait(lock, [&] { return stopping || hasWork(); });
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t chunk,
+                             const std::function<void(size_t, size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    if (chunk == 0) {
+        chunk = std::max<size_t>(1, count / (size() * 4));
+    }
+
+    // Contiguous slice per node, proportional to its worker count
+    std::vector<std::pair<size_t, size_t>> chunks;
+    std::vector<size_t> chunkNode;
+    size_t begin = 0;
+    size_t workersSoFar = 0;
+    for (size_t node = 0; node < nodeCount(); ++node) {
+        workersSoFar += nodeWorkers[node].size();
+        size_t end = count * workersSoFar / size();
+        for (size_t b = begin; b < end; b += chunk) {
+            chunks.emplace_back(b, std::min(end, b + chunk));
+            chunkNode.push_back(node);
+        }
+        begin = end;
+    }
+
+    auto group = std::make_shared<TaskGroup>();
+    group->remaining = chunks.size();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        size_t b = chunks[i].first;
+        size_t e = chunks[i].second;
+        submit(
+            [group, &body, b, e] {
+                std::exception_ptr error;
+                try {
+                    body(b, e, currentWorkerIndex);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                group->finish(error);
+            },
+            static_cast<int>(chunkNode[i]));
+    }
+    group->wait();
+}
+
+void ThreadPool::forEachWorker(const std::function<void(size_t)>& fn) {
+    auto group = std::make_shared<TaskGroup>();
+    group->remaining = size();
+    for (size_t i = 0; i < size(); ++i) {
+        pending++;
+        push(*ownQueues[i], [group, &fn, i] {
+            std::exception_ptr error;
+            try {
+                fn(i);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            group->finish(error);
+        });
+    }
+    workAvailable.notify_all();
+    group->wait();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file trace.cpp
+ * @brief Implementation of the trace recorder
+ */
+
+#include "../include/trace.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+std::atomic<bool> Trace::active{false};
+
+namespace {
+
+// Per-thread cap; a runaway trace stops growing instead of exhausting memory
+const size_t maxEventsPerThread = size_t(1) << 22;
+
+struct Event {
+    const char* name;
+    const char* category;
+    uint64_t start;
+    uint64_t end;
+    int64_t id;
+};
+
+struct Buffer {
+    uint32_t tid;
+    std::string threadName;
+    std::vector<Event> events;
+    size_t dropped = 0;
+};
+
+std::mutex registryMutex;                     // Guards buffers (not their contents)
+std::vector<std::unique_ptr<Buffer>> buffers;  // Outlive their threads until flush
+std::string outputPath;
+std::chrono::steady_clock::time_point origin;
+
+thread_local Buffer* localBuffer = nullptr;
+
+Buffer& threadBuffer() {
+    if (localBuffer == nullptr) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers.push_back(std::make_unique<Buffer>());
+        localBuffer = buffers.back().get();
+        localBuffer->tid = static_cast<uint32_t>(buffers.size());
+        localBuffer->threadName = "thread " + std::to_string(localBuffer->tid);
+        localBuffer->events.reserve(4096);
+    }
+    return *localBuffer;
+}
+
+void appendEscaped(std::string& out, const std::string& text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+    }
+}
+
+void flushAtExit() {
+    try {
+        size_t spans = Trace::flush();
+        std::cout << "Trace of " << spans << " spans saved to: " << outputPath << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << "Warning: " << error.what() << std::endl;
+    }
+}
+
+}  // namespace
+
+void Trace::enable(const std::string& path) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    outputPath = path;
+    origin = std::chrono::steady_clock::now();
+    active.store(true, std::memory_order_relaxed);
+}
+
+bool Trace::enableFromEnvironment() {
+    const char* path = std::getenv("NM_TRACE");
+    if (path == nullptr || *path == '\0') {
+        return false;
+    }
+    enable(path);
+    nameThread("main");
+    std::atexit(flushAtExit);
+    return true;
+}
+
+void Trace::nameThread(const std::string& name) {
+    if (enabled()) {
+        threadBuffer().threadName = name;
+    }
+}
+
+uint64_t Trace::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - origin)
+                                     .count());
+}
+
+void Trace::record(const char* name, const char* category, uint64_t start, uint64_t end,
+                   int64_t id) {
+    Buffer& buffer = threadBuffer();
+    if (buffer.events.size() >= maxEventsPerThread) {
+        buffer.dropped++;
+        return;
+    }
+    buffer.events.push_back(Event{name, category, start, end, id});
+}
+
+size_t Trace::flush() {
+    active.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    // Microseconds with nanosecond digits, as the trace-event format expects
+    long pid = static_cast<long>(getpid());
+    char number[96];
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    size_t spans = 0, dropped = 0;
+    bool first = true;
+    for (const std::unique_ptr<Buffer>& buffer : buffers) {
+        out += first ? "" : ",\n";
+        first = false;
+        std::snprintf(number, sizeof(number),
+                      "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%u,", pid,
+                      buffer->tid);
+        out += number;
+        out += "\"args\":{\"name\":\"";
+        appendEscaped(out, buffer->threadName);
+        out += "\"}}";
+        for (const Event& event : buffer->events) {
+            out += ",\n{\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"cat\":\"";
+            appendEscaped(out, event.category);
+            std::snprintf(number, sizeof(number),
+                          "\",\"ph\":\"X\",\"pid\":%ld,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", pid,
+                          buffer->tid, event.start * 1e-3, (event.end - event.start) * 1e-3);
+            out += number;
+            if (event.id >= 0) {
+                std::snprintf(number, sizeof(number), ",\"args\":{\"id\":%lld}",
+                              static_cast<long long>(event.id));
+                out += number;
+            }
+            out += '}';
+        }
+        spans += buffer->events.size();
+        dropped += buffer->dropped;
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+    out += "\n]}\n";
+    if (dropped > 0) {
+        std::cerr << "Warning: trace buffer full, " << dropped << " spans dropped" << std::endl;
+    }
+
+    std::FILE* file = std::fopen(outputPath.c_str(), "w");
+    bool ok = file != nullptr && std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    if (file != nullptr && std::fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        throw std::runtime_error("cannot write trace " + outputPath);
+    }
+    return spans;
+}
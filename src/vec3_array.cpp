@@ -0,0 +1,172 @@
+/**
+ * @file vec3_array.cpp
+ * @brief Implementation of Vec3Array and its bulk operations
+ */
+
+#include "../include/vec3_array.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Below this many vectors a loop finishes faster than the pool can hand out work
+const size_t parallelMinimum = 1 << 16;
+const size_t parallelChunk = 1 << 14;
+
+// Runs body(begin, end) over [0, count), on the pool if there is one and it pays off
+template <typename Body>
+void forRange(size_t count, ThreadPool* pool, const Body& body) {
+    if (pool == nullptr || pool->size() == 1 || count < parallelMinimum) {
+        body(size_t(0), count);
+        return;
+    }
+    pool->parallelFor(count, parallelChunk,
+                      [&](size_t begin, size_t end, size_t) { body(begin, end); });
+}
+
+void requireSameSize(const Vec3Array& a, const Vec3Array& b, const char* operation) {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument(std::string(operation) + ": arrays of " +
+                                    std::to_string(a.size()) + " and " +
+                                    std::to_string(b.size()) + " vectors");
+    }
+}
+
+}  // namespace
+
+Vec3Array::Vec3Array(size_t count) : x(count, 0.0), y(count, 0.0), z(count, 0.0) {}
+
+void Vec3Array::resize(size_t count) {
+    x.resize(count, 0.0);
+    y.resize(count, 0.0);
+    z.resize(count, 0.0);
+}
+
+void Vec3Array::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    z.reserve(count);
+}
+
+void Vec3Array::set(size_t i, const Vector3D& v) {
+    x[i] = v.getX();
+    y[i] = v.getY();
+    z[i] = v.getZ();
+}
+
+void Vec3Array::push_back(const Vector3D& v) {
+    x.push_back(v.getX());
+    y.push_back(v.getY());
+    z.push_back(v.getZ());
+}
+
+Vec3Array Vec3Array::fromAoS(const std::vector<Vector3D>& vectors) {
+    Vec3Array soa(vectors.size());
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        soa.x[i] = vectors[i].getX();
+        soa.y[i] = vectors[i].getY();
+        soa.z[i] = vectors[i].getZ();
+    }
+    return soa;
+}
+
+std::vector<Vector3D> Vec3Array::toAoS() const {
+    std::vector<Vector3D> vectors;
+    vectors.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        vectors.emplace_back(x[i], y[i], z[i]);
+    }
+    return vectors;
+}
+
+// The loops below are written so that each line is one SIMD instruction across
+// consecutive i; the object is compiled with KERNEL_FLAGS (see the Makefile).
+
+void axpy(double a, const Vec3Array& x, Vec3Array& y, ThreadPool* pool) {
+    requireSameSize(x, y, "axpy");
+    const double* xx = x.x.data();
+    const double* xy = x.y.data();
+    const double* xz = x.z.data();
+    double* yx = y.x.data();
+    double* yy = y.y.data();
+    double* yz = y.z.data();
+    forRange(x.size(), pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            yx[i] += a * xx[i];
+            yy[i] += a * xy[i];
+            yz[i] += a * xz[i];
+        }
+    });
+}
+
+void dot(const Vec3Array& a, const Vec3Array& b, AlignedVector& out, ThreadPool* pool) {
+    requireSameSize(a, b, "dot");
+    out.resize(a.size());
+    const double* ax = a.x.data();
+    const double* ay = a.y.data();
+    const double* az = a.z.data();
+    const double* bx = b.x.data();
+    const double* by = b.y.data();
+    const double* bz = b.z.data();
+    double* result = out.data();
+    forRange(a.size(), pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+        }
+    });
+}
+
+void cross(const Vec3Array& a, const Vec3Array& b, Vec3Array& out, ThreadPool* pool) {
+    requireSameSize(a, b, "cross");
+    if (&out == &a || &out == &b) {
+        throw std::invalid_argument("cross: output may not alias an input");
+    }
+    out.resize(a.size());
+    const double* ax = a.x.data();
+    const double* ay = a.y.data();
+    const double* az = a.z.data();
+    const double* bx = b.x.data();
+    const double* by = b.y.data();
+    const double* bz = b.z.data();
+    double* cx = out.x.data();
+    double* cy = out.y.data();
+    double* cz = out.z.data();
+    forRange(a.size(), pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            cx[i] = ay[i] * bz[i] - az[i] * by[i];
+            cy[i] = az[i] * bx[i] - ax[i] * bz[i];
+            cz[i] = ax[i] * by[i] - ay[i] * bx[i];
+        }
+    });
+}
+
+void norm(const Vec3Array& v, AlignedVector& out, ThreadPool* pool) {
+    out.resize(v.size());
+    const double* x = v.x.data();
+    const double* y = v.y.data();
+    const double* z = v.z.data();
+    double* result = out.data();
+    forRange(v.size(), pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        }
+    });
+}
+
+void normalize(Vec3Array& v, ThreadPool* pool) {
+    double* x = v.x.data();
+    double* y = v.y.data();
+    double* z = v.z.data();
+    forRange(v.size(), pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            double length = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            // A select rather than a branch, so the loop still vectorizes
+            double inverse = length > 0.0 ? 1.0 / length : 0.0;
+            x[i] *= inverse;
+            y[i] *= inverse;
+            z[i] *= inverse;
+        }
+    });
+}
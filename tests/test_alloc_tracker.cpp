@@ -0,0 +1,99 @@
+/*
+ * Tests for the allocation tracker (include/alloc_tracker.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_tracker.h"
+
+namespace {
+
+AllocationStats statsOf(const std::string& subsystem) {
+    for (const auto& entry : AllocationTracker::subsystems()) {
+        if (entry.first == subsystem) {
+            return entry.second;
+        }
+    }
+    return AllocationStats();
+}
+
+}  // namespace
+
+TEST(AllocTrackerTest, CountsNothingUntilEnabled) {
+    ASSERT_FALSE(AllocationTracker::enabled());
+    {
+        AllocScope scope("before enable");
+        std::vector<double> values(1000, 1.0);
+    }
+    EXPECT_EQ(AllocationTracker::total().allocations, 0u);
+    EXPECT_EQ(statsOf("before enable").allocations, 0u);
+}
+
+TEST(AllocTrackerTest, ComparesStorageLayouts) {
+    AllocationTracker::enable();
+    const size_t steps = 1000;
+    {
+        // One small vector per step, as a stored RK4 path does
+        AllocScope scope("path of vectors");
+        std::vector<std::vector<double>> path;
+        for (size_t i = 0; i < steps; ++i) {
+            path.push_back({i * 0.04, 0.2, 0.0});
+        }
+    }
+    {
+        AllocScope scope("flat path");
+        std::vector<double> path;
+        path.reserve(3 * steps);
+        for (size_t i = 0; i < steps; ++i) {
+            path.insert(path.end(), {i * 0.04, 0.2, 0.0});
+        }
+    }
+
+    AllocationStats nested = statsOf("path of vectors");
+    AllocationStats flat = statsOf("flat path");
+    EXPECT_GE(nested.allocations, steps);
+    EXPECT_EQ(nested.frees, nested.allocations);
+    EXPECT_EQ(nested.liveBytes, 0);
+    EXPECT_GE(nested.peakBytes, static_cast<int64_t>(steps * (3 * sizeof(double) + 24)));
+
+    EXPECT_EQ(flat.allocations, 1u);
+    EXPECT_EQ(flat.peakBytes, static_cast<int64_t>(3 * steps * sizeof(double)));
+    EXPECT_EQ(flat.liveBytes, 0);
+
+    EXPECT_GE(AllocationTracker::total().allocations, nested.allocations + flat.allocations);
+}
+
+TEST(AllocTrackerTest, FreesAreChargedToTheOwner) {
+    AllocationTracker::enable();
+    std::unique_ptr<std::vector<char>> buffer;
+    {
+        AllocScope outer("owner");
+        {
+            AllocScope inner("inner");
+            buffer.reset(new std::vector<char>(4096));
+        }
+        std::vector<char> extra(100);  // Back in "owner"
+    }
+    EXPECT_EQ(statsOf("inner").liveBytes,
+              static_cast<int64_t>(4096 + sizeof(std::vector<char>)));
+    EXPECT_EQ(statsOf("owner").allocations, 1u);
+    EXPECT_EQ(statsOf("owner").liveBytes, 0);
+
+    // Freed outside any scope, on another thread
+    std::thread([&buffer] { buffer.reset(); }).join();
+    EXPECT_EQ(statsOf("inner").liveBytes, 0);
+    EXPECT_EQ(statsOf("inner").frees, 2u);
+
+    std::ostringstream table;
+    AllocationTracker::print(table);
+    EXPECT_NE(table.str().find("inner"), std::string::npos);
+    EXPECT_NE(table.str().find("Peak resident set"), std::string::npos);
+}
@@ -0,0 +1,113 @@
+/*
+ * Tests for the pendulum period and rotation analysis (Project 2, include/analysis.h)
+ *
+ * Build and run from Project 2: driven damped oscillations/: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "analysis.h"
+#include "thread_pool.h"
+
+namespace {
+
+// Pendulum with g / L = 1, so the small-angle period is 2π s
+OscillatorParams unitPendulum() {
+    return OscillatorParams{1.0, OscillatorParams::gravity, 0.0, 0.0, 2.0 / 3.0};
+}
+
+}  // namespace
+
+TEST(ExactFreePeriodTest, LimitsAndKnownValues) {
+    OscillatorParams params = unitPendulum();
+    EXPECT_NEAR(exactFreePeriod(params, 0.0), 2.0 * M_PI, 1e-12);
+
+    // Series T = T0 (1 + A²/16 + 11 A⁴/3072 + ...) for small amplitudes
+    double a = 0.2;
+    EXPECT_NEAR(exactFreePeriod(params, a) / (2.0 * M_PI),
+                1.0 + a * a / 16.0 + 11.0 * std::pow(a, 4) / 3072.0, 1e-7);
+
+    // T(π/2) / T0 = 2 K(1/√2) / π
+    EXPECT_NEAR(exactFreePeriod(params, M_PI / 2.0) / (2.0 * M_PI), 1.1803405990161, 1e-12);
+    EXPECT_EQ(exactFreePeriod(params, -1.0), exactFreePeriod(params, 1.0));
+    EXPECT_TRUE(std::isinf(exactFreePeriod(params, M_PI)));
+}
+
+TEST(PendulumEventsTest, CountsCrossingsAndTurns) {
+    // Angle = t - 0.5 moving forward: bottom crossings at t = 0.5 + 2πk, wraps at
+    // t = 0.5 + π(2k + 1)
+    PendulumEvents events;
+    const double dt = 0.25;
+    for (double t = 0.0; t < 20.0; t += dt) {
+        events.observe(t, t - 0.5, 1.0, t + dt, t + dt - 0.5, 1.0);
+    }
+    ASSERT_EQ(events.bottomCrossings(), 4u);  // 0.5, 6.78, 13.07, 19.35
+    EXPECT_NEAR(events.firstBottomCrossing(), 0.5, 1e-12);
+    EXPECT_NEAR(events.period(), 2.0 * M_PI, 1e-12);
+    EXPECT_EQ(events.turns(), 3);
+    EXPECT_EQ(events.wraps(), 3u);
+    EXPECT_NEAR(events.lastWrap(), 0.5 + 5.0 * M_PI, 1e-12);
+
+    // Going back over the top undoes a turn but still counts as a wrap
+    events.observe(20.0, 19.5, -1.0, 25.0, 14.5, -1.0);
+    EXPECT_EQ(events.turns(), 2);
+    EXPECT_EQ(events.wraps(), 4u);
+    EXPECT_EQ(events.bottomCrossings(), 4u);  // Backward bottom crossings are not counted
+
+    events.reset();
+    EXPECT_EQ(events.bottomCrossings(), 0u);
+    EXPECT_TRUE(std::isnan(events.period()));
+}
+
+TEST(PeriodVsAmplitudeTest, MatchesExactPeriod) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    OscillatorParams params = unitPendulum();
+    params.dampingCoefficient = 0.5;  // Switched off by periodVsAmplitude
+    params.drivingForce = 1.2;
+
+    std::vector<double> amplitudes = {0.1, 1.0, 2.0, 3.0, 0.0};
+    std::vector<PeriodMeasurement> results =
+        periodVsAmplitude(params, amplitudes, 0.01, 5, pool);
+    ASSERT_EQ(results.size(), amplitudes.size());
+    for (size_t i = 0; i + 1 < amplitudes.size(); ++i) {
+        EXPECT_EQ(results[i].amplitude, amplitudes[i]);
+        EXPECT_EQ(results[i].exact, exactFreePeriod(params, amplitudes[i]));
+        EXPECT_NEAR(results[i].period, results[i].exact, 1e-6 * results[i].exact)
+            << "amplitude " << amplitudes[i];
+    }
+    EXPECT_GT(results[3].period, 2.0 * results[0].period);  // Slower near the top
+    EXPECT_TRUE(std::isnan(results[4].period));             // At rest: never crosses
+}
+
+TEST(RotationNumbersTest, RotatingAndOscillating) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    OscillatorParams params = unitPendulum();
+    params.dampingCoefficient = 0.1;
+
+    // Undriven, starting with enough energy to rotate (ω²/2 > 2 g/L): damped, it is down
+    // to oscillating after the transient; undamped, it keeps rotating forward
+    OscillatorParams free = params;
+    free.dampingCoefficient = 0.0;
+    std::vector<OscillatorParams> cases = {params, free};
+    std::vector<RotationMeasurement> results =
+        rotationNumbers(cases, OscillatorState{0.0, 0.0, 2.5}, 100, 5, 20, pool);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].rotationNumber, 0.0);
+    EXPECT_EQ(results[0].wraps, 0u);
+    EXPECT_GT(results[1].rotationNumber, 1.0);
+    EXPECT_EQ(results[1].wraps, static_cast<uint64_t>(results[1].turns));
+    EXPECT_DOUBLE_EQ(results[1].rotationNumber, results[1].turns / 20.0);
+
+    cases[0].drivingFrequency = 0.0;
+    EXPECT_THROW(rotationNumbers(cases, OscillatorState{0.0, 0.0, 2.5}, 100, 5, 20, pool),
+                 std::invalid_argument);
+}
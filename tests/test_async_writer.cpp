@@ -0,0 +1,160 @@
+/*
+ * Tests for the shared AsyncWriter (include/async_writer.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "async_writer.h"
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return "/tmp/" + std::string(name) + "_" + std::to_string(getpid()) + ".csv";
+}
+
+std::vector<std::string> readLines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::vector<double> parseRow(const std::string& line) {
+    std::vector<double> values;
+    std::stringstream fields(line);
+    for (std::string field; std::getline(fields, field, ',');) {
+        values.push_back(std::strtod(field.c_str(), nullptr));
+    }
+    return values;
+}
+
+}  // namespace
+
+TEST(AsyncWriterTest, StreamsFromSeveralProducers) {
+    const size_t producers = 4, rows = 5000;
+    std::vector<std::string> paths;
+    for (size_t p = 0; p < producers; ++p) {
+        paths.push_back(tempPath(("async_producer" + std::to_string(p)).c_str()));
+    }
+    {
+        // Two I/O threads and small buffers: many buffers in flight at once
+        AsyncWriter writer(2, 64, 0);
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                std::shared_ptr<AsyncWriter::Stream> out =
+                    writer.open(paths[p], "#Producer " + std::to_string(p) + "\nI,X\n", 2);
+                for (size_t i = 0; i < rows; ++i) {
+                    out->append({static_cast<double>(i), 0.1 * i + p});
+                }
+                out->close();
+                out->wait();
+                EXPECT_TRUE(out->ok());
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        writer.flush();
+    }
+
+    for (size_t p = 0; p < producers; ++p) {
+        std::vector<std::string> lines = readLines(paths[p]);
+        ASSERT_EQ(lines.size(), rows + 2) << paths[p];
+        EXPECT_EQ(lines[0], "#Producer " + std::to_string(p));
+        EXPECT_EQ(lines[1], "I,X");
+        for (size_t i = 0; i < rows; ++i) {
+            std::vector<double> row = parseRow(lines[i + 2]);
+            ASSERT_EQ(row.size(), 2u);
+            ASSERT_EQ(row[0], static_cast<double>(i)) << "rows out of order in " << paths[p];
+            ASSERT_EQ(row[1], 0.1 * i + p);  // Shortest round-trip form is exact
+        }
+        std::remove(paths[p].c_str());
+    }
+}
+
+TEST(AsyncWriterTest, PrecisionAndLeftoverStreams) {
+    std::string path = tempPath("async_precision");
+    {
+        AsyncWriter writer(1, 4, 6);
+        std::shared_ptr<AsyncWriter::Stream> out = writer.open(path, "A,B\n", 2);
+        out->append({1.0 / 3.0, 2.0});
+        out->append({-1e-7, 12345678.0});
+        // Not closed: the writer closes and writes it on destruction
+    }
+    std::vector<std::string> lines = readLines(path);
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[1], "0.333333,2");
+    EXPECT_EQ(lines[2], "-1e-07,1.23457e+07");
+    std::remove(path.c_str());
+}
+
+TEST(AsyncWriterTest, UnwritablePathIsNotOk) {
+    std::string good = tempPath("async_good");
+    AsyncWriter writer;
+    std::shared_ptr<AsyncWriter::Stream> bad =
+        writer.open("/nonexistent_directory/run.csv", "X\n", 1);
+    std::shared_ptr<AsyncWriter::Stream> out = writer.open(good, "X\n", 1);
+    for (int i = 0; i < 100; ++i) {
+        bad->append({static_cast<double>(i)});
+        out->append({static_cast<double>(i)});
+    }
+    bad->close();
+    out->close();
+    bad->wait();
+    out->wait();
+    EXPECT_FALSE(bad->ok());
+    EXPECT_TRUE(out->ok());  // One failed stream does not affect the others
+    EXPECT_EQ(readLines(good).size(), 101u);
+    std::remove(good.c_str());
+}
+
+TEST(AsyncWriterTest, AppendContinuesAnExistingFile) {
+    std::string path = tempPath("async_append");
+    AsyncWriter writer(1, 8, 0);
+    std::shared_ptr<AsyncWriter::Stream> first = writer.open(path, "T,V\n", 2);
+    for (int i = 0; i < 20; ++i) {
+        first->append({static_cast<double>(i), i * 2.0});
+    }
+    first->close();
+    first->wait();
+
+    // Extending a run: no preamble, rows go after the existing ones
+    std::shared_ptr<AsyncWriter::Stream> more = writer.open(path, "", 2, true);
+    for (int i = 20; i < 50; ++i) {
+        more->append({static_cast<double>(i), i * 2.0});
+    }
+    more->close();
+    more->wait();
+    EXPECT_TRUE(more->ok());
+
+    std::vector<std::string> lines = readLines(path);
+    ASSERT_EQ(lines.size(), 51u);
+    EXPECT_EQ(lines[0], "T,V");
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(lines[i + 1], std::to_string(i) + "," + std::to_string(i * 2)) << i;
+    }
+
+    // Without append the file starts over
+    std::shared_ptr<AsyncWriter::Stream> fresh = writer.open(path, "T,V\n", 2);
+    fresh->append({7.0, 8.0});
+    fresh->close();
+    fresh->wait();
+    EXPECT_EQ(readLines(path), (std::vector<std::string>{"T,V", "7,8"}));
+    std::remove(path.c_str());
+}
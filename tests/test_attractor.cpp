@@ -0,0 +1,153 @@
+/*
+ * Tests for the attractor density histogram (Project 2, include/attractor.h)
+ *
+ * Build and run from Project 2: driven damped oscillations/: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "attractor.h"
+#include "thread_pool.h"
+
+namespace {
+
+const std::string path = "/tmp/test_attractor.npy";
+
+uint64_t sum(const std::vector<uint64_t>& values) {
+    uint64_t total = 0;
+    for (uint64_t value : values) {
+        total += value;
+    }
+    return total;
+}
+
+}  // namespace
+
+TEST(AttractorHistogramTest, BinsAndOutsideSamples) {
+    AttractorHistogram histogram(4, 2, 3, -1.0, 1.0);
+    histogram.add(-M_PI, -1.0, 0);  // First cell
+    histogram.add(M_PI, 0.999, 2);  // Angle π in the last angle bin
+    histogram.add(0.1, 0.5, 1);
+    histogram.add(0.1, 1.0, 1);  // Velocity range is half open
+    histogram.add(0.1, -1.5, 1);
+    histogram.add(0.1, NAN, 1);
+
+    EXPECT_EQ(histogram.samples(), 3u);
+    EXPECT_EQ(histogram.samplesOutside(), 3u);
+    EXPECT_EQ(histogram.count(0, 0, 0), 1u);
+    EXPECT_EQ(histogram.count(3, 1, 2), 1u);
+    EXPECT_EQ(histogram.count(2, 1, 1), 1u);
+
+    std::vector<uint64_t> plane = histogram.projection();
+    ASSERT_EQ(plane.size(), 8u);
+    EXPECT_EQ(sum(plane), 3u);
+    EXPECT_EQ(plane[1 * 4 + 2], 1u);  // Velocity-major
+}
+
+TEST(AttractorHistogramTest, MergeAddsCountsAndChecksTheGrid) {
+    AttractorHistogram a(8, 8, 2, -2.0, 2.0), b(8, 8, 2, -2.0, 2.0);
+    for (int i = 0; i < 100; ++i) {
+        a.add(0.03 * i - 1.5, 0.01 * i, i % 2);
+        b.add(0.5, 0.5, 1);
+    }
+    b.add(0.0, 5.0, 0);
+    uint64_t cell = a.count(4, 5, 1);  // Where every sample of b lands
+
+    a.merge(b);
+    EXPECT_EQ(a.samples(), 200u);
+    EXPECT_EQ(a.samplesOutside(), 1u);
+    EXPECT_EQ(a.count(4, 5, 1), cell + 100);
+    EXPECT_EQ(sum(a.projection()), 200u);
+
+    EXPECT_THROW(a.merge(AttractorHistogram(8, 8, 1, -2.0, 2.0)), std::invalid_argument);
+    EXPECT_THROW(a.merge(AttractorHistogram(8, 8, 2, -3.0, 2.0)), std::invalid_argument);
+    EXPECT_THROW(AttractorHistogram(0, 8, 2, -2.0, 2.0), std::invalid_argument);
+    EXPECT_THROW(AttractorHistogram(8, 8, 2, 2.0, 2.0), std::invalid_argument);
+}
+
+TEST(AttractorHistogramTest, AccumulateCountsEveryStepOnAnyPool) {
+    testOscillator osc;
+    std::vector<OscillatorState> starts;
+    for (int i = 0; i < 5; ++i) {
+        OscillatorState start = osc.initial;
+        start.angle += 1e-3 * i;
+        starts.push_back(start);
+    }
+    AttractorHistogram shape(32, 32, 4, -3.5, 3.5);
+    const size_t stepsPerPeriod = 50, transient = 2, periods = 20;
+
+    ThreadPoolOptions one;
+    one.threads = 1;
+    ThreadPool serial(one);
+    AttractorHistogram single = accumulateAttractor(osc.params, starts, stepsPerPeriod,
+                                                    transient, periods, shape, serial);
+    EXPECT_EQ(single.samples() + single.samplesOutside(),
+              starts.size() * periods * stepsPerPeriod);
+
+    ThreadPoolOptions three;
+    three.threads = 3;
+    ThreadPool parallel(three);
+    AttractorHistogram merged = accumulateAttractor(osc.params, starts, stepsPerPeriod,
+                                                    transient, periods, shape, parallel);
+    EXPECT_EQ(merged.samples(), single.samples());
+    EXPECT_EQ(merged.samplesOutside(), single.samplesOutside());
+    for (size_t phase = 0; phase < 4; ++phase) {
+        for (size_t v = 0; v < 32; ++v) {
+            for (size_t a = 0; a < 32; ++a) {
+                ASSERT_EQ(merged.count(a, v, phase), single.count(a, v, phase));
+            }
+        }
+    }
+
+    // Every drive phase bin gets its share of the steps
+    uint64_t binned = 0;
+    for (size_t phase = 0; phase < 4; ++phase) {
+        uint64_t inPhase = 0;
+        for (size_t v = 0; v < 32; ++v) {
+            for (size_t a = 0; a < 32; ++a) {
+                inPhase += single.count(a, v, phase);
+            }
+        }
+        EXPECT_GT(inPhase, single.samples() / 5);
+        binned += inPhase;
+    }
+    EXPECT_EQ(binned, single.samples());
+
+    osc.params.drivingFrequency = 0.0;
+    EXPECT_THROW(accumulateAttractor(osc.params, starts, stepsPerPeriod, transient, periods,
+                                     shape, serial),
+                 std::invalid_argument);
+}
+
+TEST(AttractorHistogramTest, WritesNpy) {
+    AttractorHistogram histogram(3, 2, 2, -1.0, 1.0);
+    histogram.add(0.0, 0.0, 1);
+    histogram.writeNpy(path);
+
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ASSERT_GE(bytes.size(), 10u);
+    EXPECT_EQ(bytes.substr(0, 6), "\x93NUMPY");
+    size_t headerLength = static_cast<unsigned char>(bytes[8]) |
+                          static_cast<size_t>(static_cast<unsigned char>(bytes[9])) << 8;
+    EXPECT_EQ((10 + headerLength) % 64, 0u);
+    EXPECT_NE(bytes.find("'shape': (2, 2, 3)"), std::string::npos);
+    ASSERT_EQ(bytes.size(), 10 + headerLength + 12 * sizeof(uint64_t));
+
+    std::vector<uint64_t> counts(12);
+    std::copy(bytes.end() - 12 * sizeof(uint64_t), bytes.end(),
+              reinterpret_cast<char*>(counts.data()));
+    EXPECT_EQ(counts[(1 * 2 + 1) * 3 + 1], 1u);
+    EXPECT_EQ(sum(counts), 1u);
+    std::remove(path.c_str());
+}
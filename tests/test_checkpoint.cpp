@@ -0,0 +1,128 @@
+/*
+ * Tests for sweep and ensemble checkpoints (include/checkpoint.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "checkpoint.h"
+#include "thread_pool.h"
+
+namespace {
+
+const std::string path = "/tmp/test_checkpoint.checkpoint";
+
+bool exists(const std::string& file) {
+    return static_cast<bool>(std::ifstream(file));
+}
+
+}  // namespace
+
+TEST(CheckpointTest, MissingFileStartsFromScratch) {
+    std::remove(path.c_str());
+    Checkpoint checkpoint(path, 1, 10, 2);
+    EXPECT_FALSE(checkpoint.resume());
+    EXPECT_EQ(checkpoint.doneCount(), 0u);
+    EXPECT_FALSE(checkpoint.isDone(3));
+}
+
+TEST(CheckpointTest, RoundTripIsExact) {
+    uint64_t fingerprint = checkpointHash("inputs", 6);
+    {
+        Checkpoint checkpoint(path, fingerprint, 5, 3);
+        double first[3] = {M_PI, -0.0, 1e-310};
+        double last[3] = {std::nextafter(1.0, 2.0), 42.0, -7.5};
+        checkpoint.complete(0, first);
+        checkpoint.complete(4, last);
+        checkpoint.state() = {0.1, 0.2, 0.30000000000000004};
+        checkpoint.setLabel("Output/sweep3.csv");
+        checkpoint.save();
+        EXPECT_FALSE(exists(path + ".tmp"));  // Renamed into place
+    }
+
+    Checkpoint resumed(path, fingerprint, 5, 3);
+    ASSERT_TRUE(resumed.resume());
+    EXPECT_EQ(resumed.doneCount(), 2u);
+    EXPECT_TRUE(resumed.isDone(0));
+    EXPECT_FALSE(resumed.isDone(2));
+    EXPECT_TRUE(resumed.isDone(4));
+    EXPECT_EQ(resumed.values(0)[0], M_PI);  // Bitwise, not approximately
+    EXPECT_TRUE(std::signbit(resumed.values(0)[1]));
+    EXPECT_EQ(resumed.values(0)[2], 1e-310);
+    EXPECT_EQ(resumed.values(4)[0], std::nextafter(1.0, 2.0));
+    EXPECT_EQ(resumed.state(), (std::vector<double>{0.1, 0.2, 0.30000000000000004}));
+    EXPECT_EQ(resumed.label(), "Output/sweep3.csv");
+
+    resumed.discard();
+    EXPECT_FALSE(exists(path));
+}
+
+TEST(CheckpointTest, RejectsOtherRuns) {
+    Checkpoint original(path, 7, 4, 1);
+    original.save();
+
+    Checkpoint otherInputs(path, 8, 4, 1);
+    EXPECT_THROW(otherInputs.resume(), std::runtime_error);
+    Checkpoint otherSize(path, 7, 5, 1);
+    EXPECT_THROW(otherSize.resume(), std::runtime_error);
+
+    std::ofstream(path) << "NMCKPT01 truncated";
+    Checkpoint truncated(path, 7, 4, 1);
+    EXPECT_THROW(truncated.resume(), std::runtime_error);
+    std::ofstream(path) << "not a checkpoint file at all";
+    EXPECT_THROW(truncated.resume(), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointTest, RejectsCorruptedLengths) {
+    // Header: magic, fingerprint, items, values per item, extra count, label length
+    for (size_t offset : {32, 40}) {
+        Checkpoint original(path, 7, 4, 1);
+        original.setLabel("label");
+        original.save();
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t huge = UINT64_MAX / 2;
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+        file.close();
+
+        Checkpoint corrupted(path, 7, 4, 1);
+        EXPECT_THROW(corrupted.resume(), std::runtime_error) << "offset " << offset;
+    }
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointTest, ConcurrentCompletionWritesConsistentFiles) {
+    std::remove(path.c_str());
+    const size_t items = 400;
+    {
+        // Zero interval: every completion rewrites the file
+        Checkpoint checkpoint(path, 3, items, 2, 0.0);
+        ThreadPool pool;
+        pool.parallelFor(items, 16, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                double values[2] = {static_cast<double>(i), std::sqrt(static_cast<double>(i))};
+                checkpoint.complete(i, values);
+            }
+        });
+        EXPECT_EQ(checkpoint.doneCount(), items);
+    }
+
+    Checkpoint resumed(path, 3, items, 2);
+    ASSERT_TRUE(resumed.resume());
+    EXPECT_EQ(resumed.doneCount(), items);
+    for (size_t i = 0; i < items; ++i) {
+        ASSERT_EQ(resumed.values(i)[0], static_cast<double>(i));
+        ASSERT_EQ(resumed.values(i)[1], std::sqrt(static_cast<double>(i)));
+    }
+    EXPECT_FALSE(exists(path + ".tmp"));
+    resumed.discard();
+}
@@ -0,0 +1,128 @@
+/*
+ * Tests for the projectile cloud collisions (Project 1, include/Collisions.h)
+ *
+ * Build and run from Project 1: realistic projectile motion/: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Collisions.h"
+
+namespace {
+
+ProjectileState stateAt(double x, double y, double z, double vx, double vy, double vz) {
+    ProjectileState state;
+    state.position = Vector4D(x, y, z, 0);
+    state.velocity = Vector3D(vx, vy, vz);
+    return state;
+}
+
+}  // namespace
+
+TEST(SphereTimeOfImpactTest, HeadOn) {
+    // Centres 3 m apart closing at 2 m/s; they touch when 1 m apart
+    Vector3D a(0, 0, 0), b(3, 0, 0);
+    Vector3D va(1, 0, 0), vb(-1, 0, 0);
+    EXPECT_NEAR(sphereTimeOfImpact(a, va, 0.5, b, vb, 0.5, 2.0), 1.0, 1e-12);
+    EXPECT_EQ(sphereTimeOfImpact(a, va, 0.5, b, vb, 0.5, 0.5), -1.0);  // Too late
+    EXPECT_EQ(sphereTimeOfImpact(b, vb, 0.5, a, va, 0.5, 2.0),
+              sphereTimeOfImpact(a, va, 0.5, b, vb, 0.5, 2.0));  // Symmetric
+}
+
+TEST(SphereTimeOfImpactTest, GrazingAndMisses) {
+    // Passing 1 m apart (sum of radii) at closest approach: touches exactly then
+    Vector3D a(0, 0, 0), still(0, 0, 0);
+    EXPECT_NEAR(sphereTimeOfImpact(a, still, 0.5, Vector3D(-4, 1, 0), Vector3D(2, 0, 0), 0.5,
+                                   10.0),
+                2.0, 1e-6);
+    EXPECT_EQ(sphereTimeOfImpact(a, still, 0.5, Vector3D(-4, 1.5, 0), Vector3D(2, 0, 0), 0.5,
+                                 10.0),
+              -1.0);
+    EXPECT_EQ(sphereTimeOfImpact(a, still, 0.5, Vector3D(4, 0, 0), Vector3D(2, 0, 0), 0.5,
+                                 10.0),
+              -1.0);  // Moving apart
+    EXPECT_EQ(sphereTimeOfImpact(a, Vector3D(1, 1, 1), 0.5, Vector3D(4, 0, 0),
+                                 Vector3D(1, 1, 1), 0.5, 10.0),
+              -1.0);  // Same velocity
+}
+
+TEST(SphereTimeOfImpactTest, Overlapping) {
+    Vector3D a(0, 0, 0), b(0.5, 0, 0), still(0, 0, 0);
+    EXPECT_EQ(sphereTimeOfImpact(a, still, 0.5, b, Vector3D(-1, 0, 0), 0.5, 1.0), 0.0);
+    EXPECT_EQ(sphereTimeOfImpact(a, still, 0.5, b, Vector3D(1, 0, 0), 0.5, 1.0), -1.0);
+}
+
+TEST(CollisionGridTest, MatchesBruteForce) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> position(0.0, 20.0);
+    std::uniform_real_distribution<double> velocity(-30.0, 30.0);
+    std::uniform_real_distribution<double> radius(0.05, 0.3);
+    const size_t n = 2000;
+    const double dt = 0.01;
+    std::vector<ProjectileState> states;
+    std::vector<double> radii;
+    for (size_t i = 0; i < n; ++i) {
+        states.push_back(stateAt(position(random), position(random), position(random),
+                                 velocity(random), velocity(random), velocity(random)));
+        radii.push_back(radius(random));
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> expected;
+    for (uint32_t i = 0; i < n; ++i) {
+        for (uint32_t j = i + 1; j < n; ++j) {
+            if (sphereTimeOfImpact(states[i].position, states[i].velocity, radii[i],
+                                   states[j].position, states[j].velocity, radii[j], dt) >= 0.0) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    ASSERT_GT(expected.size(), 10u);  // The test needs some contacts to mean anything
+
+    ThreadPoolOptions options;
+    options.threads = 3;
+    ThreadPool pool(options);
+    CollisionGrid grid;
+    grid.build(states, radii, dt, pool);
+    std::vector<Contact> contacts = grid.findContacts(states, radii, dt, pool);
+
+    std::vector<std::pair<uint32_t, uint32_t>> found;
+    for (size_t k = 0; k < contacts.size(); ++k) {
+        EXPECT_LT(contacts[k].a, contacts[k].b);
+        if (k > 0) {
+            EXPECT_LE(contacts[k - 1].time, contacts[k].time);  // Sorted by time of impact
+        }
+        found.emplace_back(contacts[k].a, contacts[k].b);
+    }
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+    EXPECT_GE(grid.candidatePairs(), expected.size());
+    EXPECT_LT(grid.candidatePairs(), n * (n - 1) / 20);  // Far fewer than all pairs
+}
+
+TEST(CollisionGridTest, OverlappingPairAndEmptyInput) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    CollisionGrid grid;
+    std::vector<ProjectileState> none;
+    std::vector<double> noRadii;
+    grid.build(none, noRadii, 0.01, pool);
+    EXPECT_TRUE(grid.findContacts(none, noRadii, 0.01, pool).empty());
+
+    // Two overlapping spheres still closing, far from a third
+    std::vector<ProjectileState> states = {stateAt(0, 0, 0, 0, 0, 0),
+                                           stateAt(0.15, 0, 0, -1, 0, 0),
+                                           stateAt(100, 100, 100, 0, 0, 0)};
+    std::vector<double> radii = {0.1, 0.1, 0.1};
+    grid.build(states, radii, 0.01, pool);
+    std::vector<Contact> contacts = grid.findContacts(states, radii, 0.01, pool);
+    ASSERT_EQ(contacts.size(), 1u);
+    EXPECT_EQ(contacts[0].a, 0u);
+    EXPECT_EQ(contacts[0].b, 1u);
+    EXPECT_EQ(contacts[0].time, 0.0);
+}
@@ -0,0 +1,133 @@
+/*
+ * Tests for the parallel CSV loader (include/csv_loader.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "csv_loader.h"
+#include "thread_pool.h"
+
+namespace {
+
+const std::string path = "/tmp/test_csv_loader.csv";
+
+CsvTable parseText(const std::string& text, ThreadPool* pool = nullptr) {
+    return CsvTable::parse(text.data(), text.size(), pool);
+}
+
+// Message of the exception parse throws, or an empty string
+std::string parseError(const std::string& text) {
+    try {
+        parseText(text);
+    } catch (const std::runtime_error& error) {
+        return error.what();
+    }
+    return std::string();
+}
+
+}  // namespace
+
+TEST(CsvLoaderTest, ParsesCommentsSpacesAndLineEndings) {
+    CsvTable table = parseText(
+        "# Launches\n"
+        "\n"
+        " vx , vz,mass\r\n"
+        "1.5, 2, 0.145\r\n"
+        "# skipped\n"
+        "\n"
+        "-3e2,+0.25 ,  1e-3\n"
+        "0.1,nan,inf");  // No final newline
+    ASSERT_EQ(table.names(), (std::vector<std::string>{"vx", "vz", "mass"}));
+    ASSERT_EQ(table.rows(), 3u);
+    EXPECT_EQ(table.column("vx"), (std::vector<double>{1.5, -300.0, 0.1}));
+    EXPECT_EQ(table.column("vz")[1], 0.25);
+    EXPECT_TRUE(std::isnan(table.column("vz")[2]));
+    EXPECT_EQ(table.column("mass")[1], 1e-3);
+    EXPECT_TRUE(std::isinf(table.column("mass")[2]));
+
+    EXPECT_TRUE(table.has("mass"));
+    EXPECT_FALSE(table.has("vy"));
+    EXPECT_THROW(table.column("vy"), std::invalid_argument);
+    EXPECT_EQ(table.column("vy", 7.0), (std::vector<double>(3, 7.0)));
+}
+
+TEST(CsvLoaderTest, ParallelChunksMatchSerialExactly) {
+    std::mt19937_64 random(11);
+    std::uniform_real_distribution<double> value(-1e6, 1e6);
+    std::vector<double> a, b;
+    std::string text = "a,b\n";
+    char line[64];
+    for (size_t i = 0; i < 100000; ++i) {
+        a.push_back(value(random));
+        b.push_back(value(random) * 1e-9);
+        std::snprintf(line, sizeof(line), "%.17g,%.17g\n", a.back(), b.back());
+        text += line;
+        if (i % 997 == 0) {
+            text += "# comment inside the body\n";
+        }
+    }
+
+    ThreadPoolOptions options;
+    options.threads = 4;
+    ThreadPool pool(options);
+    CsvTable serial = parseText(text);
+    CsvTable parallel = parseText(text, &pool);
+    ASSERT_EQ(parallel.rows(), a.size());
+    EXPECT_EQ(serial.column("a"), a);  // Round trip of %.17g is exact
+    EXPECT_EQ(serial.column("b"), b);
+    EXPECT_EQ(parallel.column("a"), a);
+    EXPECT_EQ(parallel.column("b"), b);
+}
+
+TEST(CsvLoaderTest, ReportsTheLineOfBadRows) {
+    EXPECT_NE(parseError("x,y\n1,2\n\n3,oops\n").find(":4: bad number 'oops' in column 'y'"),
+              std::string::npos);
+    EXPECT_NE(parseError("#c\nx,y\n1\n").find(":3: expected 2 fields"), std::string::npos);
+    EXPECT_NE(parseError("x,y\n1,2,3\n").find("more than 2 fields"), std::string::npos);
+    EXPECT_NE(parseError("x,y\n1,\n").find("missing value for column 'y'"), std::string::npos);
+    EXPECT_NE(parseError("x,x\n").find("duplicate column 'x'"), std::string::npos);
+    EXPECT_NE(parseError("# only comments\n").find("no header line"), std::string::npos);
+
+    // The first bad row in file order is reported, whichever chunk finds it first
+    std::string text = "v\n";
+    for (int i = 0; i < 200000; ++i) {
+        text += i == 150000 || i == 190000 ? "x\n" : "1\n";
+    }
+    ThreadPool pool;
+    try {
+        parseText(text, &pool);
+        FAIL() << "bad rows were accepted";
+    } catch (const std::runtime_error& error) {
+        EXPECT_NE(std::string(error.what()).find(":150002:"), std::string::npos);
+    }
+}
+
+TEST(CsvLoaderTest, LoadsMappedFiles) {
+    {
+        std::ofstream file(path);
+        file << "x,y,z\n";
+        for (int i = 0; i < 1000; ++i) {
+            file << i << "," << i * 0.5 << "," << -i << "\n";
+        }
+    }
+    ThreadPool pool;
+    CsvTable table = CsvTable::load(path, &pool);
+    ASSERT_EQ(table.rows(), 1000u);
+    EXPECT_EQ(table.column("y")[999], 499.5);
+    EXPECT_EQ(table.column("z")[10], -10.0);
+
+    std::ofstream(path).close();  // Empty file
+    EXPECT_THROW(CsvTable::load(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(CsvTable::load(path), std::runtime_error);
+}
@@ -0,0 +1,170 @@
+/*
+ * Tests for the expression compiler and ODE models (include/expression.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "expression.h"
+
+namespace {
+
+double constant(const std::string& expression) {
+    ExpressionCompiler compiler({});
+    return compiler.evaluateConstant(expression);
+}
+
+const char* pendulumModel = R"(
+# Driven damped pendulum, same numbers as Project 2's testOscillator
+param g = 9.81
+param L = 9.8
+param m = 1.0
+param b = 0.5
+param F = 1.2
+param Omega = 2/3
+state theta = 0.2
+state omega = 0
+let drive = F / m * cos(Omega * t)
+theta' = omega
+omega' = -(g / L) * sin(theta) - b / m * omega + drive
+)";
+
+}  // namespace
+
+TEST(ExpressionTest, PrecedenceAndAssociativity) {
+    EXPECT_DOUBLE_EQ(constant("1 + 2 * 3 ^ 2"), 19.0);
+    EXPECT_DOUBLE_EQ(constant("-2 ^ 2"), -4.0);  // Power binds tighter than unary minus
+    EXPECT_DOUBLE_EQ(constant("2 ^ 3 ^ 2"), 512.0);
+    EXPECT_DOUBLE_EQ(constant("8 / 4 / 2"), 1.0);
+    EXPECT_DOUBLE_EQ(constant("2 ^ -1"), 0.5);
+    EXPECT_DOUBLE_EQ(constant("max(1, 2) + min(-3, 4) * abs(-2)"), -4.0);
+    EXPECT_DOUBLE_EQ(constant("cos(pi)"), -1.0);
+    EXPECT_DOUBLE_EQ(constant("1.5e3 + .5"), 1500.5);
+}
+
+TEST(ExpressionTest, MatchesNativeCode) {
+    ExpressionCompiler compiler({"x", "y"});
+    compiler.addOutput("x * y + sin(x) - max(x, y) / 2");
+    compiler.addOutput("atan2(y, x) + sqrt(x * x + y ^ 2) * exp(-abs(y))");
+    ExpressionProgram program = compiler.finish();
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> value(-3.0, 3.0);
+    for (int i = 0; i < 100; ++i) {
+        double in[2] = {value(random), value(random)};
+        double x = in[0], y = in[1];
+        double out[2];
+        program.evaluate(in, out);
+        EXPECT_DOUBLE_EQ(out[0], x * y + std::sin(x) - std::max(x, y) / 2);
+        EXPECT_DOUBLE_EQ(out[1],
+                         std::atan2(y, x) + std::sqrt(x * x + y * y) * std::exp(-std::fabs(y)));
+    }
+}
+
+TEST(ExpressionTest, FoldsConstantsAndSharesDefinitions) {
+    ExpressionCompiler compiler({"x"});
+    compiler.defineConstant("k", 3.0);
+    compiler.define("s", "sin(x)");
+    compiler.addOutput("x * (2 * pi / k)");  // One multiply: the constant part is folded
+    compiler.addOutput("s * s + s");
+    ExpressionProgram program = compiler.finish();
+
+    size_t sines = 0;
+    for (const Instruction& ins : program.code()) {
+        sines += ins.op == OpCode::Sin;
+    }
+    EXPECT_EQ(sines, 1u);                   // The definition is computed once
+    EXPECT_EQ(program.code().size(), 4u);  // sin, x * c, s * s, + s
+
+    double x = 0.7, out[2];
+    program.evaluate(&x, out);
+    EXPECT_DOUBLE_EQ(out[0], x * (2 * M_PI / 3.0));
+    EXPECT_DOUBLE_EQ(out[1], std::sin(x) * std::sin(x) + std::sin(x));
+}
+
+TEST(ExpressionTest, ReportsErrors) {
+    ExpressionCompiler compiler({"x"});
+    EXPECT_THROW(compiler.addOutput("x +"), ExpressionError);
+    EXPECT_THROW(compiler.addOutput("(x"), ExpressionError);
+    EXPECT_THROW(compiler.addOutput("y"), ExpressionError);
+    EXPECT_THROW(compiler.addOutput("foo(x)"), ExpressionError);
+    EXPECT_THROW(compiler.addOutput("sin(x, x)"), ExpressionError);
+    EXPECT_THROW(compiler.addOutput("x $ 2"), ExpressionError);
+    EXPECT_THROW(compiler.evaluateConstant("x + 1"), ExpressionError);
+    EXPECT_THROW(compiler.defineConstant("x", 1.0), ExpressionError);
+}
+
+TEST(ExpressionTest, BatchMatchesScalar) {
+    ExpressionCompiler compiler({"a", "b", "c"});
+    compiler.addOutput("a * b - c / 3 + tanh(a) * 2");
+    compiler.addOutput("max(a, c) - b");
+    ExpressionProgram program = compiler.finish();
+
+    const size_t count = 1000;  // Not a multiple of the block size
+    std::mt19937 random(5);
+    std::uniform_real_distribution<double> value(-2.0, 2.0);
+    std::vector<double> a(count), b(count), c(count), first(count), second(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = value(random);
+        b[i] = value(random);
+        c[i] = value(random);
+    }
+    const double* inputs[3] = {a.data(), b.data(), c.data()};
+    double* outputs[2] = {first.data(), second.data()};
+    program.evaluateBatch(count, inputs, outputs);
+
+    for (size_t i = 0; i < count; ++i) {
+        double in[3] = {a[i], b[i], c[i]}, out[2];
+        program.evaluate(in, out);
+        EXPECT_EQ(first[i], out[0]) << "lane " << i;
+        EXPECT_EQ(second[i], out[1]) << "lane " << i;
+    }
+}
+
+TEST(OdeModelTest, PendulumMatchesNativeEquation) {
+    std::istringstream in(pendulumModel);
+    OdeModel model = OdeModel::parse(in);
+    ASSERT_EQ(model.dimension(), 2u);
+    EXPECT_EQ(model.stateNames()[1], "omega");
+    EXPECT_DOUBLE_EQ(model.initialState()[0], 0.2);
+
+    auto native = [](double t, double theta, double omega, double F) {
+        return -(9.81 / 9.8) * std::sin(theta) - (0.5 / 1.0) * omega +
+               (F / 1.0) * std::cos(2.0 / 3.0 * t);
+    };
+    double state[2] = {0.3, -0.1}, out[2];
+    model.derivatives(1.7, state, out);
+    EXPECT_DOUBLE_EQ(out[0], -0.1);
+    EXPECT_NEAR(out[1], native(1.7, 0.3, -0.1, 1.2), 1e-15);
+
+    model.setParameter("F", 0.0);
+    EXPECT_DOUBLE_EQ(model.parameter("F"), 0.0);
+    model.derivatives(1.7, state, out);
+    EXPECT_NEAR(out[1], native(1.7, 0.3, -0.1, 0.0), 1e-15);
+    EXPECT_THROW(model.setParameter("nope", 1.0), ExpressionError);
+}
+
+TEST(OdeModelTest, ErrorsNameTheLine) {
+    std::istringstream missing("state x = 1\nstate v = 0\nx' = v\n");
+    try {
+        OdeModel::parse(missing);
+        FAIL() << "missing derivative accepted";
+    } catch (const ExpressionError& error) {
+        EXPECT_NE(std::string(error.what()).find("'v'"), std::string::npos) << error.what();
+    }
+
+    std::istringstream typo("state x = 1\nx' = -k * x\n");
+    try {
+        OdeModel::parse(typo);
+        FAIL() << "unknown name accepted";
+    } catch (const ExpressionError& error) {
+        EXPECT_EQ(std::string(error.what()).rfind("line 2:", 0), 0u) << error.what();
+    }
+}
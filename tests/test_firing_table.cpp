@@ -0,0 +1,176 @@
+/*
+ * Tests for the firing table and its interpolated lookup (Project 1, include/FiringTable.h)
+ *
+ * Build and run from Project 1: realistic projectile motion/: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "FiringTable.h"
+
+namespace {
+
+const std::string path = "/tmp/test_firing_table.bin";
+
+// Bytes before the first axis record (magic, axis and field counts, 17 header doubles),
+// and the size of one record (parameter, padding, count, min, max)
+const size_t axesOffset = 8 + 4 + 4 + 17 * 8;
+const size_t axisRecord = 32;
+
+std::vector<TableAxis> speedAndElevation() {
+    return {TableAxis{TableParameter::Speed, 20.0, 40.0, 5},
+            TableAxis{TableParameter::Elevation, 10.0, 70.0, 13}};
+}
+
+FiringTable buildTable(ThreadPool& pool) {
+    Baseball ball(Vector4D(0, 0, 1, 0), Vector3D(0, 0, 0), Vector3D(0, 0, 0));
+    return FiringTable::build(ball, speedAndElevation(), 0.001, 60.0, pool);
+}
+
+std::string readFile(const std::string& name) {
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& name, const std::string& bytes) {
+    std::ofstream out(name, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size());
+}
+
+}  // namespace
+
+TEST(FiringTableTest, SaveLoadRoundTrip) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    FiringTable table = buildTable(pool);
+    ASSERT_EQ(table.size(), 5u * 13u);
+    ASSERT_TRUE(table.save(path));
+
+    FiringTable loaded;
+    ASSERT_TRUE(loaded.load(path));
+    std::remove(path.c_str());
+    ASSERT_EQ(loaded.size(), table.size());
+    ASSERT_EQ(loaded.getAxes().size(), 2u);
+    for (size_t d = 0; d < 2; ++d) {
+        EXPECT_EQ(loaded.getAxes()[d].parameter, table.getAxes()[d].parameter);
+        EXPECT_EQ(loaded.getAxes()[d].count, table.getAxes()[d].count);
+        EXPECT_EQ(loaded.getAxes()[d].min, table.getAxes()[d].min);
+        EXPECT_EQ(loaded.getAxes()[d].max, table.getAxes()[d].max);
+    }
+    for (std::vector<double> point : {std::vector<double>{20.0, 10.0},
+                                      std::vector<double>{27.3, 44.1},
+                                      std::vector<double>{40.0, 70.0}}) {
+        FiringSolution a = table.lookup(point), b = loaded.lookup(point);
+        EXPECT_EQ(a.flightTime, b.flightTime);
+        EXPECT_EQ(a.range, b.range);
+        EXPECT_EQ(a.impactX, b.impactX);
+        EXPECT_EQ(a.impactY, b.impactY);
+
+        FiringSolution direct = table.simulate(point), reloaded = loaded.simulate(point);
+        EXPECT_EQ(direct.range, reloaded.range);  // Same projectile and launch after loading
+    }
+}
+
+TEST(FiringTableTest, LookupMatchesDirectFlights) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    FiringTable table = buildTable(pool);
+
+    // Exact at the nodes
+    FiringSolution node = table.lookup({25.0, 40.0});
+    FiringSolution direct = table.simulate({25.0, 40.0});
+    EXPECT_EQ(node.range, direct.range);
+    EXPECT_EQ(node.flightTime, direct.flightTime);
+
+    // Between nodes, within a small fraction of the range (5 m/s and 5° spacing)
+    for (std::vector<double> point : {std::vector<double>{22.5, 12.5},
+                                      std::vector<double>{31.0, 47.0},
+                                      std::vector<double>{38.7, 66.2}}) {
+        FiringSolution interpolated = table.lookup(point);
+        FiringSolution flight = table.simulate(point);
+        EXPECT_NEAR(interpolated.range, flight.range, 0.01 * flight.range);
+        EXPECT_NEAR(interpolated.flightTime, flight.flightTime, 0.01 * flight.flightTime);
+    }
+
+    FiringTableError error = table.measureError(50, pool);
+    EXPECT_EQ(error.samples, 50u);
+    EXPECT_LE(error.meanRangeError, error.maxRangeError);
+    EXPECT_LT(error.maxRangeError, 1.0);
+    EXPECT_LT(error.maxTimeError, 0.02);
+}
+
+TEST(FiringTableTest, RejectsBadAxesAndPoints) {
+    ThreadPoolOptions options;
+    options.threads = 1;
+    ThreadPool pool(options);
+    Baseball ball(Vector4D(0, 0, 1, 0), Vector3D(0, 0, 0), Vector3D(0, 0, 0));
+    std::vector<TableAxis> repeated = speedAndElevation();
+    repeated.push_back(TableAxis{TableParameter::Speed, 1.0, 2.0, 2});
+    EXPECT_THROW(FiringTable::build(ball, repeated, 0.01, 60.0, pool), std::invalid_argument);
+    std::vector<TableAxis> empty = {TableAxis{TableParameter::WindX, -5.0, 5.0, 0}};
+    EXPECT_THROW(FiringTable::build(ball, empty, 0.01, 60.0, pool), std::invalid_argument);
+
+    FiringTable table = buildTable(pool);
+    EXPECT_THROW(table.lookup({30.0}), std::invalid_argument);
+    EXPECT_THROW(table.lookup({30.0, 45.0, 1.0}), std::invalid_argument);
+    EXPECT_THROW(table.simulate({30.0}), std::invalid_argument);
+}
+
+TEST(FiringTableTest, LoadRejectsCorruptFiles) {
+    ThreadPoolOptions options;
+    options.threads = 1;
+    ThreadPool pool(options);
+    ASSERT_TRUE(buildTable(pool).save(path));
+    const std::string good = readFile(path);
+    FiringTable table;
+
+    // Far more nodes than the file holds, and axis counts whose product overflows: both
+    // must fail before anything is allocated
+    std::string bytes = good;
+    uint64_t tooMany = 1000;
+    bytes.replace(axesOffset + 8, sizeof(tooMany), reinterpret_cast<const char*>(&tooMany),
+                  sizeof(tooMany));
+    writeFile(path, bytes);
+    EXPECT_FALSE(table.load(path));
+
+    writeFile(path, good.substr(0, good.size() - 1));
+    EXPECT_FALSE(table.load(path));
+
+    // Repeated axis
+    bytes = good;
+    bytes.replace(axesOffset + axisRecord, 4, good, axesOffset, 4);
+    writeFile(path, bytes);
+    EXPECT_FALSE(table.load(path));
+
+    Baseball ball(Vector4D(0, 0, 1, 0), Vector3D(0, 0, 0), Vector3D(0, 0, 0));
+    std::vector<TableAxis> four = {TableAxis{TableParameter::Speed, 20.0, 40.0, 2},
+                                   TableAxis{TableParameter::Elevation, 10.0, 70.0, 2},
+                                   TableAxis{TableParameter::WindX, -5.0, 5.0, 2},
+                                   TableAxis{TableParameter::Backspin, 0.0, 100.0, 2}};
+    ASSERT_TRUE(FiringTable::build(ball, four, 0.01, 60.0, pool).save(path));
+    bytes = readFile(path);
+    uint64_t huge = uint64_t(1) << 24;  // Largest count per axis; 2^96 nodes in all
+    for (size_t d = 0; d < four.size(); ++d) {
+        bytes.replace(axesOffset + d * axisRecord + 8, sizeof(huge),
+                      reinterpret_cast<const char*>(&huge), sizeof(huge));
+    }
+    writeFile(path, bytes);
+    EXPECT_FALSE(table.load(path));
+
+    EXPECT_EQ(table.size(), 0u);  // Failed loads leave the table alone
+    writeFile(path, good);
+    EXPECT_TRUE(table.load(path));
+    EXPECT_EQ(table.size(), 5u * 13u);
+    std::remove(path.c_str());
+}
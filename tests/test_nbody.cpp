@@ -0,0 +1,115 @@
+/*
+ * Tests for the shared particle system, leapfrog integrator and Barnes-Hut tree
+ * (include/particle.h, include/integrator.h, include/barnes_hut.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "barnes_hut.h"
+#include "integrator.h"
+#include "particle.h"
+
+TEST(NBodyTest, BlockedKernelMatchesReference) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    GravitySettings gravity;
+
+    // Not a multiple of the block or lane width, so the padded lanes are exercised
+    ParticleSystem reference = ParticleSystem::plummer(1037, 7);
+    ParticleSystem blocked = reference;
+    computeGravityDirect(reference, gravity, pool);
+    computeGravityBlocked(blocked, gravity, pool);
+
+    for (size_t i = 0; i < reference.size(); ++i) {
+        double difference = (reference.acceleration(i) - blocked.acceleration(i)).magnitude();
+        EXPECT_LT(difference, 1e-12 * reference.acceleration(i).magnitude()) << "particle " << i;
+    }
+}
+
+TEST(NBodyTest, LeapfrogKeepsCircularBinary) {
+    // Two equal masses on a circular orbit: separation 1, G = 1, total mass 2
+    ParticleSystem binary;
+    double speed = std::sqrt(0.5);  // v² = G m / (2 d) with m = 1, d = 1
+    binary.add(Vector3D(0.5, 0, 0), Vector3D(0, speed, 0), 1.0);
+    binary.add(Vector3D(-0.5, 0, 0), Vector3D(0, -speed, 0), 1.0);
+
+    ThreadPoolOptions options;
+    options.threads = 1;
+    ThreadPool pool(options);
+    GravitySettings gravity;
+    gravity.softening = 1e-9;
+    LeapfrogIntegrator leapfrog(
+        [&](ParticleSystem& p) { computeGravityBlocked(p, gravity, pool); });
+
+    double initial = binary.kineticEnergy() + binary.potentialEnergy(1.0, gravity.softening);
+    double period = 2.0 * M_PI * 0.5 / speed;  // Each body circles the centre at radius 0.5
+    size_t steps = 2000;
+    leapfrog.run(binary, period / steps, steps);
+
+    double energy = binary.kineticEnergy() + binary.potentialEnergy(1.0, gravity.softening);
+    EXPECT_NEAR(energy, initial, 1e-5 * std::fabs(initial));
+    EXPECT_NEAR(binary.x[0], 0.5, 1e-3);  // Back where it started after one period
+    EXPECT_NEAR(binary.y[0], 0.0, 1e-3);
+    EXPECT_NEAR(binary.momentum().magnitude(), 0.0, 1e-12);
+    EXPECT_EQ(leapfrog.steps(), steps);
+}
+
+TEST(NBodyTest, BarnesHutWithZeroThetaIsExact) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    GravitySettings gravity;
+
+    // Large enough for the parallel subtree build and splice
+    ParticleSystem direct = ParticleSystem::plummer(3000, 3);
+    ParticleSystem tree = direct;
+    computeGravityDirect(direct, gravity, pool);
+
+    BarnesHutSettings settings;
+    settings.theta = 0.0;  // Never accept a cell: every leaf is summed directly
+    BarnesHutTree octree(settings);
+    octree.computeGravity(tree, gravity, pool);
+
+    for (size_t i = 0; i < direct.size(); ++i) {
+        double difference = (direct.acceleration(i) - tree.acceleration(i)).magnitude();
+        EXPECT_LT(difference, 1e-12 * direct.acceleration(i).magnitude()) << "particle " << i;
+    }
+}
+
+TEST(NBodyTest, BarnesHutErrorShrinksWithTheta) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    GravitySettings gravity;
+
+    ParticleSystem direct = ParticleSystem::plummer(5000, 11);
+    computeGravityDirect(direct, gravity, pool);
+
+    std::vector<double> medians;
+    for (double theta : {1.0, 0.5, 0.25}) {
+        ParticleSystem tree = direct;
+        BarnesHutSettings settings;
+        settings.theta = theta;
+        BarnesHutTree octree(settings);
+        octree.computeGravity(tree, gravity, pool);
+
+        std::vector<double> errors;
+        for (size_t i = 0; i < direct.size(); ++i) {
+            errors.push_back((direct.acceleration(i) - tree.acceleration(i)).magnitude() /
+                             direct.acceleration(i).magnitude());
+        }
+        std::nth_element(errors.begin(), errors.begin() + errors.size() / 2, errors.end());
+        medians.push_back(errors[errors.size() / 2]);
+    }
+    EXPECT_LT(medians[0], 5e-2);
+    EXPECT_LT(medians[1], medians[0]);
+    EXPECT_LT(medians[2], medians[1]);
+    EXPECT_LT(medians[2], 1e-3);
+}
@@ -0,0 +1,102 @@
+/*
+ * Tests for the libnumerical C API
+ *
+ * Build and run from libnumerical/: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "numerical_api.h"
+
+namespace {
+
+nm_projectile_params dragFreeParams() {
+    // Same setup as valadationWithoutAirResistance in Project 1
+    return nm_projectile_params{{0, 0, 0, 10}, {15, 5, 15}, {0, 0, 0}, 1.0, 0.1, 0.0, 0.0, 0.0};
+}
+
+}  // namespace
+
+TEST(NumericalApiTest, VersionMatchesHeader) {
+    EXPECT_EQ(nm_api_version(), NM_API_VERSION);
+    EXPECT_STREQ(nm_status_string(NM_OK), "ok");
+}
+
+TEST(NumericalApiTest, ProjectileSizeQueryAndTruncation) {
+    nm_projectile_params params = dragFreeParams();
+    nm_projectile* proj = nullptr;
+    ASSERT_EQ(nm_projectile_create(&params, &proj), NM_OK);
+
+    nm_vec3 wind{0, 0, 0};
+    size_t count = 0;
+    EXPECT_EQ(nm_projectile_simulate(proj, 0.001, wind, 10.0, nullptr, 0, &count),
+              NM_ERR_BUFFER_TOO_SMALL);
+    ASSERT_GT(count, 1u);
+
+    std::vector<nm_point> small(10);
+    size_t total = 0;
+    EXPECT_EQ(nm_projectile_simulate(proj, 0.001, wind, 10.0, small.data(), small.size(), &total),
+              NM_ERR_BUFFER_TOO_SMALL);
+    EXPECT_EQ(total, count);
+
+    std::vector<nm_point> points(count);
+    ASSERT_EQ(nm_projectile_simulate(proj, 0.001, wind, 10.0, points.data(), count, &total),
+              NM_OK);
+    EXPECT_DOUBLE_EQ(points.front().z, 10.0);
+    EXPECT_DOUBLE_EQ(small[9].x, points[9].x);
+
+    // Handle is not consumed by a simulation: the impact call sees the same launch
+    nm_point impact{};
+    ASSERT_EQ(nm_projectile_impact(proj, 0.001, wind, 10.0, &impact), NM_OK);
+    EXPECT_DOUBLE_EQ(impact.t, points.back().t);
+    // Drag-free flight time from z = 10 with vz = 15: (15 + sqrt(15^2 + 2 g 10)) / g
+    EXPECT_NEAR(impact.t, 3.62, 0.01);
+
+    nm_projectile_destroy(proj);
+}
+
+TEST(NumericalApiTest, RejectsInvalidArguments) {
+    nm_projectile_params params = dragFreeParams();
+    params.mass = 0.0;
+    nm_projectile* proj = nullptr;
+    EXPECT_EQ(nm_projectile_create(&params, &proj), NM_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(proj, nullptr);
+
+    size_t count = 0;
+    EXPECT_EQ(nm_oscillator_simulate(nullptr, 0.04, 1.0, nullptr, 0, &count),
+              NM_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(nm_collatz(0, nullptr, nullptr), NM_ERR_INVALID_ARGUMENT);
+}
+
+TEST(NumericalApiTest, OscillatorMatchesProjectTwoDefaults) {
+    nm_oscillator_params params{1.0, 9.8, 0.5, 0.2, 0.0, 1.2, 2.0 / 3.0};
+    nm_oscillator* osc = nullptr;
+    ASSERT_EQ(nm_oscillator_create(&params, &osc), NM_OK);
+
+    size_t count = 0;
+    nm_oscillator_simulate(osc, 0.04, 180.0, nullptr, 0, &count);
+    std::vector<nm_oscillator_sample> samples(count);
+    ASSERT_EQ(nm_oscillator_simulate(osc, 0.04, 180.0, samples.data(), count, &count), NM_OK);
+    EXPECT_DOUBLE_EQ(samples.front().angle, 0.2);
+    EXPECT_GE(samples.back().t, 180.0);
+    nm_oscillator_destroy(osc);
+}
+
+TEST(NumericalApiTest, CollatzKnownValuesAndOverflow) {
+    uint64_t steps = 0;
+    uint64_t peak = 0;
+    ASSERT_EQ(nm_collatz(27, &steps, &peak), NM_OK);
+    EXPECT_EQ(steps, 111u);
+    EXPECT_EQ(peak, 9232u);
+
+    std::vector<uint64_t> range(4);
+    ASSERT_EQ(nm_collatz_range(1, range.size(), range.data(), nullptr), NM_OK);
+    EXPECT_EQ(range[0], 0u);
+    EXPECT_EQ(range[1], 1u);
+    EXPECT_EQ(range[2], 7u);
+    EXPECT_EQ(range[3], 2u);
+
+    EXPECT_EQ(nm_collatz(UINT64_MAX, &steps, &peak), NM_ERR_OVERFLOW);
+}
@@ -0,0 +1,93 @@
+/*
+ * Tests for the summary-only flight and the launch optimizer (Project 1, include/Optimizer.h)
+ *
+ * Build and run from Project 1: realistic projectile motion/: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Optimizer.h"
+#include "Processing.h"
+
+namespace {
+
+const double g = ProjectileParams::GRAVITY;
+
+ProjectileState launchAt(double speed, double elevationDeg) {
+    double angle = elevationDeg * M_PI / 180.0;
+    ProjectileState state;
+    state.position = Vector4D(0, 0, 0, 0);
+    state.velocity = Vector3D(speed * std::cos(angle), 0, speed * std::sin(angle));
+    return state;
+}
+
+}  // namespace
+
+TEST(FlightSummaryTest, VacuumMatchesAnalyticRangeAndTime) {
+    ProjectileParams vacuum;  // No air, no spin
+    for (double elevation : {10.0, 30.0, 45.0, 60.0, 80.0}) {
+        const double speed = 30.0, angle = elevation * M_PI / 180.0;
+        FlightSummary flight =
+            rk4Flight(vacuum, launchAt(speed, elevation), 0.001, Vector3D(0, 0, 0), 60.0);
+        ASSERT_TRUE(flight.landed);
+
+        // RK4 is exact for a parabola, so only the linear landing interpolation is off
+        double time = 2.0 * speed * std::sin(angle) / g;
+        EXPECT_NEAR(flight.impact.t, time, 1e-6) << elevation << " degrees";
+        EXPECT_NEAR(flight.range, speed * speed * std::sin(2.0 * angle) / g, 1e-5)
+            << elevation << " degrees";
+        EXPECT_EQ(flight.impact.z, 0.0);
+        EXPECT_EQ(flight.steps, static_cast<size_t>(std::ceil(time / 0.001)));
+    }
+}
+
+TEST(FlightSummaryTest, StopsAtMaxTime) {
+    ProjectileParams vacuum;
+    FlightSummary flight =
+        rk4Flight(vacuum, launchAt(30.0, 45.0), 0.01, Vector3D(0, 0, 0), 1.0);
+    EXPECT_FALSE(flight.landed);
+    EXPECT_NEAR(flight.impact.t, 1.0, 1e-9);
+    EXPECT_GT(flight.impact.z, 0.0);
+}
+
+TEST(OptimizerTest, VacuumOptimumIsFortyFiveDegrees) {
+    LaunchSearchCase search{std::make_shared<const ProjectileParams>(), Vector4D(0, 0, 0, 0),
+                            30.0, Vector3D(0, 0, 0)};
+    SearchSettings settings;
+    LaunchOptimum best = optimizeAngle(search, settings);
+    EXPECT_NEAR(best.elevation, 45.0, 0.01);
+    EXPECT_NEAR(best.range, 30.0 * 30.0 / g, 1e-4);
+    // The range is flat at the top, the flight time is not: check it at the angle found
+    EXPECT_NEAR(best.flightTime, 2.0 * 30.0 * std::sin(best.elevation * M_PI / 180.0) / g, 1e-6);
+    EXPECT_LT(best.angleCurvature, 0.0);
+    EXPECT_LE(best.evaluations, settings.maxEvaluations);
+
+    // Drag brings the optimum below 45°
+    ProjectileParams air;
+    air.setAirDensity(1.225);
+    search.params = std::make_shared<const ProjectileParams>(air);
+    EXPECT_LT(optimizeAngle(search, settings).elevation, 44.0);
+}
+
+TEST(OptimizerTest, ParallelCasesMatchSingleSearches) {
+    std::vector<LaunchSearchCase> cases;
+    for (double speed : {10.0, 20.0, 40.0}) {
+        cases.push_back(LaunchSearchCase{std::make_shared<const ProjectileParams>(),
+                                         Vector4D(0, 0, 0, 0), speed, Vector3D(0, 0, 0)});
+    }
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    SearchSettings settings;
+    std::vector<LaunchOptimum> results = optimizeLaunches(cases, settings, false, pool);
+    ASSERT_EQ(results.size(), cases.size());
+    for (size_t i = 0; i < cases.size(); ++i) {
+        LaunchOptimum single = optimizeAngle(cases[i], settings);
+        EXPECT_EQ(results[i].elevation, single.elevation);
+        EXPECT_EQ(results[i].range, single.range);
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * Tests for the pendulum RK4 step and its wrapped angle (Project 2, include/oscillator.h)
+ *
+ * Build and run from Project 2: driven damped oscillations/: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "oscillator.h"
+
+namespace {
+
+// Undamped and undriven, g / L = 1
+OscillatorParams freePendulum() {
+    return OscillatorParams{1.0, OscillatorParams::gravity, 0.0, 0.0, 2.0 / 3.0};
+}
+
+bool wrapped(double angle) {
+    return angle > -M_PI && angle <= M_PI;
+}
+
+}  // namespace
+
+TEST(OscillatorStepTest, WrapsOverTheTop) {
+    OscillatorParams params = freePendulum();
+    const double dt = 0.01;
+
+    // Just below the top moving forward: the step crosses π
+    OscillatorState state{0.0, M_PI - 0.005, 1.0};
+    OscillatorState next = rk4Step(params, state, dt);
+    EXPECT_TRUE(wrapped(next.angle));
+    EXPECT_LT(next.angle, 0.0);
+    EXPECT_EQ(next.turns, 1);
+    EXPECT_NEAR(next.unwrappedAngle(), state.unwrappedAngle() + 0.01, 1e-4);
+
+    // And back
+    OscillatorState back = rk4Step(params, OscillatorState{0.0, next.angle, -1.0, 1}, dt);
+    EXPECT_EQ(back.turns, 0);
+    EXPECT_TRUE(wrapped(back.angle));
+    EXPECT_GT(back.angle, 0.0);
+}
+
+TEST(OscillatorStepTest, UnwrappedAngleIsContinuous) {
+    // Rotating forward: ω²/2 > 2 g/L, so every turn passes the top
+    OscillatorParams params = freePendulum();
+    const double dt = 0.01;
+    OscillatorState state{0.0, 0.0, 3.0};
+    double travelled = 0.0;
+    for (int step = 0; step < 20000; ++step) {
+        OscillatorState next = rk4Step(params, state, dt);
+        ASSERT_TRUE(wrapped(next.angle)) << "step " << step;
+        double change = next.unwrappedAngle() - state.unwrappedAngle();
+        ASSERT_GT(change, 0.0) << "step " << step;
+        ASSERT_LT(change, 3.0 * dt + 1e-9) << "step " << step;  // Never a jump of 2π
+        travelled += change;
+        state = next;
+    }
+    EXPECT_GT(state.turns, 20);
+    EXPECT_NEAR(state.unwrappedAngle(), travelled, 1e-9 * travelled);
+
+    // Energy is conserved to RK4 accuracy, turn after turn: the wrapped angle loses no
+    // precision in sin(angle)
+    double energy = 0.5 * state.angularVelocity * state.angularVelocity - std::cos(state.angle);
+    EXPECT_NEAR(energy, 0.5 * 9.0 - 1.0, 1e-6);
+}
+
+TEST(OscillatorStepTest, BackwardRotationCountsNegativeTurns) {
+    OscillatorParams params = freePendulum();
+    OscillatorState state{0.0, 0.0, -3.0};
+    for (int step = 0; step < 5000; ++step) {
+        state = rk4Step(params, state, 0.01);
+    }
+    EXPECT_LT(state.turns, -3);
+    EXPECT_TRUE(wrapped(state.angle));
+    EXPECT_LT(state.unwrappedAngle(), -2.0 * M_PI * 3);
+}
+
+TEST(OscillatorStepTest, OscillationNeverWraps) {
+    OscillatorParams params = freePendulum();
+    OscillatorState state{0.0, 1.0, 0.0};
+    for (int step = 0; step < 5000; ++step) {
+        state = rk4Step(params, state, 0.01);
+        ASSERT_EQ(state.turns, 0);
+    }
+    EXPECT_EQ(state.unwrappedAngle(), state.angle);
+}
+
+TEST(OscillatorStepTest, WrapsLargeAndNonFiniteAngles) {
+    // A state saved unwrapped: every whole turn is taken out in one go
+    OscillatorState state{0.0, 1000.0 * 2.0 * M_PI + 0.25, 0.0, 3};
+    wrapAngle(state);
+    EXPECT_NEAR(state.angle, 0.25, 1e-9);
+    EXPECT_EQ(state.turns, 1003);
+
+    state = OscillatorState{0.0, -1e6, 0.0};
+    wrapAngle(state);
+    EXPECT_TRUE(wrapped(state.angle));
+    EXPECT_NEAR(state.unwrappedAngle(), -1e6, 1e-6);
+
+    // The ends of the interval
+    state = OscillatorState{0.0, 3.0 * M_PI, 0.0};
+    wrapAngle(state);
+    EXPECT_TRUE(wrapped(state.angle));
+    EXPECT_EQ(state.turns, 1);
+    state = OscillatorState{0.0, -M_PI, 0.0};
+    wrapAngle(state);
+    EXPECT_EQ(state.angle, M_PI);
+    EXPECT_EQ(state.turns, -1);
+
+    // Non-finite angles are left alone instead of looping forever
+    for (double bad : {INFINITY, -INFINITY, NAN}) {
+        state = OscillatorState{0.0, bad, 0.0, 2};
+        wrapAngle(state);
+        EXPECT_EQ(state.turns, 2);
+        EXPECT_FALSE(std::isfinite(state.angle));
+    }
+    OscillatorParams params = freePendulum();
+    params.drivingForce = 1e308;
+    state = OscillatorState{0.0, 0.0, 1e308};
+    for (int step = 0; step < 10; ++step) {
+        state = rk4Step(params, state, 0.01);
+    }
+    EXPECT_FALSE(std::isfinite(state.angle));
+}
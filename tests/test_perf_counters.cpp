@@ -0,0 +1,101 @@
+/*
+ * Tests for the hardware counter profile (include/perf_counters.h)
+ *
+ * Counters are often unavailable (virtual machines, containers, strict
+ * perf_event_paranoid); the tests check both outcomes are handled.
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "perf_counters.h"
+#include "thread_pool.h"
+
+namespace {
+
+double busyLoop(int iterations) {
+    volatile double sum = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        sum = sum + std::sqrt(static_cast<double>(i));
+    }
+    return sum;
+}
+
+}  // namespace
+
+TEST(PerfCountersTest, CountsOrExplainsWhyNot) {
+    PerfCounters counters;
+    if (!counters.available()) {
+        EXPECT_FALSE(counters.error().empty());
+        PerfSample sample = counters.read();
+        EXPECT_FALSE(sample.measured[PerfCycles]);
+        EXPECT_TRUE(std::isnan(sample.ipc()));
+        return;
+    }
+    PerfSample before = counters.read();
+    busyLoop(1000000);
+    PerfSample after = counters.read();
+    ASSERT_TRUE(after.measured[PerfInstructions]);
+    EXPECT_GT(after.counts[PerfInstructions] - before.counts[PerfInstructions], 1e6);
+    EXPECT_GT(after.counts[PerfCycles], before.counts[PerfCycles]);
+    EXPECT_GT(after.ipc(), 0.0);
+}
+
+TEST(PerfCountersTest, SampleRatiosNeedBothEvents) {
+    PerfSample sample;
+    sample.counts[PerfInstructions] = 3000.0;
+    sample.measured[PerfInstructions] = true;
+    EXPECT_TRUE(std::isnan(sample.ipc()));  // Cycles not measured
+    sample.counts[PerfCycles] = 1000.0;
+    sample.measured[PerfCycles] = true;
+    EXPECT_DOUBLE_EQ(sample.ipc(), 3.0);
+    sample.counts[PerfCacheMisses] = 30.0;
+    sample.measured[PerfCacheMisses] = true;
+    EXPECT_DOUBLE_EQ(sample.cacheMissesPerKilo(), 10.0);
+
+    PerfSample total;
+    total += sample;
+    total += sample;
+    EXPECT_DOUBLE_EQ(total.counts[PerfCycles], 2000.0);
+    EXPECT_DOUBLE_EQ(total.ipc(), 3.0);
+}
+
+TEST(PerfCountersTest, ProfileCollectsScopesFromEveryThread) {
+    {
+        PerfScope ignored("disabled");  // Profiling is off: not recorded
+    }
+    PerfProfile::enable();
+    ThreadPoolOptions options;
+    options.threads = 3;
+    ThreadPool pool(options);
+    pool.parallelFor(12, 1, [](size_t, size_t, size_t) {
+        PerfScope scope("busy loop");
+        busyLoop(20000);
+    });
+    {
+        PerfScope scope("main thread");
+        busyLoop(20000);
+    }
+
+    auto kernels = PerfProfile::kernels();
+    ASSERT_EQ(kernels.size(), 2u);
+    EXPECT_EQ(kernels[0].first, "busy loop");
+    EXPECT_EQ(kernels[0].second.calls, 12u);
+    EXPECT_GT(kernels[0].second.seconds, 0.0);
+    EXPECT_EQ(kernels[1].second.calls, 1u);
+
+    std::ostringstream table;
+    PerfProfile::print(table);
+    EXPECT_NE(table.str().find("busy loop"), std::string::npos);
+    EXPECT_NE(table.str().find("IPC"), std::string::npos);
+    if (!PerfProfile::unavailableReason().empty()) {
+        EXPECT_NE(table.str().find("wall time only"), std::string::npos);
+    }
+    PerfProfile::reset();
+    EXPECT_TRUE(PerfProfile::kernels().empty());
+}
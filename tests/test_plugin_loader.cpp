@@ -0,0 +1,136 @@
+/*
+ * Tests for the model plugin loader (include/plugin_loader.h) using the example
+ * plugins in plugins/
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "plugin_loader.h"
+
+namespace {
+
+const std::string pluginDir = "bin/plugins";
+
+double duffingAcceleration(double t, double x, double v) {
+    return 0.5 * std::cos(1.2 * t) - 0.3 * v + x - x * x * x;
+}
+
+}  // namespace
+
+TEST(PluginLoaderTest, LoadsOdeModel) {
+    PluginRegistry registry;
+    ASSERT_EQ(registry.load(pluginDir + "/duffing.so"), 1u);
+    const PluginModel* found = registry.find("duffing", NM_MODEL_ODE);
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(registry.find("duffing", NM_MODEL_ACCELERATION), nullptr);
+
+    PluginModel model = *found;
+    EXPECT_EQ(model.stateSize(), 2u);
+    EXPECT_EQ(model.outputSize(), 2u);
+    EXPECT_EQ(model.stateNames(), (std::vector<std::string>{"x", "v"}));
+    EXPECT_EQ(model.initialState(), (std::vector<double>{1.0, 0.0}));
+    EXPECT_EQ(model.parameterNames().size(), model.parameters().size());
+
+    double state[2] = {0.4, -0.2}, out[2];
+    model.evaluate(2.5, state, out);
+    EXPECT_DOUBLE_EQ(out[0], -0.2);
+    EXPECT_NEAR(out[1], duffingAcceleration(2.5, 0.4, -0.2), 1e-15);
+
+    // Parameters belong to the copy, not to the registry's model
+    model.setParameter("gamma", 0.0);
+    model.evaluate(2.5, state, out);
+    EXPECT_NEAR(out[1], -0.3 * -0.2 + 0.4 - 0.4 * 0.4 * 0.4, 1e-15);
+    found->evaluate(2.5, state, out);
+    EXPECT_NEAR(out[1], duffingAcceleration(2.5, 0.4, -0.2), 1e-15);
+    EXPECT_THROW(model.setParameter("nope", 1.0), PluginError);
+}
+
+TEST(PluginLoaderTest, BatchMatchesScalar) {
+    PluginRegistry registry;
+    registry.load(pluginDir + "/drag_crisis.so");
+    const PluginModel* model = registry.find("drag_crisis", NM_MODEL_ACCELERATION);
+    ASSERT_NE(model, nullptr);
+    ASSERT_TRUE(model->hasBatch());
+    ASSERT_EQ(model->outputSize(), 3u);
+
+    const size_t count = 257;
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> velocity(-80.0, 80.0);
+    std::vector<std::vector<double>> in(6, std::vector<double>(count));
+    std::vector<std::vector<double>> out(3, std::vector<double>(count));
+    std::vector<double> t(count, 0.0);
+    const double* inputs[6];
+    double* outputs[3];
+    for (int k = 0; k < 6; ++k) {
+        for (double& v : in[k]) {
+            v = velocity(random);
+        }
+        inputs[k] = in[k].data();
+    }
+    for (int k = 0; k < 3; ++k) {
+        outputs[k] = out[k].data();
+    }
+    model->evaluateBatch(count, t.data(), inputs, outputs);
+
+    for (size_t i = 0; i < count; ++i) {
+        double single[6], a[3];
+        for (int k = 0; k < 6; ++k) {
+            single[k] = in[k][i];
+        }
+        model->evaluate(0.0, single, a);
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_EQ(out[k][i], a[k]) << "lane " << i;
+        }
+    }
+}
+
+TEST(PluginLoaderTest, DragCoefficientDropsPastCriticalReynolds) {
+    PluginRegistry registry;
+    registry.load(pluginDir + "/drag_crisis.so");
+    const PluginModel* model = registry.find("drag_crisis", NM_MODEL_ACCELERATION);
+    ASSERT_NE(model, nullptr);
+
+    // Drag deceleration divided by v^2 is proportional to Cd
+    auto dragPerSpeedSquared = [&](double speed) {
+        double in[6] = {speed, 0, 0, 0, 0, 0}, a[3];
+        model->evaluate(0.0, in, a);
+        EXPECT_DOUBLE_EQ(a[2], -9.81);
+        return -a[0] / (speed * speed);
+    };
+    double area = M_PI * 0.0366 * 0.0366;
+    double full = 0.5 * 1.225 * area / 0.145;
+    EXPECT_NEAR(dragPerSpeedSquared(5.0) / full, 0.5, 1e-3);   // Re ~ 2.4e4
+    EXPECT_NEAR(dragPerSpeedSquared(90.0) / full, 0.2, 1e-3);  // Re ~ 4.4e5
+}
+
+TEST(PluginLoaderTest, DiscoversDirectoriesAndReportsErrors) {
+    PluginRegistry registry;
+    EXPECT_EQ(registry.discover(pluginDir), 2u);
+    EXPECT_TRUE(registry.errors().empty());
+    EXPECT_EQ(registry.discover("no/such/directory"), 0u);
+
+    // The same models again are rejected, and collected by discover() instead of thrown
+    EXPECT_THROW(registry.load(pluginDir + "/duffing.so"), PluginError);
+    EXPECT_EQ(registry.discover(pluginDir), 0u);
+    EXPECT_EQ(registry.errors().size(), 2u);
+    EXPECT_EQ(registry.models().size(), 2u);
+
+    EXPECT_THROW(registry.load("no/such/plugin.so"), PluginError);
+    EXPECT_THROW(registry.load("/dev/null"), PluginError);
+}
+
+TEST(PluginLoaderTest, SearchPathReadsEnvironment) {
+    setenv("NM_PLUGIN_PATH", "/opt/a::/opt/b", 1);
+    EXPECT_EQ(PluginRegistry::searchPath("plugins"),
+              (std::vector<std::string>{"/opt/a", "/opt/b", "plugins"}));
+    unsetenv("NM_PLUGIN_PATH");
+    EXPECT_EQ(PluginRegistry::searchPath("plugins"), (std::vector<std::string>{"plugins"}));
+}
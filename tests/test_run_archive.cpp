@@ -0,0 +1,118 @@
+/*
+ * Tests for the shared RunArchive container (include/run_archive.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "run_archive.h"
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return "/tmp/" + std::string(name) + "_" + std::to_string(getpid()) + ".nmra";
+}
+
+RunArchiveLayout sweepLayout() {
+    return RunArchiveLayout{{"Angle", "Speed"}, {"Range"}, {"Time", "X", "Z"}};
+}
+
+}  // namespace
+
+TEST(RunArchiveTest, RoundTripFindAndSelect) {
+    std::string path = tempPath("round_trip");
+    {
+        RunArchiveWriter writer(path, sweepLayout());
+        for (uint64_t id = 0; id < 20; ++id) {
+            double parameters[2] = {static_cast<double>(20 - id), 10.0};
+            double summary = id * 1.5;
+            std::vector<double> rows;
+            for (size_t r = 0; r <= id; ++r) {
+                rows.insert(rows.end(), {r * 0.1, static_cast<double>(id), -1.0 * r});
+            }
+            ASSERT_TRUE(writer.append(id, parameters, &summary, rows.data(), id + 1));
+        }
+        writer.close();
+    }
+
+    RunArchiveReader reader(path);
+    ASSERT_EQ(reader.size(), 20u);
+    EXPECT_EQ(reader.layout().columns[1], "X");
+    EXPECT_EQ(reader.parameterIndex("Speed"), 1u);
+    EXPECT_EQ(reader.parameterIndex("Spin"), RunArchiveReader::npos);
+
+    RunArchiveReader::Run run;
+    ASSERT_TRUE(reader.find(7, run));
+    EXPECT_EQ(run.rows, 8u);
+    EXPECT_DOUBLE_EQ(run.parameters[0], 13.0);
+    EXPECT_DOUBLE_EQ(run.summary[0], 10.5);
+    EXPECT_DOUBLE_EQ(run.at(7, 1), 7.0);
+    EXPECT_DOUBLE_EQ(run.at(7, 2), -7.0);
+    EXPECT_FALSE(reader.find(20, run));
+
+    std::vector<RunArchiveReader::Run> selected = reader.select(0, 4.5, 8.0);
+    ASSERT_EQ(selected.size(), 4u);  // angles 5, 6, 7, 8
+    EXPECT_DOUBLE_EQ(selected.front().parameters[0], 5.0);
+    EXPECT_EQ(selected.back().id, 12u);
+    unlink(path.c_str());
+}
+
+TEST(RunArchiveTest, ConcurrentAppendsAreAllIndexed) {
+    std::string path = tempPath("concurrent");
+    const size_t threads = 4;
+    const size_t perThread = 250;
+    {
+        RunArchiveWriter writer(path, sweepLayout());
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (size_t i = 0; i < perThread; ++i) {
+                    uint64_t id = t * perThread + i;
+                    double parameters[2] = {static_cast<double>(id), 0.0};
+                    double summary = 2.0 * id;
+                    std::vector<double> rows(3 * (i % 5), static_cast<double>(id));
+                    writer.append(id, parameters, &summary, rows.data(), i % 5);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        EXPECT_TRUE(writer.ok());
+        EXPECT_EQ(writer.runs(), threads * perThread);
+    }
+
+    RunArchiveReader reader(path);
+    ASSERT_EQ(reader.size(), threads * perThread);
+    for (size_t i = 0; i < reader.size(); ++i) {
+        RunArchiveReader::Run run = reader.run(i);
+        ASSERT_EQ(run.id, i);
+        EXPECT_DOUBLE_EQ(run.summary[0], 2.0 * i);
+        for (size_t r = 0; r < run.rows; ++r) {
+            ASSERT_DOUBLE_EQ(run.at(r, 0), static_cast<double>(i));
+        }
+    }
+    unlink(path.c_str());
+}
+
+TEST(RunArchiveTest, RejectsUnclosedArchive) {
+    std::string path = tempPath("unclosed");
+    EXPECT_THROW(RunArchiveReader("/nonexistent/archive.nmra"), std::runtime_error);
+
+    // Cut off the index, as if the writer had crashed before close()
+    {
+        RunArchiveWriter writer(path, sweepLayout());
+        writer.close();
+    }
+    ASSERT_EQ(truncate(path.c_str(), 40), 0);
+    EXPECT_THROW(RunArchiveReader reader(path), std::runtime_error);
+    unlink(path.c_str());
+}
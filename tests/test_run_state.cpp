@@ -0,0 +1,93 @@
+/*
+ * Tests for saved run states (include/run_state.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "run_state.h"
+
+namespace {
+
+const std::string path = "/tmp/test_run_state.state";
+
+}  // namespace
+
+TEST(RunStateTest, RoundTripIsExact) {
+    std::mt19937 random(42);
+    random.discard(1000);
+    std::ostringstream engine;
+    engine << random;
+
+    RunState saved;
+    saved.model = "oscillator";
+    saved.output = "Output/some dir/run.csv";
+    saved.parameters = {{"length", 9.8}, {"frequency", 2.0 / 3.0}};
+    saved.names = {"Time", "Angle", "AngularVelocity"};
+    saved.state = {180.04, -M_PI / 3.0, std::nextafter(1.0, 2.0)};
+    saved.timeStep = 0.04;
+    saved.endTime = 180.0;
+    saved.steps = 4501;
+    saved.rng = engine.str();
+    saved.snapshot(0, {0.0, 0.2, 0.0}, 250);
+    saved.snapshot(249, {9.96, 0.1, 0.1}, 250);  // Not a multiple: skipped
+    saved.snapshot(250, {10.000000000000002, -0.3, 1e-300}, 250);
+    saved.save(path);
+
+    RunState loaded = RunState::load(path);
+    EXPECT_EQ(loaded.model, saved.model);
+    EXPECT_EQ(loaded.output, saved.output);
+    EXPECT_EQ(loaded.parameters, saved.parameters);
+    EXPECT_EQ(loaded.names, saved.names);
+    EXPECT_EQ(loaded.state, saved.state);  // Bitwise, not approximately
+    EXPECT_EQ(loaded.timeStep, saved.timeStep);
+    EXPECT_EQ(loaded.endTime, saved.endTime);
+    EXPECT_EQ(loaded.steps, saved.steps);
+    ASSERT_EQ(loaded.snapshots.size(), 2u);
+    EXPECT_EQ(loaded.snapshots[1].step, 250u);
+    EXPECT_EQ(loaded.snapshots[1].state, saved.snapshots[1].state);
+    EXPECT_DOUBLE_EQ(loaded.parameter("length"), 9.8);
+    EXPECT_THROW(loaded.parameter("mass"), std::invalid_argument);
+
+    // The restored engine continues the same sequence
+    std::mt19937 restored;
+    std::istringstream(loaded.rng) >> restored;
+    EXPECT_EQ(restored(), random());
+
+    EXPECT_FALSE(std::ifstream(path + ".tmp"));  // Renamed into place
+    std::remove(path.c_str());
+}
+
+TEST(RunStateTest, SnapshotBeforeTime) {
+    RunState saved;
+    saved.snapshots = {{0, {0.0, 1.0}}, {10, {1.0, 2.0}}, {20, {2.0, 3.0}}};
+    EXPECT_EQ(saved.snapshotBefore(-0.5), nullptr);
+    EXPECT_EQ(saved.snapshotBefore(0.0)->step, 0u);
+    EXPECT_EQ(saved.snapshotBefore(1.5)->step, 10u);
+    EXPECT_EQ(saved.snapshotBefore(99.0)->step, 20u);
+}
+
+TEST(RunStateTest, RejectsBadFiles) {
+    EXPECT_THROW(RunState::load("/tmp/no_such_run.state"), std::runtime_error);
+
+    std::ofstream(path) << "something else\n";
+    EXPECT_THROW(RunState::load(path), std::runtime_error);
+    std::ofstream(path) << "nm-run-state 1\nnames t x\nstate 0x1p+0\ntime_step 0x1p-4\n";
+    EXPECT_THROW(RunState::load(path), std::runtime_error);  // Two names, one value
+    std::ofstream(path) << "nm-run-state 1\nnames t\nstate 1.5abc\ntime_step 0x1p-4\n";
+    EXPECT_THROW(RunState::load(path), std::runtime_error);
+    std::remove(path.c_str());
+
+    RunState unnamed;
+    unnamed.model = "two words";
+    EXPECT_THROW(unnamed.save(path), std::invalid_argument);
+}
@@ -0,0 +1,79 @@
+/*
+ * Tests for the parallel projectile sweeps (Project 1, include/Sweep.h)
+ *
+ * Build and run from Project 1: realistic projectile motion/: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Processing.h"
+#include "Sweep.h"
+
+namespace {
+
+const std::string archivePath = "/tmp/test_sweep.nmra";
+
+std::vector<SweepCase> baseballAngles() {
+    Baseball ball(Vector4D(0, 0, 1, 0), Vector3D(0, 0, 0), Vector3D(0, 0, 0));
+    return angleSweep(ball, 40.0, 5.0, 75.0, 8, Vector3D(2, -1, 0));
+}
+
+}  // namespace
+
+TEST(RunSweepTest, SavingAndSummaryOnlyReportTheSameLanding) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    std::vector<SweepCase> cases = baseballAngles();
+    const double dt = 0.001, maxTime = 60.0;
+    std::vector<SweepResult> summary = runSweep(cases, dt, maxTime, pool);
+
+    RunArchiveWriter archive(archivePath, sweepArchiveLayout());
+    SweepOutput output;
+    output.archive = &archive;
+    std::vector<SweepResult> saved = runSweep(cases, dt, maxTime, pool, output);
+    archive.close();
+    std::remove(archivePath.c_str());
+
+    ASSERT_EQ(saved.size(), cases.size());
+    for (size_t i = 0; i < cases.size(); ++i) {
+        EXPECT_EQ(saved[i].impact.x, summary[i].impact.x) << "case " << i;
+        EXPECT_EQ(saved[i].impact.y, summary[i].impact.y) << "case " << i;
+        EXPECT_EQ(saved[i].impact.t, summary[i].impact.t) << "case " << i;
+        EXPECT_EQ(saved[i].range, summary[i].range) << "case " << i;
+        EXPECT_EQ(saved[i].steps, summary[i].steps) << "case " << i;
+        EXPECT_EQ(saved[i].impact.z, 0.0);
+
+        FlightSummary flight =
+            rk4Flight(*cases[i].params, cases[i].start, dt, cases[i].wind, maxTime);
+        EXPECT_EQ(summary[i].impact.t, flight.impact.t);
+        EXPECT_EQ(summary[i].range, flight.range);
+    }
+}
+
+TEST(RunSweepTest, MaxTimeInTheAir) {
+    ThreadPoolOptions options;
+    options.threads = 2;
+    ThreadPool pool(options);
+    std::vector<SweepCase> cases = baseballAngles();
+    const double dt = 0.01, maxTime = 0.5;
+    std::vector<SweepResult> summary = runSweep(cases, dt, maxTime, pool);
+
+    RunArchiveWriter archive(archivePath, sweepArchiveLayout());
+    SweepOutput output;
+    output.archive = &archive;
+    std::vector<SweepResult> saved = runSweep(cases, dt, maxTime, pool, output);
+    archive.close();
+    std::remove(archivePath.c_str());
+
+    for (size_t i = 0; i < cases.size(); ++i) {
+        EXPECT_GT(summary[i].impact.z, 0.0);
+        EXPECT_NEAR(summary[i].impact.t, maxTime, dt);
+        EXPECT_EQ(saved[i].impact.z, summary[i].impact.z);
+        EXPECT_EQ(saved[i].steps, summary[i].steps);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Tests for the trace recorder (include/trace.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "thread_pool.h"
+#include "trace.h"
+
+namespace {
+
+const std::string path = "/tmp/test_trace.json";
+
+std::string readFile(const std::string& file) {
+    std::ifstream in(file);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+size_t occurrences(const std::string& text, const std::string& word) {
+    size_t count = 0;
+    for (size_t at = text.find(word); at != std::string::npos; at = text.find(word, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST(TraceTest, DisabledSpansRecordNothing) {
+    ASSERT_FALSE(Trace::enabled());
+    {
+        TraceSpan span("ignored", "test");
+    }
+    Trace::enable(path);
+    EXPECT_EQ(Trace::flush(), 0u);
+    EXPECT_FALSE(Trace::enabled());
+    EXPECT_EQ(occurrences(readFile(path), "\"ignored\""), 0u);
+}
+
+TEST(TraceTest, RecordsSpansOfEveryWorker) {
+    Trace::enable(path);
+    Trace::nameThread("test main");
+    {
+        TraceSpan outer("whole run", "test");
+        ThreadPoolOptions options;
+        options.threads = 3;
+        ThreadPool pool(options);
+        pool.parallelFor(40, 1, [](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                TraceSpan span("job", "test", static_cast<int64_t>(i));
+                volatile double sink = 0.0;
+                for (int k = 0; k < 1000; ++k) {
+                    sink = sink + k;
+                }
+            }
+        });
+    }
+    size_t spans = Trace::flush();
+    EXPECT_GE(spans, 40u + 40u + 1u);  // Jobs, the pool tasks running them, the outer span
+
+    std::string json = readFile(path);
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("]}"), std::string::npos);
+    EXPECT_EQ(occurrences(json, "\"name\":\"job\""), 40u);
+    EXPECT_EQ(occurrences(json, "\"ph\":\"X\""), spans);
+    EXPECT_EQ(occurrences(json, "\"name\":\"pool worker "), 3u);
+    EXPECT_EQ(occurrences(json, "\"name\":\"test main\""), 1u);
+    EXPECT_NE(json.find("\"args\":{\"id\":39}"), std::string::npos);
+
+    // Flushing empties the buffers: a second trace starts clean
+    Trace::enable(path);
+    EXPECT_EQ(Trace::flush(), 0u);
+    std::remove(path.c_str());
+}
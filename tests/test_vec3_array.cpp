@@ -0,0 +1,90 @@
+/*
+ * Tests for the shared structure-of-arrays vector container (include/vec3_array.h)
+ *
+ * Build and run from the workspace root: make test
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "vec3_array.h"
+
+namespace {
+
+std::vector<Vector3D> randomVectors(size_t count, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> component(-5.0, 5.0);
+    std::vector<Vector3D> vectors(count);
+    for (Vector3D& v : vectors) {
+        v = Vector3D(component(random), component(random), component(random));
+    }
+    return vectors;
+}
+
+void expectVectorNear(const Vector3D& expected, const Vector3D& actual, size_t i) {
+    EXPECT_NEAR(expected.getX(), actual.getX(), 1e-12) << "vector " << i;
+    EXPECT_NEAR(expected.getY(), actual.getY(), 1e-12) << "vector " << i;
+    EXPECT_NEAR(expected.getZ(), actual.getZ(), 1e-12) << "vector " << i;
+}
+
+}  // namespace
+
+TEST(Vec3ArrayTest, ConversionRoundTripAndAlignment) {
+    std::vector<Vector3D> vectors = randomVectors(1001, 1);
+    Vec3Array soa = Vec3Array::fromAoS(vectors);
+    ASSERT_EQ(soa.size(), vectors.size());
+    for (const AlignedVector* array : {&soa.x, &soa.y, &soa.z}) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(array->data()) % 64, 0u);
+    }
+
+    std::vector<Vector3D> back = soa.toAoS();
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        EXPECT_EQ(back[i].getX(), vectors[i].getX());
+        EXPECT_EQ(back[i].getY(), vectors[i].getY());
+        EXPECT_EQ(back[i].getZ(), vectors[i].getZ());
+    }
+}
+
+TEST(Vec3ArrayTest, BulkOperationsMatchVector3D) {
+    // Large enough to take the threaded path, and not a multiple of any SIMD width
+    const size_t count = (1 << 17) + 3;
+    std::vector<Vector3D> aosA = randomVectors(count, 2);
+    std::vector<Vector3D> aosB = randomVectors(count, 3);
+    aosA[5] = Vector3D(0, 0, 0);  // normalize() must leave it at zero
+
+    ThreadPoolOptions options;
+    options.threads = 3;
+    ThreadPool pool(options);
+    for (ThreadPool* p : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        Vec3Array a = Vec3Array::fromAoS(aosA);
+        Vec3Array b = Vec3Array::fromAoS(aosB);
+        Vec3Array product;
+        AlignedVector dots, norms;
+        dot(a, b, dots, p);
+        cross(a, b, product, p);
+        norm(a, norms, p);
+        axpy(0.5, a, b, p);
+        normalize(a, p);
+
+        for (size_t i = 0; i < count; i += 97) {
+            EXPECT_NEAR(dots[i], aosA[i].dot(aosB[i]), 1e-12) << "vector " << i;
+            EXPECT_NEAR(norms[i], aosA[i].magnitude(), 1e-12) << "vector " << i;
+            expectVectorNear(aosA[i].cross(aosB[i]), product.get(i), i);
+            expectVectorNear(aosB[i] + aosA[i] * 0.5, b.get(i), i);
+            expectVectorNear(aosA[i].normalized(), a.get(i), i);
+        }
+        expectVectorNear(Vector3D(0, 0, 0), a.get(5), 5);
+    }
+}
+
+TEST(Vec3ArrayTest, RejectsMismatchedSizes) {
+    Vec3Array a(4), b(5);
+    AlignedVector out;
+    EXPECT_THROW(axpy(1.0, a, b), std::invalid_argument);
+    EXPECT_THROW(dot(a, b, out), std::invalid_argument);
+    EXPECT_THROW(cross(a, a, a), std::invalid_argument);
+}